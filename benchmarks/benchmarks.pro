@@ -0,0 +1,7 @@
+# 性能基准（独立于主程序构建）：qmake benchmarks/benchmarks.pro && make
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    prompttiming \
+    ssereplay \
+    translatorthroughput
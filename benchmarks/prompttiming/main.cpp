@@ -0,0 +1,336 @@
+#include "apiformatmanager.h"
+#include "llmmockserver.h"
+#include "llmserviceclient.h"
+#include "promptrequestcomposer.h"
+#include "segmentwirecodec.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QList>
+#include <QPair>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+#include <QtGlobal>
+
+#include <algorithm>
+
+// 提示布局首字延迟基准：按分段顺序逐个发送流式请求，分别使用调整前的布局（三条 user 消息：
+// 指令 + 上一段译文 + 本段）与现行的前缀缓存布局（system 静态前缀 + 一条 user 消息），
+// 输出首字延迟（TTFT）分位数与相邻请求体的公共前缀字节数。
+// 缺省在本进程内启动 LlmMockServer（--prefill-ms 模拟未命中前缀缓存部分的预填充耗时）；
+// 指定 --host 时改为测量真实服务（如本地 Ollama / LM Studio）。
+namespace {
+struct BenchOptions
+{
+    int segmentCount = 30;
+    int chunkSize = 20;
+    QString host;
+    QString provider = QStringLiteral("本地 OpenAI 兼容");
+    QString model = QStringLiteral("mock-model");
+    LlmMockServerOptions mockOptions;
+};
+
+struct LayoutResult
+{
+    QVector<qint64> firstTokenMs;
+    qint64 sharedPrefixBytes = 0;
+    qint64 bodyBytes = 0;
+    int requests = 0;
+    QString failure;
+};
+
+enum class PromptLayout {
+    Legacy,
+    PrefixCached
+};
+
+bool parseIntOption(const QCommandLineParser &parser, const QString &name, int minimum, int *target, QString *errorMessage)
+{
+    if (!parser.isSet(name)) {
+        return true;
+    }
+    bool ok = false;
+    const int value = parser.value(name).toInt(&ok);
+    if (!ok || value < minimum) {
+        *errorMessage = QStringLiteral("--%1 的取值无效").arg(name);
+        return false;
+    }
+    *target = value;
+    return true;
+}
+
+bool parseOptions(const QStringList &arguments, BenchOptions *options, QString *errorMessage)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("提示布局首字延迟基准：调整前布局与前缀缓存布局的 TTFT 对比"));
+    parser.addHelpOption();
+    parser.addOptions({
+        {QStringLiteral("segments"), QStringLiteral("顺序发送的分段数，缺省 30"), QStringLiteral("count")},
+        {QStringLiteral("chunk-size"), QStringLiteral("每个分段的条目数，缺省 20"), QStringLiteral("count")},
+        {QStringLiteral("latency-ms"), QStringLiteral("模拟服务首字节延迟，缺省 300"), QStringLiteral("ms")},
+        {QStringLiteral("tokens-per-sec"), QStringLiteral("模拟服务每个请求的输出速率，缺省 80"), QStringLiteral("count")},
+        {QStringLiteral("prefill-ms"), QStringLiteral("模拟服务每千个未命中缓存的提示 token 的预填充耗时，缺省 200"), QStringLiteral("ms")},
+        {QStringLiteral("host"), QStringLiteral("改为测量指定服务的基础地址（不启动模拟服务）"), QStringLiteral("url")},
+        {QStringLiteral("provider"), QStringLiteral("--host 对应的 Provider 名称，缺省“本地 OpenAI 兼容”"), QStringLiteral("name")},
+        {QStringLiteral("model"), QStringLiteral("请求使用的模型名"), QStringLiteral("name")},
+    });
+    if (!parser.parse(arguments)) {
+        *errorMessage = parser.errorText();
+        return false;
+    }
+    if (parser.isSet(QStringLiteral("help"))) {
+        parser.showHelp(0);
+    }
+
+    BenchOptions result;
+    result.mockOptions.prefillMsPerKToken = 200;
+    result.host = parser.value(QStringLiteral("host")).trimmed();
+    if (parser.isSet(QStringLiteral("provider"))) {
+        result.provider = parser.value(QStringLiteral("provider"));
+    }
+    if (parser.isSet(QStringLiteral("model"))) {
+        result.model = parser.value(QStringLiteral("model"));
+    }
+    if (!parseIntOption(parser, QStringLiteral("segments"), 1, &result.segmentCount, errorMessage)
+        || !parseIntOption(parser, QStringLiteral("chunk-size"), 1, &result.chunkSize, errorMessage)
+        || !parseIntOption(parser, QStringLiteral("latency-ms"), 0, &result.mockOptions.firstByteLatencyMs, errorMessage)
+        || !parseIntOption(parser, QStringLiteral("tokens-per-sec"), 1, &result.mockOptions.tokensPerSecond, errorMessage)
+        || !parseIntOption(parser, QStringLiteral("prefill-ms"), 0, &result.mockOptions.prefillMsPerKToken, errorMessage)) {
+        return false;
+    }
+
+    *options = result;
+    return true;
+}
+
+// 第 segment 段的紧凑行载荷；句子与翻译吞吐基准相同，末尾带全局序号。
+QString segmentPayload(int segment, int chunkSize)
+{
+    static const char *const kLines[] = {
+        "I told you we should have left before the storm.",
+        "Where did you put the keys to the truck?",
+        "Nobody in this town remembers what happened that night.",
+        "We have twenty minutes before the guards change shifts.",
+        "Dr. Harris will see you now, please follow me.",
+        "That's not what the report from March says.",
+        "If the bridge is out, we take the long road through Millbrook.",
+        "Thank you. I mean it, really.",
+    };
+    const int lineCount = static_cast<int>(sizeof(kLines) / sizeof(kLines[0]));
+
+    QStringList lines;
+    for (int i = 0; i < chunkSize; ++i) {
+        const int id = segment * chunkSize + i + 1;
+        lines << SegmentWireCodec::encodeLine(id, QStringLiteral("%1 (%2)").arg(QLatin1String(kLines[id % lineCount])).arg(id));
+    }
+    return lines.join('\n');
+}
+
+QJsonObject userMessage(const QString &content)
+{
+    QJsonObject message;
+    message.insert(QStringLiteral("role"), QStringLiteral("user"));
+    message.insert(QStringLiteral("content"), content);
+    return message;
+}
+
+// 调整前（fd87e9f 之前）的消息布局：指令与输出格式说明、上一段译文、本段条目各为一条 user 消息。
+QJsonArray legacyMessages(const QString &staticPrompt, const QString &previousContext, const QString &segmentText)
+{
+    QJsonArray messages;
+    messages.append(userMessage(staticPrompt));
+    if (!previousContext.trimmed().isEmpty()) {
+        messages.append(userMessage(QStringLiteral("【上一段译文（仅用于保持文风一致，不要重复输出）】\n%1")
+                                        .arg(previousContext)));
+    }
+    messages.append(userMessage(segmentText));
+    return messages;
+}
+
+// 与 SubtitleTranslation::sendCurrentSegmentRequest() 相同的前缀缓存布局。
+QJsonArray prefixCachedMessages(const QString &staticPrompt, const QString &previousContext, const QString &segmentText)
+{
+    QString variableContent;
+    if (!previousContext.trimmed().isEmpty()) {
+        variableContent = QStringLiteral("【上一段译文（仅用于保持文风一致，不要重复输出）】\n%1\n\n").arg(previousContext);
+    }
+    variableContent += segmentText;
+    return PromptRequestComposer::buildPrefixCachedMessages(staticPrompt, variableContent);
+}
+
+int commonPrefixLength(const QByteArray &left, const QByteArray &right)
+{
+    const int limit = qMin(left.size(), right.size());
+    int length = 0;
+    while (length < limit && left.at(length) == right.at(length)) {
+        ++length;
+    }
+    return length;
+}
+
+LayoutResult runLayout(const BenchOptions &options, PromptLayout layout)
+{
+    LayoutResult result;
+
+    // 每种布局使用新的模拟服务，前缀缓存从空开始。
+    QObject serverOwner;
+    QString baseUrl = options.host;
+    if (baseUrl.isEmpty()) {
+        LlmMockServerOptions mockOptions = options.mockOptions;
+        mockOptions.port = 0;
+        LlmMockServer *server = new LlmMockServer(mockOptions, &serverOwner);
+        QString errorMessage;
+        if (!server->start(&errorMessage)) {
+            result.failure = QStringLiteral("模拟服务启动失败：%1").arg(errorMessage);
+            return result;
+        }
+        baseUrl = QStringLiteral("http://127.0.0.1:%1/v1").arg(server->port());
+    }
+
+    LlmServiceConfig config;
+    config.provider = options.provider;
+    config.baseUrl = baseUrl;
+    config.model = options.model;
+    config.stream = true;
+    const QString providerId = ApiFormatManager::providerId(config.provider, config.normalizedBaseUrl());
+
+    PromptComposeInput composeInput;
+    composeInput.targetLanguage = QStringLiteral("中文");
+    const QString staticPrompt = PromptRequestComposer::buildFinalInstruction(composeInput)
+                                 + QStringLiteral("\n\n")
+                                 + SegmentWireCodec::outputInstruction();
+
+    LlmServiceClient client;
+    QEventLoop loop;
+    QString content;
+    qint64 firstTokenMs = -1;
+    QObject::connect(&client, &LlmServiceClient::chatMetricsMeasured, &loop,
+                     [&firstTokenMs](quint64, const LlmRequestMetrics &metrics) {
+                         firstTokenMs = metrics.firstTokenMs;
+                     });
+    QObject::connect(&client, &LlmServiceClient::chatCompleted, &loop,
+                     [&loop, &content](quint64, const QString &text, const QJsonObject &) {
+                         content = text;
+                         loop.quit();
+                     });
+    QObject::connect(&client, &LlmServiceClient::requestFailed, &loop,
+                     [&loop, &result](quint64, const QString &stage, const QString &message) {
+                         result.failure = stage + QStringLiteral("：") + message;
+                         loop.quit();
+                     });
+
+    QString previousContext;
+    QByteArray previousBody;
+    for (int segment = 0; segment < options.segmentCount; ++segment) {
+        const QString segmentText = QStringLiteral("【待翻译分段 %1/%2】\n%3")
+                                        .arg(segment + 1)
+                                        .arg(options.segmentCount)
+                                        .arg(segmentPayload(segment, options.chunkSize));
+        const QJsonArray messages = layout == PromptLayout::Legacy
+                                        ? legacyMessages(staticPrompt, previousContext, segmentText)
+                                        : prefixCachedMessages(staticPrompt, previousContext, segmentText);
+
+        const QByteArray body = QJsonDocument(ApiFormatManager::buildChatBody(providerId, config.model, true, messages, QJsonObject()))
+                                    .toJson(QJsonDocument::Compact);
+        if (!previousBody.isEmpty()) {
+            result.sharedPrefixBytes += commonPrefixLength(previousBody, body);
+        }
+        result.bodyBytes += body.size();
+        previousBody = body;
+
+        content.clear();
+        firstTokenMs = -1;
+        if (client.requestChatCompletion(config, messages) == 0) {
+            result.failure = QStringLiteral("请求未能发出");
+            return result;
+        }
+        loop.exec();
+        if (!result.failure.isEmpty()) {
+            return result;
+        }
+        result.firstTokenMs.append(firstTokenMs);
+        ++result.requests;
+        previousContext = content;
+    }
+    return result;
+}
+
+qint64 percentile(QVector<qint64> samples, int percent)
+{
+    if (samples.isEmpty()) {
+        return -1;
+    }
+    std::sort(samples.begin(), samples.end());
+    const int index = qBound(0, (samples.size() * percent + 99) / 100 - 1, samples.size() - 1);
+    return samples.at(index);
+}
+
+double mean(const QVector<qint64> &samples)
+{
+    if (samples.isEmpty()) {
+        return 0.0;
+    }
+    qint64 total = 0;
+    for (qint64 sample : samples) {
+        total += sample;
+    }
+    return static_cast<double>(total) / samples.size();
+}
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    BenchOptions options;
+    QString errorMessage;
+    if (!parseOptions(application.arguments(), &options, &errorMessage)) {
+        QTextStream(stderr) << errorMessage << '\n';
+        return 2;
+    }
+
+    QTextStream out(stdout);
+    if (options.host.isEmpty()) {
+        out << QStringLiteral("模拟服务：首字节 %1 ms，%2 token/s，预填充 %3 ms/千 token；%4 段 × %5 条\n")
+                   .arg(options.mockOptions.firstByteLatencyMs)
+                   .arg(options.mockOptions.tokensPerSecond)
+                   .arg(options.mockOptions.prefillMsPerKToken)
+                   .arg(options.segmentCount)
+                   .arg(options.chunkSize);
+    } else {
+        out << QStringLiteral("目标服务：%1（%2，%3）；%4 段 × %5 条\n")
+                   .arg(options.host, options.provider, options.model)
+                   .arg(options.segmentCount)
+                   .arg(options.chunkSize);
+    }
+    out << QStringLiteral("布局\t请求数\tTTFT p50(ms)\tTTFT p90(ms)\tTTFT 均值(ms)\t相邻请求公共前缀(B)\t平均请求体(B)\n");
+    out.flush();
+
+    int exitCode = 0;
+    const QList<QPair<PromptLayout, QString>> layouts{
+        {PromptLayout::Legacy, QStringLiteral("调整前")},
+        {PromptLayout::PrefixCached, QStringLiteral("前缀缓存")},
+    };
+    for (const auto &layout : layouts) {
+        const LayoutResult result = runLayout(options, layout.first);
+        if (!result.failure.isEmpty()) {
+            out << layout.second << QStringLiteral("：请求失败：") << result.failure << '\n';
+            exitCode = 1;
+            continue;
+        }
+        const int pairs = qMax(1, result.requests - 1);
+        out << layout.second << '\t'
+            << result.requests << '\t'
+            << percentile(result.firstTokenMs, 50) << '\t'
+            << percentile(result.firstTokenMs, 90) << '\t'
+            << QString::number(mean(result.firstTokenMs), 'f', 1) << '\t'
+            << result.sharedPrefixBytes / pairs << '\t'
+            << result.bodyBytes / qMax(1, result.requests) << '\n';
+        out.flush();
+    }
+    return exitCode;
+}
@@ -0,0 +1,6 @@
+include(../translator.pri)
+
+TARGET = prompttiming
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,360 @@
+#include "llmserviceclient.h"
+#include "sselinescanner.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QHostAddress>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QList>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTextStream>
+#include <QVector>
+#include <QtGlobal>
+
+#include <algorithm>
+
+// SSE 回放基准：把一份录制格式（LlmTrafficRecorder JSONL）的流式响应反复送入
+// 1) SseLineScanner（只测行扫描），2) LlmServiceClient（本地 TCP 服务不加节奏地一次写出全部数据块，
+// 经网络层、行扫描、JSON 解析到 streamChunkReceived 发出增量），分别输出 MB/s。
+// 未指定 --capture 时合成约 200 KB 的 OpenAI 兼容流式响应。
+namespace {
+// 合成数据块的大小：接近一个 TCP 报文段的负载。
+constexpr int kSynthesizedChunkBytes = 1460;
+
+struct Capture
+{
+    QString source;
+    QJsonObject request;
+    QList<QByteArray> chunks;
+    qint64 totalBytes = 0;
+    // 合成时已知的完整正文，用于核对客户端拼出的增量。
+    QString expectedContent;
+};
+
+QByteArray openAiFrame(const QString &content, bool finished)
+{
+    QJsonObject delta;
+    if (!content.isEmpty()) {
+        delta.insert(QStringLiteral("content"), content);
+    }
+    QJsonObject choice;
+    choice.insert(QStringLiteral("index"), 0);
+    choice.insert(QStringLiteral("delta"), delta);
+    choice.insert(QStringLiteral("finish_reason"), finished ? QJsonValue(QStringLiteral("stop")) : QJsonValue());
+    QJsonObject object;
+    object.insert(QStringLiteral("id"), QStringLiteral("chatcmpl-bench"));
+    object.insert(QStringLiteral("object"), QStringLiteral("chat.completion.chunk"));
+    object.insert(QStringLiteral("model"), QStringLiteral("mock-model"));
+    object.insert(QStringLiteral("choices"), QJsonArray{choice});
+    return "data: " + QJsonDocument(object).toJson(QJsonDocument::Compact) + "\n\n";
+}
+
+// 按紧凑行译文（编号|文本）合成流式响应：约 4 字符一个增量，与 LlmMockServer 的合成节奏一致；
+// 数据块按固定字节数切分（不切断 UTF-8 字符），使部分行跨块到达。
+Capture synthesizeCapture(int targetBytes)
+{
+    Capture capture;
+    capture.source = QStringLiteral("synthesized");
+    QJsonObject message;
+    message.insert(QStringLiteral("role"), QStringLiteral("user"));
+    message.insert(QStringLiteral("content"), QStringLiteral("sse replay benchmark"));
+    capture.request.insert(QStringLiteral("model"), QStringLiteral("mock-model"));
+    capture.request.insert(QStringLiteral("stream"), true);
+    capture.request.insert(QStringLiteral("messages"), QJsonArray{message});
+
+    QByteArray stream;
+    for (int line = 1; stream.size() < targetBytes; ++line) {
+        const QString text = QStringLiteral("%1|这是第 %1 条译文，用于测量流式响应的解析吞吐。\n").arg(line);
+        capture.expectedContent += text;
+        for (int offset = 0; offset < text.size(); offset += 4) {
+            stream += openAiFrame(text.mid(offset, 4), false);
+        }
+    }
+    stream += openAiFrame(QString(), true);
+    stream += "data: [DONE]\n\n";
+
+    int position = 0;
+    while (position < stream.size()) {
+        int end = qMin(stream.size(), position + kSynthesizedChunkBytes);
+        while (end < stream.size() && end > position + 1 && (static_cast<uchar>(stream.at(end)) & 0xC0) == 0x80) {
+            --end;
+        }
+        capture.chunks.append(stream.mid(position, end - position));
+        position = end;
+    }
+    capture.totalBytes = stream.size();
+    return capture;
+}
+
+// 取录制文件中数据量最大的一次流式交换。
+bool loadCapture(const QString &filePath, Capture *capture, QString *errorMessage)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *errorMessage = QStringLiteral("无法读取录制文件：%1").arg(filePath);
+        return false;
+    }
+
+    Capture best;
+    while (!file.atEnd()) {
+        const QJsonObject record = QJsonDocument::fromJson(file.readLine()).object();
+        if (!record.value(QStringLiteral("stream")).toBool(false)) {
+            continue;
+        }
+        Capture candidate;
+        candidate.source = filePath;
+        candidate.request = record.value(QStringLiteral("request")).toObject();
+        const QJsonArray chunks = record.value(QStringLiteral("chunks")).toArray();
+        for (const QJsonValue &value : chunks) {
+            const QByteArray data = value.toObject().value(QStringLiteral("data")).toString().toUtf8();
+            candidate.chunks.append(data);
+            candidate.totalBytes += data.size();
+        }
+        if (candidate.totalBytes > best.totalBytes) {
+            best = candidate;
+        }
+    }
+    if (best.totalBytes == 0) {
+        *errorMessage = QStringLiteral("录制文件中没有流式响应：%1").arg(filePath);
+        return false;
+    }
+    *capture = best;
+    return true;
+}
+
+// 写出一行录制格式记录，供下次 --capture 或 LlmMockServer 回放使用。
+bool writeCapture(const QString &filePath, const Capture &capture)
+{
+    QJsonArray chunks;
+    for (int i = 0; i < capture.chunks.size(); ++i) {
+        QJsonObject chunk;
+        chunk.insert(QStringLiteral("atMs"), i);
+        chunk.insert(QStringLiteral("data"), QString::fromUtf8(capture.chunks.at(i)));
+        chunks.append(chunk);
+    }
+    QJsonObject record;
+    record.insert(QStringLiteral("url"), QStringLiteral("http://127.0.0.1/v1/chat/completions"));
+    record.insert(QStringLiteral("request"), capture.request);
+    record.insert(QStringLiteral("status"), 200);
+    record.insert(QStringLiteral("stream"), true);
+    record.insert(QStringLiteral("totalMs"), capture.chunks.size());
+    record.insert(QStringLiteral("chunks"), chunks);
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    file.write(QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n');
+    return true;
+}
+
+double megabytesPerSecond(qint64 bytes, qint64 nanoseconds)
+{
+    return nanoseconds > 0 ? (bytes / 1e6) / (nanoseconds / 1e9) : 0.0;
+}
+
+// 第一遍：只测 SseLineScanner，数据块按录制顺序追加并取出全部完整行。
+void runScannerPass(const Capture &capture, int iterations, QTextStream &out)
+{
+    SseLineScanner scanner;
+    QByteArray line;
+    int linesPerIteration = 0;
+    QElapsedTimer timer;
+    qint64 elapsedNs = 0;
+    for (int iteration = 0; iteration <= iterations; ++iteration) {
+        int lines = 0;
+        timer.start();
+        scanner.reset();
+        for (const QByteArray &chunk : capture.chunks) {
+            scanner.append(chunk);
+            while (scanner.nextLine(&line)) {
+                ++lines;
+            }
+        }
+        if (!scanner.takeRemainder().isEmpty()) {
+            ++lines;
+        }
+        // 第 0 轮用于预热，不计时。
+        if (iteration > 0) {
+            elapsedNs += timer.nsecsElapsed();
+        }
+        linesPerIteration = lines;
+    }
+    out << QStringLiteral("SseLineScanner：%1 轮，%2 MB/s，每轮 %3 行\n")
+               .arg(iterations)
+               .arg(QString::number(megabytesPerSecond(capture.totalBytes * iterations, elapsedNs), 'f', 1))
+               .arg(linesPerIteration);
+}
+
+// 第二遍：本地 TCP 服务收到完整请求后一次写出全部数据块并断开，客户端按流式请求解析。
+bool runClientPass(const Capture &capture, int iterations, QTextStream &out)
+{
+    QByteArray response = "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nCache-Control: no-cache\r\n"
+                          "Connection: close\r\n\r\n";
+    for (const QByteArray &chunk : capture.chunks) {
+        response += chunk;
+    }
+
+    QTcpServer server;
+    if (!server.listen(QHostAddress::LocalHost, 0)) {
+        out << QStringLiteral("本地服务监听失败：%1\n").arg(server.errorString());
+        return false;
+    }
+    QObject::connect(&server, &QTcpServer::newConnection, &server, [&server, response]() {
+        while (server.hasPendingConnections()) {
+            QTcpSocket *socket = server.nextPendingConnection();
+            QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            QObject::connect(socket, &QTcpSocket::readyRead, socket, [socket, response]() {
+                QByteArray request = socket->property("pending").toByteArray() + socket->readAll();
+                const int headerEnd = request.indexOf("\r\n\r\n");
+                if (headerEnd < 0) {
+                    socket->setProperty("pending", request);
+                    return;
+                }
+                int contentLength = 0;
+                for (const QByteArray &header : request.left(headerEnd).split('\n')) {
+                    if (header.toLower().startsWith("content-length:")) {
+                        contentLength = header.mid(header.indexOf(':') + 1).trimmed().toInt();
+                    }
+                }
+                if (request.size() < headerEnd + 4 + contentLength) {
+                    socket->setProperty("pending", request);
+                    return;
+                }
+                socket->setProperty("pending", QByteArray());
+                socket->write(response);
+                socket->disconnectFromHost();
+            });
+        }
+    });
+
+    LlmServiceConfig config;
+    config.provider = QStringLiteral("本地 OpenAI 兼容");
+    config.baseUrl = QStringLiteral("http://127.0.0.1:%1/v1").arg(server.serverPort());
+    config.model = QStringLiteral("mock-model");
+    config.stream = true;
+
+    QJsonObject message;
+    message.insert(QStringLiteral("role"), QStringLiteral("user"));
+    message.insert(QStringLiteral("content"), QStringLiteral("sse replay benchmark"));
+    const QJsonArray messages{message};
+
+    LlmServiceClient client;
+    QEventLoop loop;
+    QString content;
+    QString failure;
+    int deltas = 0;
+    QObject::connect(&client, &LlmServiceClient::streamChunkReceived, &loop, [&content, &deltas](quint64, const QString &delta) {
+        content += delta;
+        ++deltas;
+    });
+    QObject::connect(&client, &LlmServiceClient::chatCompleted, &loop, [&loop]() {
+        loop.quit();
+    });
+    QObject::connect(&client, &LlmServiceClient::requestFailed, &loop,
+                     [&loop, &failure](quint64, const QString &stage, const QString &message) {
+                         failure = stage + QStringLiteral("：") + message;
+                         loop.quit();
+                     });
+
+    QVector<qint64> requestNs;
+    QElapsedTimer timer;
+    for (int iteration = 0; iteration <= iterations; ++iteration) {
+        content.clear();
+        deltas = 0;
+        timer.start();
+        if (client.requestChatCompletion(config, messages) == 0) {
+            out << QStringLiteral("请求未能发出\n");
+            return false;
+        }
+        loop.exec();
+        const qint64 elapsedNs = timer.nsecsElapsed();
+        if (!failure.isEmpty()) {
+            out << QStringLiteral("请求失败：%1\n").arg(failure);
+            return false;
+        }
+        if (!capture.expectedContent.isEmpty() && content != capture.expectedContent) {
+            out << QStringLiteral("增量拼接结果与合成正文不一致（%1 / %2 字符）\n")
+                       .arg(content.size())
+                       .arg(capture.expectedContent.size());
+            return false;
+        }
+        // 第 0 轮包含建连与首次分配，用于预热，不计时。
+        if (iteration > 0) {
+            requestNs.append(elapsedNs);
+        }
+    }
+
+    qint64 totalNs = 0;
+    for (qint64 ns : requestNs) {
+        totalNs += ns;
+    }
+    std::sort(requestNs.begin(), requestNs.end());
+    out << QStringLiteral("LlmServiceClient 流式：%1 轮，%2 MB/s，每轮 %3 个增量 / %4 字符，单次中位 %5 ms\n")
+               .arg(iterations)
+               .arg(QString::number(megabytesPerSecond(capture.totalBytes * iterations, totalNs), 'f', 1))
+               .arg(deltas)
+               .arg(content.size())
+               .arg(QString::number(requestNs.at(requestNs.size() / 2) / 1e6, 'f', 2));
+    return true;
+}
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("SSE 回放基准：行扫描与流式客户端的解析吞吐（MB/s）"));
+    parser.addHelpOption();
+    parser.addOptions({
+        {QStringLiteral("capture"), QStringLiteral("LlmTrafficRecorder 录制的 JSONL，取其中最大的一次流式响应"), QStringLiteral("path")},
+        {QStringLiteral("size-kb"), QStringLiteral("未指定 --capture 时合成的响应大小，缺省 200"), QStringLiteral("kb")},
+        {QStringLiteral("write-capture"), QStringLiteral("把所用响应写成录制格式 JSONL"), QStringLiteral("path")},
+        {QStringLiteral("iterations"), QStringLiteral("每一遍的计时轮数，缺省 20"), QStringLiteral("count")},
+    });
+    parser.process(application);
+
+    bool ok = true;
+    const int sizeKb = parser.isSet(QStringLiteral("size-kb")) ? parser.value(QStringLiteral("size-kb")).toInt(&ok) : 200;
+    if (!ok || sizeKb < 1) {
+        QTextStream(stderr) << "--size-kb 的取值无效\n";
+        return 2;
+    }
+    const int iterations = parser.isSet(QStringLiteral("iterations")) ? parser.value(QStringLiteral("iterations")).toInt(&ok) : 20;
+    if (!ok || iterations < 1) {
+        QTextStream(stderr) << "--iterations 的取值无效\n";
+        return 2;
+    }
+
+    Capture capture;
+    if (parser.isSet(QStringLiteral("capture"))) {
+        QString errorMessage;
+        if (!loadCapture(parser.value(QStringLiteral("capture")), &capture, &errorMessage)) {
+            QTextStream(stderr) << errorMessage << '\n';
+            return 2;
+        }
+    } else {
+        capture = synthesizeCapture(sizeKb * 1024);
+    }
+    if (parser.isSet(QStringLiteral("write-capture")) && !writeCapture(parser.value(QStringLiteral("write-capture")), capture)) {
+        QTextStream(stderr) << "无法写入录制文件：" << parser.value(QStringLiteral("write-capture")) << '\n';
+        return 2;
+    }
+
+    QTextStream out(stdout);
+    out << QStringLiteral("响应：%1，%2 字节，%3 个数据块\n")
+               .arg(capture.source)
+               .arg(capture.totalBytes)
+               .arg(capture.chunks.size());
+    out.flush();
+    runScannerPass(capture, iterations, out);
+    out.flush();
+    return runClientPass(capture, iterations, out) ? 0 : 1;
+}
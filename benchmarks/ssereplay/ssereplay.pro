@@ -0,0 +1,6 @@
+include(../translator.pri)
+
+TARGET = ssereplay
+
+SOURCES += \
+    main.cpp
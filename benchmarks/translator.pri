@@ -0,0 +1,54 @@
+# 翻译模块中不依赖界面的部分（客户端、执行器、模拟服务），供各基准程序共用。
+QT       += core network
+QT       -= gui
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+TRANSLATOR_DIR = $$PWD/../src/Modules/Translator
+INCLUDEPATH += $$TRANSLATOR_DIR
+
+SOURCES += \
+    $$TRANSLATOR_DIR/apiformatmanager.cpp \
+    $$TRANSLATOR_DIR/chattranslationbackend.cpp \
+    $$TRANSLATOR_DIR/headlesstranslationrunner.cpp \
+    $$TRANSLATOR_DIR/llmbatchclient.cpp \
+    $$TRANSLATOR_DIR/llmendpointpool.cpp \
+    $$TRANSLATOR_DIR/llmmockserver.cpp \
+    $$TRANSLATOR_DIR/llmserviceclient.cpp \
+    $$TRANSLATOR_DIR/llmtrafficrecorder.cpp \
+    $$TRANSLATOR_DIR/modelroutingpolicy.cpp \
+    $$TRANSLATOR_DIR/mttranslationbackend.cpp \
+    $$TRANSLATOR_DIR/promptrequestcomposer.cpp \
+    $$TRANSLATOR_DIR/segmentwirecodec.cpp \
+    $$TRANSLATOR_DIR/sselinescanner.cpp \
+    $$TRANSLATOR_DIR/streamingcueparser.cpp \
+    $$TRANSLATOR_DIR/subtitleentry.cpp \
+    $$TRANSLATOR_DIR/translationdocumentstore.cpp \
+    $$TRANSLATOR_DIR/translationmemory.cpp \
+    $$TRANSLATOR_DIR/translationtaskrunner.cpp \
+    $$TRANSLATOR_DIR/translationtelemetry.cpp
+
+HEADERS += \
+    $$TRANSLATOR_DIR/apiformatmanager.h \
+    $$TRANSLATOR_DIR/chattranslationbackend.h \
+    $$TRANSLATOR_DIR/headlesstranslationrunner.h \
+    $$TRANSLATOR_DIR/llmbatchclient.h \
+    $$TRANSLATOR_DIR/llmendpointpool.h \
+    $$TRANSLATOR_DIR/llmmockserver.h \
+    $$TRANSLATOR_DIR/llmserviceclient.h \
+    $$TRANSLATOR_DIR/llmtrafficrecorder.h \
+    $$TRANSLATOR_DIR/modelroutingpolicy.h \
+    $$TRANSLATOR_DIR/mttranslationbackend.h \
+    $$TRANSLATOR_DIR/promptrequestcomposer.h \
+    $$TRANSLATOR_DIR/segmentwirecodec.h \
+    $$TRANSLATOR_DIR/sselinescanner.h \
+    $$TRANSLATOR_DIR/streamingcueparser.h \
+    $$TRANSLATOR_DIR/subtitleentry.h \
+    $$TRANSLATOR_DIR/translationbackend.h \
+    $$TRANSLATOR_DIR/translationdocumentstore.h \
+    $$TRANSLATOR_DIR/translationmemory.h \
+    $$TRANSLATOR_DIR/translationtaskrunner.h \
+    $$TRANSLATOR_DIR/translationtelemetry.h
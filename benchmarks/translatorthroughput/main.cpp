@@ -0,0 +1,277 @@
+#include "headlesstranslationrunner.h"
+#include "llmmockserver.h"
+#include "subtitleentry.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QtGlobal>
+
+// 翻译吞吐基准：在本进程内为每个端点启动一个 LlmMockServer，用 HeadlessTranslationRunner
+// 翻译一份 SRT（分块、并发在途、缺失补译与按序提交均与界面的并发模式相同），输出条目吞吐（条/秒）。
+// --endpoints 可依次测量多个端点数，用于观察吞吐随推理服务数量的扩展。
+namespace {
+struct BenchOptions
+{
+    int entryCount = 600;
+    QString srtPath;
+    QList<int> endpointCounts;
+    int endpointConcurrency = 4;
+    int chunkSize = 20;
+    bool structuredOutput = false;
+    bool verbose = false;
+    LlmMockServerOptions mockOptions;
+};
+
+struct BenchResult
+{
+    int entries = 0;
+    int translated = 0;
+    double seconds = 0.0;
+    double entriesPerSecond = 0.0;
+    bool success = false;
+};
+
+bool g_verbose = false;
+
+// 执行器逐块输出的 qInfo 日志默认不显示，只保留警告与基准结果。
+void benchMessageHandler(QtMsgType type, const QMessageLogContext &, const QString &message)
+{
+    if (type == QtInfoMsg && !g_verbose) {
+        return;
+    }
+    QTextStream(stderr) << message << '\n';
+}
+
+bool parseIntOption(const QCommandLineParser &parser, const QString &name, int minimum, int *target, QString *errorMessage)
+{
+    if (!parser.isSet(name)) {
+        return true;
+    }
+    bool ok = false;
+    const int value = parser.value(name).toInt(&ok);
+    if (!ok || value < minimum) {
+        *errorMessage = QStringLiteral("--%1 的取值无效").arg(name);
+        return false;
+    }
+    *target = value;
+    return true;
+}
+
+bool parseOptions(const QStringList &arguments, BenchOptions *options, QString *errorMessage)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("翻译吞吐基准：本地模拟服务 + 并发翻译流程，输出条/秒"));
+    parser.addHelpOption();
+    parser.addOptions({
+        {QStringLiteral("entries"), QStringLiteral("生成的测试字幕条数，缺省 600"), QStringLiteral("count")},
+        {QStringLiteral("srt"), QStringLiteral("改用指定的 SRT 文件"), QStringLiteral("path")},
+        {QStringLiteral("endpoints"), QStringLiteral("依次测量的端点数，逗号分隔，缺省 1（如 1,2,4）"), QStringLiteral("list")},
+        {QStringLiteral("endpoint-concurrency"), QStringLiteral("每个端点的并发上限，缺省 4"), QStringLiteral("count")},
+        {QStringLiteral("chunk-size"), QStringLiteral("每个分块的条目数，缺省 20"), QStringLiteral("count")},
+        {QStringLiteral("latency-ms"), QStringLiteral("模拟服务首字节延迟，缺省 300"), QStringLiteral("ms")},
+        {QStringLiteral("tokens-per-sec"), QStringLiteral("模拟服务每个请求的输出速率，缺省 80"), QStringLiteral("count")},
+        {QStringLiteral("error-rate"), QStringLiteral("注入 HTTP 503 的百分比，缺省 0"), QStringLiteral("percent")},
+        {QStringLiteral("replay"), QStringLiteral("LlmTrafficRecorder 录制的 JSONL，命中的请求按录制回放"), QStringLiteral("path")},
+        {QStringLiteral("structured"), QStringLiteral("使用结构化输出（JSON Schema）")},
+        {QStringLiteral("verbose"), QStringLiteral("显示执行器日志")},
+    });
+    if (!parser.parse(arguments)) {
+        *errorMessage = parser.errorText();
+        return false;
+    }
+    if (parser.isSet(QStringLiteral("help"))) {
+        parser.showHelp(0);
+    }
+
+    BenchOptions result;
+    result.srtPath = parser.value(QStringLiteral("srt"));
+    result.structuredOutput = parser.isSet(QStringLiteral("structured"));
+    result.verbose = parser.isSet(QStringLiteral("verbose"));
+    result.mockOptions.replayPath = parser.value(QStringLiteral("replay"));
+    if (!parseIntOption(parser, QStringLiteral("entries"), 1, &result.entryCount, errorMessage)
+        || !parseIntOption(parser, QStringLiteral("endpoint-concurrency"), 1, &result.endpointConcurrency, errorMessage)
+        || !parseIntOption(parser, QStringLiteral("chunk-size"), 1, &result.chunkSize, errorMessage)
+        || !parseIntOption(parser, QStringLiteral("latency-ms"), 0, &result.mockOptions.firstByteLatencyMs, errorMessage)
+        || !parseIntOption(parser, QStringLiteral("tokens-per-sec"), 1, &result.mockOptions.tokensPerSecond, errorMessage)
+        || !parseIntOption(parser, QStringLiteral("error-rate"), 0, &result.mockOptions.errorRatePercent, errorMessage)) {
+        return false;
+    }
+    result.mockOptions.errorRatePercent = qMin(100, result.mockOptions.errorRatePercent);
+
+    const QStringList counts = parser.value(QStringLiteral("endpoints")).split(',', Qt::SkipEmptyParts);
+    for (const QString &countText : counts) {
+        bool ok = false;
+        const int count = countText.trimmed().toInt(&ok);
+        if (!ok || count < 1) {
+            *errorMessage = QStringLiteral("--endpoints 的取值无效：%1").arg(countText);
+            return false;
+        }
+        result.endpointCounts.append(count);
+    }
+    if (result.endpointCounts.isEmpty()) {
+        result.endpointCounts.append(1);
+    }
+
+    *options = result;
+    return true;
+}
+
+// 生成固定内容的测试字幕：句长与标点接近常见影视对白，每条 2 秒、间隔 0.5 秒。
+// 每条末尾带序号，避免翻译记忆命中重复原文而跳过请求。
+bool writeFixtureSrt(const QString &filePath, int entryCount)
+{
+    static const char *const kLines[] = {
+        "I told you we should have left before the storm.",
+        "Where did you put the keys to the truck?",
+        "Nobody in this town remembers what happened that night.",
+        "We have twenty minutes before the guards change shifts.",
+        "Dr. Harris will see you now, please follow me.",
+        "That's not what the report from March says.",
+        "If the bridge is out, we take the long road through Millbrook.",
+        "Thank you. I mean it, really.",
+    };
+    const int lineCount = static_cast<int>(sizeof(kLines) / sizeof(kLines[0]));
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        return false;
+    }
+    QTextStream out(&file);
+    out.setCodec("UTF-8");
+    for (int i = 0; i < entryCount; ++i) {
+        const qint64 startMs = i * 2500LL;
+        out << (i + 1) << '\n'
+            << SubtitleTimeline::fromMs(startMs) << " --> " << SubtitleTimeline::fromMs(startMs + 2000) << '\n'
+            << kLines[i % lineCount] << " (" << (i + 1) << ")\n\n";
+    }
+    return true;
+}
+
+BenchResult runOnce(const BenchOptions &options, const QString &srtPath, int endpointCount, const QString &workDirectory)
+{
+    BenchResult result;
+    QObject serverOwner;
+    QStringList hosts;
+    for (int i = 0; i < endpointCount; ++i) {
+        LlmMockServerOptions mockOptions = options.mockOptions;
+        mockOptions.port = 0;
+        LlmMockServer *server = new LlmMockServer(mockOptions, &serverOwner);
+        QString errorMessage;
+        if (!server->start(&errorMessage)) {
+            qWarning("模拟服务启动失败：%s", qPrintable(errorMessage));
+            return result;
+        }
+        hosts << QStringLiteral("http://127.0.0.1:%1/v1|1|%2").arg(server->port()).arg(options.endpointConcurrency);
+    }
+
+    const QString outputDirectory = QDir(workDirectory).filePath(QStringLiteral("endpoints_%1").arg(endpointCount));
+    const QString reportPath = QDir(outputDirectory).filePath(QStringLiteral("report.json"));
+    QStringList arguments;
+    arguments << QCoreApplication::applicationFilePath()
+              << QStringLiteral("--translate") << srtPath
+              << QStringLiteral("--host") << hosts.join(';')
+              << QStringLiteral("--model") << QStringLiteral("mock-model")
+              << QStringLiteral("--target-lang") << QStringLiteral("中文")
+              << QStringLiteral("--chunk-size") << QString::number(options.chunkSize)
+              << QStringLiteral("--parallel-files") << QStringLiteral("1")
+              << QStringLiteral("--output-dir") << outputDirectory
+              << QStringLiteral("--report") << reportPath;
+    if (options.structuredOutput) {
+        arguments << QStringLiteral("--structured");
+    }
+
+    HeadlessTranslationOptions runnerOptions;
+    QString errorMessage;
+    if (!HeadlessTranslationOptions::fromArguments(arguments, &runnerOptions, &errorMessage)) {
+        qWarning("%s", qPrintable(errorMessage));
+        return result;
+    }
+
+    HeadlessTranslationRunner runner(runnerOptions);
+    QEventLoop loop;
+    QObject::connect(&runner, &HeadlessTranslationRunner::finished, &loop, &QEventLoop::exit);
+    if (!runner.start(&errorMessage)) {
+        qWarning("%s", qPrintable(errorMessage));
+        return result;
+    }
+    result.success = loop.exec() == 0;
+
+    QFile reportFile(reportPath);
+    if (reportFile.open(QIODevice::ReadOnly)) {
+        const QJsonObject totals = QJsonDocument::fromJson(reportFile.readAll()).object().value(QStringLiteral("totals")).toObject();
+        result.entries = totals.value(QStringLiteral("entries")).toInt();
+        result.translated = totals.value(QStringLiteral("translated")).toInt();
+        result.seconds = totals.value(QStringLiteral("seconds")).toDouble();
+        result.entriesPerSecond = totals.value(QStringLiteral("entriesPerSecond")).toDouble();
+    }
+    return result;
+}
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    BenchOptions options;
+    QString errorMessage;
+    if (!parseOptions(application.arguments(), &options, &errorMessage)) {
+        QTextStream(stderr) << errorMessage << '\n';
+        return 2;
+    }
+    g_verbose = options.verbose;
+    qInstallMessageHandler(benchMessageHandler);
+
+    QTemporaryDir workDirectory;
+    if (!workDirectory.isValid()) {
+        QTextStream(stderr) << "无法创建临时目录\n";
+        return 2;
+    }
+    QString srtPath = options.srtPath;
+    if (srtPath.isEmpty()) {
+        srtPath = workDirectory.filePath(QStringLiteral("fixture.srt"));
+        if (!writeFixtureSrt(srtPath, options.entryCount)) {
+            QTextStream(stderr) << "无法写入测试字幕：" << srtPath << '\n';
+            return 2;
+        }
+    }
+
+    QTextStream out(stdout);
+    out << QStringLiteral("模拟服务：首字节 %1 ms，%2 token/s，错误注入 %3%；分块 %4 条，每端点并发 %5\n")
+               .arg(options.mockOptions.firstByteLatencyMs)
+               .arg(options.mockOptions.tokensPerSecond)
+               .arg(options.mockOptions.errorRatePercent)
+               .arg(options.chunkSize)
+               .arg(options.endpointConcurrency);
+    out << QStringLiteral("端点数\t在途上限\t译出/总条数\t用时(s)\t条/秒\t相对首行\n");
+    out.flush();
+
+    double baseline = 0.0;
+    int exitCode = 0;
+    for (int endpointCount : options.endpointCounts) {
+        const BenchResult result = runOnce(options, srtPath, endpointCount, workDirectory.path());
+        if (!result.success) {
+            exitCode = 1;
+        }
+        if (baseline <= 0.0) {
+            baseline = result.entriesPerSecond;
+        }
+        out << endpointCount << '\t'
+            << endpointCount * options.endpointConcurrency << '\t'
+            << result.translated << '/' << result.entries << '\t'
+            << QString::number(result.seconds, 'f', 2) << '\t'
+            << QString::number(result.entriesPerSecond, 'f', 2) << '\t'
+            << (baseline > 0.0 ? QString::number(result.entriesPerSecond / baseline, 'f', 2) + QLatin1Char('x')
+                               : QStringLiteral("-"))
+            << '\n';
+        out.flush();
+    }
+    return exitCode;
+}
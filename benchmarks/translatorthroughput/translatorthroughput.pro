@@ -0,0 +1,6 @@
+include(../translator.pri)
+
+TARGET = translatorthroughput
+
+SOURCES += \
+    main.cpp
@@ -19,12 +19,28 @@ DEFINES += QT_DEPRECATED_WARNINGS
 
 SOURCES += \
     src/Modules/Translator/apiformatmanager.cpp \
+    src/Modules/Translator/chattranslationbackend.cpp \
     src/Modules/Translator/translationflowstate.cpp \
     src/Core/dependencymanager.cpp \
     src/Core/executablecapabilities.cpp \
+    src/Core/logringbuffer.cpp \
+    src/Core/pipelinelogmodel.cpp \
     src/Modules/Loader/embeddedffmpegplayer.cpp \
+    src/Modules/Translator/headlesstranslationrunner.cpp \
+    src/Modules/Translator/llmbatchclient.cpp \
+    src/Modules/Translator/llmendpointpool.cpp \
+    src/Modules/Translator/llmmockserver.cpp \
     src/Modules/Translator/llmserviceclient.cpp \
+    src/Modules/Translator/llmtrafficrecorder.cpp \
+    src/Modules/Translator/modelroutingpolicy.cpp \
+    src/Modules/Translator/mttranslationbackend.cpp \
+    src/Modules/Translator/outputpanelmodel.cpp \
     src/Modules/Translator/promptrequestcomposer.cpp \
+    src/Modules/Translator/segmentwirecodec.cpp \
+    src/Modules/Translator/sselinescanner.cpp \
+    src/Modules/Translator/sentenceregrouper.cpp \
+    src/Modules/Translator/sourceeditdiff.cpp \
+    src/Modules/Translator/streamingcueparser.cpp \
     src/Modules/Translator/promptediting.cpp \
     src/Widgets/pageswitchconfirmdialog.cpp \
     src/main.cpp \
@@ -38,7 +54,13 @@ SOURCES += \
     src/Modules/Whisper/whispersegmentmerger.cpp \
     src/Modules/Whisper/whispercommandbuilder.cpp \
     src/Modules/Whisper/whisperruntimeselector.cpp \
+    src/Modules/Translator/subtitleentry.cpp \
     src/Modules/Translator/subtitletranslation.cpp \
+    src/Modules/Translator/translationdocumentstore.cpp \
+    src/Modules/Translator/translationsessionjournal.cpp \
+    src/Modules/Translator/translationtaskrunner.cpp \
+    src/Modules/Translator/translationmemory.cpp \
+    src/Modules/Translator/translationtelemetry.cpp \
     src/Modules/Downloder/videodownloadcommandbuilder.cpp \
     src/Modules/Downloder/videodownloadtaskrunner.cpp \
     src/Modules/Downloder/videodownloader.cpp \
@@ -46,12 +68,28 @@ SOURCES += \
 
 HEADERS += \
     src/Modules/Translator/apiformatmanager.h \
+    src/Modules/Translator/chattranslationbackend.h \
     src/Modules/Translator/translationflowstate.h \
     src/Core/dependencymanager.h \
     src/Core/executablecapabilities.h \
+    src/Core/logringbuffer.h \
+    src/Core/pipelinelogmodel.h \
     src/Modules/Loader/embeddedffmpegplayer.h \
+    src/Modules/Translator/headlesstranslationrunner.h \
+    src/Modules/Translator/llmbatchclient.h \
+    src/Modules/Translator/llmendpointpool.h \
+    src/Modules/Translator/llmmockserver.h \
     src/Modules/Translator/llmserviceclient.h \
+    src/Modules/Translator/llmtrafficrecorder.h \
+    src/Modules/Translator/modelroutingpolicy.h \
+    src/Modules/Translator/mttranslationbackend.h \
+    src/Modules/Translator/outputpanelmodel.h \
     src/Modules/Translator/promptrequestcomposer.h \
+    src/Modules/Translator/segmentwirecodec.h \
+    src/Modules/Translator/sselinescanner.h \
+    src/Modules/Translator/sentenceregrouper.h \
+    src/Modules/Translator/sourceeditdiff.h \
+    src/Modules/Translator/streamingcueparser.h \
     src/Modules/Translator/promptediting.h \
     src/Widgets/pageswitchconfirmdialog.h \
     src/mainwindow.h \
@@ -64,7 +102,14 @@ HEADERS += \
     src/Modules/Whisper/whispersegmentmerger.h \
     src/Modules/Whisper/whispercommandbuilder.h \
     src/Modules/Whisper/whisperruntimeselector.h \
+    src/Modules/Translator/subtitleentry.h \
     src/Modules/Translator/subtitletranslation.h \
+    src/Modules/Translator/translationdocumentstore.h \
+    src/Modules/Translator/translationsessionjournal.h \
+    src/Modules/Translator/translationtaskrunner.h \
+    src/Modules/Translator/translationbackend.h \
+    src/Modules/Translator/translationmemory.h \
+    src/Modules/Translator/translationtelemetry.h \
     src/Modules/Downloder/videodownloadcommandbuilder.h \
     src/Modules/Downloder/videodownloadtaskrunner.h \
     src/Modules/Downloder/videodownloader.h \
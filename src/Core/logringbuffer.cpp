@@ -0,0 +1,173 @@
+#include "logringbuffer.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+namespace {
+QString severityLabel(LogSeverity severity)
+{
+    switch (severity) {
+    case LogSeverity::Warning:
+        return QCoreApplication::translate("LogRingBuffer", "警告");
+    case LogSeverity::Error:
+        return QCoreApplication::translate("LogRingBuffer", "错误");
+    case LogSeverity::Info:
+        break;
+    }
+    return QCoreApplication::translate("LogRingBuffer", "信息");
+}
+}
+
+QString LogRecord::displayText() const
+{
+    const QString timestamp = QDateTime::fromMSecsSinceEpoch(timestampMs).toString(QStringLiteral("HH:mm:ss"));
+    switch (severity) {
+    case LogSeverity::Warning:
+        return QStringLiteral("[%1] %2%3").arg(timestamp, QCoreApplication::translate("LogRingBuffer", "[警告] "), text);
+    case LogSeverity::Error:
+        return QStringLiteral("[%1] %2%3").arg(timestamp, QCoreApplication::translate("LogRingBuffer", "[错误] "), text);
+    case LogSeverity::Info:
+        break;
+    }
+    return QStringLiteral("[%1] %2").arg(timestamp, text);
+}
+
+QString LogRecord::spillText() const
+{
+    return QStringLiteral("%1 %2 [%3] %4")
+        .arg(QDateTime::fromMSecsSinceEpoch(timestampMs).toString(QStringLiteral("yyyy-MM-dd HH:mm:ss.zzz")),
+             severityLabel(severity),
+             module,
+             text);
+}
+
+LogRingBuffer::LogRingBuffer(int capacity)
+    : m_capacity(qMax(1, capacity))
+{
+    m_records.resize(m_capacity);
+}
+
+LogRingBuffer::~LogRingBuffer()
+{
+    closeSpillFile();
+}
+
+int LogRingBuffer::capacity() const
+{
+    return m_capacity;
+}
+
+void LogRingBuffer::setCapacity(int capacity)
+{
+    capacity = qMax(1, capacity);
+    if (capacity == m_capacity) {
+        return;
+    }
+
+    const int keep = qMin(m_size, capacity);
+    QVector<LogRecord> records(capacity);
+    for (int i = 0; i < keep; ++i) {
+        records[i] = at(m_size - keep + i);
+    }
+    m_records = records;
+    m_capacity = capacity;
+    m_head = 0;
+    m_size = keep;
+}
+
+int LogRingBuffer::size() const
+{
+    return m_size;
+}
+
+bool LogRingBuffer::isEmpty() const
+{
+    return m_size == 0;
+}
+
+bool LogRingBuffer::isFull() const
+{
+    return m_size == m_capacity;
+}
+
+const LogRecord &LogRingBuffer::at(int index) const
+{
+    return m_records.at((m_head + index) % m_capacity);
+}
+
+void LogRingBuffer::append(const LogRecord &record)
+{
+    if (isFull()) {
+        removeOldest();
+    }
+    m_records[(m_head + m_size) % m_capacity] = record;
+    ++m_size;
+
+    if (m_spillFile) {
+        m_spillFile->write(record.spillText().toUtf8());
+        m_spillFile->write("\n", 1);
+        ++m_spilledCount;
+        // 普通记录由文件缓冲批量写出；警告与错误立即落盘，异常退出时也能保留。
+        if (record.severity != LogSeverity::Info) {
+            m_spillFile->flush();
+        }
+    }
+}
+
+void LogRingBuffer::removeOldest()
+{
+    if (m_size == 0) {
+        return;
+    }
+    m_records[m_head] = LogRecord();
+    m_head = (m_head + 1) % m_capacity;
+    --m_size;
+}
+
+void LogRingBuffer::clear()
+{
+    m_records = QVector<LogRecord>(m_capacity);
+    m_head = 0;
+    m_size = 0;
+}
+
+bool LogRingBuffer::setSpillPath(const QString &path)
+{
+    closeSpillFile();
+    m_spilledCount = 0;
+    if (path.isEmpty()) {
+        return true;
+    }
+
+    if (!QDir().mkpath(QFileInfo(path).absolutePath())) {
+        return false;
+    }
+    std::unique_ptr<QFile> file(new QFile(path));
+    if (!file->open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        return false;
+    }
+    m_spillFile = std::move(file);
+    return true;
+}
+
+QString LogRingBuffer::spillPath() const
+{
+    return m_spillFile ? m_spillFile->fileName() : QString();
+}
+
+qint64 LogRingBuffer::spilledCount() const
+{
+    return m_spilledCount;
+}
+
+void LogRingBuffer::closeSpillFile()
+{
+    if (m_spillFile) {
+        m_spillFile->flush();
+        m_spillFile->close();
+        m_spillFile.reset();
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef LOGRINGBUFFER_H
+#define LOGRINGBUFFER_H
+
+#include <QString>
+#include <QVector>
+
+#include <memory>
+
+class QFile;
+
+enum class LogSeverity {
+    Info,
+    Warning,
+    Error
+};
+
+struct LogRecord {
+    qint64 timestampMs = 0;
+    LogSeverity severity = LogSeverity::Info;
+    // 来源模块（whisper / download / translator ...），写入落盘文件。
+    QString module;
+    QString text;
+
+    // 界面显示的一行："[hh:mm:ss] 文本"，警告与错误带级别标记。
+    QString displayText() const;
+    // 落盘的一行：完整日期、级别与模块。
+    QString spillText() const;
+};
+
+// 固定容量的日志环形缓冲：满后淘汰最旧一条，内存占用与任务时长无关。
+// 设置落盘路径后每条记录同时追加写入文件，完整历史保存在磁盘上。
+class LogRingBuffer {
+public:
+    explicit LogRingBuffer(int capacity = 2000);
+    ~LogRingBuffer();
+
+    LogRingBuffer(const LogRingBuffer &) = delete;
+    LogRingBuffer &operator=(const LogRingBuffer &) = delete;
+
+    int capacity() const;
+    // 缩小容量时保留最新的记录。
+    void setCapacity(int capacity);
+    int size() const;
+    bool isEmpty() const;
+    bool isFull() const;
+    // 0 为最旧一条。
+    const LogRecord &at(int index) const;
+
+    // 追加一条；已满时先淘汰最旧一条（调用方需要行号变化时先调用 removeOldest()）。
+    void append(const LogRecord &record);
+    void removeOldest();
+    // 清空内存中的记录，落盘文件不受影响。
+    void clear();
+
+    // 落盘文件（追加写入，目录不存在时创建）；传空串关闭落盘。无法打开时返回 false。
+    bool setSpillPath(const QString &path);
+    QString spillPath() const;
+    // 自落盘开始以来写入的记录数（含已被淘汰的）。
+    qint64 spilledCount() const;
+
+private:
+    void closeSpillFile();
+
+    QVector<LogRecord> m_records;
+    int m_head = 0;
+    int m_size = 0;
+    int m_capacity = 0;
+    std::unique_ptr<QFile> m_spillFile;
+    qint64 m_spilledCount = 0;
+};
+
+#endif // LOGRINGBUFFER_H
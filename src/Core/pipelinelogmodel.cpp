@@ -0,0 +1,232 @@
+#include "pipelinelogmodel.h"
+
+#include <QBrush>
+#include <QColor>
+#include <QDateTime>
+#include <QDir>
+
+#include <algorithm>
+
+PipelineLogModel::PipelineLogModel(const QString &module, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_module(module)
+    , m_spillDirectory(QDir::currentPath() + QStringLiteral("/output/logs"))
+{
+}
+
+int PipelineLogModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    if (isEmpty()) {
+        return m_placeholderText.isEmpty() ? 0 : 1;
+    }
+    return m_records.size() + m_activeKeys.size();
+}
+
+QVariant PipelineLogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= rowCount()) {
+        return QVariant();
+    }
+
+    if (isEmpty()) {
+        if (role == Qt::DisplayRole) {
+            return m_placeholderText;
+        }
+        if (role == Qt::ForegroundRole) {
+            return QBrush(QColor(QStringLiteral("#9AA0A6")));
+        }
+        return QVariant();
+    }
+
+    const int row = index.row();
+    if (row >= m_records.size()) {
+        if (role == Qt::DisplayRole || role == Qt::ToolTipRole) {
+            return m_activeLines.value(m_activeKeys.at(row - m_records.size()));
+        }
+        return QVariant();
+    }
+
+    // 只在视图请求时格式化，不可见的行不产生字符串。
+    const LogRecord &record = m_records.at(row);
+    if (role == Qt::DisplayRole || role == Qt::ToolTipRole) {
+        return record.displayText();
+    }
+    if (role == Qt::ForegroundRole && record.severity != LogSeverity::Info) {
+        return QBrush(QColor(record.severity == LogSeverity::Error ? QStringLiteral("#D93025")
+                                                                   : QStringLiteral("#B06000")));
+    }
+    return QVariant();
+}
+
+void PipelineLogModel::append(const QString &text, LogSeverity severity)
+{
+    LogRecord record;
+    record.timestampMs = QDateTime::currentMSecsSinceEpoch();
+    record.severity = severity;
+    record.module = m_module;
+    record.text = text;
+    openSpillFileIfNeeded();
+
+    if (isEmpty() && !m_placeholderText.isEmpty()) {
+        beginResetModel();
+        m_records.append(record);
+        endResetModel();
+        return;
+    }
+
+    if (m_records.isFull()) {
+        beginRemoveRows(QModelIndex(), 0, 0);
+        m_records.removeOldest();
+        endRemoveRows();
+    }
+    const int row = m_records.size();
+    beginInsertRows(QModelIndex(), row, row);
+    m_records.append(record);
+    endInsertRows();
+}
+
+void PipelineLogModel::setActiveLine(const QString &key, const QString &text)
+{
+    const int existingRow = activeRow(key);
+    if (existingRow >= 0) {
+        if (m_activeLines.value(key) != text) {
+            m_activeLines.insert(key, text);
+            const QModelIndex changed = index(existingRow);
+            emit dataChanged(changed, changed);
+        }
+        return;
+    }
+
+    if (isEmpty() && !m_placeholderText.isEmpty()) {
+        beginResetModel();
+        m_activeKeys.append(key);
+        m_activeLines.insert(key, text);
+        endResetModel();
+        return;
+    }
+
+    const int row = m_records.size() + m_activeKeys.size();
+    beginInsertRows(QModelIndex(), row, row);
+    m_activeKeys.append(key);
+    m_activeLines.insert(key, text);
+    endInsertRows();
+}
+
+void PipelineLogModel::removeActiveLine(const QString &key)
+{
+    const int row = activeRow(key);
+    if (row < 0) {
+        return;
+    }
+
+    if (m_records.isEmpty() && m_activeKeys.size() == 1 && !m_placeholderText.isEmpty()) {
+        beginResetModel();
+        m_activeKeys.clear();
+        m_activeLines.clear();
+        endResetModel();
+        return;
+    }
+
+    beginRemoveRows(QModelIndex(), row, row);
+    m_activeKeys.removeAt(row - m_records.size());
+    m_activeLines.remove(key);
+    endRemoveRows();
+}
+
+void PipelineLogModel::clearActiveLines()
+{
+    if (m_activeKeys.isEmpty()) {
+        return;
+    }
+
+    beginResetModel();
+    m_activeKeys.clear();
+    m_activeLines.clear();
+    endResetModel();
+}
+
+void PipelineLogModel::beginSession()
+{
+    beginResetModel();
+    m_records.clear();
+    m_activeKeys.clear();
+    m_activeLines.clear();
+    endResetModel();
+    m_spillPending = true;
+}
+
+void PipelineLogModel::setCapacity(int capacity)
+{
+    beginResetModel();
+    m_records.setCapacity(capacity);
+    endResetModel();
+}
+
+void PipelineLogModel::setSpillDirectory(const QString &directory)
+{
+    m_spillDirectory = directory;
+    m_records.setSpillPath(QString());
+    m_spillPending = true;
+}
+
+QString PipelineLogModel::spillFilePath() const
+{
+    return m_records.spillPath();
+}
+
+void PipelineLogModel::setPlaceholderText(const QString &text)
+{
+    beginResetModel();
+    m_placeholderText = text;
+    endResetModel();
+}
+
+QString PipelineLogModel::textForRows(const QModelIndexList &indexes) const
+{
+    QVector<int> rows;
+    rows.reserve(indexes.size());
+    for (const QModelIndex &modelIndex : indexes) {
+        rows.append(modelIndex.row());
+    }
+    std::sort(rows.begin(), rows.end());
+
+    QStringList lines;
+    lines.reserve(rows.size());
+    for (int row : rows) {
+        lines.append(data(index(row), Qt::DisplayRole).toString());
+    }
+    return lines.join('\n');
+}
+
+bool PipelineLogModel::isEmpty() const
+{
+    return m_records.isEmpty() && m_activeKeys.isEmpty();
+}
+
+int PipelineLogModel::activeRow(const QString &key) const
+{
+    const int position = m_activeKeys.indexOf(key);
+    return position < 0 ? -1 : m_records.size() + position;
+}
+
+void PipelineLogModel::openSpillFileIfNeeded()
+{
+    if (!m_spillPending) {
+        return;
+    }
+
+    m_spillPending = false;
+    if (m_spillDirectory.isEmpty()) {
+        m_records.setSpillPath(QString());
+        return;
+    }
+    const QString fileName = QStringLiteral("%1_%2.log")
+                                 .arg(m_module, QDateTime::currentDateTime().toString(QStringLiteral("yyyyMMdd_HHmmss")));
+    const QString filePath = QDir(m_spillDirectory).filePath(fileName);
+    if (!m_records.setSpillPath(filePath)) {
+        qWarning("%s", qPrintable(tr("日志落盘文件无法打开：%1").arg(filePath)));
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef PIPELINELOGMODEL_H
+#define PIPELINELOGMODEL_H
+
+#include "logringbuffer.h"
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QModelIndexList>
+#include <QStringList>
+
+// 各页面共用的日志模型：历史记录存于固定容量的环形缓冲，活动行（进行中的分段、下载任务）固定显示在末尾并原位更新。
+// 配合统一行高的 QListView 只格式化、绘制可见行；追加只插入一行，不重排已有内容。
+// 每个会话的完整历史追加写入 <落盘目录>/<模块>_<时间>.log。
+class PipelineLogModel : public QAbstractListModel {
+    Q_OBJECT
+public:
+    explicit PipelineLogModel(const QString &module, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    void append(const QString &text, LogSeverity severity = LogSeverity::Info);
+    // 设置或更新一条活动行（key 相同则原位替换），显示在历史记录之后。
+    void setActiveLine(const QString &key, const QString &text);
+    void removeActiveLine(const QString &key);
+    void clearActiveLines();
+
+    // 开始新会话：清空记录与活动行，下一条记录写入新的落盘文件。
+    void beginSession();
+    void setCapacity(int capacity);
+    // 落盘目录，缺省为 <当前目录>/output/logs；传空串关闭落盘。
+    void setSpillDirectory(const QString &directory);
+    // 当前会话的落盘文件；尚未写入任何记录时为空。
+    QString spillFilePath() const;
+    // 没有任何记录与活动行时显示的占位行。
+    void setPlaceholderText(const QString &text);
+    // 按行号顺序拼接所选行的文本（复制用）。
+    QString textForRows(const QModelIndexList &indexes) const;
+
+private:
+    bool isEmpty() const;
+    int activeRow(const QString &key) const;
+    void openSpillFileIfNeeded();
+
+    QString m_module;
+    LogRingBuffer m_records;
+    QStringList m_activeKeys;
+    QHash<QString, QString> m_activeLines;
+    QString m_placeholderText;
+    QString m_spillDirectory;
+    bool m_spillPending = true;
+};
+
+#endif // PIPELINELOGMODEL_H
@@ -15,6 +15,7 @@
 #include <QTransform>
 
 #include "../../Core/dependencymanager.h"
+#include "../../Core/pipelinelogmodel.h"
 
 SubtitleBurning::SubtitleBurning(QWidget *parent) :
     QWidget(parent),
@@ -40,11 +41,13 @@ SubtitleBurning::SubtitleBurning(QWidget *parent) :
     connect(m_burnTaskRunner, &SubtitleBurnTaskRunner::taskStarted, this, [this]() {
         updateRunningStateUi(true);
     });
-    connect(m_burnTaskRunner, &SubtitleBurnTaskRunner::taskLog, this, &SubtitleBurning::appendLogLine);
+    connect(m_burnTaskRunner, &SubtitleBurnTaskRunner::taskLog, this, [this](const QString &message) {
+        appendLogLine(message);
+    });
     connect(m_burnTaskRunner, &SubtitleBurnTaskRunner::taskFinished, this,
             [this](bool success, const QString &message) {
                 updateRunningStateUi(false);
-                appendLogLine(message);
+                appendLogLine(message, success ? LogSeverity::Info : LogSeverity::Error);
                 if (!success) {
                     QMessageBox::warning(this, tr("字幕烧录"), message);
                 }
@@ -110,10 +113,9 @@ void SubtitleBurning::setupBurnWorkflowUi()
 
     populateContainerOptions();
 
-    if (ui->logTextEdit) {
-        ui->logTextEdit->clear();
-        ui->logTextEdit->append(tr("就绪：请选择视频与字幕后开始压制。"));
-    }
+    m_logModel = new PipelineLogModel(QStringLiteral("burner"), this);
+    m_logModel->setPlaceholderText(tr("就绪：请选择视频与字幕后开始压制。"));
+    ui->logListView->setModel(m_logModel);
 
     if (ui->cancelBurnButton) {
         ui->cancelBurnButton->setEnabled(false);
@@ -253,13 +255,14 @@ void SubtitleBurning::updateRunningStateUi(bool running)
     }
 }
 
-void SubtitleBurning::appendLogLine(const QString &message)
+void SubtitleBurning::appendLogLine(const QString &message, LogSeverity severity)
 {
-    if (!ui || !ui->logTextEdit || message.trimmed().isEmpty()) {
+    if (!m_logModel || message.trimmed().isEmpty()) {
         return;
     }
 
-    ui->logTextEdit->append(message);
+    m_logModel->append(message, severity);
+    ui->logListView->scrollToBottom();
 }
 
 QString SubtitleBurning::defaultVideoImportDirectory() const
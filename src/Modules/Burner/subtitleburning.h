@@ -5,7 +5,10 @@
 #include <QIcon>
 #include <QString>
 
+#include "../../Core/logringbuffer.h"
+
 class QTimer;
+class PipelineLogModel;
 class SubtitleBurnTaskRunner;
 class EmbeddedFfmpegPlayer;
 
@@ -31,12 +34,13 @@ private:
     QString m_externalSubtitlePath;
     SubtitleBurnTaskRunner *m_burnTaskRunner = nullptr;
     EmbeddedFfmpegPlayer *m_previewPlayer = nullptr;
+    PipelineLogModel *m_logModel = nullptr;
 
     void setToolsLoading(bool loading);
     void updateToolsSpinner();
     void setupBurnWorkflowUi();
     void updateRunningStateUi(bool running);
-    void appendLogLine(const QString &message);
+    void appendLogLine(const QString &message, LogSeverity severity = LogSeverity::Info);
     QString defaultVideoImportDirectory() const;
     QString defaultSubtitleImportDirectory() const;
     void saveLastVideoImportDirectory(const QString &filePath);
@@ -2,6 +2,7 @@
 #include "ui_videodownloader.h"
 #include "videodownloadtaskrunner.h"
 
+#include <QAction>
 #include <QApplication>
 #include <QClipboard>
 #include <QDateTime>
@@ -13,16 +14,17 @@
 #include <QHeaderView>
 #include <QHBoxLayout>
 #include <QInputDialog>
+#include <QKeySequence>
 #include <QLabel>
 #include <QMessageBox>
 #include <QRegularExpression>
-#include <QScrollBar>
 #include <QTimer>
 #include <QTreeWidgetItem>
 #include <QTransform>
 #include <QToolButton>
 
 #include "../../Core/dependencymanager.h"
+#include "../../Core/pipelinelogmodel.h"
 
 namespace {
 constexpr int RoleUrl = Qt::UserRole + 1;
@@ -200,6 +202,15 @@ void VideoDownloader::setupDownloadUi()
         ui->cancelButton->setEnabled(false);
     }
 
+    m_logModel = new PipelineLogModel(QStringLiteral("download"), this);
+    ui->logListView->setModel(m_logModel);
+    QAction *copyRowsAction = new QAction(QStringLiteral("复制选中行"), ui->logListView);
+    copyRowsAction->setShortcut(QKeySequence::Copy);
+    copyRowsAction->setShortcutContext(Qt::WidgetShortcut);
+    connect(copyRowsAction, &QAction::triggered, this, &VideoDownloader::copySelectedLogRows);
+    ui->logListView->addAction(copyRowsAction);
+    ui->logListView->setContextMenuPolicy(Qt::ActionsContextMenu);
+
     appendLog(QStringLiteral("下载模块已就绪。"));
 
     connect(ui->pasteButton, &QPushButton::clicked, this, [this]() {
@@ -416,49 +427,31 @@ void VideoDownloader::updateRunningStateUi(bool running)
     refreshActionButtons();
 }
 
-void VideoDownloader::appendLog(const QString &line)
+void VideoDownloader::appendLog(const QString &line, LogSeverity severity)
 {
-    if (!ui || !ui->logTextEdit || line.trimmed().isEmpty()) {
+    if (!m_logModel || line.trimmed().isEmpty()) {
         return;
     }
 
-    const QString timestamp = QDateTime::currentDateTime().toString(QStringLiteral("HH:mm:ss"));
-    m_logHistory << QStringLiteral("[%1] %2").arg(timestamp, line);
-    renderLogConsole();
+    m_logModel->append(line, severity);
+    followLogConsole();
 }
 
-void VideoDownloader::renderLogConsole()
+void VideoDownloader::followLogConsole()
 {
-    if (!ui || !ui->logTextEdit) {
-        return;
+    if (ui && ui->logListView) {
+        ui->logListView->scrollToBottom();
     }
+}
 
-    QStringList lines = m_logHistory;
-
-    // 活动任务行始终渲染在底部，效果对齐 Whisper 的“活动行 + 历史行”展示。
-    if (ui->downloadsTree) {
-        const int count = ui->downloadsTree->topLevelItemCount();
-        for (int i = 0; i < count; ++i) {
-            QTreeWidgetItem *item = ui->downloadsTree->topLevelItem(i);
-            if (!item) {
-                continue;
-            }
-
-            VideoDownloadTaskRunner *runner = runnerForItem(item);
-            if (!runner) {
-                continue;
-            }
-
-            const QString activeLine = m_activeTaskLogLines.value(runner).trimmed();
-            if (!activeLine.isEmpty()) {
-                lines << activeLine;
-            }
-        }
+void VideoDownloader::copySelectedLogRows()
+{
+    const QModelIndexList selected = ui->logListView->selectionModel()->selectedIndexes();
+    if (selected.isEmpty()) {
+        return;
     }
-
-    ui->logTextEdit->setPlainText(lines.join("\n"));
-    if (ui->logTextEdit->verticalScrollBar()) {
-        ui->logTextEdit->verticalScrollBar()->setValue(ui->logTextEdit->verticalScrollBar()->maximum());
+    if (QClipboard *clipboard = QApplication::clipboard()) {
+        clipboard->setText(m_logModel->textForRows(selected));
     }
 }
 
@@ -689,7 +682,7 @@ bool VideoDownloader::buildRequestForItem(QTreeWidgetItem *item, QString *errorM
         }
 
         clearActiveTaskLogLine(runner);
-        appendLog(message);
+        appendLog(message, success || canceled ? LogSeverity::Info : LogSeverity::Error);
         runner->deleteLater();
         refreshActionButtons();
 
@@ -915,7 +908,7 @@ void VideoDownloader::schedulePendingTasks()
         if (!buildRequestForItem(pendingItem, &errorMessage)) {
             setItemStatus(pendingItem, pendingItem->text(1), QStringLiteral("失败"));
             pendingItem->setData(0, RoleStatus, QString::fromLatin1(StatusFailed));
-            appendLog(errorMessage);
+            appendLog(errorMessage, LogSeverity::Error);
         }
     }
 
@@ -1066,9 +1059,10 @@ void VideoDownloader::refreshActiveTaskLogLine(VideoDownloadTaskRunner *runner)
                                  .arg(taskItem->text(4).trimmed().isEmpty() ? QStringLiteral("--") : taskItem->text(4).trimmed())
                                  .arg(taskItem->text(5).trimmed().isEmpty() ? QStringLiteral("--") : taskItem->text(5).trimmed());
 
-    m_activeTaskLogLines[runner] = QStringLiteral("[%1] %2 | %3 | 速度 %4 | %5 | %6")
-                                       .arg(timestamp, fileText, progressText, speedText, statusText, metaText);
-    renderLogConsole();
+    m_logModel->setActiveLine(QString::number(reinterpret_cast<quintptr>(runner)),
+                              QStringLiteral("[%1] %2 | %3 | 速度 %4 | %5 | %6")
+                                  .arg(timestamp, fileText, progressText, speedText, statusText, metaText));
+    followLogConsole();
 }
 
 void VideoDownloader::clearActiveTaskLogLine(VideoDownloadTaskRunner *runner)
@@ -1077,8 +1071,7 @@ void VideoDownloader::clearActiveTaskLogLine(VideoDownloadTaskRunner *runner)
         return;
     }
 
-    m_activeTaskLogLines.remove(runner);
+    m_logModel->removeActiveLine(QString::number(reinterpret_cast<quintptr>(runner)));
     m_runnerSpeedText.remove(runner);
     m_runnerProgressPercent.remove(runner);
-    renderLogConsole();
 }
@@ -6,7 +6,10 @@
 #include <QHash>
 #include <QStringList>
 
+#include "../../Core/logringbuffer.h"
+
 class QTimer;
+class PipelineLogModel;
 class QTreeWidgetItem;
 class VideoDownloadTaskRunner;
 class QComboBox;
@@ -39,8 +42,8 @@ private:
     bool m_toolsLoading = false;
     int m_maxParallelTasks = 5;
     QHash<VideoDownloadTaskRunner *, QTreeWidgetItem *> m_runningTaskMap;
-    QStringList m_logHistory;
-    QHash<VideoDownloadTaskRunner *, QString> m_activeTaskLogLines;
+    /// @brief 日志框模型：历史记录（固定容量，完整历史落盘）+ 运行中任务的活动行
+    PipelineLogModel *m_logModel = nullptr;
     QHash<VideoDownloadTaskRunner *, QString> m_runnerSpeedText;
     QHash<VideoDownloadTaskRunner *, int> m_runnerProgressPercent;
     QComboBox *m_cookieModeComboBox = nullptr;
@@ -60,9 +63,11 @@ private:
     void updateRunningStateUi(bool running);
 
     /// @brief 追加一行日志到日志框
-    void appendLog(const QString &line);
-    /// @brief 重新渲染日志框（历史在上、活动任务行在下）
-    void renderLogConsole();
+    void appendLog(const QString &line, LogSeverity severity = LogSeverity::Info);
+    /// @brief 日志框滚动到末尾（历史在上、活动任务行在下）
+    void followLogConsole();
+    /// @brief 复制日志框中选中的行
+    void copySelectedLogRows();
     /// @brief 将输入框中的 URL 加入下载队列
     void enqueueUrlFromInput(bool fromClipboard);
     /// @brief 创建队列项
@@ -1,5 +1,7 @@
 #include "apiformatmanager.h"
 
+#include <QJsonDocument>
+
 namespace {
 QString normalized(const QString &text)
 {
@@ -18,6 +20,36 @@ bool isEmptyOption(const QJsonValue &value)
 
     return false;
 }
+
+// Ollama /api/chat 只从 options 对象读取的运行参数。
+bool isOllamaRuntimeOption(const QString &key)
+{
+    return key == QStringLiteral("temperature")
+           || key == QStringLiteral("top_p")
+           || key == QStringLiteral("top_k")
+           || key == QStringLiteral("seed")
+           || key == QStringLiteral("num_ctx")
+           || key == QStringLiteral("num_predict");
+}
+
+// 仅本地服务识别的常驻参数；发给云端接口会被视为未知字段而拒绝。
+bool isResidencyOption(const QString &key)
+{
+    return key == QStringLiteral("keep_alive")
+           || key == QStringLiteral("num_ctx")
+           || key == QStringLiteral("ttl");
+}
+
+bool acceptsResidencyOption(const QString &providerId, const QString &key)
+{
+    if (providerId == QStringLiteral("ollama")) {
+        return key == QStringLiteral("keep_alive") || key == QStringLiteral("num_ctx");
+    }
+    if (providerId == QStringLiteral("lmstudio")) {
+        return key == QStringLiteral("ttl");
+    }
+    return false;
+}
 }
 
 QString ApiFormatManager::providerId(const QString &provider, const QString &baseUrl)
@@ -60,11 +92,79 @@ QString ApiFormatManager::chatEndpoint(const QString &providerId)
     return QStringLiteral("/chat/completions");
 }
 
+bool ApiFormatManager::supportsJsonSchema(const QString &providerId)
+{
+    return providerId != QStringLiteral("deepseek");
+}
+
+bool ApiFormatManager::supportsBatch(const QString &providerId)
+{
+    return providerId == QStringLiteral("openai") || providerId == QStringLiteral("openai_compatible");
+}
+
+QString ApiFormatManager::batchFilesEndpoint()
+{
+    return QStringLiteral("/files");
+}
+
+QString ApiFormatManager::batchesEndpoint()
+{
+    return QStringLiteral("/batches");
+}
+
+QString ApiFormatManager::batchStatusEndpoint(const QString &batchId)
+{
+    return QStringLiteral("/batches/%1").arg(batchId);
+}
+
+QString ApiFormatManager::batchCancelEndpoint(const QString &batchId)
+{
+    return QStringLiteral("/batches/%1/cancel").arg(batchId);
+}
+
+QString ApiFormatManager::batchFileContentEndpoint(const QString &fileId)
+{
+    return QStringLiteral("/files/%1/content").arg(fileId);
+}
+
+QString ApiFormatManager::batchRequestUrl()
+{
+    return QStringLiteral("/v1/chat/completions");
+}
+
+QByteArray ApiFormatManager::buildBatchRequestLine(const QString &customId, const QJsonObject &chatBody)
+{
+    // 批任务不支持流式，也不需要流式 usage 选项。
+    QJsonObject body = chatBody;
+    body.remove(QStringLiteral("stream"));
+    body.remove(QStringLiteral("stream_options"));
+
+    QJsonObject line;
+    line.insert(QStringLiteral("custom_id"), customId);
+    line.insert(QStringLiteral("method"), QStringLiteral("POST"));
+    line.insert(QStringLiteral("url"), batchRequestUrl());
+    line.insert(QStringLiteral("body"), body);
+    return QJsonDocument(line).toJson(QJsonDocument::Compact);
+}
+
+QJsonObject ApiFormatManager::defaultResidencyOptions(const QString &providerId)
+{
+    QJsonObject options;
+    if (providerId == QStringLiteral("ollama")) {
+        options.insert(QStringLiteral("keep_alive"), QStringLiteral("30m"));
+        options.insert(QStringLiteral("num_ctx"), 8192);
+    } else if (providerId == QStringLiteral("lmstudio")) {
+        options.insert(QStringLiteral("ttl"), 1800);
+    }
+    return options;
+}
+
 QJsonObject ApiFormatManager::buildChatBody(const QString &providerId,
                                             const QString &model,
                                             bool stream,
                                             const QJsonArray &messages,
-                                            const QJsonObject &options)
+                                            const QJsonObject &options,
+                                            const QJsonObject &responseSchema)
 {
     QJsonObject body;
     body.insert(QStringLiteral("messages"), messages);
@@ -75,11 +175,29 @@ QJsonObject ApiFormatManager::buildChatBody(const QString &providerId,
         body.insert(QStringLiteral("model"), trimmedModel);
     }
 
-    for (auto it = options.constBegin(); it != options.constEnd(); ++it) {
+    QJsonObject effectiveOptions = options;
+    const QJsonObject residencyDefaults = defaultResidencyOptions(providerId);
+    for (auto it = residencyDefaults.constBegin(); it != residencyDefaults.constEnd(); ++it) {
+        if (!effectiveOptions.contains(it.key())) {
+            effectiveOptions.insert(it.key(), it.value());
+        }
+    }
+
+    QJsonObject ollamaOptions;
+    for (auto it = effectiveOptions.constBegin(); it != effectiveOptions.constEnd(); ++it) {
         if (it.key().trimmed().isEmpty() || isEmptyOption(it.value())) {
             continue;
         }
 
+        if (isResidencyOption(it.key()) && !acceptsResidencyOption(providerId, it.key())) {
+            continue;
+        }
+
+        if (providerId == QStringLiteral("ollama") && isOllamaRuntimeOption(it.key())) {
+            ollamaOptions.insert(it.key(), it.value());
+            continue;
+        }
+
         if (it.key() == QStringLiteral("max_tokens") && it.value().toInt() <= 0) {
             continue;
         }
@@ -104,8 +222,46 @@ QJsonObject ApiFormatManager::buildChatBody(const QString &providerId,
         body.insert(it.key(), it.value());
     }
 
+    // OpenAI 兼容接口的流式响应默认不带 usage，需显式请求；其它兼容服务未必支持该字段，不附加。
+    if (stream
+        && (providerId == QStringLiteral("openai")
+            || providerId == QStringLiteral("deepseek")
+            || providerId == QStringLiteral("lmstudio"))) {
+        QJsonObject streamOptions;
+        streamOptions.insert(QStringLiteral("include_usage"), true);
+        body.insert(QStringLiteral("stream_options"), streamOptions);
+    }
+
     if (providerId == QStringLiteral("ollama")) {
         body.remove(QStringLiteral("max_tokens"));
+        if (!ollamaOptions.isEmpty()) {
+            body.insert(QStringLiteral("options"), ollamaOptions);
+        }
+    }
+
+    if (!responseSchema.isEmpty()) {
+        if (providerId == QStringLiteral("ollama")) {
+            body.insert(QStringLiteral("format"), responseSchema);
+        } else if (!supportsJsonSchema(providerId)) {
+            QJsonObject responseFormat;
+            responseFormat.insert(QStringLiteral("type"), QStringLiteral("json_object"));
+            body.insert(QStringLiteral("response_format"), responseFormat);
+        } else {
+            QString schemaName = responseSchema.value(QStringLiteral("title")).toString().trimmed();
+            if (schemaName.isEmpty()) {
+                schemaName = QStringLiteral("structured_output");
+            }
+
+            QJsonObject jsonSchema;
+            jsonSchema.insert(QStringLiteral("name"), schemaName);
+            jsonSchema.insert(QStringLiteral("strict"), true);
+            jsonSchema.insert(QStringLiteral("schema"), responseSchema);
+
+            QJsonObject responseFormat;
+            responseFormat.insert(QStringLiteral("type"), QStringLiteral("json_schema"));
+            responseFormat.insert(QStringLiteral("json_schema"), jsonSchema);
+            body.insert(QStringLiteral("response_format"), responseFormat);
+        }
     }
 
     return body;
@@ -1,6 +1,7 @@
 #ifndef APIFORMATMANAGER_H
 #define APIFORMATMANAGER_H
 
+#include <QByteArray>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QString>
@@ -15,12 +16,35 @@ public:
     // 返回对话补全接口路径（如 /v1/chat/completions）。
     static QString chatEndpoint(const QString &providerId);
 
+    // Provider 是否支持按 JSON Schema 约束输出（DeepSeek 仅支持 json_object 模式）。
+    static bool supportsJsonSchema(const QString &providerId);
+
+    // Provider 是否提供 OpenAI 兼容的批量接口（/files + /batches）；Ollama、LM Studio 与 DeepSeek 没有。
+    static bool supportsBatch(const QString &providerId);
+    // 批量接口路径：上传输入文件、创建 / 查询批任务、下载结果文件（相对于基础地址）。
+    static QString batchFilesEndpoint();
+    static QString batchesEndpoint();
+    static QString batchStatusEndpoint(const QString &batchId);
+    static QString batchCancelEndpoint(const QString &batchId);
+    static QString batchFileContentEndpoint(const QString &fileId);
+    // 批任务中每行请求的目标接口（OpenAI 要求写完整路径，与基础地址无关）。
+    static QString batchRequestUrl();
+    // 批量输入文件的一行：{"custom_id","method":"POST","url","body"}，不含换行。
+    static QByteArray buildBatchRequestLine(const QString &customId, const QJsonObject &chatBody);
+
+    // 保持模型常驻的默认参数：Ollama 为 keep_alive / num_ctx，LM Studio 为 ttl（秒）；其它 Provider 为空。
+    // num_ctx 固定不变，避免 Ollama 因上下文长度变化而重新加载模型。
+    static QJsonObject defaultResidencyOptions(const QString &providerId);
+
     // 按目标 Provider 规范构造请求体，并做必要参数清洗。
+    // responseSchema 非空时附加结构化输出约束：OpenAI 兼容为 response_format，Ollama 为 format。
+    // Ollama 的采样参数（temperature、num_ctx 等）放入 options 对象；常驻参数未指定时使用默认值。
     static QJsonObject buildChatBody(const QString &providerId,
                                      const QString &model,
                                      bool stream,
                                      const QJsonArray &messages,
-                                     const QJsonObject &options);
+                                     const QJsonObject &options,
+                                     const QJsonObject &responseSchema = QJsonObject());
 };
 
 #endif // APIFORMATMANAGER_H
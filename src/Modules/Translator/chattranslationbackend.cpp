@@ -0,0 +1,101 @@
+#include "chattranslationbackend.h"
+
+#include "promptrequestcomposer.h"
+#include "segmentwirecodec.h"
+
+ChatTranslationBackend::ChatTranslationBackend(LlmServiceClient *client, QObject *parent)
+    : TranslationBackend(parent)
+    , m_client(client)
+{
+    connect(m_client, &LlmServiceClient::chatCompleted, this, &ChatTranslationBackend::onChatCompleted);
+    connect(m_client, &LlmServiceClient::requestFailed, this, &ChatTranslationBackend::onRequestFailed);
+    connect(m_client, &LlmServiceClient::chatMetricsMeasured, this, &ChatTranslationBackend::onChatMetricsMeasured);
+}
+
+void ChatTranslationBackend::setConfig(const LlmServiceConfig &config, const QJsonObject &options)
+{
+    m_config = config;
+    m_options = options;
+}
+
+QString ChatTranslationBackend::name() const
+{
+    return QStringLiteral("chat:%1").arg(m_config.model);
+}
+
+quint64 ChatTranslationBackend::translateLines(const TranslationLineBatch &batch)
+{
+    if (batch.lines.isEmpty() || !m_config.isValid()) {
+        return 0;
+    }
+
+    QString systemPrompt = batch.systemPrompt;
+    if (systemPrompt.isEmpty()) {
+        PromptComposeInput input;
+        input.naturalInstruction = tr("请把以下字幕逐行翻译成%1，语气自然，术语统一。").arg(batch.targetLanguage);
+        input.sourceLanguage = batch.sourceLanguage;
+        input.targetLanguage = batch.targetLanguage;
+        systemPrompt = PromptRequestComposer::buildFinalInstruction(input) + QStringLiteral("\n\n")
+                       + SegmentWireCodec::outputInstruction();
+    }
+
+    QStringList encodedLines;
+    encodedLines.reserve(batch.lines.size());
+    for (int i = 0; i < batch.lines.size(); ++i) {
+        encodedLines.append(SegmentWireCodec::encodeLine(i + 1, batch.lines.at(i)));
+    }
+    const QJsonArray messages = PromptRequestComposer::buildPrefixCachedMessages(systemPrompt, encodedLines.join('\n'));
+    // 行号需逐条对应，流式增量对按行接口没有意义。
+    LlmServiceConfig config = m_config;
+    config.stream = false;
+    const quint64 requestId = m_client->requestChatCompletion(config, messages, m_options);
+    if (requestId != 0) {
+        m_lineCountByRequestId.insert(requestId, batch.lines.size());
+    }
+    return requestId;
+}
+
+void ChatTranslationBackend::cancel(quint64 requestId)
+{
+    if (m_lineCountByRequestId.remove(requestId) > 0) {
+        m_client->cancelRequest(requestId);
+    }
+}
+
+int ChatTranslationBackend::suggestedConcurrency() const
+{
+    return m_config.suggestedConcurrency();
+}
+
+void ChatTranslationBackend::onChatCompleted(quint64 requestId, const QString &content, const QJsonObject &)
+{
+    const auto it = m_lineCountByRequestId.constFind(requestId);
+    if (it == m_lineCountByRequestId.constEnd()) {
+        return;
+    }
+
+    const int lineCount = it.value();
+    m_lineCountByRequestId.erase(it);
+    const QMap<int, QString> translationsById = SegmentWireCodec::decodeResponse(content);
+    QStringList translations;
+    translations.reserve(lineCount);
+    for (int i = 0; i < lineCount; ++i) {
+        translations.append(translationsById.value(i + 1).trimmed());
+    }
+    emit linesTranslated(requestId, translations);
+}
+
+void ChatTranslationBackend::onRequestFailed(quint64 requestId, const QString &stage, const QString &message)
+{
+    if (m_lineCountByRequestId.remove(requestId) == 0) {
+        return;
+    }
+    emit linesFailed(requestId, tr("%1：%2").arg(stage, message));
+}
+
+void ChatTranslationBackend::onChatMetricsMeasured(quint64 requestId, const LlmRequestMetrics &metrics)
+{
+    if (m_lineCountByRequestId.contains(requestId)) {
+        emit requestMeasured(requestId, metrics);
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef CHATTRANSLATIONBACKEND_H
+#define CHATTRANSLATIONBACKEND_H
+
+#include "translationbackend.h"
+
+#include <QHash>
+#include <QJsonObject>
+
+// 聊天模型作为按行翻译后端：各行编码为紧凑行 "id|text"（id 为行号），经 LlmServiceClient 发出，
+// 按编号解析回等长译文。不设 systemPrompt 时按目标语言生成默认指令。
+class ChatTranslationBackend : public TranslationBackend
+{
+    Q_OBJECT
+
+public:
+    // client 不转移所有权，可与其它调用方共用（请求 ID 不会重复）。
+    explicit ChatTranslationBackend(LlmServiceClient *client, QObject *parent = nullptr);
+
+    void setConfig(const LlmServiceConfig &config, const QJsonObject &options = QJsonObject());
+
+    QString name() const override;
+    quint64 translateLines(const TranslationLineBatch &batch) override;
+    void cancel(quint64 requestId) override;
+    int suggestedConcurrency() const override;
+
+private slots:
+    void onChatCompleted(quint64 requestId, const QString &content, const QJsonObject &rawResponse);
+    void onRequestFailed(quint64 requestId, const QString &stage, const QString &message);
+    void onChatMetricsMeasured(quint64 requestId, const LlmRequestMetrics &metrics);
+
+private:
+    LlmServiceClient *m_client = nullptr;
+    LlmServiceConfig m_config;
+    QJsonObject m_options;
+    // 请求 ID -> 行数。
+    QHash<quint64, int> m_lineCountByRequestId;
+};
+
+#endif // CHATTRANSLATIONBACKEND_H
@@ -0,0 +1,587 @@
+#include "headlesstranslationrunner.h"
+
+#include "chattranslationbackend.h"
+#include "promptrequestcomposer.h"
+#include "segmentwirecodec.h"
+#include "translationtaskrunner.h"
+
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QRegularExpression>
+#include <QTimer>
+
+namespace {
+const char *const kTranslateOption = "translate";
+const char *const kApiKeyEnvironment = "QSRTTOOL_LLM_API_KEY";
+
+bool isWildcardPattern(const QString &input)
+{
+    return input.contains(QLatin1Char('*')) || input.contains(QLatin1Char('?')) || input.contains(QLatin1Char('['));
+}
+
+double entriesPerSecond(int entries, qint64 elapsedMs)
+{
+    return elapsedMs > 0 ? entries * 1000.0 / elapsedMs : 0.0;
+}
+
+QStringList commandLineOptionNames()
+{
+    return QStringList() << QStringLiteral("preset") << QStringLiteral("instruction")
+                         << QStringLiteral("source-lang") << QStringLiteral("target-lang")
+                         << QStringLiteral("provider") << QStringLiteral("host") << QStringLiteral("model")
+                         << QStringLiteral("api-key") << QStringLiteral("temperature") << QStringLiteral("max-tokens")
+                         << QStringLiteral("chunk-size") << QStringLiteral("concurrency")
+                         << QStringLiteral("parallel-files") << QStringLiteral("output-dir") << QStringLiteral("report")
+                         << QStringLiteral("mt-endpoint") << QStringLiteral("mt-format") << QStringLiteral("mt-api-key");
+}
+
+// 各选项的说明统一见 HeadlessTranslationRunner::usage()。
+void addCommandLineOptions(QCommandLineParser *parser)
+{
+    parser->addOption(QCommandLineOption(QString::fromLatin1(kTranslateOption), QString(), QStringLiteral("path")));
+    for (const QString &name : commandLineOptionNames()) {
+        parser->addOption(QCommandLineOption(name, QString(), QStringLiteral("value")));
+    }
+    parser->addOption(QCommandLineOption(QStringLiteral("structured")));
+    parser->addOption(QCommandLineOption(QStringLiteral("line-backend")));
+}
+}
+
+bool HeadlessTranslationOptions::fromArguments(const QStringList &arguments,
+                                               HeadlessTranslationOptions *options,
+                                               QString *errorMessage)
+{
+    QCommandLineParser parser;
+    addCommandLineOptions(&parser);
+    if (!parser.parse(arguments)) {
+        *errorMessage = parser.errorText();
+        return false;
+    }
+
+    HeadlessTranslationOptions result;
+    result.inputs = parser.values(QString::fromLatin1(kTranslateOption));
+    result.presetPath = parser.value(QStringLiteral("preset"));
+    result.instruction = parser.value(QStringLiteral("instruction"));
+    result.sourceLanguage = parser.value(QStringLiteral("source-lang"));
+    if (parser.isSet(QStringLiteral("target-lang"))) {
+        result.targetLanguage = parser.value(QStringLiteral("target-lang")).trimmed();
+    }
+    result.config.provider = parser.isSet(QStringLiteral("provider")) ? parser.value(QStringLiteral("provider"))
+                                                                      : QStringLiteral("OpenAI API");
+    result.config.baseUrl = parser.value(QStringLiteral("host"));
+    result.config.model = parser.value(QStringLiteral("model")).trimmed();
+    result.config.apiKey = parser.isSet(QStringLiteral("api-key")) ? parser.value(QStringLiteral("api-key"))
+                                                                   : qEnvironmentVariable(kApiKeyEnvironment);
+    result.structuredOutput = parser.isSet(QStringLiteral("structured"));
+    result.lineBackend = parser.isSet(QStringLiteral("line-backend"));
+    result.mtConfig.endpointUrl = parser.value(QStringLiteral("mt-endpoint")).trimmed();
+    result.mtConfig.apiKey = parser.value(QStringLiteral("mt-api-key"));
+    if (parser.isSet(QStringLiteral("mt-format"))
+        && !MtServiceConfig::dialectFromName(parser.value(QStringLiteral("mt-format")), &result.mtConfig.dialect)) {
+        *errorMessage = QStringLiteral("--mt-format 只能是 lines 或 libretranslate");
+        return false;
+    }
+    result.outputDirectory = parser.value(QStringLiteral("output-dir"));
+    result.reportPath = parser.value(QStringLiteral("report"));
+
+    bool ok = true;
+    if (parser.isSet(QStringLiteral("temperature"))) {
+        result.temperature = parser.value(QStringLiteral("temperature")).toDouble(&ok);
+        if (!ok || result.temperature < 0.0) {
+            *errorMessage = QStringLiteral("--temperature 的取值无效");
+            return false;
+        }
+    }
+    const struct {
+        const char *name;
+        int *target;
+        int minimum;
+    } integerOptions[] = {
+        {"max-tokens", &result.maxTokens, 1},
+        {"chunk-size", &result.chunkSize, 1},
+        {"concurrency", &result.concurrency, 0},
+        {"parallel-files", &result.parallelFiles, 1},
+    };
+    for (const auto &option : integerOptions) {
+        const QString name = QString::fromLatin1(option.name);
+        if (!parser.isSet(name)) {
+            continue;
+        }
+        *option.target = parser.value(name).toInt(&ok);
+        if (!ok || *option.target < option.minimum) {
+            *errorMessage = QStringLiteral("--%1 的取值无效").arg(name);
+            return false;
+        }
+    }
+    if (result.inputs.isEmpty()) {
+        *errorMessage = QStringLiteral("缺少 --translate");
+        return false;
+    }
+    if (result.targetLanguage.isEmpty()) {
+        *errorMessage = QStringLiteral("--target-lang 不能为空");
+        return false;
+    }
+    if (result.lineBackend && (result.structuredOutput || result.usesMtBackend())) {
+        *errorMessage = QStringLiteral("--line-backend 不能与 --structured 或 --mt-endpoint 同时使用");
+        return false;
+    }
+    if (result.usesMtBackend()) {
+        if (!result.mtConfig.isValid()) {
+            *errorMessage = QStringLiteral("--mt-endpoint 不是有效的 http(s) 地址");
+            return false;
+        }
+        result.mtConfig.timeoutMs = result.config.timeoutMs;
+    } else if (!result.config.isValid()) {
+        *errorMessage = QStringLiteral("服务地址无效，请指定 --host 或 --mt-endpoint");
+        return false;
+    }
+
+    *options = result;
+    return true;
+}
+
+bool HeadlessTranslationOptions::usesMtBackend() const
+{
+    return !mtConfig.endpointUrl.isEmpty();
+}
+
+HeadlessTranslationRunner::HeadlessTranslationRunner(const HeadlessTranslationOptions &options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+{
+}
+
+bool HeadlessTranslationRunner::isRequested(int argc, char *argv[])
+{
+    const QByteArray option = QByteArray("--") + kTranslateOption;
+    for (int i = 1; i < argc; ++i) {
+        const QByteArray argument(argv[i]);
+        if (argument == option || argument.startsWith(option + '=')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QString HeadlessTranslationRunner::usage()
+{
+    return tr("用法：qSrtTool --translate <目录|通配符|文件> [--translate ...] --host <地址> --model <模型> [选项]\n"
+              "      qSrtTool --translate <目录|通配符|文件> --mt-endpoint <地址> [--mt-format lines|libretranslate] [选项]\n"
+              "  --preset <json>          翻译预设（其中的 temperature / custom_model 作为默认值）\n"
+              "  --instruction <文本>     翻译指令，缺省时按目标语言生成\n"
+              "  --source-lang <语言>     源语言，缺省为自动检测\n"
+              "  --target-lang <语言>     目标语言，缺省为中文\n"
+              "  --provider <名称>        服务类型（OpenAI API / Ollama / LM Studio / DeepSeek ...），缺省为 OpenAI API\n"
+              "  --host <地址>            服务地址，可写多个端点（分号分隔，\"url|weight|maxConcurrent\"）\n"
+              "  --api-key <密钥>         缺省读取环境变量 %1\n"
+              "  --mt-endpoint <地址>     改用专用机器翻译服务（完整请求地址），此时不需要 --host / --model\n"
+              "  --mt-format <格式>       lines：{\"texts\":[...]} -> {\"translations\":[...]}（缺省）；libretranslate\n"
+              "  --mt-api-key <密钥>      机器翻译服务的密钥\n"
+              "  --temperature <数值>     --max-tokens <数量>\n"
+              "  --structured             使用结构化输出（JSON Schema）\n"
+              "  --line-backend           聊天模型经按行翻译后端发出（紧凑行、非流式，不与 --structured 同用）\n"
+              "  --chunk-size <条数>      每个分块的条目数，缺省 20\n"
+              "  --concurrency <数量>     全部文件共用的在途请求数，缺省取端点并发上限之和（机器翻译服务为 4）\n"
+              "  --parallel-files <数量>  同时翻译的文件数，缺省 2，不超过并发数\n"
+              "  --output-dir <目录>      译文输出目录，缺省写在源文件旁（<文件名>_<目标语言>.srt）\n"
+              "  --report <路径>          汇总报告（JSON），请求统计另存为同名 .telemetry.json")
+        .arg(QString::fromLatin1(kApiKeyEnvironment));
+}
+
+bool HeadlessTranslationRunner::start(QString *errorMessage)
+{
+    if (!m_runners.isEmpty()) {
+        *errorMessage = tr("任务已开始");
+        return false;
+    }
+    if (!loadPreset(errorMessage)) {
+        return false;
+    }
+
+    const QStringList files = collectInputFiles();
+    int totalEntries = 0;
+    m_jobs.clear();
+    for (const QString &filePath : files) {
+        FileJob job;
+        job.sourcePath = filePath;
+        job.outputPath = outputPathFor(filePath);
+        QFile file(filePath);
+        if (file.open(QIODevice::ReadOnly)) {
+            job.entries = SubtitleSrt::parse(QString::fromUtf8(file.readAll()));
+        }
+        job.document.reset(job.entries.size());
+        totalEntries += job.entries.size();
+        m_jobs.append(job);
+    }
+    if (m_jobs.isEmpty()) {
+        *errorMessage = tr("没有找到待翻译的 SRT 文件");
+        return false;
+    }
+
+    PromptComposeInput composeInput;
+    composeInput.naturalInstruction = m_options.instruction.trimmed();
+    if (composeInput.naturalInstruction.isEmpty()) {
+        composeInput.naturalInstruction = tr("这是一个影视字幕任务，请翻译成%1，注意术语统一、语气自然，并遵循预设规则。")
+                                              .arg(m_options.targetLanguage);
+    }
+    composeInput.sourceLanguage = m_options.sourceLanguage;
+    composeInput.targetLanguage = m_options.targetLanguage;
+    composeInput.presetJson = m_presetJson;
+    // 不写入字幕路径：各文件的静态前缀逐字节一致，跨文件共享服务端前缀缓存。
+    m_systemPrompt = PromptRequestComposer::buildFinalInstruction(composeInput) + QStringLiteral("\n\n");
+    if (m_options.structuredOutput) {
+        m_systemPrompt += SegmentWireCodec::structuredOutputInstruction();
+        m_responseSchema = SegmentWireCodec::responseSchema();
+    } else {
+        m_systemPrompt += SegmentWireCodec::outputInstruction();
+    }
+
+    const int concurrency = m_options.concurrency > 0 ? m_options.concurrency
+                            : m_options.usesMtBackend() ? m_options.mtConfig.maxConcurrent
+                                                        : m_options.config.suggestedConcurrency();
+    m_options.concurrency = qMax(1, concurrency);
+    // 每个文件至少占一个在途请求，同时翻译的文件数不超过并发预算。
+    const int runnerCount = qMax(1, qMin(qMin(m_options.parallelFiles, m_options.concurrency), m_jobs.size()));
+    m_options.parallelFiles = runnerCount;
+
+    m_client = new LlmServiceClient(this);
+    connect(m_client, &LlmServiceClient::chatMetricsMeasured, this, [this](quint64, const LlmRequestMetrics &metrics) {
+        m_telemetry.recordCompletion(metrics);
+    });
+    connect(m_client, &LlmServiceClient::chatFailureMeasured, this, [this](quint64, const LlmRequestMetrics &metrics) {
+        m_telemetry.recordFailure(metrics.model);
+    });
+    if (m_options.usesMtBackend()) {
+        m_backend = new MtTranslationBackend(m_options.mtConfig, this);
+        connect(m_backend, &TranslationBackend::requestMeasured, this, [this](quint64, const LlmRequestMetrics &metrics) {
+            m_telemetry.recordCompletion(metrics);
+        });
+        connect(m_backend, &TranslationBackend::linesFailed, this, [this](quint64, const QString &) {
+            m_telemetry.recordFailure(m_backend->name());
+        });
+    } else if (m_options.lineBackend) {
+        // 请求仍由共用的 m_client 发出，请求统计沿用上面的客户端信号，不再重复连接后端的统计信号。
+        ChatTranslationBackend *chatBackend = new ChatTranslationBackend(m_client, this);
+        chatBackend->setConfig(m_options.config, m_chatOptions);
+        m_backend = chatBackend;
+    }
+    for (int i = 0; i < runnerCount; ++i) {
+        TranslationTaskRunner *runner = new TranslationTaskRunner(m_client, this);
+        runner->setSharedMemory(&m_memory);
+        runner->setBackend(m_backend);
+        connect(runner, &TranslationTaskRunner::taskLog, this, [this, runner](const QString &line) {
+            const int jobIndex = m_jobByRunner.value(runner, -1);
+            if (jobIndex >= 0) {
+                qInfo("[%s] %s", qPrintable(QFileInfo(m_jobs.at(jobIndex).sourcePath).fileName()), qPrintable(line));
+            }
+        });
+        connect(runner, &TranslationTaskRunner::chunkCommitted, this,
+                [this, runner](int, int, const QVector<SubtitleEntry> &translatedEntries) {
+                    onChunkCommitted(runner, translatedEntries);
+                });
+        connect(runner, &TranslationTaskRunner::taskFinished, this, [this, runner](bool success, const QString &message) {
+            onTaskFinished(runner, success, message);
+        });
+        m_runners.append(runner);
+    }
+
+    qInfo("%s", qPrintable(tr("批量翻译：%1 个文件，共 %2 条，%3 个文件并行，在途请求上限 %4，模型 %5")
+                               .arg(m_jobs.size())
+                               .arg(totalEntries)
+                               .arg(runnerCount)
+                               .arg(m_options.concurrency)
+                               .arg(modelName())));
+    if (!m_options.usesMtBackend()) {
+        m_client->prewarmConnections(m_options.config);
+    }
+    m_telemetry.reset();
+    m_telemetry.setEntryCount(totalEntries);
+    m_startedAt = QDateTime::currentDateTime().toString(Qt::ISODate);
+    m_wallTimer.start();
+    QTimer::singleShot(0, this, [this]() {
+        for (TranslationTaskRunner *runner : m_runners) {
+            startNextFile(runner);
+        }
+    });
+    return true;
+}
+
+bool HeadlessTranslationRunner::loadPreset(QString *errorMessage)
+{
+    m_presetJson.clear();
+    QJsonObject presetObject;
+    if (!m_options.presetPath.trimmed().isEmpty()) {
+        QFile file(m_options.presetPath);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            *errorMessage = tr("无法读取预设：%1").arg(m_options.presetPath);
+            return false;
+        }
+        QJsonParseError parseError;
+        const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+        if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+            *errorMessage = tr("预设不是有效的 JSON 对象：%1").arg(m_options.presetPath);
+            return false;
+        }
+        presetObject = document.object();
+        m_presetJson = QString::fromUtf8(QJsonDocument(presetObject).toJson(QJsonDocument::Indented));
+    }
+
+    if (m_options.temperature < 0.0) {
+        m_options.temperature = presetObject.value(QStringLiteral("temperature")).toDouble(0.2);
+    }
+    if (m_options.config.model.isEmpty()) {
+        m_options.config.model = presetObject.value(QStringLiteral("custom_model")).toString().trimmed();
+    }
+    if (m_options.config.model.isEmpty()) {
+        m_options.config.model = presetObject.value(QStringLiteral("openrouter_model")).toString().trimmed();
+    }
+    if (m_options.config.model.isEmpty() && !m_options.usesMtBackend()) {
+        *errorMessage = tr("未指定模型（--model 或预设中的 custom_model）");
+        return false;
+    }
+
+    m_chatOptions = QJsonObject();
+    m_chatOptions.insert(QStringLiteral("temperature"), m_options.temperature);
+    m_chatOptions.insert(QStringLiteral("max_tokens"), m_options.maxTokens);
+    return true;
+}
+
+QString HeadlessTranslationRunner::modelName() const
+{
+    return m_backend ? m_backend->name() : m_options.config.model;
+}
+
+QStringList HeadlessTranslationRunner::collectInputFiles() const
+{
+    // 输出写在源文件旁时，跳过上次生成的译文文件。
+    const QString outputSuffix = QStringLiteral("_%1.srt").arg(m_options.targetLanguage);
+    QStringList files;
+    for (const QString &input : m_options.inputs) {
+        QStringList candidates;
+        const QFileInfo info(input);
+        if (info.isDir()) {
+            const QDir directory(info.absoluteFilePath());
+            for (const QString &name : directory.entryList(QStringList() << QStringLiteral("*.srt"), QDir::Files, QDir::Name)) {
+                candidates.append(directory.absoluteFilePath(name));
+            }
+        } else if (isWildcardPattern(info.fileName())) {
+            const QDir directory(info.absolutePath());
+            for (const QString &name : directory.entryList(QStringList() << info.fileName(), QDir::Files, QDir::Name)) {
+                candidates.append(directory.absoluteFilePath(name));
+            }
+        } else if (info.isFile()) {
+            candidates.append(info.absoluteFilePath());
+        } else {
+            qWarning("%s", qPrintable(tr("跳过不存在的输入：%1").arg(input)));
+        }
+
+        for (const QString &candidate : candidates) {
+            if (candidate.endsWith(outputSuffix, Qt::CaseInsensitive) || files.contains(candidate)) {
+                continue;
+            }
+            files.append(candidate);
+        }
+    }
+    return files;
+}
+
+QString HeadlessTranslationRunner::outputPathFor(const QString &sourcePath) const
+{
+    const QFileInfo info(sourcePath);
+    const QString directory = m_options.outputDirectory.trimmed().isEmpty() ? info.absolutePath()
+                                                                            : m_options.outputDirectory;
+    QString languageTag = m_options.targetLanguage;
+    languageTag.replace(QRegularExpression(QStringLiteral("[\\\\/:*?\"<>|\\s]")), QStringLiteral("_"));
+    return QDir(directory).filePath(QStringLiteral("%1_%2.srt").arg(info.completeBaseName(), languageTag));
+}
+
+QString HeadlessTranslationRunner::defaultReportPath() const
+{
+    return QDir::currentPath() + QStringLiteral("/output/translator_batch/report_%1.json")
+                                     .arg(QDateTime::currentDateTime().toString(QStringLiteral("yyyyMMdd_HHmmss")));
+}
+
+void HeadlessTranslationRunner::startNextFile(TranslationTaskRunner *runner)
+{
+    m_jobByRunner.remove(runner);
+    while (m_nextJob < m_jobs.size()) {
+        const int jobIndex = m_nextJob++;
+        FileJob &job = m_jobs[jobIndex];
+        job.timer.start();
+        if (job.entries.isEmpty()) {
+            job.message = tr("无法读取或没有有效的字幕条目");
+            ++m_finishedJobs;
+            qWarning("%s", qPrintable(tr("[%1] %2").arg(QFileInfo(job.sourcePath).fileName(), job.message)));
+            continue;
+        }
+
+        TranslationTaskRequest request;
+        request.entries = job.entries;
+        request.config = m_options.config;
+        request.options = m_chatOptions;
+        request.systemPrompt = m_systemPrompt;
+        request.responseSchema = m_responseSchema;
+        request.sourceLanguage = m_options.sourceLanguage;
+        request.responseFormat = m_options.structuredOutput ? StreamingCueParser::InputFormat::JsonItems
+                                                            : StreamingCueParser::InputFormat::CompactLines;
+        request.chunkSize = m_options.chunkSize;
+        // 在途上限按并行文件数均分；各执行器的请求经同一端点池排队，总量不超过端点容量。
+        request.maxInFlight = qMax(1, m_options.concurrency / m_options.parallelFiles);
+        TranslationTargetLanguage target;
+        target.language = m_options.targetLanguage;
+        target.systemPrompt = m_systemPrompt;
+        request.languages.append(target);
+
+        m_jobByRunner.insert(runner, jobIndex);
+        runner->startTask(request);
+        return;
+    }
+
+    if (m_finishedJobs == m_jobs.size() && !m_reportWritten) {
+        writeReport();
+    }
+}
+
+void HeadlessTranslationRunner::onChunkCommitted(TranslationTaskRunner *runner, const QVector<SubtitleEntry> &translatedEntries)
+{
+    const int jobIndex = m_jobByRunner.value(runner, -1);
+    if (jobIndex < 0) {
+        return;
+    }
+
+    FileJob &job = m_jobs[jobIndex];
+    for (const SubtitleEntry &entry : translatedEntries) {
+        if (entry.index >= 1 && entry.index <= job.document.size()) {
+            job.document.setEntry(entry.index - 1, entry);
+        }
+    }
+    // 按序提交时为追加写出，中途中断也保留已完成的部分。
+    flushJob(job);
+}
+
+void HeadlessTranslationRunner::onTaskFinished(TranslationTaskRunner *runner, bool success, const QString &message)
+{
+    const int jobIndex = m_jobByRunner.value(runner, -1);
+    if (jobIndex < 0) {
+        return;
+    }
+
+    FileJob &job = m_jobs[jobIndex];
+    job.elapsedMs = job.timer.elapsed();
+    flushJob(job);
+    job.success = success && job.document.translatedCount() == job.entries.size() && job.message.isEmpty();
+    if (job.message.isEmpty()) {
+        job.message = message;
+    }
+    ++m_finishedJobs;
+    qInfo("%s", qPrintable(tr("[%1] %2：%3/%4 条，用时 %5 s，%6 条/s -> %7")
+                               .arg(QFileInfo(job.sourcePath).fileName())
+                               .arg(job.success ? tr("完成") : tr("未完成"))
+                               .arg(job.document.translatedCount())
+                               .arg(job.entries.size())
+                               .arg(QString::number(job.elapsedMs / 1000.0, 'f', 1))
+                               .arg(QString::number(entriesPerSecond(job.document.translatedCount(), job.elapsedMs), 'f', 2))
+                               .arg(job.outputPath)));
+
+    // 当前调用仍在执行器的 taskFinished 信号内，下一文件放到事件循环中开始。
+    QTimer::singleShot(0, this, [this, runner]() {
+        startNextFile(runner);
+    });
+}
+
+void HeadlessTranslationRunner::flushJob(FileJob &job)
+{
+    if (!job.document.hasPendingChanges() || !QDir().mkpath(QFileInfo(job.outputPath).absolutePath())) {
+        return;
+    }
+
+    QString errorMessage;
+    if (!job.document.flushToFile(job.outputPath, TranslationDocumentStore::Expander(), nullptr, &errorMessage)) {
+        job.message = tr("译文写出失败：%1").arg(errorMessage);
+    }
+}
+
+void HeadlessTranslationRunner::writeReport()
+{
+    m_reportWritten = true;
+    const qint64 wallMs = m_wallTimer.elapsed();
+    int totalEntries = 0;
+    int translatedEntries = 0;
+    int failedFiles = 0;
+    QJsonArray files;
+    for (const FileJob &job : m_jobs) {
+        totalEntries += job.entries.size();
+        translatedEntries += job.document.translatedCount();
+        if (!job.success) {
+            ++failedFiles;
+        }
+
+        QJsonObject file;
+        file.insert(QStringLiteral("source"), job.sourcePath);
+        file.insert(QStringLiteral("output"), job.document.translatedCount() > 0 ? job.outputPath : QString());
+        file.insert(QStringLiteral("success"), job.success);
+        file.insert(QStringLiteral("message"), job.message);
+        file.insert(QStringLiteral("entries"), job.entries.size());
+        file.insert(QStringLiteral("translated"), job.document.translatedCount());
+        file.insert(QStringLiteral("seconds"), job.elapsedMs / 1000.0);
+        file.insert(QStringLiteral("entriesPerSecond"), entriesPerSecond(job.document.translatedCount(), job.elapsedMs));
+        files.append(file);
+    }
+
+    QJsonObject totals;
+    totals.insert(QStringLiteral("files"), m_jobs.size());
+    totals.insert(QStringLiteral("failedFiles"), failedFiles);
+    totals.insert(QStringLiteral("entries"), totalEntries);
+    totals.insert(QStringLiteral("translated"), translatedEntries);
+    totals.insert(QStringLiteral("seconds"), wallMs / 1000.0);
+    totals.insert(QStringLiteral("entriesPerSecond"), entriesPerSecond(translatedEntries, wallMs));
+    totals.insert(QStringLiteral("memoryEntries"), m_memory.size());
+
+    const QStringList telemetryLines = m_telemetry.summaryLines();
+    QJsonObject report;
+    report.insert(QStringLiteral("startedAt"), m_startedAt);
+    report.insert(QStringLiteral("finishedAt"), QDateTime::currentDateTime().toString(Qt::ISODate));
+    report.insert(QStringLiteral("model"), modelName());
+    report.insert(QStringLiteral("targetLanguage"), m_options.targetLanguage);
+    report.insert(QStringLiteral("concurrency"), m_options.concurrency);
+    report.insert(QStringLiteral("parallelFiles"), m_options.parallelFiles);
+    report.insert(QStringLiteral("chunkSize"), m_options.chunkSize);
+    report.insert(QStringLiteral("files"), files);
+    report.insert(QStringLiteral("totals"), totals);
+    report.insert(QStringLiteral("telemetry"), QJsonArray::fromStringList(telemetryLines));
+
+    const QString reportPath = m_options.reportPath.trimmed().isEmpty() ? defaultReportPath() : m_options.reportPath;
+    QDir().mkpath(QFileInfo(reportPath).absolutePath());
+    QFile reportFile(reportPath);
+    if (reportFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        reportFile.write(QJsonDocument(report).toJson(QJsonDocument::Indented));
+        reportFile.close();
+    } else {
+        qWarning("%s", qPrintable(tr("汇总报告写出失败：%1").arg(reportFile.errorString())));
+    }
+    QString telemetryError;
+    const QFileInfo reportInfo(reportPath);
+    const QString telemetryPath = reportInfo.dir().filePath(reportInfo.completeBaseName() + QStringLiteral(".telemetry.json"));
+    if (!m_telemetry.isEmpty() && !m_telemetry.exportJson(telemetryPath, &telemetryError)) {
+        qWarning("%s", qPrintable(tr("请求统计写出失败：%1").arg(telemetryError)));
+    }
+
+    for (const QString &line : telemetryLines) {
+        qInfo("%s", qPrintable(line));
+    }
+    qInfo("%s", qPrintable(tr("批量翻译结束：%1/%2 个文件成功，%3/%4 条，用时 %5 s，%6 条/s，翻译记忆 %7 条；报告 %8")
+                               .arg(m_jobs.size() - failedFiles)
+                               .arg(m_jobs.size())
+                               .arg(translatedEntries)
+                               .arg(totalEntries)
+                               .arg(QString::number(wallMs / 1000.0, 'f', 1))
+                               .arg(QString::number(entriesPerSecond(translatedEntries, wallMs), 'f', 2))
+                               .arg(m_memory.size())
+                               .arg(reportPath)));
+    emit finished(failedFiles == 0 ? 0 : 1);
+}
@@ -0,0 +1,118 @@
+#ifndef HEADLESSTRANSLATIONRUNNER_H
+#define HEADLESSTRANSLATIONRUNNER_H
+
+#include "llmserviceclient.h"
+#include "mttranslationbackend.h"
+#include "subtitleentry.h"
+#include "translationdocumentstore.h"
+#include "translationmemory.h"
+#include "translationtelemetry.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class TranslationTaskRunner;
+
+struct HeadlessTranslationOptions
+{
+    // 目录（其中全部 *.srt，不递归）、通配符（如 /data/ep*.srt）或单个文件。
+    QStringList inputs;
+    QString presetPath;
+    QString instruction;
+    QString sourceLanguage;
+    QString targetLanguage = QStringLiteral("中文");
+    LlmServiceConfig config;
+    // 专用机器翻译服务；endpointUrl 非空时分块经 MtTranslationBackend 发出，不需要聊天服务与模型。
+    MtServiceConfig mtConfig;
+    // 小于 0 时取预设中的 temperature，预设未设置时为 0.2。
+    double temperature = -1.0;
+    int maxTokens = 1024;
+    bool structuredOutput = false;
+    // 聊天模型改经 ChatTranslationBackend 按行发出（紧凑行、非流式），与机器翻译服务走同一条后端路径。
+    bool lineBackend = false;
+    int chunkSize = 20;
+    // 全部文件共用的在途请求总数；0 表示取端点池的建议并发数。
+    int concurrency = 0;
+    // 同时翻译的文件数，在途请求总数在这些文件间均分。
+    int parallelFiles = 2;
+    // 译文输出目录；为空时写在源文件旁。
+    QString outputDirectory;
+    // 汇总报告路径；为空时写入 output/translator_batch/report_<时间>.json。
+    QString reportPath;
+
+    // 解析命令行（含程序名）；参数无效时返回 false 并给出原因。
+    static bool fromArguments(const QStringList &arguments, HeadlessTranslationOptions *options, QString *errorMessage);
+    bool usesMtBackend() const;
+};
+
+// 无界面批量翻译：按目录或通配符收集 SRT 文件，若干文件并行，每个文件由一个 TranslationTaskRunner 分块并发翻译。
+// 全部文件共用一个 LlmServiceClient（同一端点池调度）、一份翻译记忆与一份请求统计；
+// 译文按提交增量写出，结束后写汇总报告（逐文件与合计的条目吞吐，附请求统计）。
+class HeadlessTranslationRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit HeadlessTranslationRunner(const HeadlessTranslationOptions &options, QObject *parent = nullptr);
+
+    // 命令行中是否带有 --translate（此时不创建窗口）。
+    static bool isRequested(int argc, char *argv[]);
+    static QString usage();
+
+    // 收集文件、读取预设并在事件循环中开始翻译；没有可处理的文件或预设无效时返回 false。
+    bool start(QString *errorMessage);
+
+signals:
+    // 全部文件处理完毕且报告已写出；全部成功时 exitCode 为 0。
+    void finished(int exitCode);
+
+private:
+    struct FileJob
+    {
+        QString sourcePath;
+        QString outputPath;
+        QVector<SubtitleEntry> entries;
+        TranslationDocumentStore document;
+        QElapsedTimer timer;
+        qint64 elapsedMs = 0;
+        bool success = false;
+        QString message;
+    };
+
+    QStringList collectInputFiles() const;
+    QString outputPathFor(const QString &sourcePath) const;
+    QString defaultReportPath() const;
+    // 日志与报告中的模型名：使用机器翻译服务时为后端名称。
+    QString modelName() const;
+    bool loadPreset(QString *errorMessage);
+    void startNextFile(TranslationTaskRunner *runner);
+    void onChunkCommitted(TranslationTaskRunner *runner, const QVector<SubtitleEntry> &translatedEntries);
+    void onTaskFinished(TranslationTaskRunner *runner, bool success, const QString &message);
+    void flushJob(FileJob &job);
+    void writeReport();
+
+    HeadlessTranslationOptions m_options;
+    QJsonObject m_chatOptions;
+    QString m_presetJson;
+    QString m_systemPrompt;
+    QJsonObject m_responseSchema;
+    LlmServiceClient *m_client = nullptr;
+    TranslationBackend *m_backend = nullptr;
+    QVector<TranslationTaskRunner *> m_runners;
+    QHash<TranslationTaskRunner *, int> m_jobByRunner;
+    QVector<FileJob> m_jobs;
+    int m_nextJob = 0;
+    int m_finishedJobs = 0;
+    bool m_reportWritten = false;
+    TranslationMemory m_memory;
+    TranslationTelemetry m_telemetry;
+    QElapsedTimer m_wallTimer;
+    QString m_startedAt;
+};
+
+#endif // HEADLESSTRANSLATIONRUNNER_H
@@ -0,0 +1,352 @@
+#include "llmbatchclient.h"
+#include "apiformatmanager.h"
+
+#include <QHttpMultiPart>
+#include <QHttpPart>
+#include <QJsonDocument>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QTimer>
+
+namespace {
+// 轮询间隔从 2 秒起按倍数退避，上限 1 分钟：本地模拟服务很快结束，云端批任务通常需数小时。
+const int kInitialPollIntervalMs = 2000;
+const int kMaxPollIntervalMs = 60000;
+// 轮询请求连续失败的容忍次数（隔夜运行时网络可能短暂中断）。
+const int kMaxPollFailures = 5;
+// 上传 / 下载的文件可能较大，超时不低于 2 分钟。
+const int kMinTransferTimeoutMs = 120000;
+
+bool isTerminalStatus(const QString &status)
+{
+    return status == QStringLiteral("completed")
+           || status == QStringLiteral("failed")
+           || status == QStringLiteral("expired")
+           || status == QStringLiteral("cancelled");
+}
+}
+
+LlmBatchClient::LlmBatchClient(QObject *parent)
+    : QObject(parent)
+    , m_networkManager(new QNetworkAccessManager(this))
+    , m_pollTimer(new QTimer(this))
+{
+    m_pollTimer->setSingleShot(true);
+    connect(m_pollTimer, &QTimer::timeout, this, &LlmBatchClient::poll);
+}
+
+LlmBatchClient::~LlmBatchClient()
+{
+    m_stage = Stage::Idle;
+    if (m_reply) {
+        m_reply->abort();
+    }
+}
+
+bool LlmBatchClient::isActive() const
+{
+    return m_stage != Stage::Idle;
+}
+
+QString LlmBatchClient::batchId() const
+{
+    return m_batchId;
+}
+
+bool LlmBatchClient::submit(const LlmServiceConfig &config, const QVector<LlmBatchRequest> &requests)
+{
+    const QString provider = ApiFormatManager::providerId(config.provider, config.normalizedBaseUrl());
+    if (isActive() || requests.isEmpty() || !config.isValid() || !ApiFormatManager::supportsBatch(provider)) {
+        return false;
+    }
+
+    QByteArray jsonl;
+    for (const LlmBatchRequest &request : requests) {
+        const QJsonObject body = ApiFormatManager::buildChatBody(provider,
+                                                                 config.model,
+                                                                 false,
+                                                                 request.messages,
+                                                                 request.options,
+                                                                 request.responseSchema);
+        jsonl += ApiFormatManager::buildBatchRequestLine(request.customId, body);
+        jsonl += '\n';
+    }
+
+    m_config = config;
+    m_batchId.clear();
+    m_finalStatus.clear();
+    m_pendingFileIds.clear();
+    m_requestCount = requests.size();
+    m_pollFailures = 0;
+    m_stage = Stage::Uploading;
+
+    QHttpMultiPart *multiPart = new QHttpMultiPart(QHttpMultiPart::FormDataType);
+    QHttpPart purposePart;
+    purposePart.setHeader(QNetworkRequest::ContentDispositionHeader, QStringLiteral("form-data; name=\"purpose\""));
+    purposePart.setBody("batch");
+    multiPart->append(purposePart);
+
+    QHttpPart filePart;
+    filePart.setHeader(QNetworkRequest::ContentDispositionHeader,
+                       QStringLiteral("form-data; name=\"file\"; filename=\"qsrttool_batch.jsonl\""));
+    filePart.setHeader(QNetworkRequest::ContentTypeHeader, QStringLiteral("application/jsonl"));
+    filePart.setBody(jsonl);
+    multiPart->append(filePart);
+
+    QNetworkRequest request = LlmServiceClient::buildRequest(config, ApiFormatManager::batchFilesEndpoint());
+    // 清除 JSON 类型，由 QHttpMultiPart 写入带 boundary 的 multipart 类型。
+    request.setHeader(QNetworkRequest::ContentTypeHeader, QVariant());
+    QNetworkReply *reply = m_networkManager->post(request, multiPart);
+    multiPart->setParent(reply);
+    watchReply(reply);
+    return true;
+}
+
+bool LlmBatchClient::attach(const LlmServiceConfig &config, const QString &batchId)
+{
+    if (isActive() || batchId.trimmed().isEmpty() || !config.isValid()) {
+        return false;
+    }
+
+    m_config = config;
+    m_batchId = batchId.trimmed();
+    m_finalStatus.clear();
+    m_pendingFileIds.clear();
+    m_requestCount = 0;
+    m_pollFailures = 0;
+    m_pollIntervalMs = kInitialPollIntervalMs;
+    m_stage = Stage::Polling;
+    poll();
+    return true;
+}
+
+void LlmBatchClient::cancel()
+{
+    if (!isActive()) {
+        return;
+    }
+
+    const bool cancelRemote = !m_batchId.isEmpty() && m_stage == Stage::Polling;
+    m_stage = Stage::Idle;
+    m_pollTimer->stop();
+    if (m_reply) {
+        m_reply->abort();
+    }
+
+    if (cancelRemote) {
+        // 服务端取消无需等待结果：未完成的请求不再计费即可。
+        QNetworkReply *reply = m_networkManager->post(
+            LlmServiceClient::buildRequest(m_config, ApiFormatManager::batchCancelEndpoint(m_batchId)),
+            QByteArray("{}"));
+        connect(reply, &QNetworkReply::finished, reply, &QNetworkReply::deleteLater);
+    }
+    m_batchId.clear();
+}
+
+QNetworkReply *LlmBatchClient::send(const QString &endpointPath, const QByteArray &payload)
+{
+    const QNetworkRequest request = LlmServiceClient::buildRequest(m_config, endpointPath);
+    QNetworkReply *reply = payload.isEmpty() ? m_networkManager->get(request)
+                                             : m_networkManager->post(request, payload);
+    watchReply(reply);
+    return reply;
+}
+
+void LlmBatchClient::watchReply(QNetworkReply *reply)
+{
+    m_reply = reply;
+    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
+        onReplyFinished(reply);
+    });
+    QTimer::singleShot(qMax(m_config.timeoutMs, kMinTransferTimeoutMs), reply, [reply]() {
+        reply->abort();
+    });
+}
+
+void LlmBatchClient::onReplyFinished(QNetworkReply *reply)
+{
+    reply->deleteLater();
+    if (reply != m_reply || m_stage == Stage::Idle) {
+        return;
+    }
+    m_reply = nullptr;
+
+    const QByteArray body = reply->readAll();
+    const int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (reply->error() != QNetworkReply::NoError || statusCode >= 400) {
+        QString message = errorMessageOf(QJsonDocument::fromJson(body).object());
+        if (message.isEmpty()) {
+            message = reply->errorString().trimmed();
+        }
+        if (statusCode > 0) {
+            message = QStringLiteral("HTTP %1 %2").arg(statusCode).arg(message);
+        }
+
+        if (m_stage == Stage::Polling && ++m_pollFailures <= kMaxPollFailures) {
+            schedulePoll();
+            return;
+        }
+        finish(false, tr("批量接口请求失败：%1").arg(message));
+        return;
+    }
+
+    switch (m_stage) {
+    case Stage::Uploading:
+        handleUploaded(QJsonDocument::fromJson(body).object());
+        break;
+    case Stage::Creating:
+        handleCreated(QJsonDocument::fromJson(body).object());
+        break;
+    case Stage::Polling:
+        m_pollFailures = 0;
+        handleStatus(QJsonDocument::fromJson(body).object());
+        break;
+    case Stage::Downloading:
+        deliverResults(body);
+        downloadNextFile();
+        break;
+    case Stage::Idle:
+        break;
+    }
+}
+
+void LlmBatchClient::handleUploaded(const QJsonObject &response)
+{
+    const QString fileId = response.value(QStringLiteral("id")).toString();
+    if (fileId.isEmpty()) {
+        finish(false, tr("批量输入文件上传后未返回文件 ID"));
+        return;
+    }
+
+    QJsonObject body;
+    body.insert(QStringLiteral("input_file_id"), fileId);
+    body.insert(QStringLiteral("endpoint"), ApiFormatManager::batchRequestUrl());
+    body.insert(QStringLiteral("completion_window"), QStringLiteral("24h"));
+    m_stage = Stage::Creating;
+    send(ApiFormatManager::batchesEndpoint(), QJsonDocument(body).toJson(QJsonDocument::Compact));
+}
+
+void LlmBatchClient::handleCreated(const QJsonObject &response)
+{
+    m_batchId = response.value(QStringLiteral("id")).toString();
+    if (m_batchId.isEmpty()) {
+        finish(false, tr("创建批任务后未返回批任务 ID"));
+        return;
+    }
+
+    emit batchCreated(m_batchId, m_requestCount);
+    m_stage = Stage::Polling;
+    m_pollIntervalMs = kInitialPollIntervalMs;
+    handleStatus(response);
+}
+
+void LlmBatchClient::handleStatus(const QJsonObject &response)
+{
+    const QString status = response.value(QStringLiteral("status")).toString();
+    const QJsonObject counts = response.value(QStringLiteral("request_counts")).toObject();
+    emit statusChanged(status,
+                       counts.value(QStringLiteral("completed")).toInt(),
+                       counts.value(QStringLiteral("failed")).toInt(),
+                       counts.value(QStringLiteral("total")).toInt(m_requestCount));
+    if (!isTerminalStatus(status)) {
+        schedulePoll();
+        return;
+    }
+
+    // 过期或取消的批任务仍可能带有部分结果，一并下载。
+    m_finalStatus = status;
+    m_pendingFileIds.clear();
+    const QStringList fileKeys = QStringList() << QStringLiteral("output_file_id") << QStringLiteral("error_file_id");
+    for (const QString &key : fileKeys) {
+        const QString fileId = response.value(key).toString();
+        if (!fileId.isEmpty()) {
+            m_pendingFileIds.append(fileId);
+        }
+    }
+    if (status == QStringLiteral("failed")) {
+        const QJsonArray errors = response.value(QStringLiteral("errors")).toObject().value(QStringLiteral("data")).toArray();
+        if (!errors.isEmpty()) {
+            m_finalStatus += QStringLiteral("：") + errorMessageOf(QJsonObject{{QStringLiteral("error"), errors.first()}});
+        }
+    }
+    m_stage = Stage::Downloading;
+    downloadNextFile();
+}
+
+void LlmBatchClient::schedulePoll()
+{
+    m_pollTimer->start(m_pollIntervalMs);
+    m_pollIntervalMs = qMin(m_pollIntervalMs * 2, kMaxPollIntervalMs);
+}
+
+void LlmBatchClient::poll()
+{
+    if (m_stage != Stage::Polling || m_batchId.isEmpty()) {
+        return;
+    }
+    send(ApiFormatManager::batchStatusEndpoint(m_batchId), QByteArray());
+}
+
+void LlmBatchClient::downloadNextFile()
+{
+    if (m_stage != Stage::Downloading) {
+        return;
+    }
+    if (m_pendingFileIds.isEmpty()) {
+        finish(m_finalStatus == QStringLiteral("completed"), tr("批任务 %1 结束：%2").arg(m_batchId, m_finalStatus));
+        return;
+    }
+    send(ApiFormatManager::batchFileContentEndpoint(m_pendingFileIds.takeFirst()), QByteArray());
+}
+
+void LlmBatchClient::deliverResults(const QByteArray &content)
+{
+    const QList<QByteArray> lines = content.split('\n');
+    for (const QByteArray &line : lines) {
+        // 信号处理中可能已取消批任务。
+        if (m_stage != Stage::Downloading) {
+            return;
+        }
+
+        const QJsonObject record = QJsonDocument::fromJson(line.trimmed()).object();
+        const QString customId = record.value(QStringLiteral("custom_id")).toString();
+        if (customId.isEmpty()) {
+            continue;
+        }
+
+        const QJsonObject response = record.value(QStringLiteral("response")).toObject();
+        const int statusCode = response.value(QStringLiteral("status_code")).toInt();
+        const QJsonObject body = response.value(QStringLiteral("body")).toObject();
+        if (statusCode == 200 && !record.value(QStringLiteral("error")).isObject()) {
+            emit resultReady(customId, LlmServiceClient::extractChatContent(body));
+            continue;
+        }
+
+        QString message = errorMessageOf(record);
+        if (message.isEmpty()) {
+            message = errorMessageOf(body);
+        }
+        if (message.isEmpty()) {
+            message = QStringLiteral("HTTP %1").arg(statusCode);
+        }
+        emit resultFailed(customId, message);
+    }
+}
+
+void LlmBatchClient::finish(bool success, const QString &message)
+{
+    m_stage = Stage::Idle;
+    m_pollTimer->stop();
+    m_pendingFileIds.clear();
+    emit batchFinished(success, message);
+}
+
+QString LlmBatchClient::errorMessageOf(const QJsonObject &object)
+{
+    const QJsonValue error = object.value(QStringLiteral("error"));
+    if (error.isObject()) {
+        return error.toObject().value(QStringLiteral("message")).toString().trimmed();
+    }
+    return error.toString().trimmed();
+}
@@ -0,0 +1,92 @@
+#ifndef LLMBATCHCLIENT_H
+#define LLMBATCHCLIENT_H
+
+#include "llmserviceclient.h"
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class QNetworkAccessManager;
+class QNetworkReply;
+class QTimer;
+
+struct LlmBatchRequest
+{
+    // 结果行按 custom_id 对应回请求，同一批内不可重复。
+    QString customId;
+    QJsonArray messages;
+    QJsonObject options;
+    QJsonObject responseSchema;
+};
+
+// OpenAI 兼容批量接口：把全部请求写成一份 JSONL 上传（/files，purpose=batch），创建批任务（/batches），
+// 按退避间隔轮询状态，结束后下载结果与错误文件并逐行交付。与 LlmServiceClient 共用请求头与请求体构造，
+// 结果行的正文按非流式聊天响应解析。一个客户端同时只跟踪一个批任务。
+class LlmBatchClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LlmBatchClient(QObject *parent = nullptr);
+    ~LlmBatchClient() override;
+
+    bool isActive() const;
+    QString batchId() const;
+    // 上传输入文件并创建批任务；已有批任务、参数无效或 Provider 不支持时返回 false（不发出信号）。
+    bool submit(const LlmServiceConfig &config, const QVector<LlmBatchRequest> &requests);
+    // 继续跟踪已创建的批任务（如程序重启后），直接进入轮询。
+    bool attach(const LlmServiceConfig &config, const QString &batchId);
+    // 请求服务端取消批任务并停止跟踪；之后不再发出任何信号。
+    void cancel();
+
+signals:
+    void batchCreated(const QString &batchId, int requestCount);
+    // status 为服务端原样状态（validating / in_progress / finalizing / completed ...）。
+    void statusChanged(const QString &status, int completedCount, int failedCount, int totalCount);
+    void resultReady(const QString &customId, const QString &content);
+    void resultFailed(const QString &customId, const QString &message);
+    // 批任务结束（含失败、过期与取消）；已交付的结果之外的请求均未完成。
+    void batchFinished(bool success, const QString &message);
+
+private:
+    enum class Stage {
+        Idle,
+        Uploading,
+        Creating,
+        Polling,
+        Downloading
+    };
+
+    QNetworkReply *send(const QString &endpointPath, const QByteArray &payload);
+    void watchReply(QNetworkReply *reply);
+    void onReplyFinished(QNetworkReply *reply);
+    void handleUploaded(const QJsonObject &response);
+    void handleCreated(const QJsonObject &response);
+    void handleStatus(const QJsonObject &response);
+    void schedulePoll();
+    void poll();
+    // 依次下载 m_pendingFileIds 中的文件，全部处理后结束批任务。
+    void downloadNextFile();
+    void deliverResults(const QByteArray &content);
+    void finish(bool success, const QString &message);
+    static QString errorMessageOf(const QJsonObject &object);
+
+    QNetworkAccessManager *m_networkManager = nullptr;
+    QTimer *m_pollTimer = nullptr;
+    QPointer<QNetworkReply> m_reply;
+    LlmServiceConfig m_config;
+    Stage m_stage = Stage::Idle;
+    QString m_batchId;
+    QString m_finalStatus;
+    QStringList m_pendingFileIds;
+    int m_requestCount = 0;
+    int m_pollIntervalMs = 0;
+    int m_pollFailures = 0;
+};
+
+#endif // LLMBATCHCLIENT_H
@@ -0,0 +1,235 @@
+#include "llmendpointpool.h"
+
+#include <QDateTime>
+#include <QRegularExpression>
+#include <QStringList>
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+const qint64 kBaseCooldownMs = 2000;
+const qint64 kMaxCooldownMs = 30000;
+const int kMaxLatencySamples = 64;
+// 样本过少时分位数不可信，不据此触发对冲。
+const int kMinLatencySamples = 5;
+
+qint64 nowMs()
+{
+    return QDateTime::currentMSecsSinceEpoch();
+}
+
+void appendSample(QVector<qint64> *samples, int *nextSlot, qint64 elapsedMs)
+{
+    if (samples->size() < kMaxLatencySamples) {
+        samples->append(elapsedMs);
+    } else {
+        (*samples)[*nextSlot] = elapsedMs;
+    }
+    *nextSlot = (*nextSlot + 1) % kMaxLatencySamples;
+}
+
+qint64 samplePercentile(QVector<qint64> samples, double quantile)
+{
+    if (samples.size() < kMinLatencySamples) {
+        return -1;
+    }
+
+    const int rank = qBound(0, static_cast<int>(quantile * samples.size()), samples.size() - 1);
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+    return samples.at(rank);
+}
+}
+
+QVector<LlmEndpoint> LlmEndpointPool::parseEndpointList(const QString &specText)
+{
+    QVector<LlmEndpoint> endpoints;
+    const QStringList items = specText.split(QRegularExpression(QStringLiteral("[;\\n]")), Qt::SkipEmptyParts);
+    for (const QString &item : items) {
+        const QStringList fields = item.split('|');
+        LlmEndpoint endpoint;
+        endpoint.baseUrl = fields.value(0).trimmed();
+        if (endpoint.baseUrl.isEmpty()) {
+            continue;
+        }
+
+        bool ok = false;
+        const int weight = fields.value(1).trimmed().toInt(&ok);
+        if (ok && weight > 0) {
+            endpoint.weight = weight;
+        }
+        const int maxConcurrent = fields.value(2).trimmed().toInt(&ok);
+        if (ok && maxConcurrent > 0) {
+            endpoint.maxConcurrent = maxConcurrent;
+        }
+        endpoints.append(endpoint);
+    }
+    return endpoints;
+}
+
+void LlmEndpointPool::setEndpoints(const QVector<LlmEndpoint> &endpoints)
+{
+    m_states.clear();
+    m_states.reserve(endpoints.size());
+    for (const LlmEndpoint &endpoint : endpoints) {
+        EndpointState state;
+        state.spec = endpoint;
+        m_states.append(state);
+    }
+}
+
+int LlmEndpointPool::size() const
+{
+    return m_states.size();
+}
+
+const LlmEndpoint &LlmEndpointPool::endpoint(int index) const
+{
+    return m_states.at(index).spec;
+}
+
+int LlmEndpointPool::acquire(const QSet<int> &excluded)
+{
+    const qint64 now = nowMs();
+    int bestHealthy = -1;
+    double bestHealthyLoad = std::numeric_limits<double>::max();
+    int earliestRecovering = -1;
+    qint64 earliestCooldown = std::numeric_limits<qint64>::max();
+
+    for (int i = 0; i < m_states.size(); ++i) {
+        const EndpointState &state = m_states.at(i);
+        if (excluded.contains(i) || !hasCapacity(state)) {
+            continue;
+        }
+
+        if (state.cooldownUntilMs <= now) {
+            const double load = (state.outstanding + 1.0) / qMax(1, state.spec.weight);
+            if (load < bestHealthyLoad) {
+                bestHealthyLoad = load;
+                bestHealthy = i;
+            }
+        } else if (state.outstanding == 0 && state.cooldownUntilMs < earliestCooldown) {
+            earliestCooldown = state.cooldownUntilMs;
+            earliestRecovering = i;
+        }
+    }
+
+    int chosen = bestHealthy;
+    if (chosen < 0) {
+        // 没有健康端点时才动用冷却中的端点，且每个端点同时只放行一个探测请求。
+        bool anyHealthy = false;
+        for (int i = 0; i < m_states.size(); ++i) {
+            if (!excluded.contains(i) && m_states.at(i).cooldownUntilMs <= now) {
+                anyHealthy = true;
+                break;
+            }
+        }
+        if (!anyHealthy) {
+            chosen = earliestRecovering;
+        }
+    }
+
+    if (chosen >= 0) {
+        ++m_states[chosen].outstanding;
+    }
+    return chosen;
+}
+
+void LlmEndpointPool::release(int index)
+{
+    if (index < 0 || index >= m_states.size()) {
+        return;
+    }
+    m_states[index].outstanding = qMax(0, m_states.at(index).outstanding - 1);
+}
+
+void LlmEndpointPool::reportSuccess(int index)
+{
+    if (index < 0 || index >= m_states.size()) {
+        return;
+    }
+    m_states[index].consecutiveFailures = 0;
+    m_states[index].cooldownUntilMs = 0;
+}
+
+void LlmEndpointPool::reportFailure(int index)
+{
+    if (index < 0 || index >= m_states.size()) {
+        return;
+    }
+
+    EndpointState &state = m_states[index];
+    ++state.consecutiveFailures;
+    const int shift = qMin(state.consecutiveFailures - 1, 4);
+    state.cooldownUntilMs = nowMs() + qMin(kMaxCooldownMs, kBaseCooldownMs << shift);
+}
+
+bool LlmEndpointPool::isHealthy(int index) const
+{
+    return index >= 0 && index < m_states.size() && m_states.at(index).cooldownUntilMs <= nowMs();
+}
+
+int LlmEndpointPool::outstanding(int index) const
+{
+    return (index >= 0 && index < m_states.size()) ? m_states.at(index).outstanding : 0;
+}
+
+bool LlmEndpointPool::hasAlternative(const QSet<int> &excluded) const
+{
+    for (int i = 0; i < m_states.size(); ++i) {
+        if (!excluded.contains(i)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int LlmEndpointPool::suggestedConcurrency() const
+{
+    int total = 0;
+    for (const EndpointState &state : m_states) {
+        total += state.spec.maxConcurrent > 0 ? state.spec.maxConcurrent : 1;
+    }
+    return qMax(1, total);
+}
+
+void LlmEndpointPool::recordLatency(int index, qint64 elapsedMs)
+{
+    if (index < 0 || index >= m_states.size() || elapsedMs < 0) {
+        return;
+    }
+
+    EndpointState &state = m_states[index];
+    appendSample(&state.latencySamples, &state.nextLatencySlot, elapsedMs);
+}
+
+qint64 LlmEndpointPool::latencyPercentile(int index, double quantile) const
+{
+    if (index < 0 || index >= m_states.size()) {
+        return -1;
+    }
+    return samplePercentile(m_states.at(index).latencySamples, quantile);
+}
+
+void LlmEndpointPool::recordFirstTokenLatency(int index, qint64 elapsedMs)
+{
+    if (index < 0 || index >= m_states.size() || elapsedMs < 0) {
+        return;
+    }
+
+    EndpointState &state = m_states[index];
+    appendSample(&state.firstTokenSamples, &state.nextFirstTokenSlot, elapsedMs);
+}
+
+qint64 LlmEndpointPool::firstTokenPercentile(int index, double quantile) const
+{
+    if (index < 0 || index >= m_states.size()) {
+        return -1;
+    }
+    return samplePercentile(m_states.at(index).firstTokenSamples, quantile);
+}
+
+bool LlmEndpointPool::hasCapacity(const EndpointState &state) const
+{
+    return state.spec.maxConcurrent <= 0 || state.outstanding < state.spec.maxConcurrent;
+}
@@ -0,0 +1,72 @@
+#ifndef LLMENDPOINTPOOL_H
+#define LLMENDPOINTPOOL_H
+
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+struct LlmEndpoint
+{
+    QString baseUrl;
+    // 相对权重：负载按 在途请求数 / 权重 比较。
+    int weight = 1;
+    // 并发上限，0 表示不限。
+    int maxConcurrent = 0;
+};
+
+class LlmEndpointPool
+{
+public:
+    // 解析端点列表：以分号或换行分隔，每项为 "url|weight|maxConcurrent"，后两项可省略。
+    static QVector<LlmEndpoint> parseEndpointList(const QString &specText);
+
+    // 替换端点集合并清空运行态（在途计数与健康状态）。
+    void setEndpoints(const QVector<LlmEndpoint> &endpoints);
+    int size() const;
+    const LlmEndpoint &endpoint(int index) const;
+
+    // 按“最少在途请求（按权重折算）”选出端点并计入在途；excluded 中的端点跳过。
+    // 健康端点优先；全部处于冷却期时选最早恢复的端点做探测。无可用容量时返回 -1。
+    int acquire(const QSet<int> &excluded = QSet<int>());
+    // 请求结束（无论成败）时归还在途计数。
+    void release(int index);
+    // 成功后清除连续失败计数。
+    void reportSuccess(int index);
+    // 失败后进入指数退避冷却（2s 起，上限 30s）。
+    void reportFailure(int index);
+
+    bool isHealthy(int index) const;
+    int outstanding(int index) const;
+    // 除 excluded 外是否还有端点可接手（不论当前是否有空闲容量）。
+    bool hasAlternative(const QSet<int> &excluded) const;
+    // 建议的并发请求数：各端点并发上限之和，不限并发的端点按 1 计。
+    int suggestedConcurrency() const;
+
+    // 记录一次成功请求的完整耗时（仅保留最近的样本）。
+    void recordLatency(int index, qint64 elapsedMs);
+    // 最近样本的分位耗时（quantile 取 0~1）；样本不足时返回 -1。
+    qint64 latencyPercentile(int index, double quantile) const;
+    // 流式请求的首个增量耗时，与完整耗时分开统计（完整耗时随输出长度增长）。
+    void recordFirstTokenLatency(int index, qint64 elapsedMs);
+    qint64 firstTokenPercentile(int index, double quantile) const;
+
+private:
+    struct EndpointState
+    {
+        LlmEndpoint spec;
+        int outstanding = 0;
+        int consecutiveFailures = 0;
+        qint64 cooldownUntilMs = 0;
+        // 最近成功请求耗时的环形缓冲。
+        QVector<qint64> latencySamples;
+        int nextLatencySlot = 0;
+        QVector<qint64> firstTokenSamples;
+        int nextFirstTokenSlot = 0;
+    };
+
+    bool hasCapacity(const EndpointState &state) const;
+
+    QVector<EndpointState> m_states;
+};
+
+#endif // LLMENDPOINTPOOL_H
@@ -0,0 +1,759 @@
+#include "llmmockserver.h"
+#include "segmentwirecodec.h"
+
+#include <QFile>
+#include <QHostAddress>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QRandomGenerator>
+#include <QRegularExpression>
+#include <QStringList>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QtGlobal>
+
+namespace {
+const char kMockModelName[] = "mock-model";
+
+QByteArray statusText(int status)
+{
+    switch (status) {
+    case 200:
+        return QByteArrayLiteral("OK");
+    case 400:
+        return QByteArrayLiteral("Bad Request");
+    case 404:
+        return QByteArrayLiteral("Not Found");
+    case 503:
+        return QByteArrayLiteral("Service Unavailable");
+    default:
+        return QByteArrayLiteral("Error");
+    }
+}
+
+// contentLength < 0 表示流式响应：不带长度，发送完毕后关闭连接。
+QByteArray responseHead(int status, const QByteArray &contentType, qint64 contentLength)
+{
+    QByteArray head = "HTTP/1.1 " + QByteArray::number(status) + ' ' + statusText(status) + "\r\n";
+    head += "Content-Type: " + contentType + "\r\n";
+    if (contentLength >= 0) {
+        head += "Content-Length: " + QByteArray::number(contentLength) + "\r\n";
+        head += "Connection: keep-alive\r\n";
+    } else {
+        head += "Cache-Control: no-cache\r\n";
+        head += "Connection: close\r\n";
+    }
+    head += "\r\n";
+    return head;
+}
+
+QJsonObject errorObject(const QString &message)
+{
+    QJsonObject error;
+    error.insert(QStringLiteral("message"), message);
+    QJsonObject root;
+    root.insert(QStringLiteral("error"), error);
+    return root;
+}
+
+int environmentInt(const char *name, int fallback)
+{
+    bool ok = false;
+    const int value = qEnvironmentVariableIntValue(name, &ok);
+    return ok ? value : fallback;
+}
+
+// 约 4 字符一个 token，与常见分词器对中英混排的平均粒度接近。
+QStringList splitIntoTokens(const QString &text)
+{
+    QStringList tokens;
+    for (int i = 0; i < text.size(); i += 4) {
+        tokens.append(text.mid(i, 4));
+    }
+    return tokens;
+}
+
+// 按聊天模板的顺序线性化消息（角色 + 内容），前缀缓存按此比较。
+QString linearizedPrompt(const QJsonObject &request)
+{
+    QString text;
+    const QJsonArray messages = request.value(QStringLiteral("messages")).toArray();
+    for (const QJsonValue &value : messages) {
+        const QJsonObject message = value.toObject();
+        text += message.value(QStringLiteral("role")).toString();
+        text += QLatin1Char('\n');
+        text += message.value(QStringLiteral("content")).toString();
+        text += QLatin1Char('\n');
+    }
+    return text;
+}
+
+bool isIndexLine(const QString &line)
+{
+    static const QRegularExpression regex(QStringLiteral(R"(^\d{1,9}$)"));
+    return regex.match(line.trimmed()).hasMatch();
+}
+
+// multipart/form-data 请求体以 "--boundary" 行开头；取出名为 name 的部分内容。
+QByteArray multipartField(const QByteArray &body, const QByteArray &name)
+{
+    const int firstLineEnd = body.indexOf("\r\n");
+    if (!body.startsWith("--") || firstLineEnd < 0) {
+        return QByteArray();
+    }
+
+    const QByteArray delimiter = "\r\n" + body.left(firstLineEnd);
+    int partStart = firstLineEnd + 2;
+    while (partStart < body.size()) {
+        const int headerEnd = body.indexOf("\r\n\r\n", partStart);
+        if (headerEnd < 0) {
+            break;
+        }
+        int partEnd = body.indexOf(delimiter, headerEnd);
+        if (partEnd < 0) {
+            partEnd = body.size();
+        }
+
+        const QByteArray headers = body.mid(partStart, headerEnd - partStart);
+        if (headers.contains("name=\"" + name + "\"")) {
+            return body.mid(headerEnd + 4, partEnd - headerEnd - 4);
+        }
+        partStart = partEnd + delimiter.size() + 2;
+    }
+    return QByteArray();
+}
+
+bool isTimingLine(const QString &line)
+{
+    static const QRegularExpression regex(
+        QStringLiteral(R"(^\d{2}:\d{2}:\d{2}[,\.]\d{3}\s*-->\s*\d{2}:\d{2}:\d{2}[,\.]\d{3})"));
+    return regex.match(line.trimmed()).hasMatch();
+}
+}
+
+bool LlmMockServerOptions::fromEnvironment(LlmMockServerOptions *options)
+{
+    bool ok = false;
+    const int port = qEnvironmentVariableIntValue("QSRTTOOL_MOCK_LLM_PORT", &ok);
+    if (!options || !ok || port <= 0 || port > 65535) {
+        return false;
+    }
+
+    options->port = static_cast<quint16>(port);
+    options->replayPath = qEnvironmentVariable("QSRTTOOL_MOCK_LLM_REPLAY").trimmed();
+    options->firstByteLatencyMs = qMax(0, environmentInt("QSRTTOOL_MOCK_LLM_LATENCY_MS", options->firstByteLatencyMs));
+    options->tokensPerSecond = qMax(1, environmentInt("QSRTTOOL_MOCK_LLM_TOKENS_PER_SEC", options->tokensPerSecond));
+    options->errorRatePercent = qBound(0, environmentInt("QSRTTOOL_MOCK_LLM_ERROR_RATE", options->errorRatePercent), 100);
+    options->prefillMsPerKToken = qMax(0, environmentInt("QSRTTOOL_MOCK_LLM_PREFILL_MS", options->prefillMsPerKToken));
+    return true;
+}
+
+LlmMockServer::LlmMockServer(const LlmMockServerOptions &options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+    , m_server(new QTcpServer(this))
+{
+    connect(m_server, &QTcpServer::newConnection, this, &LlmMockServer::onNewConnection);
+    loadRecordings();
+}
+
+bool LlmMockServer::start(QString *errorMessage)
+{
+    if (m_server->listen(QHostAddress::LocalHost, m_options.port)) {
+        return true;
+    }
+    if (errorMessage) {
+        *errorMessage = m_server->errorString();
+    }
+    return false;
+}
+
+quint16 LlmMockServer::port() const
+{
+    return m_server->serverPort();
+}
+
+int LlmMockServer::recordedExchangeCount() const
+{
+    return m_recordings.size();
+}
+
+void LlmMockServer::loadRecordings()
+{
+    if (m_options.replayPath.isEmpty()) {
+        return;
+    }
+
+    QFile file(m_options.replayPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    while (!file.atEnd()) {
+        const QJsonDocument document = QJsonDocument::fromJson(file.readLine());
+        const QJsonObject record = document.object();
+        const QJsonObject request = record.value(QStringLiteral("request")).toObject();
+        if (request.isEmpty()) {
+            continue;
+        }
+
+        RecordedExchange exchange;
+        exchange.status = record.value(QStringLiteral("status")).toInt(200);
+        exchange.stream = record.value(QStringLiteral("stream")).toBool(false);
+        exchange.totalMs = static_cast<qint64>(record.value(QStringLiteral("totalMs")).toDouble());
+        exchange.body = record.value(QStringLiteral("body")).toString().toUtf8();
+        const QJsonArray chunks = record.value(QStringLiteral("chunks")).toArray();
+        for (const QJsonValue &value : chunks) {
+            const QJsonObject chunk = value.toObject();
+            exchange.chunks.append(qMakePair(static_cast<qint64>(chunk.value(QStringLiteral("atMs")).toDouble()),
+                                             chunk.value(QStringLiteral("data")).toString().toUtf8()));
+        }
+
+        // QJsonObject 按键排序序列化，紧凑输出即可作为请求体的规范形式。
+        m_recordings.insert(QJsonDocument(request).toJson(QJsonDocument::Compact), exchange);
+    }
+}
+
+void LlmMockServer::onNewConnection()
+{
+    while (m_server->hasPendingConnections()) {
+        QTcpSocket *socket = m_server->nextPendingConnection();
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+            consumeRequests(socket);
+        });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            m_buffers.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void LlmMockServer::consumeRequests(QTcpSocket *socket)
+{
+    struct PendingRequest
+    {
+        QByteArray method;
+        QString path;
+        QByteArray body;
+    };
+
+    QByteArray buffer = m_buffers.take(socket) + socket->readAll();
+    QVector<PendingRequest> requests;
+    while (true) {
+        const int headerEnd = buffer.indexOf("\r\n\r\n");
+        if (headerEnd < 0) {
+            break;
+        }
+
+        const QList<QByteArray> headerLines = buffer.left(headerEnd).split('\n');
+        qint64 contentLength = 0;
+        for (int i = 1; i < headerLines.size(); ++i) {
+            const QByteArray line = headerLines.at(i).trimmed();
+            const int colon = line.indexOf(':');
+            if (colon > 0 && line.left(colon).trimmed().toLower() == "content-length") {
+                contentLength = line.mid(colon + 1).trimmed().toLongLong();
+            }
+        }
+
+        const int bodyStart = headerEnd + 4;
+        if (buffer.size() - bodyStart < contentLength) {
+            break;
+        }
+
+        const QList<QByteArray> requestLine = headerLines.value(0).trimmed().split(' ');
+        PendingRequest request;
+        request.method = requestLine.value(0);
+        request.path = QString::fromLatin1(requestLine.value(1)).section(QLatin1Char('?'), 0, 0);
+        request.body = buffer.mid(bodyStart, static_cast<int>(contentLength));
+        requests.append(request);
+        buffer.remove(0, bodyStart + static_cast<int>(contentLength));
+    }
+
+    m_buffers.insert(socket, buffer);
+    for (const PendingRequest &request : requests) {
+        handleRequest(socket, request.method, request.path, request.body);
+    }
+}
+
+void LlmMockServer::handleRequest(QTcpSocket *socket, const QByteArray &method, const QString &path, const QByteArray &body)
+{
+    if (path.contains(QStringLiteral("/files")) || path.contains(QStringLiteral("/batches"))) {
+        handleBatchRequest(socket, method, path, body);
+        return;
+    }
+
+    if (method == "GET") {
+        QJsonObject model;
+        QJsonObject response;
+        if (path.endsWith(QStringLiteral("/api/tags"))) {
+            model.insert(QStringLiteral("name"), QString::fromLatin1(kMockModelName));
+            response.insert(QStringLiteral("models"), QJsonArray{model});
+        } else if (path.endsWith(QStringLiteral("/models"))) {
+            model.insert(QStringLiteral("id"), QString::fromLatin1(kMockModelName));
+            model.insert(QStringLiteral("object"), QStringLiteral("model"));
+            response.insert(QStringLiteral("data"), QJsonArray{model});
+        } else {
+            sendJson(socket, 404, errorObject(QStringLiteral("unknown path: %1").arg(path)));
+            return;
+        }
+        sendJson(socket, 200, response);
+        return;
+    }
+
+    if (method == "POST"
+        && (path.endsWith(QStringLiteral("/translate")) || path.endsWith(QStringLiteral("/translate_lines")))) {
+        handleMtRequest(socket, path, body);
+        return;
+    }
+
+    if (method != "POST"
+        || !(path.endsWith(QStringLiteral("/chat/completions")) || path.endsWith(QStringLiteral("/api/chat")))) {
+        sendJson(socket, 404, errorObject(QStringLiteral("unknown path: %1").arg(path)));
+        return;
+    }
+
+    if (m_options.errorRatePercent > 0
+        && static_cast<int>(QRandomGenerator::global()->bounded(100)) < m_options.errorRatePercent) {
+        sendJson(socket, 503, errorObject(QStringLiteral("mock injected failure")), m_options.firstByteLatencyMs);
+        return;
+    }
+
+    const QJsonDocument document = QJsonDocument::fromJson(body);
+    if (!document.isObject()) {
+        sendJson(socket, 400, errorObject(QStringLiteral("request body is not a JSON object")));
+        return;
+    }
+
+    const auto recorded = m_recordings.constFind(QJsonDocument(document.object()).toJson(QJsonDocument::Compact));
+    if (recorded != m_recordings.constEnd()) {
+        replayExchange(socket, recorded.value());
+        return;
+    }
+    sendSynthesizedChat(socket, path, document.object());
+}
+
+void LlmMockServer::replayExchange(QTcpSocket *socket, const RecordedExchange &exchange)
+{
+    if (!exchange.stream) {
+        const QByteArray response = responseHead(exchange.status, "application/json", exchange.body.size()) + exchange.body;
+        QTimer::singleShot(static_cast<int>(exchange.totalMs), socket, [socket, response]() {
+            socket->write(response);
+        });
+        return;
+    }
+
+    // 按录制时的到达时刻逐块写出，重现首字延迟与输出节奏。
+    socket->write(responseHead(exchange.status, "text/event-stream", -1));
+    qint64 lastAtMs = 0;
+    for (const QPair<qint64, QByteArray> &chunk : exchange.chunks) {
+        const QByteArray data = chunk.second;
+        lastAtMs = qMax(lastAtMs, chunk.first);
+        QTimer::singleShot(static_cast<int>(chunk.first), socket, [socket, data]() {
+            socket->write(data);
+        });
+    }
+    QTimer::singleShot(static_cast<int>(qMax(lastAtMs, exchange.totalMs)), socket, [socket]() {
+        socket->disconnectFromHost();
+    });
+}
+
+void LlmMockServer::handleMtRequest(QTcpSocket *socket, const QString &path, const QByteArray &body)
+{
+    if (m_options.errorRatePercent > 0
+        && static_cast<int>(QRandomGenerator::global()->bounded(100)) < m_options.errorRatePercent) {
+        sendJson(socket, 503, errorObject(QStringLiteral("mock injected failure")), m_options.firstByteLatencyMs);
+        return;
+    }
+
+    const QJsonObject request = QJsonDocument::fromJson(body).object();
+    const bool libreTranslate = path.endsWith(QStringLiteral("/translate"));
+    const QJsonValue input = request.value(libreTranslate ? QStringLiteral("q") : QStringLiteral("texts"));
+    const QString target = request.value(libreTranslate ? QStringLiteral("target") : QStringLiteral("target_lang")).toString();
+    if (target.isEmpty() || !(input.isArray() || (libreTranslate && input.isString()))) {
+        sendJson(socket, 400, errorObject(QStringLiteral("missing %1 or target language")
+                                              .arg(libreTranslate ? QStringLiteral("q") : QStringLiteral("texts"))));
+        return;
+    }
+
+    // LibreTranslate 的 q 可为单个字符串，此时 translatedText 也是字符串。
+    QJsonObject response;
+    if (input.isString()) {
+        response.insert(QStringLiteral("translatedText"), QStringLiteral("[mock %1] %2").arg(target, input.toString()));
+    } else {
+        QJsonArray translations;
+        for (const QJsonValue &line : input.toArray()) {
+            translations.append(QStringLiteral("[mock %1] %2").arg(target, line.toString()));
+        }
+        response.insert(libreTranslate ? QStringLiteral("translatedText") : QStringLiteral("translations"), translations);
+    }
+    sendJson(socket, 200, response, m_options.firstByteLatencyMs);
+}
+
+void LlmMockServer::sendSynthesizedChat(QTcpSocket *socket, const QString &path, const QJsonObject &request)
+{
+    const bool ollama = path.endsWith(QStringLiteral("/api/chat"));
+    const bool stream = request.value(QStringLiteral("stream")).toBool(false);
+    const QString content = synthesizeContent(request);
+    const QStringList tokens = splitIntoTokens(content);
+    const int promptTokens = QJsonDocument(request).toJson(QJsonDocument::Compact).size() / 4;
+    const double tokenIntervalMs = 1000.0 / m_options.tokensPerSecond;
+    const int firstByteMs = m_options.firstByteLatencyMs + takePrefillDelayMs(request);
+
+    QJsonObject usage;
+    usage.insert(QStringLiteral("prompt_tokens"), promptTokens);
+    usage.insert(QStringLiteral("completion_tokens"), tokens.size());
+    usage.insert(QStringLiteral("total_tokens"), promptTokens + tokens.size());
+
+    if (!stream) {
+        QJsonObject message;
+        message.insert(QStringLiteral("role"), QStringLiteral("assistant"));
+        message.insert(QStringLiteral("content"), content);
+
+        QJsonObject response;
+        if (ollama) {
+            response.insert(QStringLiteral("message"), message);
+            response.insert(QStringLiteral("done"), true);
+            response.insert(QStringLiteral("prompt_eval_count"), promptTokens);
+            response.insert(QStringLiteral("eval_count"), tokens.size());
+        } else {
+            response = chatCompletionObject(content, promptTokens, tokens.size());
+        }
+        sendJson(socket,
+                 200,
+                 response,
+                 firstByteMs + static_cast<int>(tokens.size() * tokenIntervalMs));
+        return;
+    }
+
+    socket->write(responseHead(200, ollama ? "application/x-ndjson" : "text/event-stream", -1));
+    for (int i = 0; i < tokens.size(); ++i) {
+        QByteArray frame;
+        if (ollama) {
+            QJsonObject message;
+            message.insert(QStringLiteral("role"), QStringLiteral("assistant"));
+            message.insert(QStringLiteral("content"), tokens.at(i));
+            QJsonObject object;
+            object.insert(QStringLiteral("message"), message);
+            object.insert(QStringLiteral("done"), false);
+            frame = QJsonDocument(object).toJson(QJsonDocument::Compact) + '\n';
+        } else {
+            QJsonObject delta;
+            delta.insert(QStringLiteral("content"), tokens.at(i));
+            QJsonObject choice;
+            choice.insert(QStringLiteral("index"), 0);
+            choice.insert(QStringLiteral("delta"), delta);
+            QJsonObject object;
+            object.insert(QStringLiteral("choices"), QJsonArray{choice});
+            frame = "data: " + QJsonDocument(object).toJson(QJsonDocument::Compact) + "\n\n";
+        }
+
+        const int atMs = firstByteMs + static_cast<int>(i * tokenIntervalMs);
+        QTimer::singleShot(atMs, socket, [socket, frame]() {
+            socket->write(frame);
+        });
+    }
+
+    QByteArray finalFrame;
+    if (ollama) {
+        QJsonObject message;
+        message.insert(QStringLiteral("role"), QStringLiteral("assistant"));
+        message.insert(QStringLiteral("content"), QString());
+        QJsonObject object;
+        object.insert(QStringLiteral("message"), message);
+        object.insert(QStringLiteral("done"), true);
+        object.insert(QStringLiteral("prompt_eval_count"), promptTokens);
+        object.insert(QStringLiteral("eval_count"), tokens.size());
+        finalFrame = QJsonDocument(object).toJson(QJsonDocument::Compact) + '\n';
+    } else {
+        QJsonObject choice;
+        choice.insert(QStringLiteral("index"), 0);
+        choice.insert(QStringLiteral("delta"), QJsonObject());
+        choice.insert(QStringLiteral("finish_reason"), QStringLiteral("stop"));
+        QJsonObject object;
+        object.insert(QStringLiteral("choices"), QJsonArray{choice});
+        object.insert(QStringLiteral("usage"), usage);
+        finalFrame = "data: " + QJsonDocument(object).toJson(QJsonDocument::Compact) + "\n\ndata: [DONE]\n\n";
+    }
+
+    const int finalAtMs = firstByteMs + static_cast<int>(tokens.size() * tokenIntervalMs);
+    QTimer::singleShot(finalAtMs, socket, [socket, finalFrame]() {
+        socket->write(finalFrame);
+        socket->disconnectFromHost();
+    });
+}
+
+int LlmMockServer::takePrefillDelayMs(const QJsonObject &request)
+{
+    if (m_options.prefillMsPerKToken <= 0) {
+        return 0;
+    }
+
+    const QString prompt = linearizedPrompt(request);
+    const int limit = qMin(prompt.size(), m_cachedPrompt.size());
+    int cached = 0;
+    while (cached < limit && prompt.at(cached) == m_cachedPrompt.at(cached)) {
+        ++cached;
+    }
+    m_cachedPrompt = prompt;
+    // 与输出相同按约 4 字符一个 token 折算。
+    const qint64 uncachedTokens = (prompt.size() - cached) / 4;
+    return static_cast<int>(uncachedTokens * m_options.prefillMsPerKToken / 1000);
+}
+
+void LlmMockServer::sendJson(QTcpSocket *socket, int status, const QJsonObject &object, int delayMs)
+{
+    const QByteArray payload = QJsonDocument(object).toJson(QJsonDocument::Compact);
+    const QByteArray response = responseHead(status, "application/json", payload.size()) + payload;
+    if (delayMs <= 0) {
+        socket->write(response);
+        return;
+    }
+    QTimer::singleShot(delayMs, socket, [socket, response]() {
+        socket->write(response);
+    });
+}
+
+QJsonObject LlmMockServer::chatCompletionObject(const QString &content, int promptTokens, int completionTokens) const
+{
+    QJsonObject message;
+    message.insert(QStringLiteral("role"), QStringLiteral("assistant"));
+    message.insert(QStringLiteral("content"), content);
+
+    QJsonObject choice;
+    choice.insert(QStringLiteral("index"), 0);
+    choice.insert(QStringLiteral("message"), message);
+    choice.insert(QStringLiteral("finish_reason"), QStringLiteral("stop"));
+
+    QJsonObject usage;
+    usage.insert(QStringLiteral("prompt_tokens"), promptTokens);
+    usage.insert(QStringLiteral("completion_tokens"), completionTokens);
+    usage.insert(QStringLiteral("total_tokens"), promptTokens + completionTokens);
+
+    QJsonObject response;
+    response.insert(QStringLiteral("model"), QString::fromLatin1(kMockModelName));
+    response.insert(QStringLiteral("choices"), QJsonArray{choice});
+    response.insert(QStringLiteral("usage"), usage);
+    return response;
+}
+
+void LlmMockServer::handleBatchRequest(QTcpSocket *socket, const QByteArray &method, const QString &path, const QByteArray &body)
+{
+    const bool filesPath = path.contains(QStringLiteral("/files"));
+    const QString collection = filesPath ? QStringLiteral("/files") : QStringLiteral("/batches");
+    const QStringList tail = path.mid(path.indexOf(collection) + collection.size()).split(QLatin1Char('/'), Qt::SkipEmptyParts);
+
+    if (filesPath && method == "POST" && tail.isEmpty()) {
+        const QByteArray content = multipartField(body, "file");
+        if (content.isEmpty()) {
+            sendJson(socket, 400, errorObject(QStringLiteral("missing multipart field: file")));
+            return;
+        }
+        const QString fileId = nextObjectId(QStringLiteral("file-mock"));
+        m_files.insert(fileId, content);
+        QJsonObject file;
+        file.insert(QStringLiteral("id"), fileId);
+        file.insert(QStringLiteral("object"), QStringLiteral("file"));
+        file.insert(QStringLiteral("bytes"), content.size());
+        file.insert(QStringLiteral("purpose"), QStringLiteral("batch"));
+        sendJson(socket, 200, file);
+        return;
+    }
+
+    if (filesPath && method == "GET" && tail.size() == 2 && tail.at(1) == QStringLiteral("content")) {
+        const auto file = m_files.constFind(tail.at(0));
+        if (file == m_files.constEnd()) {
+            sendJson(socket, 404, errorObject(QStringLiteral("unknown file: %1").arg(tail.at(0))));
+            return;
+        }
+        socket->write(responseHead(200, "application/jsonl", file.value().size()) + file.value());
+        return;
+    }
+
+    if (!filesPath && method == "POST" && tail.isEmpty()) {
+        const QString inputFileId = QJsonDocument::fromJson(body).object().value(QStringLiteral("input_file_id")).toString();
+        if (!m_files.contains(inputFileId)) {
+            sendJson(socket, 404, errorObject(QStringLiteral("unknown input file: %1").arg(inputFileId)));
+            return;
+        }
+
+        MockBatch batch;
+        batch.id = nextObjectId(QStringLiteral("batch_mock"));
+        batch.status = QStringLiteral("validating");
+        batch.inputFileId = inputFileId;
+        m_batches.insert(batch.id, batch);
+        sendJson(socket, 200, batchObject(batch));
+
+        const QString batchId = batch.id;
+        QTimer::singleShot(m_options.firstByteLatencyMs, this, [this, batchId]() {
+            auto it = m_batches.find(batchId);
+            if (it == m_batches.end() || it->status != QStringLiteral("validating")) {
+                return;
+            }
+            it->status = QStringLiteral("in_progress");
+            const int durationMs = runBatch(it.value());
+            QTimer::singleShot(durationMs, this, [this, batchId]() {
+                auto finished = m_batches.find(batchId);
+                if (finished != m_batches.end() && finished->status == QStringLiteral("in_progress")) {
+                    finished->status = QStringLiteral("completed");
+                }
+            });
+        });
+        return;
+    }
+
+    const auto batch = m_batches.find(tail.value(0));
+    if (filesPath || batch == m_batches.end()) {
+        sendJson(socket, 404, errorObject(QStringLiteral("unknown path: %1").arg(path)));
+        return;
+    }
+    if (method == "POST" && tail.value(1) == QStringLiteral("cancel")) {
+        if (batch->status == QStringLiteral("validating") || batch->status == QStringLiteral("in_progress")) {
+            batch->status = QStringLiteral("cancelled");
+        }
+    }
+    sendJson(socket, 200, batchObject(batch.value()));
+}
+
+int LlmMockServer::runBatch(MockBatch &batch)
+{
+    const double tokenIntervalMs = 1000.0 / m_options.tokensPerSecond;
+    const QList<QByteArray> lines = m_files.value(batch.inputFileId).split('\n');
+    QByteArray output;
+    QByteArray errors;
+    int longestMs = 0;
+    for (const QByteArray &line : lines) {
+        const QJsonObject record = QJsonDocument::fromJson(line.trimmed()).object();
+        const QString customId = record.value(QStringLiteral("custom_id")).toString();
+        if (customId.isEmpty()) {
+            continue;
+        }
+        ++batch.total;
+
+        QJsonObject response;
+        response.insert(QStringLiteral("request_id"), nextObjectId(QStringLiteral("req_mock")));
+        if (m_options.errorRatePercent > 0
+            && static_cast<int>(QRandomGenerator::global()->bounded(100)) < m_options.errorRatePercent) {
+            response.insert(QStringLiteral("status_code"), 503);
+            response.insert(QStringLiteral("body"), errorObject(QStringLiteral("mock injected failure")));
+            ++batch.failed;
+        } else {
+            const QJsonObject request = record.value(QStringLiteral("body")).toObject();
+            const QString content = synthesizeContent(request);
+            const int completionTokens = splitIntoTokens(content).size();
+            const int promptTokens = QJsonDocument(request).toJson(QJsonDocument::Compact).size() / 4;
+            response.insert(QStringLiteral("status_code"), 200);
+            response.insert(QStringLiteral("body"), chatCompletionObject(content, promptTokens, completionTokens));
+            longestMs = qMax(longestMs, static_cast<int>(completionTokens * tokenIntervalMs));
+            ++batch.completed;
+        }
+
+        QJsonObject result;
+        result.insert(QStringLiteral("id"), nextObjectId(QStringLiteral("batch_req_mock")));
+        result.insert(QStringLiteral("custom_id"), customId);
+        result.insert(QStringLiteral("response"), response);
+        result.insert(QStringLiteral("error"), QJsonValue::Null);
+        QByteArray &target = response.value(QStringLiteral("status_code")).toInt() == 200 ? output : errors;
+        target += QJsonDocument(result).toJson(QJsonDocument::Compact) + '\n';
+    }
+
+    if (!output.isEmpty()) {
+        batch.outputFileId = nextObjectId(QStringLiteral("file-mock"));
+        m_files.insert(batch.outputFileId, output);
+    }
+    if (!errors.isEmpty()) {
+        batch.errorFileId = nextObjectId(QStringLiteral("file-mock"));
+        m_files.insert(batch.errorFileId, errors);
+    }
+    return longestMs;
+}
+
+QJsonObject LlmMockServer::batchObject(const MockBatch &batch) const
+{
+    QJsonObject counts;
+    // 完成前只报告总数，与真实服务处理中的进度类似。
+    const bool finished = batch.status == QStringLiteral("completed") || batch.status == QStringLiteral("cancelled");
+    counts.insert(QStringLiteral("total"), batch.total);
+    counts.insert(QStringLiteral("completed"), finished ? batch.completed : 0);
+    counts.insert(QStringLiteral("failed"), finished ? batch.failed : 0);
+
+    QJsonObject object;
+    object.insert(QStringLiteral("id"), batch.id);
+    object.insert(QStringLiteral("object"), QStringLiteral("batch"));
+    object.insert(QStringLiteral("endpoint"), QStringLiteral("/v1/chat/completions"));
+    object.insert(QStringLiteral("input_file_id"), batch.inputFileId);
+    object.insert(QStringLiteral("completion_window"), QStringLiteral("24h"));
+    object.insert(QStringLiteral("status"), batch.status);
+    object.insert(QStringLiteral("request_counts"), counts);
+    if (finished) {
+        object.insert(QStringLiteral("output_file_id"),
+                      batch.outputFileId.isEmpty() ? QJsonValue(QJsonValue::Null) : QJsonValue(batch.outputFileId));
+        object.insert(QStringLiteral("error_file_id"),
+                      batch.errorFileId.isEmpty() ? QJsonValue(QJsonValue::Null) : QJsonValue(batch.errorFileId));
+    }
+    return object;
+}
+
+QString LlmMockServer::nextObjectId(const QString &prefix)
+{
+    return QStringLiteral("%1-%2").arg(prefix).arg(++m_nextObjectId);
+}
+
+QString LlmMockServer::synthesizeContent(const QJsonObject &request) const
+{
+    QString userContent;
+    const QJsonArray messages = request.value(QStringLiteral("messages")).toArray();
+    for (int i = messages.size() - 1; i >= 0; --i) {
+        const QJsonObject message = messages.at(i).toObject();
+        if (message.value(QStringLiteral("role")).toString() == QStringLiteral("user")) {
+            userContent = message.value(QStringLiteral("content")).toString();
+            break;
+        }
+    }
+
+    // 只回显本段条目：上一段上下文位于分段标记之前。
+    QStringList lines = userContent.split(QLatin1Char('\n'));
+    for (int i = lines.size() - 1; i >= 0; --i) {
+        if (lines.at(i).startsWith(QStringLiteral("【待翻译")) || lines.at(i).startsWith(QStringLiteral("【补译"))
+            || lines.at(i).startsWith(QStringLiteral("【初译"))) {
+            lines = lines.mid(i + 1);
+            break;
+        }
+    }
+
+    QJsonArray items;
+    QStringList compactLines;
+    for (const QString &line : lines) {
+        int id = 0;
+        QString text;
+        if (!SegmentWireCodec::decodeLine(line, &id, &text) || text.isEmpty()) {
+            continue;
+        }
+
+        const QString translated = QStringLiteral("[mock] ") + text;
+        QJsonObject item;
+        item.insert(QStringLiteral("id"), id);
+        item.insert(QStringLiteral("text"), translated);
+        items.append(item);
+        compactLines.append(SegmentWireCodec::encodeLine(id, translated));
+    }
+
+    if (!compactLines.isEmpty()) {
+        const bool structured = request.contains(QStringLiteral("response_format"))
+                                || request.value(QStringLiteral("format")).isObject();
+        if (structured) {
+            QJsonObject root;
+            root.insert(QStringLiteral("items"), items);
+            return QString::fromUtf8(QJsonDocument(root).toJson(QJsonDocument::Compact));
+        }
+        return compactLines.join(QLatin1Char('\n'));
+    }
+
+    // SRT 模式：从第一个“序号行 + 时间轴行”起原样回显。
+    for (int i = 0; i + 1 < lines.size(); ++i) {
+        if (isIndexLine(lines.at(i)) && isTimingLine(lines.at(i + 1))) {
+            return lines.mid(i).join(QLatin1Char('\n'));
+        }
+    }
+    return QStringLiteral("[mock] ") + userContent;
+}
@@ -0,0 +1,104 @@
+#ifndef LLMMOCKSERVER_H
+#define LLMMOCKSERVER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QObject>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+class QTcpServer;
+class QTcpSocket;
+
+struct LlmMockServerOptions
+{
+    quint16 port = 0;
+    // LlmTrafficRecorder 录制的 JSONL；请求体逐字节相同时按录制内容与节奏回放。
+    QString replayPath;
+    // 首字节延迟与输出速率（按约 4 字符一个 token 切分流式数据块）。
+    int firstByteLatencyMs = 300;
+    int tokensPerSecond = 80;
+    // 注入 HTTP 503 的概率（百分比）。
+    int errorRatePercent = 0;
+    // 预填充耗时：每千个未命中前缀缓存的提示 token 追加的首字延迟（毫秒），0 表示不模拟。
+    // 前缀缓存按单槽 KV 模拟：与上一请求的消息序列（角色 + 内容）逐字符比较，公共前缀视为命中。
+    int prefillMsPerKToken = 0;
+
+    // 读取 QSRTTOOL_MOCK_LLM_PORT / _REPLAY / _LATENCY_MS / _TOKENS_PER_SEC / _ERROR_RATE / _PREFILL_MS；
+    // 未设置端口时返回 false。
+    static bool fromEnvironment(LlmMockServerOptions *options);
+};
+
+// 本地模拟 LLM 服务：OpenAI 兼容（/v1/chat/completions、/v1/models、/v1/files、/v1/batches）与 Ollama（/api/chat、/api/tags）。
+// 另模拟专用机器翻译服务：LibreTranslate（/translate）与通用行数组接口（/translate_lines），整批在首字节延迟后一次返回。
+// 录制中找不到的请求按输入回显合成译文（紧凑行 / JSON / SRT 三种格式），用于无外部服务时的性能测量。
+// 批任务在内存中执行：首字节延迟后进入 in_progress，按最长一条的输出耗时完成，注入的失败写入错误文件。
+class LlmMockServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LlmMockServer(const LlmMockServerOptions &options, QObject *parent = nullptr);
+
+    bool start(QString *errorMessage = nullptr);
+    quint16 port() const;
+    int recordedExchangeCount() const;
+
+private slots:
+    void onNewConnection();
+
+private:
+    struct MockBatch
+    {
+        QString id;
+        QString status;
+        QString inputFileId;
+        QString outputFileId;
+        QString errorFileId;
+        int total = 0;
+        int completed = 0;
+        int failed = 0;
+    };
+
+    struct RecordedExchange
+    {
+        int status = 200;
+        bool stream = false;
+        qint64 totalMs = 0;
+        QByteArray body;
+        QVector<QPair<qint64, QByteArray>> chunks;
+    };
+
+    void loadRecordings();
+    void consumeRequests(QTcpSocket *socket);
+    void handleRequest(QTcpSocket *socket, const QByteArray &method, const QString &path, const QByteArray &body);
+    void replayExchange(QTcpSocket *socket, const RecordedExchange &exchange);
+    void sendSynthesizedChat(QTcpSocket *socket, const QString &path, const QJsonObject &request);
+    void sendJson(QTcpSocket *socket, int status, const QJsonObject &object, int delayMs = 0);
+    QString synthesizeContent(const QJsonObject &request) const;
+    // 按前缀缓存模型计算本请求的预填充耗时，并以本请求替换缓存内容。
+    int takePrefillDelayMs(const QJsonObject &request);
+    QJsonObject chatCompletionObject(const QString &content, int promptTokens, int completionTokens) const;
+    // 机器翻译接口：逐行回显合成译文，注入失败与聊天接口相同。
+    void handleMtRequest(QTcpSocket *socket, const QString &path, const QByteArray &body);
+    void handleBatchRequest(QTcpSocket *socket, const QByteArray &method, const QString &path, const QByteArray &body);
+    // 执行批任务的全部请求，生成结果 / 错误文件；返回最长一条的模拟输出耗时。
+    int runBatch(MockBatch &batch);
+    QJsonObject batchObject(const MockBatch &batch) const;
+    QString nextObjectId(const QString &prefix);
+
+    LlmMockServerOptions m_options;
+    QTcpServer *m_server = nullptr;
+    QHash<QTcpSocket *, QByteArray> m_buffers;
+    QHash<QByteArray, RecordedExchange> m_recordings;
+    // 批量接口的上传文件与批任务（仅存于内存）。
+    QHash<QString, QByteArray> m_files;
+    QHash<QString, MockBatch> m_batches;
+    int m_nextObjectId = 0;
+    // 单槽前缀缓存：上一聊天请求线性化后的消息序列。
+    QString m_cachedPrompt;
+};
+
+#endif // LLMMOCKSERVER_H
@@ -13,6 +13,11 @@
 #include <QStringList>
 #include <QTimer>
 #include <QUrl>
+#if QT_CONFIG(ssl)
+#include <QSslConfiguration>
+#endif
+
+#include <limits>
 
 namespace {
 QString normalizedProvider(const QString &provider)
@@ -79,20 +84,38 @@ QString persistRequestPayloadForDebug(const QByteArray &payload,
 
 QString LlmServiceConfig::normalizedBaseUrl() const
 {
-    QString base = baseUrl.trimmed();
-    if (base.isEmpty()) {
-        base = defaultBaseUrlForProvider(provider);
-    }
-    while (base.endsWith('/')) {
-        base.chop(1);
+    const QVector<LlmEndpoint> endpointList = endpoints();
+    return endpointList.isEmpty() ? QString() : endpointList.first().baseUrl;
+}
+
+QVector<LlmEndpoint> LlmServiceConfig::endpoints() const
+{
+    QVector<LlmEndpoint> endpointList = LlmEndpointPool::parseEndpointList(baseUrl);
+    if (endpointList.isEmpty()) {
+        LlmEndpoint fallback;
+        fallback.baseUrl = defaultBaseUrlForProvider(provider);
+        endpointList.append(fallback);
     }
 
     const QString normalizedProviderName = provider.trimmed().toLower();
-    if (normalizedProviderName.contains("deepseek") && base.endsWith("/v1", Qt::CaseInsensitive)) {
-        base.chop(3);
+    for (LlmEndpoint &endpoint : endpointList) {
+        QString base = endpoint.baseUrl.trimmed();
+        while (base.endsWith('/')) {
+            base.chop(1);
+        }
+        if (normalizedProviderName.contains("deepseek") && base.endsWith("/v1", Qt::CaseInsensitive)) {
+            base.chop(3);
+        }
+        endpoint.baseUrl = base;
     }
+    return endpointList;
+}
 
-    return base;
+int LlmServiceConfig::suggestedConcurrency() const
+{
+    LlmEndpointPool pool;
+    pool.setEndpoints(endpoints());
+    return pool.suggestedConcurrency();
 }
 
 bool LlmServiceConfig::isValid() const
@@ -122,6 +145,10 @@ LlmServiceClient::LlmServiceClient(QObject *parent)
     : QObject(parent)
     , m_networkManager(new QNetworkAccessManager(this))
 {
+    const QString recordDirectory = LlmTrafficRecorder::outputDirectoryFromEnvironment();
+    if (!recordDirectory.isEmpty()) {
+        m_recorder.reset(new LlmTrafficRecorder(recordDirectory));
+    }
 }
 
 LlmServiceClient::~LlmServiceClient()
@@ -132,7 +159,7 @@ LlmServiceClient::~LlmServiceClient()
 void LlmServiceClient::requestModels(const LlmServiceConfig &config)
 {
     if (!config.isValid()) {
-        emit requestFailed(tr("模型列表"), tr("服务地址为空，无法请求模型列表"));
+        emit requestFailed(0, tr("模型列表"), tr("服务地址为空，无法请求模型列表"));
         return;
     }
 
@@ -140,37 +167,110 @@ void LlmServiceClient::requestModels(const LlmServiceConfig &config)
     const QString endpoint = ApiFormatManager::modelListEndpoint(provider);
     const QNetworkRequest request = buildRequest(config, endpoint);
     const int timeoutMs = config.timeoutMs > 0 ? config.timeoutMs : 30000;
-    sendRequest(request, QByteArray(), ReplyKind::ModelList, timeoutMs);
+    sendRequest(request, QByteArray(), ReplyKind::ModelList, timeoutMs, 0);
 }
 
-void LlmServiceClient::requestChatCompletion(const LlmServiceConfig &config,
-                                             const QJsonArray &messages,
-                                             const QJsonObject &options)
+quint64 LlmServiceClient::requestChatCompletion(const LlmServiceConfig &config,
+                                                const QJsonArray &messages,
+                                                const QJsonObject &options,
+                                                const QJsonObject &responseSchema)
 {
     if (!config.isValid()) {
-        emit requestFailed(tr("翻译请求"), tr("服务地址为空，无法发送请求"));
-        return;
+        emit requestFailed(0, tr("翻译请求"), tr("服务地址为空，无法发送请求"));
+        return 0;
     }
 
     if (messages.isEmpty()) {
-        emit requestFailed(tr("翻译请求"), tr("消息内容为空"));
-        return;
+        emit requestFailed(0, tr("翻译请求"), tr("消息内容为空"));
+        return 0;
     }
 
+    const QString poolKey = ensureEndpointPool(config);
+
     const QString provider = ApiFormatManager::providerId(config.provider, config.normalizedBaseUrl());
-    const QString endpoint = ApiFormatManager::chatEndpoint(provider);
+    const QJsonObject body = buildChatBody(config, messages, options, responseSchema);
+
+    ChatTask task;
+    task.config = config;
+    task.poolKey = poolKey;
+    task.endpointPath = ApiFormatManager::chatEndpoint(provider);
+    task.payload = QJsonDocument(body).toJson(QJsonDocument::Compact);
+    task.queuedTimer.start();
+
+    const quint64 requestId = ++m_nextRequestId;
+    ++m_chatRequestsIssued;
+    m_chatTasks.insert(requestId, task);
+    m_pendingChatTasks.append(requestId);
+    dispatchPendingChatTasks();
+    return m_chatTasks.contains(requestId) ? requestId : 0;
+}
 
-    const QJsonObject body = buildChatBody(config, messages, options);
-    QNetworkRequest request = buildRequest(config, endpoint);
-    request.setRawHeader("X-QSrtTool-Stream", config.stream ? "1" : "0");
-    sendRequest(request,
-                QJsonDocument(body).toJson(QJsonDocument::Compact),
-                ReplyKind::ChatCompletion,
-                config.timeoutMs);
+void LlmServiceClient::prewarmConnections(const LlmServiceConfig &config)
+{
+    if (!config.isValid()) {
+        return;
+    }
+
+    const QVector<LlmEndpoint> endpointList = config.endpoints();
+    for (const LlmEndpoint &endpoint : endpointList) {
+        const QUrl url(endpoint.baseUrl);
+        if (!url.isValid() || url.host().isEmpty()) {
+            continue;
+        }
+
+        if (url.scheme().compare(QStringLiteral("https"), Qt::CaseInsensitive) == 0) {
+#if QT_CONFIG(ssl)
+            // 声明 h2 的 ALPN 配置使预热连接与带 Http2AllowedAttribute 的请求落在同一连接上。
+            QSslConfiguration sslConfiguration = QSslConfiguration::defaultConfiguration();
+            sslConfiguration.setAllowedNextProtocols({QSslConfiguration::ALPNProtocolHTTP2,
+                                                      QSslConfiguration::NextProtocolHttp1_1});
+            m_networkManager->connectToHostEncrypted(url.host(),
+                                                     static_cast<quint16>(url.port(443)),
+                                                     sslConfiguration);
+#endif
+        } else {
+            m_networkManager->connectToHost(url.host(), static_cast<quint16>(url.port(80)));
+        }
+    }
+}
+
+void LlmServiceClient::cancelRequest(quint64 requestId)
+{
+    if (requestId == 0 || !m_chatTasks.contains(requestId)) {
+        return;
+    }
+
+    const QList<QNetworkReply *> replies = m_chatTasks.value(requestId).replies;
+    removeChatTask(requestId);
+    m_pendingChatTasks.removeAll(requestId);
+
+    for (QNetworkReply *reply : replies) {
+        m_discardedReplies.insert(reply);
+    }
+    for (QNetworkReply *reply : replies) {
+        reply->abort();
+    }
 }
 
 void LlmServiceClient::cancelAll()
 {
+    // 排队中的请求尚未发出，直接以取消失败通知使用方。
+    const QList<quint64> pendingIds = m_pendingChatTasks;
+    m_pendingChatTasks.clear();
+    // 已对冲的请求只保留主副本的失败通知，避免同一请求 ID 报告两次。
+    for (auto it = m_chatTasks.constBegin(); it != m_chatTasks.constEnd(); ++it) {
+        for (int i = 1; i < it->replies.size(); ++i) {
+            m_discardedReplies.insert(it->replies.at(i));
+        }
+    }
+    const QList<quint64> taskIds = m_chatTasks.keys();
+    for (quint64 requestId : taskIds) {
+        removeChatTask(requestId);
+    }
+    for (quint64 requestId : pendingIds) {
+        emit requestFailed(requestId, tr("翻译请求"), tr("请求已取消"));
+    }
+
     const QList<QNetworkReply *> replies = m_replyKinds.keys();
     for (QNetworkReply *reply : replies) {
         if (reply) {
@@ -179,10 +279,11 @@ void LlmServiceClient::cancelAll()
     }
 }
 
-void LlmServiceClient::sendRequest(const QNetworkRequest &request,
-                                   const QByteArray &payload,
-                                   ReplyKind kind,
-                                   int timeoutMs)
+QNetworkReply *LlmServiceClient::sendRequest(const QNetworkRequest &request,
+                                             const QByteArray &payload,
+                                             ReplyKind kind,
+                                             int timeoutMs,
+                                             quint64 requestId)
 {
     QNetworkReply *reply = nullptr;
     if (payload.isEmpty()) {
@@ -192,19 +293,316 @@ void LlmServiceClient::sendRequest(const QNetworkRequest &request,
     }
 
     if (!reply) {
-        emit requestFailed(tr("网络"), tr("无法创建网络请求"));
+        emit requestFailed(requestId, tr("网络"), tr("无法创建网络请求"));
+        return nullptr;
+    }
+
+    attachReply(reply, kind, timeoutMs, payload, requestId);
+    return reply;
+}
+
+QString LlmServiceClient::ensureEndpointPool(const LlmServiceConfig &config)
+{
+    const QVector<LlmEndpoint> endpointList = config.endpoints();
+    QStringList keyParts;
+    keyParts.reserve(endpointList.size());
+    for (const LlmEndpoint &endpoint : endpointList) {
+        keyParts << QStringLiteral("%1|%2|%3").arg(endpoint.baseUrl).arg(endpoint.weight).arg(endpoint.maxConcurrent);
+    }
+
+    const QString key = keyParts.join(';');
+    if (!m_endpointPools.contains(key)) {
+        // 在途请求仍按旧池的端点下标归还与重发，旧池保留到它们结束。
+        pruneEndpointPools(key);
+        m_endpointPools[key].setEndpoints(endpointList);
+    }
+    return key;
+}
+
+void LlmServiceClient::pruneEndpointPools(const QString &keepKey)
+{
+    QSet<QString> referencedKeys;
+    referencedKeys.insert(keepKey);
+    for (auto it = m_chatTasks.constBegin(); it != m_chatTasks.constEnd(); ++it) {
+        referencedKeys.insert(it->poolKey);
+    }
+    for (auto it = m_replyEndpoints.constBegin(); it != m_replyEndpoints.constEnd(); ++it) {
+        referencedKeys.insert(it->poolKey);
+    }
+
+    auto poolIt = m_endpointPools.begin();
+    while (poolIt != m_endpointPools.end()) {
+        if (referencedKeys.contains(poolIt.key())) {
+            ++poolIt;
+        } else {
+            poolIt = m_endpointPools.erase(poolIt);
+        }
+    }
+}
+
+void LlmServiceClient::dispatchPendingChatTasks()
+{
+    int i = 0;
+    while (i < m_pendingChatTasks.size()) {
+        const quint64 requestId = m_pendingChatTasks.at(i);
+        const auto taskIt = m_chatTasks.constFind(requestId);
+        if (taskIt == m_chatTasks.constEnd()) {
+            m_pendingChatTasks.removeAt(i);
+            continue;
+        }
+
+        const int endpointIndex = m_endpointPools[taskIt->poolKey].acquire(taskIt->triedEndpoints);
+        if (endpointIndex < 0) {
+            ++i;
+            continue;
+        }
+        m_pendingChatTasks.removeAt(i);
+
+        const ChatTask task = taskIt.value();
+        QNetworkReply *reply = sendChatTaskRequest(requestId, task, endpointIndex);
+        if (!reply) {
+            removeChatTask(requestId);
+            continue;
+        }
+
+        const auto sentIt = m_chatTasks.find(requestId);
+        if (sentIt != m_chatTasks.end()) {
+            sentIt->replies.append(reply);
+            startHedgeTimer(requestId, endpointIndex);
+        }
+    }
+}
+
+QNetworkReply *LlmServiceClient::sendChatTaskRequest(quint64 requestId, const ChatTask &task, int endpointIndex)
+{
+    LlmServiceConfig endpointConfig = task.config;
+    endpointConfig.baseUrl = m_endpointPools[task.poolKey].endpoint(endpointIndex).baseUrl;
+    const auto taskIt = m_chatTasks.find(requestId);
+    if (taskIt != m_chatTasks.end()) {
+        ++taskIt->attempts;
+    }
+    QNetworkRequest request = buildRequest(endpointConfig, task.endpointPath);
+    request.setRawHeader("X-QSrtTool-Stream", endpointConfig.stream ? "1" : "0");
+
+    QNetworkReply *reply = sendRequest(request,
+                                       task.payload,
+                                       ReplyKind::ChatCompletion,
+                                       endpointConfig.timeoutMs,
+                                       requestId);
+    if (!reply) {
+        // sendRequest 失败时已同步发出 requestFailed，使用方可能已提交新请求，池表需重新查找。
+        m_endpointPools[task.poolKey].release(endpointIndex);
+        return nullptr;
+    }
+    EndpointSlot slot;
+    slot.poolKey = task.poolKey;
+    slot.index = endpointIndex;
+    m_replyEndpoints.insert(reply, slot);
+
+    LlmRequestMetrics &metrics = m_replyMetrics[reply];
+    metrics.endpointUrl = endpointConfig.baseUrl;
+    metrics.model = endpointConfig.model;
+    metrics.queueWaitMs = task.queuedTimer.isValid() ? task.queuedTimer.elapsed() : 0;
+    metrics.bytesSent = task.payload.size();
+    return reply;
+}
+
+void LlmServiceClient::removeChatTask(quint64 requestId)
+{
+    const auto taskIt = m_chatTasks.find(requestId);
+    if (taskIt == m_chatTasks.end()) {
+        return;
+    }
+
+    if (taskIt->hedgeTimer) {
+        taskIt->hedgeTimer->stop();
+        taskIt->hedgeTimer->deleteLater();
+    }
+    m_chatTasks.erase(taskIt);
+}
+
+void LlmServiceClient::reportChatFailure(QNetworkReply *reply, quint64 requestId)
+{
+    if (!m_chatTasks.contains(requestId)) {
+        return;
+    }
+    emit chatFailureMeasured(requestId, collectReplyMetrics(reply, m_replyElapsed.value(reply).elapsed()));
+}
+
+void LlmServiceClient::startHedgeTimer(quint64 requestId, int endpointIndex)
+{
+    const auto taskIt = m_chatTasks.find(requestId);
+    if (taskIt == m_chatTasks.end() || taskIt->hedged || taskIt->config.hedgeBudgetPercent <= 0) {
+        return;
+    }
+
+    // 对冲只发往其它端点：原端点已经偏慢，再加一路只会加重它的负载。
+    const LlmEndpointPool &pool = m_endpointPools[taskIt->poolKey];
+    QSet<int> excluded = taskIt->triedEndpoints;
+    excluded.insert(endpointIndex);
+    if (!pool.hasAlternative(excluded)) {
+        return;
+    }
+
+    // 流式请求的完整耗时随输出长度增长，按首个增量的 p90 判断是否卡住；首个增量到达后即停止计时。
+    const qint64 thresholdMs = taskIt->config.stream ? pool.firstTokenPercentile(endpointIndex, 0.9)
+                                                     : pool.latencyPercentile(endpointIndex, 0.9);
+    if (thresholdMs < 0) {
+        return;
+    }
+
+    if (!taskIt->hedgeTimer) {
+        QTimer *timer = new QTimer(this);
+        timer->setSingleShot(true);
+        connect(timer, &QTimer::timeout, this, [this, requestId]() {
+            launchHedgeRequest(requestId);
+        });
+        taskIt->hedgeTimer = timer;
+    }
+    taskIt->hedgeTimer->start(static_cast<int>(qMin<qint64>(thresholdMs, std::numeric_limits<int>::max())));
+}
+
+void LlmServiceClient::launchHedgeRequest(quint64 requestId)
+{
+    const auto taskIt = m_chatTasks.find(requestId);
+    if (taskIt == m_chatTasks.end() || taskIt->hedged || taskIt->replies.size() != 1) {
+        return;
+    }
+
+    // 预算按请求总数计：累计对冲数不超过其百分比，避免慢端点拖垮时对冲流量翻倍。
+    const quint64 budgetPercent = static_cast<quint64>(qMax(0, taskIt->config.hedgeBudgetPercent));
+    if ((m_hedgedRequests + 1) * 100 > m_chatRequestsIssued * budgetPercent) {
+        return;
+    }
+
+    LlmEndpointPool &pool = m_endpointPools[taskIt->poolKey];
+    const int primaryEndpoint = m_replyEndpoints.value(taskIt->replies.first()).index;
+    QSet<int> excluded = taskIt->triedEndpoints;
+    excluded.insert(primaryEndpoint);
+    // 其它端点都没有空闲容量时放弃对冲，不回落到原端点。
+    const int endpointIndex = pool.acquire(excluded);
+    if (endpointIndex < 0) {
+        return;
+    }
+
+    taskIt->hedged = true;
+    ++m_hedgedRequests;
+    const ChatTask task = taskIt.value();
+    QNetworkReply *reply = sendChatTaskRequest(requestId, task, endpointIndex);
+    if (!reply) {
         return;
     }
 
-    attachReply(reply, kind, timeoutMs, payload);
+    m_hedgeReplies.insert(reply);
+    m_replyMetrics[reply].queueWaitMs = 0;
+    const auto sentIt = m_chatTasks.find(requestId);
+    if (sentIt != m_chatTasks.end()) {
+        sentIt->replies.append(reply);
+    }
 }
 
-QNetworkRequest LlmServiceClient::buildRequest(const LlmServiceConfig &config, const QString &endpointPath) const
+bool LlmServiceClient::detachLosingReply(QNetworkReply *reply, quint64 requestId)
+{
+    const auto taskIt = m_chatTasks.find(requestId);
+    if (taskIt == m_chatTasks.end()) {
+        return false;
+    }
+
+    taskIt->replies.removeAll(reply);
+    if (taskIt->replies.isEmpty()) {
+        return false;
+    }
+
+    // 另一路仍在途：本路失败只计入端点健康度，结果由另一路决定。
+    if (reply->error() != QNetworkReply::NoError && isRetryableFailure(reply)) {
+        m_endpointPools[taskIt->poolKey].reportFailure(m_replyEndpoints.value(reply).index);
+    }
+    return true;
+}
+
+void LlmServiceClient::resolveChatTask(QNetworkReply *winner, quint64 requestId, qint64 elapsedMs)
+{
+    const EndpointSlot slot = m_replyEndpoints.value(winner);
+    const auto poolIt = m_endpointPools.find(slot.poolKey);
+    if (poolIt != m_endpointPools.end()) {
+        poolIt->reportSuccess(slot.index);
+        poolIt->recordLatency(slot.index, elapsedMs);
+        if (m_replyStreaming.value(winner, false)) {
+            poolIt->recordFirstTokenLatency(slot.index, m_replyMetrics.value(winner).firstTokenMs);
+        }
+    }
+
+    const QList<QNetworkReply *> replies = m_chatTasks.value(requestId).replies;
+    removeChatTask(requestId);
+    for (QNetworkReply *reply : replies) {
+        if (reply != winner) {
+            m_discardedReplies.insert(reply);
+        }
+    }
+    for (QNetworkReply *reply : replies) {
+        if (reply != winner) {
+            reply->abort();
+        }
+    }
+
+    if (m_hedgeReplies.contains(winner)) {
+        emit requestRestarted(requestId, tr("对冲请求先于主请求完成，改用其结果"));
+    }
+}
+
+bool LlmServiceClient::isRetryableFailure(QNetworkReply *reply) const
+{
+    if (!reply) {
+        return false;
+    }
+    if (m_replyTimedOut.value(reply, false)) {
+        return true;
+    }
+    if (reply->error() == QNetworkReply::OperationCanceledError) {
+        return false;
+    }
+
+    const int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (statusCode <= 0) {
+        return true;
+    }
+    return statusCode == 429 || statusCode >= 500;
+}
+
+bool LlmServiceClient::tryFailoverChatTask(QNetworkReply *reply, quint64 requestId)
+{
+    const auto taskIt = m_chatTasks.find(requestId);
+    if (taskIt == m_chatTasks.end() || !isRetryableFailure(reply)) {
+        return false;
+    }
+
+    LlmEndpointPool &pool = m_endpointPools[taskIt->poolKey];
+    const int endpointIndex = m_replyEndpoints.value(reply).index;
+    pool.reportFailure(endpointIndex);
+    taskIt->triedEndpoints.insert(endpointIndex);
+    if (!pool.hasAlternative(taskIt->triedEndpoints)) {
+        return false;
+    }
+
+    const QString failedUrl = endpointIndex >= 0 ? pool.endpoint(endpointIndex).baseUrl : QString();
+    const QString reason = m_replyTimedOut.value(reply, false)
+                           ? tr("请求超时")
+                           : reply->errorString().trimmed();
+    taskIt->queuedTimer.start();
+    m_pendingChatTasks.append(requestId);
+    emit requestRestarted(requestId, tr("端点 %1 失败（%2），改由其它端点重发").arg(failedUrl, reason));
+    return true;
+}
+
+QNetworkRequest LlmServiceClient::buildRequest(const LlmServiceConfig &config, const QString &endpointPath)
 {
     const QUrl url(joinUrl(config.normalizedBaseUrl(), endpointPath));
     QNetworkRequest request(url);
     request.setHeader(QNetworkRequest::ContentTypeHeader, QStringLiteral("application/json"));
     request.setRawHeader("Accept", "application/json");
+    // https 端点经 ALPN 协商 HTTP/2，同一主机的并发分块复用一条多路复用连接；
+    // 明文 http 不做 h2c 直连，避免本地 HTTP/1.1 服务握手失败。
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
 
     const QString token = config.apiKey.trimmed();
     if (!token.isEmpty()) {
@@ -221,17 +619,19 @@ QNetworkRequest LlmServiceClient::buildRequest(const LlmServiceConfig &config, c
 
 QJsonObject LlmServiceClient::buildChatBody(const LlmServiceConfig &config,
                                             const QJsonArray &messages,
-                                            const QJsonObject &options) const
+                                            const QJsonObject &options,
+                                            const QJsonObject &responseSchema) const
 {
     const QString provider = ApiFormatManager::providerId(config.provider, config.normalizedBaseUrl());
     return ApiFormatManager::buildChatBody(provider,
                                            config.model,
                                            config.stream,
                                            messages,
-                                           options);
+                                           options,
+                                           responseSchema);
 }
 
-QString LlmServiceClient::extractChatContent(const QJsonObject &responseObject) const
+QString LlmServiceClient::extractChatContent(const QJsonObject &responseObject)
 {
     const QJsonArray choices = responseObject.value("choices").toArray();
     if (!choices.isEmpty()) {
@@ -434,7 +834,11 @@ QString LlmServiceClient::normalizeErrorMessage(QNetworkReply *reply, const QByt
     return withRequestContext(qtError.isEmpty() ? tr("请求失败") : qtError);
 }
 
-void LlmServiceClient::attachReply(QNetworkReply *reply, ReplyKind kind, int timeoutMs, const QByteArray &payload)
+void LlmServiceClient::attachReply(QNetworkReply *reply,
+                                   ReplyKind kind,
+                                   int timeoutMs,
+                                   const QByteArray &payload,
+                                   quint64 requestId)
 {
     ++m_activeRequests;
     if (m_activeRequests == 1) {
@@ -442,6 +846,7 @@ void LlmServiceClient::attachReply(QNetworkReply *reply, ReplyKind kind, int tim
     }
 
     m_replyKinds.insert(reply, kind);
+    m_replyRequestIds.insert(reply, requestId);
     m_replyRequestPayload.insert(reply, payload);
     m_replyRequestUrl.insert(reply, reply->request().url().toString());
     const bool requestMarkedStreaming = reply->request().hasRawHeader("X-QSrtTool-Stream")
@@ -449,6 +854,16 @@ void LlmServiceClient::attachReply(QNetworkReply *reply, ReplyKind kind, int tim
     m_replyStreaming.insert(reply, kind == ReplyKind::ChatCompletion && requestMarkedStreaming);
     m_replyTimedOut.insert(reply, false);
     m_replyTimeoutMs.insert(reply, timeoutMs);
+    QElapsedTimer elapsed;
+    elapsed.start();
+    m_replyElapsed.insert(reply, elapsed);
+    m_replyMetrics.insert(reply, LlmRequestMetrics());
+    if (m_recorder && kind == ReplyKind::ChatCompletion) {
+        m_recorder->beginExchange(reply,
+                                  reply->request().url().toString(),
+                                  payload,
+                                  m_replyStreaming.value(reply, false));
+    }
 
     if (timeoutMs > 0) {
         QTimer *timer = new QTimer(reply);
@@ -474,9 +889,31 @@ void LlmServiceClient::attachReply(QNetworkReply *reply, ReplyKind kind, int tim
         }
     });
 
+    connect(reply, &QNetworkReply::metaDataChanged, this, [this, reply]() {
+        const auto metricsIt = m_replyMetrics.find(reply);
+        if (metricsIt != m_replyMetrics.end() && metricsIt->headersMs < 0) {
+            metricsIt->headersMs = m_replyElapsed.value(reply).elapsed();
+        }
+    });
+#if QT_CONFIG(ssl)
+    connect(reply, &QNetworkReply::encrypted, this, [this, reply]() {
+        const auto metricsIt = m_replyMetrics.find(reply);
+        if (metricsIt != m_replyMetrics.end() && metricsIt->tlsReadyMs < 0) {
+            metricsIt->tlsReadyMs = m_replyElapsed.value(reply).elapsed();
+        }
+    });
+#endif
+    connect(reply, &QNetworkReply::downloadProgress, this, [this, reply](qint64 bytesReceived, qint64) {
+        const auto metricsIt = m_replyMetrics.find(reply);
+        if (metricsIt != m_replyMetrics.end()) {
+            metricsIt->bytesReceived = bytesReceived;
+        }
+    });
+
     connect(reply, &QNetworkReply::finished, this, [this, reply]() {
         const ReplyKind kind = m_replyKinds.value(reply, ReplyKind::ChatCompletion);
         const bool isStreaming = m_replyStreaming.value(reply, false);
+        const quint64 requestId = m_replyRequestIds.value(reply, 0);
 
         const bool success = (reply->error() == QNetworkReply::NoError);
         const QByteArray payload = isStreaming ? QByteArray() : reply->readAll();
@@ -487,15 +924,42 @@ void LlmServiceClient::attachReply(QNetworkReply *reply, ReplyKind kind, int tim
                 processStreamingPayload(reply, tailChunk);
             }
 
-            const QByteArray tailBuffer = m_streamBuffers.take(reply);
+            const QByteArray tailBuffer = m_streamScanners[reply].takeRemainder();
             if (!tailBuffer.trimmed().isEmpty()) {
                 consumeStreamingLine(reply, tailBuffer);
             }
         }
 
+        if (m_recorder) {
+            if (m_discardedReplies.contains(reply) || reply->error() == QNetworkReply::OperationCanceledError) {
+                m_recorder->discardExchange(reply);
+            } else {
+                m_recorder->finishExchange(reply,
+                                           reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(),
+                                           m_replyElapsed.value(reply).elapsed(),
+                                           payload);
+            }
+        }
+
+        if (m_discardedReplies.remove(reply)) {
+            finalizeReply(reply);
+            return;
+        }
+
         if (!success) {
-            emit requestFailed(kind == ReplyKind::ModelList ? tr("模型列表") : tr("翻译请求"),
-                              normalizeErrorMessage(reply, payload));
+            if (kind == ReplyKind::ChatCompletion
+                && (detachLosingReply(reply, requestId) || tryFailoverChatTask(reply, requestId))) {
+                finalizeReply(reply);
+                return;
+            }
+
+            if (kind == ReplyKind::ChatCompletion) {
+                reportChatFailure(reply, requestId);
+            }
+            removeChatTask(requestId);
+            emit requestFailed(requestId,
+                               kind == ReplyKind::ModelList ? tr("模型列表") : tr("翻译请求"),
+                               normalizeErrorMessage(reply, payload));
             finalizeReply(reply);
             return;
         }
@@ -504,8 +968,17 @@ void LlmServiceClient::attachReply(QNetworkReply *reply, ReplyKind kind, int tim
             QJsonParseError parseError;
             const QJsonDocument document = QJsonDocument::fromJson(payload, &parseError);
             if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
-                emit requestFailed(kind == ReplyKind::ModelList ? tr("模型列表") : tr("翻译请求"),
-                                  tr("响应不是有效 JSON：%1").arg(parseError.errorString()));
+                if (kind == ReplyKind::ChatCompletion && detachLosingReply(reply, requestId)) {
+                    finalizeReply(reply);
+                    return;
+                }
+                if (kind == ReplyKind::ChatCompletion) {
+                    reportChatFailure(reply, requestId);
+                }
+                removeChatTask(requestId);
+                emit requestFailed(requestId,
+                                   kind == ReplyKind::ModelList ? tr("模型列表") : tr("翻译请求"),
+                                   tr("响应不是有效 JSON：%1").arg(parseError.errorString()));
                 finalizeReply(reply);
                 return;
             }
@@ -514,24 +987,43 @@ void LlmServiceClient::attachReply(QNetworkReply *reply, ReplyKind kind, int tim
             if (kind == ReplyKind::ModelList) {
                 const QStringList models = extractModelList(object);
                 if (models.isEmpty()) {
-                    emit requestFailed(tr("模型列表"), tr("未从响应中解析到模型列表"));
+                    emit requestFailed(requestId, tr("模型列表"), tr("未从响应中解析到模型列表"));
                 } else {
                     emit modelsReady(models);
                 }
             } else {
                 const QString content = extractChatContent(object);
                 if (content.isEmpty()) {
-                    emit requestFailed(tr("翻译请求"), tr("响应中未找到可用文本内容"));
+                    if (!detachLosingReply(reply, requestId)) {
+                        reportChatFailure(reply, requestId);
+                        removeChatTask(requestId);
+                        emit requestFailed(requestId, tr("翻译请求"), tr("响应中未找到可用文本内容"));
+                    }
                 } else {
-                    emit chatCompleted(content, object);
+                    const qint64 totalMs = m_replyElapsed.value(reply).elapsed();
+                    LlmRequestMetrics metrics = collectReplyMetrics(reply, totalMs);
+                    metrics.firstTokenMs = totalMs;
+                    metrics.bytesReceived = qMax<qint64>(metrics.bytesReceived, payload.size());
+                    extractUsage(object, &metrics.promptTokens, &metrics.completionTokens);
+                    resolveChatTask(reply, requestId, totalMs);
+                    emit chatMetricsMeasured(requestId, metrics);
+                    emit chatCompleted(requestId, content, object);
                 }
             }
         } else {
             const QString aggregated = m_streamAccumulated.take(reply).trimmed();
             if (aggregated.isEmpty()) {
-                emit requestFailed(tr("翻译请求"), tr("流式响应结束，但未收到可用文本内容"));
+                if (!detachLosingReply(reply, requestId)) {
+                    reportChatFailure(reply, requestId);
+                    removeChatTask(requestId);
+                    emit requestFailed(requestId, tr("翻译请求"), tr("流式响应结束，但未收到可用文本内容"));
+                }
             } else {
-                emit chatCompleted(aggregated, QJsonObject());
+                const qint64 totalMs = m_replyElapsed.value(reply).elapsed();
+                const LlmRequestMetrics metrics = collectReplyMetrics(reply, totalMs);
+                resolveChatTask(reply, requestId, totalMs);
+                emit chatMetricsMeasured(requestId, metrics);
+                emit chatCompleted(requestId, aggregated, QJsonObject());
             }
         }
 
@@ -545,15 +1037,16 @@ void LlmServiceClient::processStreamingPayload(QNetworkReply *reply, const QByte
         return;
     }
 
-    QByteArray &buffer = m_streamBuffers[reply];
-    buffer.append(payloadChunk);
+    if (m_recorder) {
+        m_recorder->appendChunk(reply, m_replyElapsed.value(reply).elapsed(), payloadChunk);
+    }
+
+    SseLineScanner &scanner = m_streamScanners[reply];
+    scanner.append(payloadChunk);
 
-    int newlinePos = buffer.indexOf('\n');
-    while (newlinePos >= 0) {
-        const QByteArray line = buffer.left(newlinePos);
-        buffer.remove(0, newlinePos + 1);
+    QByteArray line;
+    while (scanner.nextLine(&line)) {
         consumeStreamingLine(reply, line);
-        newlinePos = buffer.indexOf('\n');
     }
 }
 
@@ -582,16 +1075,78 @@ void LlmServiceClient::consumeStreamingLine(QNetworkReply *reply, const QByteArr
         return;
     }
 
+    const QJsonObject object = document.object();
+    const auto metricsIt = m_replyMetrics.find(reply);
+    // usage 通常随最后一个（可能不含文本的）数据块到达，需在判断增量之前读取。
+    if (metricsIt != m_replyMetrics.end()) {
+        extractUsage(object, &metricsIt->promptTokens, &metricsIt->completionTokens);
+    }
+
     bool done = false;
-    const QString delta = extractStreamDelta(document.object(), &done);
+    const QString delta = extractStreamDelta(object, &done);
     Q_UNUSED(done)
     if (delta.isEmpty()) {
         return;
     }
 
-    QString &aggregated = m_streamAccumulated[reply];
-    aggregated += delta;
-    emit streamChunkReceived(delta, aggregated);
+    if (metricsIt != m_replyMetrics.end()) {
+        if (metricsIt->firstTokenMs < 0) {
+            metricsIt->firstTokenMs = m_replyElapsed.value(reply).elapsed();
+            // 主请求已开始输出，不再对冲。
+            const auto taskIt = m_chatTasks.find(m_replyRequestIds.value(reply, 0));
+            if (taskIt != m_chatTasks.end() && taskIt->hedgeTimer && !m_hedgeReplies.contains(reply)) {
+                taskIt->hedgeTimer->stop();
+            }
+        }
+        ++metricsIt->streamChunks;
+    }
+
+    // 全文只在客户端内部累积一次，用于结束时的 chatCompleted；增量信号不再携带全文副本。
+    m_streamAccumulated[reply] += delta;
+    // 对冲副本不转发增量，避免两路输出交错；胜出时随 chatCompleted 整体交付。
+    if (!m_hedgeReplies.contains(reply)) {
+        emit streamChunkReceived(m_replyRequestIds.value(reply, 0), delta);
+    }
+}
+
+LlmRequestMetrics LlmServiceClient::collectReplyMetrics(QNetworkReply *reply, qint64 totalMs) const
+{
+    LlmRequestMetrics metrics = m_replyMetrics.value(reply);
+    metrics.totalMs = totalMs;
+    metrics.http2 = reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool();
+
+    // 须在 resolveChatTask 移除任务之前读取重发 / 对冲次数。
+    const auto taskIt = m_chatTasks.constFind(m_replyRequestIds.value(reply, 0));
+    if (taskIt != m_chatTasks.constEnd()) {
+        metrics.attempts = qMax(1, taskIt->attempts);
+        metrics.hedged = taskIt->hedged;
+    }
+    return metrics;
+}
+
+bool LlmServiceClient::extractUsage(const QJsonObject &object, qint64 *promptTokens, qint64 *completionTokens) const
+{
+    const QJsonObject usage = object.value(QStringLiteral("usage")).toObject();
+    if (!usage.isEmpty()) {
+        if (promptTokens && usage.contains(QStringLiteral("prompt_tokens"))) {
+            *promptTokens = static_cast<qint64>(usage.value(QStringLiteral("prompt_tokens")).toDouble());
+        }
+        if (completionTokens && usage.contains(QStringLiteral("completion_tokens"))) {
+            *completionTokens = static_cast<qint64>(usage.value(QStringLiteral("completion_tokens")).toDouble());
+        }
+        return true;
+    }
+
+    if (object.contains(QStringLiteral("eval_count")) || object.contains(QStringLiteral("prompt_eval_count"))) {
+        if (promptTokens && object.contains(QStringLiteral("prompt_eval_count"))) {
+            *promptTokens = static_cast<qint64>(object.value(QStringLiteral("prompt_eval_count")).toDouble());
+        }
+        if (completionTokens && object.contains(QStringLiteral("eval_count"))) {
+            *completionTokens = static_cast<qint64>(object.value(QStringLiteral("eval_count")).toDouble());
+        }
+        return true;
+    }
+    return false;
 }
 
 void LlmServiceClient::finalizeReply(QNetworkReply *reply)
@@ -606,8 +1161,23 @@ void LlmServiceClient::finalizeReply(QNetworkReply *reply)
     m_replyRequestPayload.remove(reply);
     m_replyRequestUrl.remove(reply);
     m_replyStreaming.remove(reply);
-    m_streamBuffers.remove(reply);
+    m_replyRequestIds.remove(reply);
+    m_streamScanners.remove(reply);
     m_streamAccumulated.remove(reply);
+    m_replyElapsed.remove(reply);
+    m_replyMetrics.remove(reply);
+    if (m_recorder) {
+        m_recorder->discardExchange(reply);
+    }
+    m_hedgeReplies.remove(reply);
+    m_discardedReplies.remove(reply);
+    if (m_replyEndpoints.contains(reply)) {
+        const EndpointSlot slot = m_replyEndpoints.take(reply);
+        const auto poolIt = m_endpointPools.find(slot.poolKey);
+        if (poolIt != m_endpointPools.end()) {
+            poolIt->release(slot.index);
+        }
+    }
 
     QTimer *timer = m_replyTimers.take(reply);
     if (timer) {
@@ -617,6 +1187,9 @@ void LlmServiceClient::finalizeReply(QNetworkReply *reply)
 
     reply->deleteLater();
 
+    // 先让排队请求接手释放出的端点容量，再更新忙闲状态，避免连续任务中出现短暂“空闲”。
+    dispatchPendingChatTasks();
+
     --m_activeRequests;
     if (m_activeRequests <= 0) {
         m_activeRequests = 0;
@@ -2,11 +2,20 @@
 #define LLMSERVICECLIENT_H
 
 #include <QObject>
+#include <QElapsedTimer>
 #include <QHash>
+#include <QList>
+#include <QSet>
 #include <QStringList>
 #include <QJsonArray>
 #include <QJsonObject>
+#include <QMetaType>
 #include <QNetworkRequest>
+#include <QScopedPointer>
+
+#include "llmendpointpool.h"
+#include "llmtrafficrecorder.h"
+#include "sselinescanner.h"
 
 class QNetworkAccessManager;
 class QNetworkReply;
@@ -21,9 +30,15 @@ struct LlmServiceConfig
     QString model;
     bool stream = false;
     int timeoutMs = 60000;
+    // 尾延迟对冲预算（占聊天请求总数的百分比），0 表示关闭。
+    int hedgeBudgetPercent = 0;
 
-    // 规范化基础地址（去尾斜杠、按 provider 做兼容修正）。
+    // 规范化基础地址（去尾斜杠、按 provider 做兼容修正）；配置了多个端点时返回第一个。
     QString normalizedBaseUrl() const;
+    // baseUrl 可写多个端点（分号分隔，"url|weight|maxConcurrent"）；返回规范化后的端点列表。
+    QVector<LlmEndpoint> endpoints() const;
+    // 建议的并发请求数：各端点并发上限之和（不限并发的端点按 1 计）。
+    int suggestedConcurrency() const;
     // 判断配置是否可用于发起请求。
     bool isValid() const;
 
@@ -31,6 +46,33 @@ struct LlmServiceConfig
     static QString defaultBaseUrlForProvider(const QString &provider);
 };
 
+// 单次聊天请求的耗时分解（毫秒），各阶段均从请求实际发出时起算；未发生的阶段为 -1。
+struct LlmRequestMetrics
+{
+    QString endpointUrl;
+    QString model;
+    // 在客户端队列中等待端点容量的时间（对冲副本为 0）。
+    qint64 queueWaitMs = 0;
+    // https 连接加密就绪（新建连接时包含 DNS、TCP 与 TLS 握手）。
+    qint64 tlsReadyMs = -1;
+    // 收到响应头：包含建连与服务端预填充。
+    qint64 headersMs = -1;
+    // 首个增量到达（非流式等于总耗时）。
+    qint64 firstTokenMs = -1;
+    qint64 totalMs = 0;
+    qint64 bytesSent = 0;
+    qint64 bytesReceived = 0;
+    bool http2 = false;
+    // 服务端 usage 统计（OpenAI usage / Ollama eval_count），未返回时为 -1。
+    qint64 promptTokens = -1;
+    qint64 completionTokens = -1;
+    // 收到的非空流式增量数（无 usage 时可粗略代替输出 token 数）。
+    int streamChunks = 0;
+    // 本请求 ID 累计发出的副本数：1 为一次成功，换端点重发与对冲各计一次。
+    int attempts = 1;
+    bool hedged = false;
+};
+
 class LlmServiceClient : public QObject
 {
     Q_OBJECT
@@ -41,18 +83,37 @@ public:
 
     // 请求远端模型列表。
     void requestModels(const LlmServiceConfig &config);
-    // 发送聊天补全请求（支持流式与非流式）。
-    void requestChatCompletion(const LlmServiceConfig &config,
-                               const QJsonArray &messages,
-                               const QJsonObject &options = QJsonObject());
+    // 发送聊天补全请求（支持流式与非流式），返回请求 ID；参数无效时返回 0。
+    // responseSchema 非空时请求结构化输出（由 ApiFormatManager 按 Provider 转换）。
+    quint64 requestChatCompletion(const LlmServiceConfig &config,
+                                  const QJsonArray &messages,
+                                  const QJsonObject &options = QJsonObject(),
+                                  const QJsonObject &responseSchema = QJsonObject());
+    // 任务开始前预先与各端点建立连接（https 同时完成 TLS 并通过 ALPN 协商 HTTP/2）。
+    void prewarmConnections(const LlmServiceConfig &config);
+    // 取消单个聊天请求（含仍在排队的请求），不再发出该请求的任何信号。
+    void cancelRequest(quint64 requestId);
     // 取消当前所有进行中的网络请求。
     void cancelAll();
 
+    // 构造带鉴权头的请求（批量接口等其它调用方复用）。
+    static QNetworkRequest buildRequest(const LlmServiceConfig &config, const QString &endpointPath);
+    // 从非流式响应（OpenAI choices / Ollama message / response）中取出正文。
+    static QString extractChatContent(const QJsonObject &responseObject);
+
 signals:
     void modelsReady(const QStringList &models);
-    void chatCompleted(const QString &content, const QJsonObject &rawResponse);
-    void streamChunkReceived(const QString &chunk, const QString &aggregatedContent);
-    void requestFailed(const QString &stage, const QString &message);
+    void chatCompleted(quint64 requestId, const QString &content, const QJsonObject &rawResponse);
+    // 在 chatCompleted 之前发出：胜出副本的耗时分解与收发字节数。
+    void chatMetricsMeasured(quint64 requestId, const LlmRequestMetrics &metrics);
+    // 仅携带本次增量；需要全文的使用方按 requestId 自行累积。
+    void streamChunkReceived(quint64 requestId, const QString &delta);
+    // 在聊天请求的 requestFailed 之前发出：失败副本所用模型与端点、耗时；用户取消的请求不发出。
+    void chatFailureMeasured(quint64 requestId, const LlmRequestMetrics &metrics);
+    // requestId 为 0 表示非聊天请求（如模型列表）或请求未能发出。
+    void requestFailed(quint64 requestId, const QString &stage, const QString &message);
+    // 请求在某端点失败后切换到其它端点重发；此前该请求发出的增量作废，使用方应清空对应累积内容。
+    void requestRestarted(quint64 requestId, const QString &reason);
     void busyChanged(bool busy);
 
 private:
@@ -61,26 +122,78 @@ private:
         ChatCompletion
     };
 
-    void sendRequest(const QNetworkRequest &request,
-                     const QByteArray &payload,
-                     ReplyKind kind,
-                     int timeoutMs);
+    // 逻辑聊天请求：同一请求 ID 在端点失败时可换端点重发。
+    struct ChatTask
+    {
+        LlmServiceConfig config;
+        // 所属端点池（按端点列表区分），triedEndpoints 等下标均指该池。
+        QString poolKey;
+        QString endpointPath;
+        QByteArray payload;
+        QSet<int> triedEndpoints;
+        // 进入待发队列起计时，用于统计排队等待。
+        QElapsedTimer queuedTimer;
+        int attempts = 0;
+        // 在途副本：首个为主请求，对冲发出后追加第二个。
+        QList<QNetworkReply *> replies;
+        QTimer *hedgeTimer = nullptr;
+        bool hedged = false;
+    };
+
+    QNetworkReply *sendRequest(const QNetworkRequest &request,
+                               const QByteArray &payload,
+                               ReplyKind kind,
+                               int timeoutMs,
+                               quint64 requestId);
+    // 聊天副本所用的端点：所属端点池与池内下标。
+    struct EndpointSlot
+    {
+        QString poolKey;
+        int index = -1;
+    };
+
+    // 返回配置对应的端点池键，池不存在时创建；不同端点列表的请求各用各的池，互不影响在途请求。
+    QString ensureEndpointPool(const LlmServiceConfig &config);
+    // 移除已无请求引用的旧端点池。
+    void pruneEndpointPools(const QString &keepKey);
+    // 为排队中的聊天请求分配端点并发出；端点容量不足的请求继续排队。
+    void dispatchPendingChatTasks();
+    QNetworkReply *sendChatTaskRequest(quint64 requestId, const ChatTask &task, int endpointIndex);
+    void removeChatTask(quint64 requestId);
+    // 须在 removeChatTask 之前调用；任务已被 cancelAll() 移除时视为用户取消，不报告。
+    void reportChatFailure(QNetworkReply *reply, quint64 requestId);
+    // 主请求耗时超过所在端点近期 p90 时发出对冲副本（受预算限制）。
+    void startHedgeTimer(quint64 requestId, int endpointIndex);
+    void launchHedgeRequest(quint64 requestId);
+    // 同一请求仍有另一路在途时，丢弃本路失败结果；返回 true 表示已丢弃。
+    bool detachLosingReply(QNetworkReply *reply, quint64 requestId);
+    // 首个有效结果胜出：记录端点耗时并中止其余副本。
+    void resolveChatTask(QNetworkReply *winner, quint64 requestId, qint64 elapsedMs);
+    // 端点级失败（连接错误、超时、429/5xx）时换端点重发；返回 true 表示已重新排队。
+    bool tryFailoverChatTask(QNetworkReply *reply, quint64 requestId);
+    bool isRetryableFailure(QNetworkReply *reply) const;
 
-    QNetworkRequest buildRequest(const LlmServiceConfig &config, const QString &endpointPath) const;
     QJsonObject buildChatBody(const LlmServiceConfig &config,
                               const QJsonArray &messages,
-                              const QJsonObject &options) const;
+                              const QJsonObject &options,
+                              const QJsonObject &responseSchema) const;
 
-    QString extractChatContent(const QJsonObject &responseObject) const;
     QStringList extractModelList(const QJsonObject &responseObject) const;
     QString extractStreamDelta(const QJsonObject &object, bool *done = nullptr) const;
+    // 读取 usage（OpenAI 兼容）或 prompt_eval_count / eval_count（Ollama）；未包含时不改写输出。
+    bool extractUsage(const QJsonObject &object, qint64 *promptTokens, qint64 *completionTokens) const;
     QString normalizeErrorMessage(QNetworkReply *reply, const QByteArray &responseBody) const;
 
     void processStreamingPayload(QNetworkReply *reply, const QByteArray &payloadChunk);
     void consumeStreamingLine(QNetworkReply *reply, const QByteArray &line);
 
-    void attachReply(QNetworkReply *reply, ReplyKind kind, int timeoutMs, const QByteArray &payload);
+    void attachReply(QNetworkReply *reply,
+                     ReplyKind kind,
+                     int timeoutMs,
+                     const QByteArray &payload,
+                     quint64 requestId);
     void finalizeReply(QNetworkReply *reply);
+    LlmRequestMetrics collectReplyMetrics(QNetworkReply *reply, qint64 totalMs) const;
 
     QNetworkAccessManager *m_networkManager = nullptr;
     QHash<QNetworkReply *, ReplyKind> m_replyKinds;
@@ -90,9 +203,27 @@ private:
     QHash<QNetworkReply *, QByteArray> m_replyRequestPayload;
     QHash<QNetworkReply *, QString> m_replyRequestUrl;
     QHash<QNetworkReply *, bool> m_replyStreaming;
-    QHash<QNetworkReply *, QByteArray> m_streamBuffers;
+    QHash<QNetworkReply *, quint64> m_replyRequestIds;
+    QHash<QNetworkReply *, SseLineScanner> m_streamScanners;
     QHash<QNetworkReply *, QString> m_streamAccumulated;
+    QHash<QNetworkReply *, QElapsedTimer> m_replyElapsed;
+    QHash<QNetworkReply *, LlmRequestMetrics> m_replyMetrics;
+    QHash<QNetworkReply *, EndpointSlot> m_replyEndpoints;
+    QHash<QString, LlmEndpointPool> m_endpointPools;
+    QHash<quint64, ChatTask> m_chatTasks;
+    QList<quint64> m_pendingChatTasks;
+    // 结果不再需要的副本（已取消或对冲落败），结束时静默回收。
+    QSet<QNetworkReply *> m_discardedReplies;
+    // 对冲副本：流式增量不转发，胜出时整体交付。
+    QSet<QNetworkReply *> m_hedgeReplies;
+    // 设置 QSRTTOOL_LLM_RECORD_DIR 时录制聊天请求 / 响应，供模拟服务回放。
+    QScopedPointer<LlmTrafficRecorder> m_recorder;
+    quint64 m_chatRequestsIssued = 0;
+    quint64 m_hedgedRequests = 0;
     int m_activeRequests = 0;
+    quint64 m_nextRequestId = 0;
 };
 
+Q_DECLARE_METATYPE(LlmRequestMetrics)
+
 #endif // LLMSERVICECLIENT_H
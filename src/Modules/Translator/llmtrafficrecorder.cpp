@@ -0,0 +1,88 @@
+#include "llmtrafficrecorder.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtGlobal>
+
+LlmTrafficRecorder::LlmTrafficRecorder(const QString &outputDirectory)
+{
+    QDir().mkpath(outputDirectory);
+    const QString timestamp = QDateTime::currentDateTime().toString(QStringLiteral("yyyyMMdd_HHmmss"));
+    m_outputFilePath = QDir(outputDirectory).filePath(QStringLiteral("llm_traffic_%1.jsonl").arg(timestamp));
+}
+
+QString LlmTrafficRecorder::outputDirectoryFromEnvironment()
+{
+    return qEnvironmentVariable("QSRTTOOL_LLM_RECORD_DIR").trimmed();
+}
+
+QString LlmTrafficRecorder::outputFilePath() const
+{
+    return m_outputFilePath;
+}
+
+void LlmTrafficRecorder::beginExchange(QNetworkReply *reply,
+                                       const QString &url,
+                                       const QByteArray &requestBody,
+                                       bool streaming)
+{
+    Exchange exchange;
+    exchange.url = url;
+    exchange.requestBody = requestBody;
+    exchange.streaming = streaming;
+    m_exchanges.insert(reply, exchange);
+}
+
+void LlmTrafficRecorder::appendChunk(QNetworkReply *reply, qint64 elapsedMs, const QByteArray &data)
+{
+    const auto it = m_exchanges.find(reply);
+    if (it == m_exchanges.end() || data.isEmpty()) {
+        return;
+    }
+
+    QJsonObject chunk;
+    chunk.insert(QStringLiteral("atMs"), static_cast<double>(elapsedMs));
+    chunk.insert(QStringLiteral("data"), QString::fromUtf8(data));
+    it->chunks.append(chunk);
+}
+
+void LlmTrafficRecorder::finishExchange(QNetworkReply *reply, int statusCode, qint64 totalMs, const QByteArray &body)
+{
+    const auto it = m_exchanges.find(reply);
+    if (it == m_exchanges.end()) {
+        return;
+    }
+
+    QJsonObject record;
+    record.insert(QStringLiteral("url"), it->url);
+    const QJsonDocument requestDocument = QJsonDocument::fromJson(it->requestBody);
+    if (requestDocument.isObject()) {
+        record.insert(QStringLiteral("request"), requestDocument.object());
+    } else {
+        record.insert(QStringLiteral("requestRaw"), QString::fromUtf8(it->requestBody));
+    }
+    record.insert(QStringLiteral("status"), statusCode);
+    record.insert(QStringLiteral("stream"), it->streaming);
+    record.insert(QStringLiteral("totalMs"), static_cast<double>(totalMs));
+    if (it->streaming) {
+        record.insert(QStringLiteral("chunks"), it->chunks);
+    } else {
+        record.insert(QStringLiteral("body"), QString::fromUtf8(body));
+    }
+    m_exchanges.erase(it);
+
+    QFile file(m_outputFilePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return;
+    }
+    file.write(QJsonDocument(record).toJson(QJsonDocument::Compact));
+    file.write("\n");
+}
+
+void LlmTrafficRecorder::discardExchange(QNetworkReply *reply)
+{
+    m_exchanges.remove(reply);
+}
@@ -0,0 +1,44 @@
+#ifndef LLMTRAFFICRECORDER_H
+#define LLMTRAFFICRECORDER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonArray>
+#include <QString>
+
+class QNetworkReply;
+
+// 聊天请求 / 响应录制：每个交换写一行 JSON（请求体、状态码、流式数据块及其到达时刻），
+// 供 LlmMockServer 离线回放。由环境变量 QSRTTOOL_LLM_RECORD_DIR 指定输出目录后启用。
+class LlmTrafficRecorder
+{
+public:
+    explicit LlmTrafficRecorder(const QString &outputDirectory);
+
+    // 读取 QSRTTOOL_LLM_RECORD_DIR；未设置时返回空字符串。
+    static QString outputDirectoryFromEnvironment();
+
+    QString outputFilePath() const;
+
+    void beginExchange(QNetworkReply *reply, const QString &url, const QByteArray &requestBody, bool streaming);
+    // 记录一块原始响应数据（流式为 SSE / NDJSON 原文），elapsedMs 为请求发出起的耗时。
+    void appendChunk(QNetworkReply *reply, qint64 elapsedMs, const QByteArray &data);
+    // 交换结束：写入一行记录。非流式响应的完整响应体通过 body 传入。
+    void finishExchange(QNetworkReply *reply, int statusCode, qint64 totalMs, const QByteArray &body);
+    // 丢弃未完成的交换（用户取消或对冲落败，响应不完整）。
+    void discardExchange(QNetworkReply *reply);
+
+private:
+    struct Exchange
+    {
+        QString url;
+        QByteArray requestBody;
+        bool streaming = false;
+        QJsonArray chunks;
+    };
+
+    QString m_outputFilePath;
+    QHash<QNetworkReply *, Exchange> m_exchanges;
+};
+
+#endif // LLMTRAFFICRECORDER_H
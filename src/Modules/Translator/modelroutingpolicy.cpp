@@ -0,0 +1,79 @@
+#include "modelroutingpolicy.h"
+
+#include <QRegularExpression>
+#include <QtGlobal>
+
+namespace {
+// 超过该长度（字符，CJK 按 2 计）的条目视为长句。
+const double kLongLineLength = 60.0;
+// 各特征权重，合计为 1。
+const double kLengthWeight = 0.35;
+const double kVocabularyWeight = 0.2;
+const double kNamedWeight = 0.25;
+const double kMemoryMissWeight = 0.2;
+
+int weightedLength(const QString &text)
+{
+    int length = 0;
+    for (const QChar ch : text) {
+        if (ch.isSpace()) {
+            continue;
+        }
+        // CJK 统一表意文字与假名信息密度高，按 2 计。
+        const ushort code = ch.unicode();
+        length += (code >= 0x3040 && code <= 0x9FFF) || (code >= 0xAC00 && code <= 0xD7AF) ? 2 : 1;
+    }
+    return length;
+}
+}
+
+ChunkDifficulty ModelRoutingPolicy::assess(const QStringList &texts, int memoryHits, double hardThreshold)
+{
+    static const QRegularExpression wordRegex(QStringLiteral("[A-Za-z\\x{00C0}-\\x{024F}']+"));
+    // 数字，或句中（非句首）大写开头的词：多为人名、地名、机构名。
+    static const QRegularExpression numberRegex(QStringLiteral("\\d"));
+    static const QRegularExpression namedRegex(QStringLiteral("[^.!?\\s]\\s+[A-Z][a-z]+"));
+
+    ChunkDifficulty difficulty;
+    const int totalCount = texts.size() + qMax(0, memoryHits);
+    if (totalCount <= 0 || texts.isEmpty()) {
+        difficulty.memoryMissRatio = 0.0;
+        difficulty.hard = false;
+        return difficulty;
+    }
+
+    qint64 totalLength = 0;
+    int wordCount = 0;
+    int longWordCount = 0;
+    int namedOrNumericCount = 0;
+    for (const QString &text : texts) {
+        const QString trimmed = text.simplified();
+        totalLength += weightedLength(trimmed);
+
+        QRegularExpressionMatchIterator words = wordRegex.globalMatch(trimmed);
+        while (words.hasNext()) {
+            const QRegularExpressionMatch match = words.next();
+            ++wordCount;
+            if (match.capturedLength() >= 8) {
+                ++longWordCount;
+            }
+        }
+
+        if (numberRegex.match(trimmed).hasMatch() || namedRegex.match(trimmed).hasMatch()) {
+            ++namedOrNumericCount;
+        }
+    }
+
+    difficulty.averageLength = static_cast<double>(totalLength) / texts.size();
+    difficulty.longWordRatio = wordCount > 0 ? static_cast<double>(longWordCount) / wordCount : 0.0;
+    difficulty.namedOrNumericRatio = static_cast<double>(namedOrNumericCount) / texts.size();
+    difficulty.memoryMissRatio = static_cast<double>(texts.size()) / totalCount;
+
+    // 长词比例超过 25% 已属明显偏难，按此归一化。
+    difficulty.score = kLengthWeight * qMin(1.0, difficulty.averageLength / kLongLineLength)
+                       + kVocabularyWeight * qMin(1.0, difficulty.longWordRatio * 4.0)
+                       + kNamedWeight * difficulty.namedOrNumericRatio
+                       + kMemoryMissWeight * difficulty.memoryMissRatio;
+    difficulty.hard = difficulty.score >= hardThreshold;
+    return difficulty;
+}
@@ -0,0 +1,30 @@
+#ifndef MODELROUTINGPOLICY_H
+#define MODELROUTINGPOLICY_H
+
+#include <QString>
+#include <QStringList>
+
+// 单个分块的本地难度评估（0~1，越大越难），不调用模型。
+struct ChunkDifficulty
+{
+    double score = 0.0;
+    // 平均每条字符数（CJK 字符按 2 计）。
+    double averageLength = 0.0;
+    // 长词（8 个字母以上）占全部词的比例，衡量词汇难度。
+    double longWordRatio = 0.0;
+    // 含人名 / 专有名词或数字的条目比例，这类条目需要保持一致与准确。
+    double namedOrNumericRatio = 0.0;
+    // 未命中翻译记忆的条目比例。
+    double memoryMissRatio = 1.0;
+    bool hard = true;
+};
+
+// 快慢模型分流：简单分块（短句、常用词、重复台词多）发给快速模型，其余发给主模型。
+class ModelRoutingPolicy
+{
+public:
+    // texts 为分块中需要请求的原文；memoryHits 为命中翻译记忆、无需请求的条数。
+    static ChunkDifficulty assess(const QStringList &texts, int memoryHits, double hardThreshold);
+};
+
+#endif // MODELROUTINGPOLICY_H
@@ -0,0 +1,210 @@
+#include "mttranslationbackend.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QTimer>
+#include <QUrl>
+
+namespace {
+QString dialectName(MtServiceConfig::Dialect dialect)
+{
+    return dialect == MtServiceConfig::Dialect::LibreTranslate ? QStringLiteral("libretranslate")
+                                                               : QStringLiteral("lines");
+}
+
+QString errorMessageOf(const QJsonObject &object)
+{
+    const QJsonValue error = object.value(QStringLiteral("error"));
+    if (error.isObject()) {
+        return error.toObject().value(QStringLiteral("message")).toString().trimmed();
+    }
+    return error.toString().trimmed();
+}
+}
+
+bool MtServiceConfig::isValid() const
+{
+    const QUrl url(endpointUrl.trimmed());
+    return url.isValid() && (url.scheme() == QStringLiteral("http") || url.scheme() == QStringLiteral("https"))
+           && !url.host().isEmpty();
+}
+
+bool MtServiceConfig::dialectFromName(const QString &name, Dialect *dialect)
+{
+    const QString normalized = name.trimmed().toLower();
+    if (normalized == QStringLiteral("lines")) {
+        *dialect = Dialect::LineArray;
+        return true;
+    }
+    if (normalized == QStringLiteral("libretranslate")) {
+        *dialect = Dialect::LibreTranslate;
+        return true;
+    }
+    return false;
+}
+
+MtTranslationBackend::MtTranslationBackend(const MtServiceConfig &config, QObject *parent)
+    : TranslationBackend(parent)
+    , m_config(config)
+    , m_networkManager(new QNetworkAccessManager(this))
+{
+    m_config.endpointUrl = m_config.endpointUrl.trimmed();
+    m_config.maxConcurrent = qMax(1, m_config.maxConcurrent);
+}
+
+QString MtTranslationBackend::name() const
+{
+    return QStringLiteral("mt:%1").arg(dialectName(m_config.dialect));
+}
+
+QString MtTranslationBackend::languageCode(const QString &language)
+{
+    static const QHash<QString, QString> codeByName = {
+        {QStringLiteral("中文"), QStringLiteral("zh")},
+        {QStringLiteral("简体中文"), QStringLiteral("zh")},
+        {QStringLiteral("繁体中文"), QStringLiteral("zt")},
+        {QStringLiteral("英语"), QStringLiteral("en")},
+        {QStringLiteral("英文"), QStringLiteral("en")},
+        {QStringLiteral("日语"), QStringLiteral("ja")},
+        {QStringLiteral("日文"), QStringLiteral("ja")},
+        {QStringLiteral("韩语"), QStringLiteral("ko")},
+        {QStringLiteral("法语"), QStringLiteral("fr")},
+        {QStringLiteral("德语"), QStringLiteral("de")},
+        {QStringLiteral("西班牙语"), QStringLiteral("es")},
+        {QStringLiteral("俄语"), QStringLiteral("ru")},
+    };
+
+    const QString trimmed = language.trimmed();
+    if (trimmed.isEmpty() || trimmed == QStringLiteral("自动检测")) {
+        return QString();
+    }
+    return codeByName.value(trimmed, trimmed);
+}
+
+QByteArray MtTranslationBackend::buildPayload(const TranslationLineBatch &batch) const
+{
+    const QString source = languageCode(batch.sourceLanguage);
+    const QString target = languageCode(batch.targetLanguage);
+    QJsonObject body;
+    if (m_config.dialect == MtServiceConfig::Dialect::LibreTranslate) {
+        body.insert(QStringLiteral("q"), QJsonArray::fromStringList(batch.lines));
+        body.insert(QStringLiteral("source"), source.isEmpty() ? QStringLiteral("auto") : source);
+        body.insert(QStringLiteral("target"), target);
+        body.insert(QStringLiteral("format"), QStringLiteral("text"));
+        if (!m_config.apiKey.isEmpty()) {
+            body.insert(QStringLiteral("api_key"), m_config.apiKey);
+        }
+    } else {
+        body.insert(QStringLiteral("source_lang"), source);
+        body.insert(QStringLiteral("target_lang"), target);
+        body.insert(QStringLiteral("texts"), QJsonArray::fromStringList(batch.lines));
+    }
+    return QJsonDocument(body).toJson(QJsonDocument::Compact);
+}
+
+quint64 MtTranslationBackend::translateLines(const TranslationLineBatch &batch)
+{
+    if (batch.lines.isEmpty() || batch.targetLanguage.trimmed().isEmpty() || !m_config.isValid()) {
+        return 0;
+    }
+
+    QNetworkRequest request{QUrl(m_config.endpointUrl)};
+    request.setHeader(QNetworkRequest::ContentTypeHeader, QStringLiteral("application/json"));
+    if (!m_config.apiKey.isEmpty() && m_config.dialect == MtServiceConfig::Dialect::LineArray) {
+        request.setRawHeader("Authorization", "Bearer " + m_config.apiKey.toUtf8());
+    }
+
+    const QByteArray payload = buildPayload(batch);
+    const quint64 requestId = ++m_nextRequestId;
+    PendingRequest pending;
+    pending.lineCount = batch.lines.size();
+    pending.bytesSent = payload.size();
+    pending.timer.start();
+    pending.reply = m_networkManager->post(request, payload);
+    m_requests.insert(requestId, pending);
+
+    connect(pending.reply, &QNetworkReply::finished, this, [this, requestId]() {
+        onReplyFinished(requestId);
+    });
+    QNetworkReply *reply = pending.reply;
+    QTimer::singleShot(m_config.timeoutMs > 0 ? m_config.timeoutMs : 60000, reply, [reply]() {
+        reply->abort();
+    });
+    return requestId;
+}
+
+void MtTranslationBackend::cancel(quint64 requestId)
+{
+    const auto it = m_requests.find(requestId);
+    if (it == m_requests.end()) {
+        return;
+    }
+
+    QNetworkReply *reply = it.value().reply;
+    m_requests.erase(it);
+    // 先移出表再中止：finished 信号随后到达时按未知请求忽略。
+    reply->abort();
+}
+
+int MtTranslationBackend::suggestedConcurrency() const
+{
+    return m_config.maxConcurrent;
+}
+
+void MtTranslationBackend::onReplyFinished(quint64 requestId)
+{
+    const auto it = m_requests.find(requestId);
+    if (it == m_requests.end()) {
+        return;
+    }
+
+    const PendingRequest pending = it.value();
+    m_requests.erase(it);
+    QNetworkReply *reply = pending.reply;
+    reply->deleteLater();
+
+    const QByteArray body = reply->readAll();
+    const int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    const QJsonObject response = QJsonDocument::fromJson(body).object();
+    if (reply->error() != QNetworkReply::NoError || statusCode >= 400) {
+        QString message = errorMessageOf(response);
+        if (message.isEmpty()) {
+            message = reply->errorString().trimmed();
+        }
+        if (statusCode > 0) {
+            message = QStringLiteral("HTTP %1 %2").arg(statusCode).arg(message);
+        }
+        emit linesFailed(requestId, message);
+        return;
+    }
+
+    const QString resultKey = m_config.dialect == MtServiceConfig::Dialect::LibreTranslate
+                                  ? QStringLiteral("translatedText")
+                                  : QStringLiteral("translations");
+    const QJsonValue result = response.value(resultKey);
+    if (!result.isArray()) {
+        emit linesFailed(requestId, tr("响应缺少 %1 数组").arg(resultKey));
+        return;
+    }
+
+    const QJsonArray items = result.toArray();
+    QStringList translations;
+    translations.reserve(pending.lineCount);
+    for (int i = 0; i < pending.lineCount; ++i) {
+        translations.append(items.at(i).toString().trimmed());
+    }
+
+    LlmRequestMetrics metrics;
+    metrics.endpointUrl = m_config.endpointUrl;
+    metrics.model = name();
+    metrics.totalMs = pending.timer.elapsed();
+    metrics.firstTokenMs = metrics.totalMs;
+    metrics.bytesSent = pending.bytesSent;
+    metrics.bytesReceived = body.size();
+    emit requestMeasured(requestId, metrics);
+    emit linesTranslated(requestId, translations);
+}
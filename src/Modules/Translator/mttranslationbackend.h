@@ -0,0 +1,69 @@
+#ifndef MTTRANSLATIONBACKEND_H
+#define MTTRANSLATIONBACKEND_H
+
+#include "translationbackend.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+
+class QNetworkAccessManager;
+class QNetworkReply;
+
+struct MtServiceConfig
+{
+    enum class Dialect {
+        // 通用行数组接口（如 CTranslate2 / NLLB 的 HTTP 封装）：
+        // {"source_lang","target_lang","texts":[...]} -> {"translations":[...]}
+        LineArray,
+        // LibreTranslate：{"q":[...],"source","target","format":"text"} -> {"translatedText":[...]}
+        LibreTranslate
+    };
+
+    // 完整请求地址，如 http://127.0.0.1:5000/translate。
+    QString endpointUrl;
+    QString apiKey;
+    Dialect dialect = Dialect::LineArray;
+    int maxConcurrent = 4;
+    int timeoutMs = 60000;
+
+    bool isValid() const;
+    // "lines" / "libretranslate"；无法识别时返回 false。
+    static bool dialectFromName(const QString &name, Dialect *dialect);
+};
+
+// 专用机器翻译服务作为按行翻译后端：一个请求携带整块原文行，响应按下标对应。
+// 语言名（中文、英语、日语…）转换为服务使用的语言代码，已是代码时原样传递。
+class MtTranslationBackend : public TranslationBackend
+{
+    Q_OBJECT
+
+public:
+    explicit MtTranslationBackend(const MtServiceConfig &config, QObject *parent = nullptr);
+
+    QString name() const override;
+    quint64 translateLines(const TranslationLineBatch &batch) override;
+    void cancel(quint64 requestId) override;
+    int suggestedConcurrency() const override;
+
+    // 语言名转语言代码；为空时返回空串。
+    static QString languageCode(const QString &language);
+
+private:
+    struct PendingRequest
+    {
+        QNetworkReply *reply = nullptr;
+        int lineCount = 0;
+        qint64 bytesSent = 0;
+        QElapsedTimer timer;
+    };
+
+    QByteArray buildPayload(const TranslationLineBatch &batch) const;
+    void onReplyFinished(quint64 requestId);
+
+    MtServiceConfig m_config;
+    QNetworkAccessManager *m_networkManager = nullptr;
+    QHash<quint64, PendingRequest> m_requests;
+    quint64 m_nextRequestId = 0;
+};
+
+#endif // MTTRANSLATIONBACKEND_H
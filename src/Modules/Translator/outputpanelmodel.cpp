@@ -0,0 +1,222 @@
+#include "outputpanelmodel.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFont>
+
+#include <algorithm>
+
+OutputPanelModel::OutputPanelModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+    m_previewRows << tr("(暂无预览内容)");
+}
+
+int OutputPanelModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return 3 + m_previewRows.size() + qMax(1, m_logRecords.size());
+}
+
+QVariant OutputPanelModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= rowCount()) {
+        return QVariant();
+    }
+
+    const int row = index.row();
+    const bool headerRow = row == 0 || row == logHeaderRow();
+    if (role == Qt::FontRole && headerRow) {
+        QFont font;
+        font.setBold(true);
+        return font;
+    }
+    if (role != Qt::DisplayRole && role != Qt::ToolTipRole) {
+        return QVariant();
+    }
+
+    if (row == 0) {
+        return QStringLiteral("【输出预览】");
+    }
+    if (row <= m_previewRows.size()) {
+        return m_previewRows.at(row - 1);
+    }
+    if (row == logHeaderRow()) {
+        return QStringLiteral("【日志】");
+    }
+    if (row >= firstLogRow()) {
+        if (m_logRecords.isEmpty()) {
+            return tr("(暂无日志)");
+        }
+        return m_logRecords.at(row - firstLogRow()).displayText();
+    }
+    return QString();
+}
+
+void OutputPanelModel::setPreviewText(const QString &text)
+{
+    QStringList lines = splitLines(text);
+    m_previewEmpty = lines.isEmpty();
+    if (m_previewEmpty) {
+        lines << tr("(暂无预览内容)");
+    }
+    replacePreviewLines(lines);
+}
+
+void OutputPanelModel::appendPreviewText(const QString &text)
+{
+    const QStringList lines = splitLines(text);
+    if (lines.isEmpty()) {
+        return;
+    }
+    if (m_previewEmpty) {
+        setPreviewText(text);
+        return;
+    }
+
+    const int first = 1 + m_previewRows.size();
+    beginInsertRows(QModelIndex(), first, first + lines.size());
+    m_previewRows << QString() << lines;
+    endInsertRows();
+}
+
+void OutputPanelModel::appendLogLine(const QString &line, LogSeverity severity)
+{
+    LogRecord record;
+    record.timestampMs = QDateTime::currentMSecsSinceEpoch();
+    record.severity = severity;
+    record.module = QStringLiteral("translator");
+    record.text = line;
+    openLogSpillFileIfNeeded();
+
+    if (m_logRecords.isEmpty()) {
+        m_logRecords.append(record);
+        const QModelIndex changed = index(firstLogRow());
+        emit dataChanged(changed, changed);
+        return;
+    }
+
+    if (m_logRecords.isFull()) {
+        beginRemoveRows(QModelIndex(), firstLogRow(), firstLogRow());
+        m_logRecords.removeOldest();
+        endRemoveRows();
+    }
+    const int row = firstLogRow() + m_logRecords.size();
+    beginInsertRows(QModelIndex(), row, row);
+    m_logRecords.append(record);
+    endInsertRows();
+}
+
+void OutputPanelModel::setLogCapacity(int capacity)
+{
+    beginResetModel();
+    m_logRecords.setCapacity(capacity);
+    endResetModel();
+}
+
+void OutputPanelModel::clear()
+{
+    beginResetModel();
+    m_previewRows = QStringList() << tr("(暂无预览内容)");
+    m_previewEmpty = true;
+    m_logRecords.clear();
+    endResetModel();
+    m_logSpillPending = true;
+}
+
+QString OutputPanelModel::logSpillFilePath() const
+{
+    return m_logRecords.spillPath();
+}
+
+QString OutputPanelModel::textForRows(const QModelIndexList &indexes) const
+{
+    QVector<int> rows;
+    rows.reserve(indexes.size());
+    for (const QModelIndex &modelIndex : indexes) {
+        rows.append(modelIndex.row());
+    }
+    std::sort(rows.begin(), rows.end());
+
+    QStringList lines;
+    lines.reserve(rows.size());
+    for (int row : rows) {
+        lines.append(data(index(row), Qt::DisplayRole).toString());
+    }
+    return lines.join('\n');
+}
+
+int OutputPanelModel::logHeaderRow() const
+{
+    return 2 + m_previewRows.size();
+}
+
+int OutputPanelModel::firstLogRow() const
+{
+    return 3 + m_previewRows.size();
+}
+
+void OutputPanelModel::replacePreviewLines(const QStringList &lines)
+{
+    int common = 0;
+    const int overlap = qMin(m_previewRows.size(), lines.size());
+    while (common < overlap && m_previewRows.at(common) == lines.at(common)) {
+        ++common;
+    }
+
+    if (lines.size() < m_previewRows.size()) {
+        beginRemoveRows(QModelIndex(), 1 + lines.size(), m_previewRows.size());
+        m_previewRows.erase(m_previewRows.begin() + lines.size(), m_previewRows.end());
+        endRemoveRows();
+    }
+
+    const int changedEnd = qMin(m_previewRows.size(), lines.size());
+    if (common < changedEnd) {
+        for (int i = common; i < changedEnd; ++i) {
+            m_previewRows[i] = lines.at(i);
+        }
+        emit dataChanged(index(1 + common), index(changedEnd));
+    }
+
+    if (lines.size() > m_previewRows.size()) {
+        const int first = 1 + m_previewRows.size();
+        beginInsertRows(QModelIndex(), first, lines.size());
+        for (int i = m_previewRows.size(); i < lines.size(); ++i) {
+            m_previewRows.append(lines.at(i));
+        }
+        endInsertRows();
+    }
+}
+
+void OutputPanelModel::openLogSpillFileIfNeeded()
+{
+    if (!m_logSpillPending) {
+        return;
+    }
+
+    m_logSpillPending = false;
+    const QString filePath = QDir(QDir::currentPath() + QStringLiteral("/output/logs"))
+                                 .filePath(QStringLiteral("translator_%1.log")
+                                               .arg(QDateTime::currentDateTime().toString(QStringLiteral("yyyyMMdd_HHmmss"))));
+    if (!m_logRecords.setSpillPath(filePath)) {
+        qWarning("%s", qPrintable(tr("日志落盘文件无法打开：%1").arg(filePath)));
+    }
+}
+
+QStringList OutputPanelModel::splitLines(const QString &text)
+{
+    const QString trimmed = text.trimmed();
+    if (trimmed.isEmpty()) {
+        return QStringList();
+    }
+
+    QStringList lines = trimmed.split('\n');
+    for (QString &line : lines) {
+        if (line.endsWith('\r')) {
+            line.chop(1);
+        }
+    }
+    return lines;
+}
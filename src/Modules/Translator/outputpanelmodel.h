@@ -0,0 +1,51 @@
+#ifndef OUTPUTPANELMODEL_H
+#define OUTPUTPANELMODEL_H
+
+#include <QAbstractListModel>
+#include <QModelIndexList>
+#include <QStringList>
+
+#include "../../Core/logringbuffer.h"
+
+// 输出面板模型：预览与日志按行存放，配合统一行高的 QListView 只绘制可见行。
+// 预览更新时只替换与旧内容不同的尾部行，日志只在末尾追加、超出上限时淘汰首行，未变化的行不会重新布局。
+// 日志存于固定容量的环形缓冲，每个任务的完整日志追加写入 output/logs/translator_<时间>.log。
+class OutputPanelModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit OutputPanelModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    // 替换预览内容：保留与旧内容相同的前缀行，只增删改其后的行。
+    void setPreviewText(const QString &text);
+    // 在预览末尾追加一段（与已有内容之间空一行）。
+    void appendPreviewText(const QString &text);
+    // 追加一条日志（显示时带时间戳与级别标记）。
+    void appendLogLine(const QString &line, LogSeverity severity = LogSeverity::Info);
+    void setLogCapacity(int capacity);
+    // 清空预览与日志；之后的第一条日志写入新的落盘文件。
+    void clear();
+    // 当前任务的日志落盘文件；尚未写入时为空。
+    QString logSpillFilePath() const;
+    // 按行号顺序拼接所选行的文本（复制用）。
+    QString textForRows(const QModelIndexList &indexes) const;
+
+private:
+    // 行布局：预览标题、预览行、空行、日志标题、日志行；无内容时各有一行占位。
+    int logHeaderRow() const;
+    int firstLogRow() const;
+    void replacePreviewLines(const QStringList &lines);
+    static QStringList splitLines(const QString &text);
+    void openLogSpillFileIfNeeded();
+
+    QStringList m_previewRows;
+    bool m_previewEmpty = true;
+    LogRingBuffer m_logRecords{500};
+    bool m_logSpillPending = true;
+};
+
+#endif // OUTPUTPANELMODEL_H
@@ -55,3 +55,50 @@ QJsonArray PromptRequestComposer::buildSingleTurnMessages(const PromptComposeInp
 
     return messages;
 }
+
+QString PromptRequestComposer::buildPolishInstruction(const PromptComposeInput &input)
+{
+    const QString targetLanguage = input.targetLanguage.trimmed().isEmpty() ? QStringLiteral("中文")
+                                                                           : input.targetLanguage.trimmed();
+    QString result = QStringLiteral("这是一个影视字幕译文校对润色任务。每段会给出【原文】与【初译】，两者编号一一对应。"
+                                    "请对照原文修正初译中的误译、漏译与术语不统一之处，使%1表达自然、符合字幕简洁的习惯；"
+                                    "初译无误时原样输出。保持编号不变，不要合并或拆分条目，只输出润色后的%1译文。")
+                         .arg(targetLanguage);
+
+    const QString instruction = input.naturalInstruction.trimmed();
+    if (!instruction.isEmpty()) {
+        result += QStringLiteral("\n\n【翻译要求（供参考）】\n");
+        result += instruction;
+    }
+    if (!input.presetJson.trimmed().isEmpty()) {
+        result += QStringLiteral("\n\n【完整预设（JSON）】\n");
+        result += input.presetJson.trimmed();
+    }
+    return result;
+}
+
+QString PromptRequestComposer::buildReferenceContextBlock(const QStringList &lines)
+{
+    if (lines.isEmpty()) {
+        return QString();
+    }
+    return QStringLiteral("【参考上下文（相邻条目的原文 → 现有译文，仅用于衔接语气与指代，不要输出）】\n%1\n\n")
+        .arg(lines.join('\n'));
+}
+
+QJsonArray PromptRequestComposer::buildPrefixCachedMessages(const QString &staticPrompt, const QString &variableContent)
+{
+    QJsonArray messages;
+
+    QJsonObject systemMessage;
+    systemMessage.insert(QStringLiteral("role"), QStringLiteral("system"));
+    systemMessage.insert(QStringLiteral("content"), staticPrompt);
+    messages.append(systemMessage);
+
+    QJsonObject userMessage;
+    userMessage.insert(QStringLiteral("role"), QStringLiteral("user"));
+    userMessage.insert(QStringLiteral("content"), variableContent);
+    messages.append(userMessage);
+
+    return messages;
+}
@@ -3,6 +3,7 @@
 
 #include <QJsonArray>
 #include <QString>
+#include <QStringList>
 
 struct PromptComposeInput
 {
@@ -22,6 +23,13 @@ public:
     static QString buildFinalInstruction(const PromptComposeInput &input);
     // 构造单轮消息数组，供聊天补全接口直接发送。
     static QJsonArray buildSingleTurnMessages(const PromptComposeInput &input);
+    // 构造可复用前缀缓存的消息：静态提示作为 system 消息置首（各请求逐字节一致），
+    // 随请求变化的内容（上一段上下文、本段条目）全部放在最后一条 user 消息。
+    static QJsonArray buildPrefixCachedMessages(const QString &staticPrompt, const QString &variableContent);
+    // 参考上下文块（相邻条目的原文与现有译文，供衔接，不要求输出）；lines 为空时返回空串。
+    static QString buildReferenceContextBlock(const QStringList &lines);
+    // 第二阶段润色指令：对照原文校对初译，编号不变、不合并拆分条目（输出格式说明由调用方追加）。
+    static QString buildPolishInstruction(const PromptComposeInput &input);
 };
 
 #endif // PROMPTREQUESTCOMPOSER_H
@@ -0,0 +1,167 @@
+#include "segmentwirecodec.h"
+
+#include <QJsonArray>
+#include <QRegularExpression>
+#include <QStringList>
+
+namespace {
+const QRegularExpression &wireLineRegex()
+{
+    static const QRegularExpression regex(QStringLiteral(R"(^\[?(\d{1,9})\]?\s*[|｜]\s?(.*)$)"));
+    return regex;
+}
+
+QString escapeText(const QString &text)
+{
+    QString escaped;
+    escaped.reserve(text.size() + 8);
+    for (const QChar ch : text) {
+        if (ch == QLatin1Char('\\')) {
+            escaped += QStringLiteral("\\\\");
+        } else if (ch == QLatin1Char('\n')) {
+            escaped += QStringLiteral("\\n");
+        } else if (ch != QLatin1Char('\r')) {
+            escaped += ch;
+        }
+    }
+    return escaped;
+}
+
+QString unescapeText(const QString &text)
+{
+    QString plain;
+    plain.reserve(text.size());
+    for (int i = 0; i < text.size(); ++i) {
+        const QChar ch = text.at(i);
+        if (ch == QLatin1Char('\\') && i + 1 < text.size()) {
+            const QChar next = text.at(i + 1);
+            if (next == QLatin1Char('n')) {
+                plain += QLatin1Char('\n');
+                ++i;
+                continue;
+            }
+            if (next == QLatin1Char('\\')) {
+                plain += QLatin1Char('\\');
+                ++i;
+                continue;
+            }
+        }
+        plain += ch;
+    }
+    return plain;
+}
+}
+
+QString SegmentWireCodec::encodeLine(int id, const QString &text)
+{
+    return QString::number(id) + QLatin1Char('|') + escapeText(text.trimmed());
+}
+
+bool SegmentWireCodec::decodeLine(const QString &line, int *id, QString *text)
+{
+    const QRegularExpressionMatch match = wireLineRegex().match(line.trimmed());
+    if (!match.hasMatch()) {
+        return false;
+    }
+
+    bool ok = false;
+    const int parsedId = match.captured(1).toInt(&ok);
+    if (!ok || parsedId <= 0) {
+        return false;
+    }
+
+    if (id) {
+        *id = parsedId;
+    }
+    if (text) {
+        *text = unescapeText(match.captured(2)).trimmed();
+    }
+    return true;
+}
+
+QMap<int, QString> SegmentWireCodec::decodeResponse(const QString &rawText)
+{
+    QMap<int, QString> result;
+    const QStringList lines = rawText.split(QLatin1Char('\n'));
+    for (const QString &line : lines) {
+        int id = 0;
+        QString text;
+        if (decodeLine(line, &id, &text) && !text.isEmpty()) {
+            result.insert(id, text);
+        }
+    }
+    return result;
+}
+
+QString SegmentWireCodec::outputInstruction()
+{
+    return QStringLiteral("输入每行格式为“编号|原文”，请逐行输出“编号|译文”，编号必须与输入一一对应，不要输出时间轴。"
+                          "\n文本内的换行以 \\n 表示，输出时保持同样写法；仅返回译文行，不要额外解释。");
+}
+
+QJsonObject SegmentWireCodec::responseSchema()
+{
+    QJsonObject idProperty;
+    idProperty.insert(QStringLiteral("type"), QStringLiteral("integer"));
+    QJsonObject textProperty;
+    textProperty.insert(QStringLiteral("type"), QStringLiteral("string"));
+
+    QJsonObject itemProperties;
+    itemProperties.insert(QStringLiteral("id"), idProperty);
+    itemProperties.insert(QStringLiteral("text"), textProperty);
+
+    QJsonObject itemSchema;
+    itemSchema.insert(QStringLiteral("type"), QStringLiteral("object"));
+    itemSchema.insert(QStringLiteral("properties"), itemProperties);
+    itemSchema.insert(QStringLiteral("required"), QJsonArray{QStringLiteral("id"), QStringLiteral("text")});
+    itemSchema.insert(QStringLiteral("additionalProperties"), false);
+
+    QJsonObject itemsProperty;
+    itemsProperty.insert(QStringLiteral("type"), QStringLiteral("array"));
+    itemsProperty.insert(QStringLiteral("items"), itemSchema);
+
+    QJsonObject rootProperties;
+    rootProperties.insert(QStringLiteral("items"), itemsProperty);
+
+    QJsonObject schema;
+    schema.insert(QStringLiteral("title"), QStringLiteral("subtitle_translation"));
+    schema.insert(QStringLiteral("type"), QStringLiteral("object"));
+    schema.insert(QStringLiteral("properties"), rootProperties);
+    schema.insert(QStringLiteral("required"), QJsonArray{QStringLiteral("items")});
+    schema.insert(QStringLiteral("additionalProperties"), false);
+    return schema;
+}
+
+QString SegmentWireCodec::structuredOutputInstruction()
+{
+    return QStringLiteral("输入每行格式为“编号|原文”（文本内换行以 \\n 表示）。"
+                          "\n请仅输出 JSON：{\"items\":[{\"id\":编号,\"text\":\"译文\"}]}，"
+                          "每个输入编号对应一项，按输入顺序排列，不要输出时间轴或额外解释。");
+}
+
+bool SegmentWireCodec::decodeJsonItem(const QJsonObject &item, int *id, QString *text)
+{
+    const QJsonValue idValue = item.value(QStringLiteral("id"));
+    int parsedId = 0;
+    if (idValue.isDouble()) {
+        parsedId = idValue.toInt();
+    } else if (idValue.isString()) {
+        parsedId = idValue.toString().trimmed().toInt();
+    }
+    if (parsedId <= 0) {
+        return false;
+    }
+
+    const QJsonValue textValue = item.value(QStringLiteral("text"));
+    if (!textValue.isString()) {
+        return false;
+    }
+
+    if (id) {
+        *id = parsedId;
+    }
+    if (text) {
+        *text = unescapeText(textValue.toString()).trimmed();
+    }
+    return true;
+}
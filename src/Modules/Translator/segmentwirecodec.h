@@ -0,0 +1,28 @@
+#ifndef SEGMENTWIRECODEC_H
+#define SEGMENTWIRECODEC_H
+
+#include <QJsonObject>
+#include <QMap>
+#include <QString>
+
+class SegmentWireCodec
+{
+public:
+    // 编码单行 "id|text"；文本内换行转义为字面量 \n，反斜杠转义为 \\。
+    static QString encodeLine(int id, const QString &text);
+    // 解析单行 "id|text"（容忍全角竖线与 [id] 写法）；不是该格式时返回 false。
+    static bool decodeLine(const QString &line, int *id, QString *text);
+    // 解析整段响应，返回 id -> 译文；同一 id 出现多次时以最后一次为准。
+    static QMap<int, QString> decodeResponse(const QString &rawText);
+    // 追加在翻译指令末尾的输出格式约束。
+    static QString outputInstruction();
+
+    // 结构化输出的 JSON Schema：{"items":[{"id":整数,"text":"译文"}]}。
+    static QJsonObject responseSchema();
+    // 结构化输出模式下追加在指令末尾的格式约束。
+    static QString structuredOutputInstruction();
+    // 解析单个 {"id":..,"text":..} 对象；缺字段或 id 非法时返回 false。
+    static bool decodeJsonItem(const QJsonObject &item, int *id, QString *text);
+};
+
+#endif // SEGMENTWIRECODEC_H
@@ -0,0 +1,199 @@
+#include "sentenceregrouper.h"
+
+#include <QHash>
+#include <QtGlobal>
+
+namespace {
+// 切点可偏离比例位置的最大字符数。
+const int kSplitSearchRadius = 8;
+
+bool endsSentence(const QString &text)
+{
+    static const QString terminals = QStringLiteral(".!?。！？…♪\"”」』)）");
+    const QString trimmed = text.trimmed();
+    if (trimmed.isEmpty()) {
+        return true;
+    }
+    // 省略号结尾通常是话未说完，继续合并。
+    if (trimmed.endsWith(QStringLiteral("...")) || trimmed.endsWith(QStringLiteral("…"))) {
+        return false;
+    }
+    return terminals.contains(trimmed.at(trimmed.size() - 1));
+}
+
+bool isCjk(QChar ch)
+{
+    const ushort code = ch.unicode();
+    return (code >= 0x3000 && code <= 0x9FFF) || (code >= 0xAC00 && code <= 0xD7AF) || (code >= 0xFF00 && code <= 0xFFEF);
+}
+
+QString joinFragments(const QString &left, const QString &right)
+{
+    if (left.isEmpty()) {
+        return right;
+    }
+    if (right.isEmpty()) {
+        return left;
+    }
+    // CJK 文本直接相连，其余以空格分隔。
+    if (isCjk(left.at(left.size() - 1)) || isCjk(right.at(0))) {
+        return left + right;
+    }
+    return left + QLatin1Char(' ') + right;
+}
+
+bool isBreakAfter(QChar ch)
+{
+    static const QString breaks = QStringLiteral(",.!?;:，。！？；：、…");
+    return ch.isSpace() || breaks.contains(ch);
+}
+}
+
+QVector<SubtitleEntry> SentenceRegrouper::group(const QVector<SubtitleEntry> &cues,
+                                                const Options &options,
+                                                QVector<SentenceUnit> *units)
+{
+    QVector<SubtitleEntry> grouped;
+    QVector<SentenceUnit> groupedUnits;
+    grouped.reserve(cues.size());
+    groupedUnits.reserve(cues.size());
+
+    int i = 0;
+    while (i < cues.size()) {
+        SentenceUnit unit;
+        unit.firstIndex = i;
+        unit.count = 1;
+        SubtitleEntry entry = cues.at(i);
+        entry.text = entry.text.simplified();
+
+        while (i + unit.count < cues.size()) {
+            const SubtitleEntry &previous = cues.at(i + unit.count - 1);
+            const SubtitleEntry &next = cues.at(i + unit.count);
+            const QString nextText = next.text.simplified();
+            if (endsSentence(previous.text)
+                || unit.count >= options.maxCuesPerUnit
+                || next.startMs - previous.endMs > options.maxGapMs
+                || next.endMs - entry.startMs > options.maxUnitDurationMs
+                || entry.text.size() + nextText.size() > options.maxCharsPerUnit) {
+                break;
+            }
+
+            entry.text = joinFragments(entry.text, nextText);
+            entry.endMs = next.endMs;
+            entry.endText = next.endText;
+            ++unit.count;
+        }
+
+        entry.index = grouped.size() + 1;
+        grouped.append(entry);
+        groupedUnits.append(unit);
+        i += unit.count;
+    }
+
+    if (units) {
+        *units = groupedUnits;
+    }
+    return grouped;
+}
+
+QVector<SubtitleEntry> SentenceRegrouper::redistribute(const QVector<SubtitleEntry> &translatedUnits,
+                                                       const QVector<SubtitleEntry> &originalCues,
+                                                       const QVector<SentenceUnit> &units)
+{
+    QHash<qint64, int> unitByStartMs;
+    unitByStartMs.reserve(units.size());
+    for (int i = 0; i < units.size(); ++i) {
+        const SentenceUnit &unit = units.at(i);
+        if (unit.firstIndex >= 0 && unit.firstIndex + unit.count <= originalCues.size()) {
+            unitByStartMs.insert(originalCues.at(unit.firstIndex).startMs, i);
+        }
+    }
+
+    QVector<SubtitleEntry> result;
+    result.reserve(originalCues.size());
+    for (const SubtitleEntry &translated : translatedUnits) {
+        const auto unitIt = unitByStartMs.constFind(translated.startMs);
+        if (unitIt == unitByStartMs.constEnd()) {
+            result.append(translated);
+            continue;
+        }
+
+        result += redistributeUnit(translated, originalCues, units.at(unitIt.value()));
+    }
+    return result;
+}
+
+QVector<SubtitleEntry> SentenceRegrouper::redistributeUnit(const SubtitleEntry &translatedUnit,
+                                                           const QVector<SubtitleEntry> &originalCues,
+                                                           const SentenceUnit &unit)
+{
+    QVector<SubtitleEntry> result;
+    if (unit.count <= 0 || unit.firstIndex < 0 || unit.firstIndex + unit.count > originalCues.size()) {
+        result.append(translatedUnit);
+        return result;
+    }
+
+    QVector<qint64> weights;
+    weights.reserve(unit.count);
+    for (int i = 0; i < unit.count; ++i) {
+        const SubtitleEntry &cue = originalCues.at(unit.firstIndex + i);
+        weights.append(qMax<qint64>(1, cue.endMs - cue.startMs));
+    }
+
+    const QStringList parts = splitByWeights(translatedUnit.text, weights);
+    result.reserve(unit.count);
+    for (int i = 0; i < unit.count; ++i) {
+        SubtitleEntry cue = originalCues.at(unit.firstIndex + i);
+        cue.text = parts.value(i);
+        if (!cue.text.isEmpty()) {
+            result.append(cue);
+        } else if (!result.isEmpty()) {
+            // 译文过短分不满时，由前一条延续显示到本条结束。
+            result.last().endMs = cue.endMs;
+            result.last().endText = cue.endText;
+        }
+    }
+    return result;
+}
+
+QStringList SentenceRegrouper::splitByWeights(const QString &text, const QVector<qint64> &weights)
+{
+    QStringList parts;
+    const QString source = text.trimmed();
+    if (weights.size() <= 1) {
+        parts.append(source);
+        return parts;
+    }
+
+    qint64 totalWeight = 0;
+    for (qint64 weight : weights) {
+        totalWeight += qMax<qint64>(1, weight);
+    }
+
+    int cursor = 0;
+    qint64 cumulativeWeight = 0;
+    for (int i = 0; i < weights.size() - 1; ++i) {
+        cumulativeWeight += qMax<qint64>(1, weights.at(i));
+        const int target = static_cast<int>(source.size() * cumulativeWeight / totalWeight);
+
+        // 在比例位置附近找最近的标点或空格，切点保持单调且尽量不产生空段。
+        int cut = qBound(cursor, target, source.size());
+        for (int offset = 0; offset <= kSplitSearchRadius; ++offset) {
+            const int after = target + offset;
+            const int before = target - offset;
+            if (after > cursor && after < source.size() && isBreakAfter(source.at(after - 1))) {
+                cut = after;
+                break;
+            }
+            if (before > cursor && before < source.size() && isBreakAfter(source.at(before - 1))) {
+                cut = before;
+                break;
+            }
+        }
+
+        parts.append(source.mid(cursor, cut - cursor).trimmed());
+        cursor = cut;
+    }
+    parts.append(source.mid(cursor).trimmed());
+    return parts;
+}
@@ -0,0 +1,46 @@
+#ifndef SENTENCEREGROUPER_H
+#define SENTENCEREGROUPER_H
+
+#include "subtitleentry.h"
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// 句子单元：覆盖原条目中 [firstIndex, firstIndex + count) 的连续范围。
+struct SentenceUnit
+{
+    int firstIndex = 0;
+    int count = 0;
+};
+
+// 翻译前将语音识别切碎的连续条目按标点与间隔合并为句子单元，翻译后再按原条目时长比例切回。
+class SentenceRegrouper
+{
+public:
+    struct Options
+    {
+        // 相邻条目间隔超过该值时视为换句。
+        qint64 maxGapMs = 800;
+        int maxCuesPerUnit = 4;
+        int maxCharsPerUnit = 160;
+        qint64 maxUnitDurationMs = 10000;
+    };
+
+    // 返回单元条目（编号从 1 连续，时间为首条开始到末条结束），units 与之一一对应。
+    static QVector<SubtitleEntry> group(const QVector<SubtitleEntry> &cues,
+                                        const Options &options,
+                                        QVector<SentenceUnit> *units);
+    // 按开始时间匹配单元，将单元译文按原条目时长比例切回；无法匹配的条目原样保留。
+    static QVector<SubtitleEntry> redistribute(const QVector<SubtitleEntry> &translatedUnits,
+                                               const QVector<SubtitleEntry> &originalCues,
+                                               const QVector<SentenceUnit> &units);
+    // 单个单元的译文切回其覆盖的原条目（增量导出按单元逐个展开）。
+    static QVector<SubtitleEntry> redistributeUnit(const SubtitleEntry &translatedUnit,
+                                                   const QVector<SubtitleEntry> &originalCues,
+                                                   const SentenceUnit &unit);
+    // 按权重切分文本，切点优先落在附近的标点或空格处；返回份数与 weights 相同。
+    static QStringList splitByWeights(const QString &text, const QVector<qint64> &weights);
+};
+
+#endif // SENTENCEREGROUPER_H
@@ -0,0 +1,82 @@
+#include "sourceeditdiff.h"
+
+#include "translationmemory.h"
+
+#include <QCryptographicHash>
+#include <QHash>
+
+#include <algorithm>
+
+bool SourceFingerprint::operator==(const SourceFingerprint &other) const
+{
+    return startMs == other.startMs && endMs == other.endMs && textHash == other.textHash;
+}
+
+SourceFingerprint SourceEditDiff::fingerprint(const SubtitleEntry &entry)
+{
+    SourceFingerprint result;
+    result.startMs = entry.startMs;
+    result.endMs = entry.endMs;
+    result.textHash = hashText(entry.text);
+    return result;
+}
+
+QVector<SourceFingerprint> SourceEditDiff::fingerprints(const QVector<SubtitleEntry> &entries)
+{
+    QVector<SourceFingerprint> result;
+    result.reserve(entries.size());
+    for (const SubtitleEntry &entry : entries) {
+        result.append(fingerprint(entry));
+    }
+    return result;
+}
+
+QString SourceEditDiff::hashText(const QString &text)
+{
+    const QByteArray digest = QCryptographicHash::hash(TranslationMemory::normalizeSource(text).toUtf8(),
+                                                       QCryptographicHash::Sha1);
+    return QString::fromLatin1(digest.toHex().left(16));
+}
+
+QVector<int> SourceEditDiff::matchPositions(const QVector<SourceFingerprint> &oldSource,
+                                            const QVector<SourceFingerprint> &newSource)
+{
+    // 时间 + 文本哈希 -> 旧位置（升序）。
+    QHash<QString, QVector<int>> oldPositionsByKey;
+    oldPositionsByKey.reserve(oldSource.size());
+    const auto keyOf = [](const SourceFingerprint &fingerprint) {
+        return QStringLiteral("%1|%2|%3").arg(fingerprint.startMs).arg(fingerprint.endMs).arg(fingerprint.textHash);
+    };
+    for (int i = 0; i < oldSource.size(); ++i) {
+        oldPositionsByKey[keyOf(oldSource.at(i))].append(i);
+    }
+
+    QVector<int> matches(newSource.size(), -1);
+    int lastOld = -1;
+    for (int i = 0; i < newSource.size(); ++i) {
+        const SourceFingerprint &current = newSource.at(i);
+        if (i > lastOld && i < oldSource.size() && oldSource.at(i) == current) {
+            matches[i] = i;
+            lastOld = i;
+            continue;
+        }
+
+        const auto keyIt = oldPositionsByKey.constFind(keyOf(current));
+        if (keyIt != oldPositionsByKey.constEnd()) {
+            const QVector<int> &positions = keyIt.value();
+            const auto next = std::upper_bound(positions.constBegin(), positions.constEnd(), lastOld);
+            if (next != positions.constEnd()) {
+                matches[i] = *next;
+                lastOld = *next;
+                continue;
+            }
+        }
+
+        // 同编号、文本未变、仅时间轴调整：沿用旧译文，时间轴以新源文件为准。
+        if (i > lastOld && i < oldSource.size() && oldSource.at(i).textHash == current.textHash) {
+            matches[i] = i;
+            lastOld = i;
+        }
+    }
+    return matches;
+}
@@ -0,0 +1,35 @@
+#ifndef SOURCEEDITDIFF_H
+#define SOURCEEDITDIFF_H
+
+#include "subtitleentry.h"
+
+#include <QString>
+#include <QVector>
+
+// 源条目指纹：时间轴与规范化文本的哈希，会话日志据此比对源文件修改前后的条目。
+struct SourceFingerprint
+{
+    qint64 startMs = 0;
+    qint64 endMs = 0;
+    QString textHash;
+
+    bool operator==(const SourceFingerprint &other) const;
+};
+
+// 源文件修改后的条目级比对：按（编号，时间，文本哈希）找出未改动的条目，只重译其余部分。
+class SourceEditDiff
+{
+public:
+    static SourceFingerprint fingerprint(const SubtitleEntry &entry);
+    static QVector<SourceFingerprint> fingerprints(const QVector<SubtitleEntry> &entries);
+    // 去首尾空白、合并连续空白后取 SHA-1 前 16 位十六进制。
+    static QString hashText(const QString &text);
+
+    // 返回与 newSource 等长的数组：未改动条目对应的旧位置，新增或修改的条目为 -1。
+    // 匹配保持顺序：先比同编号，再按时间 + 文本在旧条目中顺序查找（插入 / 删除条目后编号整体偏移）；
+    // 仅时间轴被调整、文本不变的同编号条目也视为未改动。
+    static QVector<int> matchPositions(const QVector<SourceFingerprint> &oldSource,
+                                       const QVector<SourceFingerprint> &newSource);
+};
+
+#endif // SOURCEEDITDIFF_H
@@ -0,0 +1,55 @@
+#include "sselinescanner.h"
+
+namespace {
+const int kInitialCapacity = 16 * 1024;
+}
+
+SseLineScanner::SseLineScanner()
+{
+    m_buffer.reserve(kInitialCapacity);
+}
+
+void SseLineScanner::reset()
+{
+    m_buffer.resize(0);
+    m_readOffset = 0;
+    m_scanOffset = 0;
+}
+
+void SseLineScanner::append(const QByteArray &chunk)
+{
+    if (chunk.isEmpty()) {
+        return;
+    }
+
+    // 读游标之前的数据已全部消费，剩余部分至多是一条半行，压缩代价与新数据同阶。
+    if (m_readOffset > 0) {
+        m_buffer.remove(0, m_readOffset);
+        m_scanOffset -= m_readOffset;
+        m_readOffset = 0;
+    }
+    m_buffer.append(chunk);
+}
+
+bool SseLineScanner::nextLine(QByteArray *line)
+{
+    const int newlinePos = m_buffer.indexOf('\n', m_scanOffset);
+    if (newlinePos < 0) {
+        m_scanOffset = m_buffer.size();
+        return false;
+    }
+
+    if (line) {
+        *line = m_buffer.mid(m_readOffset, newlinePos - m_readOffset);
+    }
+    m_readOffset = newlinePos + 1;
+    m_scanOffset = m_readOffset;
+    return true;
+}
+
+QByteArray SseLineScanner::takeRemainder()
+{
+    const QByteArray remainder = m_buffer.mid(m_readOffset);
+    reset();
+    return remainder;
+}
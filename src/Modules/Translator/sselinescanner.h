@@ -0,0 +1,26 @@
+#ifndef SSELINESCANNER_H
+#define SSELINESCANNER_H
+
+#include <QByteArray>
+
+class SseLineScanner
+{
+public:
+    SseLineScanner();
+
+    // 清空缓冲但保留已分配容量，供下一次响应复用。
+    void reset();
+    // 追加网络层新到达的数据；已消费的前缀只在此处整体压缩一次。
+    void append(const QByteArray &chunk);
+    // 取出下一条完整行（不含换行符）；没有完整行时返回 false。
+    bool nextLine(QByteArray *line);
+    // 取出流结束时残留的未终止数据。
+    QByteArray takeRemainder();
+
+private:
+    QByteArray m_buffer;
+    int m_readOffset = 0;
+    int m_scanOffset = 0;
+};
+
+#endif // SSELINESCANNER_H
@@ -0,0 +1,318 @@
+#include "streamingcueparser.h"
+#include "segmentwirecodec.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+
+namespace {
+const QRegularExpression &timingLineRegex()
+{
+    static const QRegularExpression regex(
+        QStringLiteral(R"(^(\d{2}:\d{2}:\d{2}[,\.]\d{3})\s*-->\s*(\d{2}:\d{2}:\d{2}[,\.]\d{3}))"));
+    return regex;
+}
+
+bool isIndexLine(const QString &line)
+{
+    if (line.isEmpty() || line.size() > 9) {
+        return false;
+    }
+    for (const QChar ch : line) {
+        if (!ch.isDigit()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QString normalizedTimelineToken(const QString &token)
+{
+    QString value = token.trimmed();
+    value.replace('.', ',');
+    return value;
+}
+}
+
+void StreamingCueParser::reset()
+{
+    m_format = InputFormat::SrtBlocks;
+    m_keyedTimeline.clear();
+    restart();
+}
+
+void StreamingCueParser::restart()
+{
+    m_jsonDepth = 0;
+    m_jsonItemDepth = 0;
+    m_jsonInString = false;
+    m_jsonEscape = false;
+    m_jsonItemBuffer.clear();
+    m_state = LineState::Idle;
+    m_lineBuffer.clear();
+    m_hasInput = false;
+    m_committedInCall = 0;
+    m_pendingIndexLine.clear();
+    m_cueIndexLine.clear();
+    m_cueTimingLine.clear();
+    m_cueStartText.clear();
+    m_cueEndText.clear();
+    m_cueTextLines.clear();
+    m_committedCues.clear();
+    m_committedText.clear();
+}
+
+int StreamingCueParser::feed(const QString &delta)
+{
+    m_committedInCall = 0;
+    if (delta.isEmpty()) {
+        return 0;
+    }
+
+    m_hasInput = true;
+    if (m_format == InputFormat::JsonItems) {
+        consumeJsonText(delta);
+        return m_committedInCall;
+    }
+
+    // 残留缓冲只保存“未换行的半行”，因此每次只扫描本次新增的数据。
+    const int scanFrom = m_lineBuffer.size();
+    m_lineBuffer += delta;
+
+    int lineStart = 0;
+    int newlinePos = m_lineBuffer.indexOf('\n', scanFrom);
+    while (newlinePos >= 0) {
+        consumeLine(m_lineBuffer.mid(lineStart, newlinePos - lineStart));
+        lineStart = newlinePos + 1;
+        newlinePos = m_lineBuffer.indexOf('\n', lineStart);
+    }
+
+    if (lineStart > 0) {
+        m_lineBuffer.remove(0, lineStart);
+    }
+    return m_committedInCall;
+}
+
+int StreamingCueParser::finish()
+{
+    m_committedInCall = 0;
+    if (!m_lineBuffer.isEmpty()) {
+        const QString tailLine = m_lineBuffer;
+        m_lineBuffer.clear();
+        consumeLine(tailLine);
+    }
+
+    if (m_state == LineState::InText) {
+        commitPendingCue();
+    }
+    m_state = LineState::Idle;
+    m_pendingIndexLine.clear();
+    return m_committedInCall;
+}
+
+void StreamingCueParser::setKeyedFormat(InputFormat format, const QHash<int, CueTiming> &timelineById)
+{
+    m_format = format;
+    m_keyedTimeline = timelineById;
+}
+
+bool StreamingCueParser::hasInput() const
+{
+    return m_hasInput;
+}
+
+const QVector<StreamingCueParser::Cue> &StreamingCueParser::committedCues() const
+{
+    return m_committedCues;
+}
+
+const QString &StreamingCueParser::committedText() const
+{
+    return m_committedText;
+}
+
+void StreamingCueParser::consumeLine(const QString &rawLine)
+{
+    const QString line = rawLine.trimmed();
+    if (m_format == InputFormat::CompactLines) {
+        consumeCompactLine(line);
+        return;
+    }
+
+    if (line.startsWith(QStringLiteral("```"))) {
+        // 代码围栏既可能是开头也可能是结尾，遇到时结束当前条目即可。
+        if (m_state == LineState::InText) {
+            commitPendingCue();
+        }
+        m_state = LineState::Idle;
+        m_pendingIndexLine.clear();
+        return;
+    }
+
+    const QRegularExpressionMatch timingMatch = line.contains(QStringLiteral("-->"))
+                                                ? timingLineRegex().match(line)
+                                                : QRegularExpressionMatch();
+    const bool isTiming = timingMatch.hasMatch();
+
+    switch (m_state) {
+    case LineState::Idle:
+        if (isTiming) {
+            beginCue(line, timingMatch.captured(1), timingMatch.captured(2));
+        } else if (isIndexLine(line)) {
+            m_pendingIndexLine = line;
+            m_state = LineState::ExpectTiming;
+        }
+        break;
+    case LineState::ExpectTiming:
+        if (isTiming) {
+            beginCue(line, timingMatch.captured(1), timingMatch.captured(2));
+        } else if (isIndexLine(line)) {
+            m_pendingIndexLine = line;
+        } else {
+            m_pendingIndexLine.clear();
+            m_state = LineState::Idle;
+        }
+        break;
+    case LineState::InText:
+        if (isTiming) {
+            // 模型漏掉空行时：上一条以新的时间轴行为界提交，末尾纯数字行视为新序号。
+            if (!m_cueTextLines.isEmpty() && isIndexLine(m_cueTextLines.last())) {
+                m_pendingIndexLine = m_cueTextLines.takeLast();
+            }
+            commitPendingCue();
+            beginCue(line, timingMatch.captured(1), timingMatch.captured(2));
+        } else if (line.isEmpty()) {
+            if (!m_cueTextLines.isEmpty()) {
+                commitPendingCue();
+                m_state = LineState::Idle;
+            }
+        } else {
+            m_cueTextLines.append(line);
+        }
+        break;
+    }
+}
+
+void StreamingCueParser::consumeCompactLine(const QString &line)
+{
+    int id = 0;
+    QString text;
+    if (SegmentWireCodec::decodeLine(line, &id, &text)) {
+        commitKeyedCue(id, text);
+    }
+}
+
+void StreamingCueParser::consumeJsonText(const QString &delta)
+{
+    // 逐字符跟踪括号深度与字符串状态；条目对象闭合时才整体解析，代价只与新数据相关。
+    for (const QChar ch : delta) {
+        if (m_jsonItemDepth > 0) {
+            m_jsonItemBuffer += ch;
+        }
+
+        if (m_jsonInString) {
+            if (m_jsonEscape) {
+                m_jsonEscape = false;
+            } else if (ch == QLatin1Char('\\')) {
+                m_jsonEscape = true;
+            } else if (ch == QLatin1Char('"')) {
+                m_jsonInString = false;
+            }
+            continue;
+        }
+
+        if (ch == QLatin1Char('"')) {
+            if (m_jsonDepth > 0) {
+                m_jsonInString = true;
+            }
+        } else if (ch == QLatin1Char('{') || ch == QLatin1Char('[')) {
+            ++m_jsonDepth;
+            // 根容器之内遇到的第一层对象即条目：{"items":[{...}]} 或 [{...}] 均适用。
+            if (ch == QLatin1Char('{') && m_jsonItemDepth == 0 && m_jsonDepth >= 2) {
+                m_jsonItemDepth = m_jsonDepth;
+                m_jsonItemBuffer = ch;
+            }
+        } else if (ch == QLatin1Char('}') || ch == QLatin1Char(']')) {
+            if (m_jsonItemDepth > 0 && m_jsonDepth == m_jsonItemDepth) {
+                const QJsonDocument document = QJsonDocument::fromJson(m_jsonItemBuffer.toUtf8());
+                m_jsonItemBuffer.clear();
+                m_jsonItemDepth = 0;
+
+                int id = 0;
+                QString text;
+                if (document.isObject() && SegmentWireCodec::decodeJsonItem(document.object(), &id, &text)) {
+                    commitKeyedCue(id, text);
+                }
+            }
+            m_jsonDepth = qMax(0, m_jsonDepth - 1);
+        }
+    }
+}
+
+void StreamingCueParser::commitKeyedCue(int id, const QString &text)
+{
+    if (text.isEmpty()) {
+        return;
+    }
+
+    // 未知编号说明模型输出错位，丢弃该条交由上层校验缺失条目。
+    const auto timingIt = m_keyedTimeline.constFind(id);
+    if (timingIt == m_keyedTimeline.constEnd()) {
+        return;
+    }
+
+    Cue cue;
+    cue.index = id;
+    cue.startText = timingIt->startText;
+    cue.endText = timingIt->endText;
+    cue.text = text;
+    cue.block = QString::number(id) + '\n' + cue.startText + QStringLiteral(" --> ") + cue.endText + '\n' + text;
+    appendCommittedCue(cue);
+}
+
+void StreamingCueParser::beginCue(const QString &timingLine, const QString &startText, const QString &endText)
+{
+    m_cueIndexLine = m_pendingIndexLine;
+    m_pendingIndexLine.clear();
+    m_cueTimingLine = timingLine;
+    m_cueStartText = normalizedTimelineToken(startText);
+    m_cueEndText = normalizedTimelineToken(endText);
+    m_cueTextLines.clear();
+    m_state = LineState::InText;
+}
+
+void StreamingCueParser::appendCommittedCue(const Cue &cue)
+{
+    if (!m_committedText.isEmpty()) {
+        m_committedText += QStringLiteral("\n\n");
+    }
+    m_committedText += cue.block;
+    m_committedCues.append(cue);
+    ++m_committedInCall;
+}
+
+bool StreamingCueParser::commitPendingCue()
+{
+    if (m_cueTimingLine.isEmpty() || m_cueTextLines.isEmpty()) {
+        m_cueTimingLine.clear();
+        m_cueIndexLine.clear();
+        m_cueTextLines.clear();
+        return false;
+    }
+
+    Cue cue;
+    cue.index = m_cueIndexLine.toInt();
+    cue.startText = m_cueStartText;
+    cue.endText = m_cueEndText;
+    cue.text = m_cueTextLines.join('\n');
+    if (!m_cueIndexLine.isEmpty()) {
+        cue.block = m_cueIndexLine + '\n';
+    }
+    cue.block += m_cueTimingLine + '\n' + cue.text;
+    appendCommittedCue(cue);
+
+    m_cueTimingLine.clear();
+    m_cueIndexLine.clear();
+    m_cueTextLines.clear();
+    return true;
+}
@@ -0,0 +1,93 @@
+#ifndef STREAMINGCUEPARSER_H
+#define STREAMINGCUEPARSER_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class StreamingCueParser
+{
+public:
+    enum class InputFormat {
+        SrtBlocks,
+        CompactLines,
+        JsonItems
+    };
+
+    struct Cue
+    {
+        int index = 0;
+        QString startText;
+        QString endText;
+        QString text;
+        // 裁剪后的原文块（序号行 + 时间轴行 + 文本），不做改写。
+        QString block;
+    };
+
+    struct CueTiming
+    {
+        QString startText;
+        QString endText;
+    };
+
+    // 清空解析状态，准备接收新一段响应（默认按 SRT 块解析）。
+    void reset();
+    // 切换为按编号回填时间轴的格式：CompactLines 每个完整行即一条，
+    // JsonItems 每个闭合的 {"id","text"} 对象即一条。
+    void setKeyedFormat(InputFormat format, const QHash<int, CueTiming> &timelineById);
+    // 丢弃已接收内容但保留格式与时间轴，用于同一请求换端点重发后重新解析。
+    void restart();
+    // 追加新到达的增量文本，仅扫描新数据；返回本次新提交的条目数。
+    int feed(const QString &delta);
+    // 响应结束时处理残留行，并提交未遇到空行终止的最后一条。
+    int finish();
+
+    // 是否已接收过任何输入（用于区分流式与非流式结果）。
+    bool hasInput() const;
+    const QVector<Cue> &committedCues() const;
+    // 已提交条目按空行拼接的预览文本（随提交增量追加）。
+    const QString &committedText() const;
+
+private:
+    enum class LineState {
+        Idle,
+        ExpectTiming,
+        InText
+    };
+
+    void consumeLine(const QString &rawLine);
+    void consumeCompactLine(const QString &line);
+    void consumeJsonText(const QString &delta);
+    void commitKeyedCue(int id, const QString &text);
+    void appendCommittedCue(const Cue &cue);
+    void beginCue(const QString &timingLine, const QString &startText, const QString &endText);
+    bool commitPendingCue();
+
+    InputFormat m_format = InputFormat::SrtBlocks;
+    QHash<int, CueTiming> m_keyedTimeline;
+
+    // JsonItems 扫描状态：仅缓存当前未闭合的条目对象。
+    int m_jsonDepth = 0;
+    int m_jsonItemDepth = 0;
+    bool m_jsonInString = false;
+    bool m_jsonEscape = false;
+    QString m_jsonItemBuffer;
+
+    LineState m_state = LineState::Idle;
+    QString m_lineBuffer;
+    bool m_hasInput = false;
+    int m_committedInCall = 0;
+
+    QString m_pendingIndexLine;
+    QString m_cueIndexLine;
+    QString m_cueTimingLine;
+    QString m_cueStartText;
+    QString m_cueEndText;
+    QStringList m_cueTextLines;
+
+    QVector<Cue> m_committedCues;
+    QString m_committedText;
+};
+
+#endif // STREAMINGCUEPARSER_H
@@ -0,0 +1,75 @@
+#include "subtitleentry.h"
+
+#include <QChar>
+#include <QRegularExpression>
+
+QString SubtitleTimeline::normalizeToken(const QString &timelineToken)
+{
+    QString value = timelineToken.trimmed();
+    value.replace('.', ',');
+    return value;
+}
+
+qint64 SubtitleTimeline::toMs(const QString &timelineToken)
+{
+    static const QRegularExpression tokenRegex(QStringLiteral(R"((\d{2}):(\d{2}):(\d{2}),(\d{3}))"));
+    const QRegularExpressionMatch match = tokenRegex.match(normalizeToken(timelineToken));
+    if (!match.hasMatch()) {
+        return -1;
+    }
+
+    const int hours = match.captured(1).toInt();
+    const int minutes = match.captured(2).toInt();
+    const int seconds = match.captured(3).toInt();
+    const int millis = match.captured(4).toInt();
+    return (((hours * 60LL + minutes) * 60LL) + seconds) * 1000LL + millis;
+}
+
+QString SubtitleTimeline::fromMs(qint64 ms)
+{
+    if (ms < 0) {
+        ms = 0;
+    }
+
+    const qint64 hours = ms / 3600000;
+    ms %= 3600000;
+    const qint64 minutes = ms / 60000;
+    ms %= 60000;
+    const qint64 seconds = ms / 1000;
+    ms %= 1000;
+
+    return QStringLiteral("%1:%2:%3,%4")
+        .arg(hours, 2, 10, QChar('0'))
+        .arg(minutes, 2, 10, QChar('0'))
+        .arg(seconds, 2, 10, QChar('0'))
+        .arg(ms, 3, 10, QChar('0'));
+}
+
+const QRegularExpression &SubtitleSrt::blockRegex()
+{
+    static const QRegularExpression regex(
+        QStringLiteral("(?ms)(?:\\s*(\\d+)\\s*\\n)?\\s*(\\d{2}:\\d{2}:\\d{2}[,\\.]\\d{3})\\s*-->\\s*(\\d{2}:\\d{2}:\\d{2}[,\\.]\\d{3})\\s*\\n(.*?)(?=\\n{2,}(?:\\d+\\s*\\n)?\\s*\\d{2}:\\d{2}:\\d{2}[,\\.]\\d{3}\\s*-->|\\z)"));
+    return regex;
+}
+
+QVector<SubtitleEntry> SubtitleSrt::parse(const QString &srtText)
+{
+    QVector<SubtitleEntry> entries;
+    QRegularExpressionMatchIterator iterator = blockRegex().globalMatch(srtText);
+    while (iterator.hasNext()) {
+        const QRegularExpressionMatch match = iterator.next();
+        SubtitleEntry entry;
+        entry.index = match.captured(1).trimmed().toInt();
+        entry.startText = SubtitleTimeline::normalizeToken(match.captured(2));
+        entry.endText = SubtitleTimeline::normalizeToken(match.captured(3));
+        entry.startMs = SubtitleTimeline::toMs(entry.startText);
+        entry.endMs = SubtitleTimeline::toMs(entry.endText);
+        entry.text = match.captured(4).trimmed();
+
+        if (entry.startMs < 0 || entry.endMs < 0 || entry.text.isEmpty()) {
+            continue;
+        }
+        entries.append(entry);
+    }
+    return entries;
+}
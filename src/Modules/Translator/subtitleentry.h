@@ -0,0 +1,35 @@
+#ifndef SUBTITLEENTRY_H
+#define SUBTITLEENTRY_H
+
+#include <QRegularExpression>
+#include <QString>
+#include <QVector>
+
+// 单条字幕（SRT 条目）；翻译页、任务执行器与导出共用。
+struct SubtitleEntry
+{
+    int index = 0;
+    qint64 startMs = 0;
+    qint64 endMs = 0;
+    QString startText;
+    QString endText;
+    QString text;
+};
+
+namespace SubtitleTimeline {
+// 统一毫秒分隔符为逗号（00:00:01.000 -> 00:00:01,000）。
+QString normalizeToken(const QString &timelineToken);
+// 解析 HH:MM:SS,mmm；格式无效时返回 -1。
+qint64 toMs(const QString &timelineToken);
+// 毫秒转 HH:MM:SS,mmm（负值按 0 处理）。
+QString fromMs(qint64 ms);
+}
+
+namespace SubtitleSrt {
+// SRT 块（序号可省略，毫秒分隔符兼容逗号与点）：捕获 1 序号、2 开始、3 结束、4 文本。
+const QRegularExpression &blockRegex();
+// 解析 SRT 文本；时间轴无效或文本为空的块跳过。
+QVector<SubtitleEntry> parse(const QString &srtText);
+}
+
+#endif // SUBTITLEENTRY_H
@@ -1,9 +1,12 @@
 #include "subtitletranslation.h"
 #include "ui_subtitletranslation.h"
 
+#include "llmbatchclient.h"
 #include "llmserviceclient.h"
+#include "outputpanelmodel.h"
 #include "promptrequestcomposer.h"
 #include "promptediting.h"
+#include "segmentwirecodec.h"
 
 #include <QDateTime>
 #include <QDir>
@@ -21,11 +24,10 @@
 #include <QScrollBar>
 #include <QSettings>
 #include <QTextStream>
+#include <QAction>
 #include <QClipboard>
 #include <QTimer>
 
-#include <algorithm>
-
 #ifdef Q_OS_WIN
 #include <windows.h>
 #include <wincrypt.h>
@@ -67,13 +69,6 @@ QString finalOutputDirectory()
     return QDir::currentPath() + "/output/translator_final";
 }
 
-QRegularExpression srtBlockRegex()
-{
-    static const QRegularExpression regex(
-        QStringLiteral("(?ms)(?:\\s*(\\d+)\\s*\\n)?\\s*(\\d{2}:\\d{2}:\\d{2}[,\\.]\\d{3})\\s*-->\\s*(\\d{2}:\\d{2}:\\d{2}[,\\.]\\d{3})\\s*\\n(.*?)(?=\\n{2,}(?:\\d+\\s*\\n)?\\s*\\d{2}:\\d{2}:\\d{2}[,\\.]\\d{3}\\s*-->|\\z)"));
-    return regex;
-}
-
 QString encryptSecret(const QString &plainText)
 {
     if (plainText.isEmpty()) {
@@ -178,6 +173,7 @@ SubtitleTranslation::SubtitleTranslation(QWidget *parent) :
     connect(ui->stopTaskButton, &QPushButton::clicked, this, &SubtitleTranslation::onStopTaskClicked);
     connect(ui->retryActionButton, &QPushButton::clicked, this, &SubtitleTranslation::onRetryActionClicked);
     connect(ui->copyResultButton, &QPushButton::clicked, this, &SubtitleTranslation::onCopyResultClicked);
+    connect(ui->exportTelemetryButton, &QPushButton::clicked, this, &SubtitleTranslation::onExportTelemetryClicked);
     connect(ui->clearOutputButton, &QPushButton::clicked, this, &SubtitleTranslation::onClearOutputClicked);
         connect(ui->presetComboBox,
             static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
@@ -206,6 +202,10 @@ SubtitleTranslation::SubtitleTranslation(QWidget *parent) :
             static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged),
             this,
             [this](int) { persistUiPreferences(); });
+        connect(ui->hedgeBudgetSpinBox,
+            static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged),
+            this,
+            [this](int) { persistUiPreferences(); });
         connect(ui->sourceLangComboBox,
             &QComboBox::currentTextChanged,
             this,
@@ -222,10 +222,42 @@ SubtitleTranslation::SubtitleTranslation(QWidget *parent) :
             &QCheckBox::toggled,
             this,
             [this](bool) { persistUiPreferences(); });
+        connect(ui->structuredOutputCheckBox,
+            &QCheckBox::toggled,
+            this,
+            [this](bool) { persistUiPreferences(); });
+        connect(ui->concurrentPipelineCheckBox,
+            &QCheckBox::toggled,
+            this,
+            [this](bool) { persistUiPreferences(); });
+        connect(ui->sentenceRegroupCheckBox,
+            &QCheckBox::toggled,
+            this,
+            [this](bool) { persistUiPreferences(); });
+        connect(ui->batchApiCheckBox,
+            &QCheckBox::toggled,
+            this,
+            [this](bool) { persistUiPreferences(); });
         connect(ui->hostLineEdit,
             &QLineEdit::textChanged,
             this,
             [this](const QString &) { persistUiPreferences(); });
+        connect(ui->polishModelLineEdit,
+            &QLineEdit::textChanged,
+            this,
+            [this](const QString &) { persistUiPreferences(); });
+        connect(ui->polishHostLineEdit,
+            &QLineEdit::textChanged,
+            this,
+            [this](const QString &) { persistUiPreferences(); });
+        connect(ui->extraTargetLangLineEdit,
+            &QLineEdit::textChanged,
+            this,
+            [this](const QString &) { persistUiPreferences(); });
+        connect(ui->fastModelLineEdit,
+            &QLineEdit::textChanged,
+            this,
+            [this](const QString &) { persistUiPreferences(); });
         connect(ui->providerComboBox,
             &QComboBox::currentTextChanged,
             this,
@@ -248,14 +280,39 @@ SubtitleTranslation::SubtitleTranslation(QWidget *parent) :
     connect(m_llmClient, &LlmServiceClient::chatCompleted, this, &SubtitleTranslation::onChatCompleted);
     connect(m_llmClient, &LlmServiceClient::streamChunkReceived, this, &SubtitleTranslation::onStreamChunkReceived);
     connect(m_llmClient, &LlmServiceClient::requestFailed, this, &SubtitleTranslation::onRequestFailed);
+    connect(m_llmClient, &LlmServiceClient::chatMetricsMeasured, this, &SubtitleTranslation::onChatMetricsMeasured);
+    connect(m_llmClient, &LlmServiceClient::chatFailureMeasured, this, &SubtitleTranslation::onChatFailureMeasured);
+    connect(m_llmClient, &LlmServiceClient::requestRestarted, this, &SubtitleTranslation::onRequestRestarted);
     connect(m_llmClient, &LlmServiceClient::busyChanged, this, &SubtitleTranslation::onBusyChanged);
 
+    m_polishLlmClient = new LlmServiceClient(this);
+    connect(m_polishLlmClient, &LlmServiceClient::chatMetricsMeasured, this, &SubtitleTranslation::onChatMetricsMeasured);
+    connect(m_polishLlmClient, &LlmServiceClient::chatFailureMeasured, this, &SubtitleTranslation::onChatFailureMeasured);
+
+    m_taskRunner = new TranslationTaskRunner(m_llmClient, this);
+    m_taskRunner->setPolishClient(m_polishLlmClient);
+    m_batchClient = new LlmBatchClient(this);
+    m_taskRunner->setBatchClient(m_batchClient);
+    connect(m_taskRunner, &TranslationTaskRunner::taskLog, this, &SubtitleTranslation::appendOutputMessage);
+    connect(m_taskRunner, &TranslationTaskRunner::chunkCommitted, this, &SubtitleTranslation::onConcurrentChunkCommitted);
+    connect(m_taskRunner, &TranslationTaskRunner::progressChanged, this, &SubtitleTranslation::onConcurrentProgressChanged);
+    connect(m_taskRunner, &TranslationTaskRunner::taskFinished, this, &SubtitleTranslation::onConcurrentTaskFinished);
+
     m_streamPreviewTimer = new QTimer(this);
     m_streamPreviewTimer->setSingleShot(true);
     m_streamPreviewTimer->setInterval(120);
     connect(m_streamPreviewTimer, &QTimer::timeout, this, &SubtitleTranslation::flushPendingStreamPreview);
 
-    if (QScrollBar *outputScrollBar = ui->outputTextEdit->verticalScrollBar()) {
+    m_outputModel = new OutputPanelModel(this);
+    ui->outputListView->setModel(m_outputModel);
+    QAction *copyRowsAction = new QAction(tr("复制选中行"), ui->outputListView);
+    copyRowsAction->setShortcut(QKeySequence::Copy);
+    copyRowsAction->setShortcutContext(Qt::WidgetShortcut);
+    connect(copyRowsAction, &QAction::triggered, this, &SubtitleTranslation::copySelectedOutputRows);
+    ui->outputListView->addAction(copyRowsAction);
+    ui->outputListView->setContextMenuPolicy(Qt::ActionsContextMenu);
+
+    if (QScrollBar *outputScrollBar = ui->outputListView->verticalScrollBar()) {
         connect(outputScrollBar, &QScrollBar::sliderPressed, this, [this]() {
             m_outputAutoFollow = false;
         });
@@ -265,9 +322,6 @@ SubtitleTranslation::SubtitleTranslation(QWidget *parent) :
             m_outputAutoFollow = (maximum - value) <= 2;
         });
         connect(outputScrollBar, &QScrollBar::valueChanged, this, [this, outputScrollBar](int value) {
-            if (m_restoringOutputScroll) {
-                return;
-            }
             const int maximum = outputScrollBar->maximum();
             m_outputAutoFollow = (maximum - value) <= 2;
         });
@@ -295,6 +349,87 @@ void SubtitleTranslation::setPendingSubtitleFile(const QString &subtitlePath)
     persistUiPreferences();
     ui->progressStatusLabel->setText(tr("已载入待翻译文件"));
     appendOutputMessage(tr("已接收待翻译文件：%1").arg(normalizedPath));
+    announceRecoverableSession(normalizedPath);
+}
+
+bool SubtitleTranslation::beginStreamingSource(const QString &subtitlePath)
+{
+    if (m_taskRunner->isRunning() || m_flowState.hasRunningOrPendingTask()) {
+        appendOutputMessage(tr("已有翻译任务进行中，本次识别结果不自动翻译"));
+        return false;
+    }
+
+    const QString normalizedPath = QFileInfo(subtitlePath).absoluteFilePath();
+    ui->srtPathLineEdit->setText(normalizedPath);
+    if (!refreshActiveRequestContextFromUi()) {
+        appendOutputMessage(tr("服务地址或模型未配置，本次识别结果不自动翻译"));
+        return false;
+    }
+    // 流式任务总是由并发执行器执行，润色作为独立的第二阶段。
+    m_activeComposeInput.reviewPolish = false;
+    refreshActivePromptPrefix();
+
+    resetTranslationSessionState();
+    m_streamingSource = true;
+    m_llmClient->prewarmConnections(m_activeConfig);
+    m_telemetry.reset();
+    m_outputModel->clear();
+    m_outputPreviewText.clear();
+    m_outputAutoFollow = true;
+    m_extraLanguages = extraTargetLanguages();
+    m_extraDocuments = QVector<TranslationDocumentStore>(m_extraLanguages.size());
+    appendOutputMessage(tr("边识别边翻译：%1").arg(normalizedPath));
+    if (ui->sentenceRegroupCheckBox->isChecked()) {
+        appendOutputMessage(tr("源条目逐段到达，本次不合并碎句"));
+    }
+    appendOutputMessage(tr("源条目逐段到达，本次不写会话日志"));
+
+    startConcurrentTranslation();
+    return m_taskRunner->isRunning();
+}
+
+void SubtitleTranslation::appendStreamingSource(const QString &srtFragment)
+{
+    if (!m_streamingSource || !m_taskRunner->isRunning()) {
+        return;
+    }
+
+    QVector<SubtitleEntry> entries = SubtitleSrt::parse(srtFragment);
+    if (entries.isEmpty()) {
+        return;
+    }
+    for (SubtitleEntry &entry : entries) {
+        const int position = m_sourceEntries.size();
+        entry.index = position + 1;
+        m_sourceEntries.append(entry);
+        m_runtimeEntries.append(entry);
+        m_runtimePositions.append(position);
+    }
+    m_translatedDocument.grow(m_sourceEntries.size());
+    for (TranslationDocumentStore &document : m_extraDocuments) {
+        document.grow(m_sourceEntries.size());
+    }
+    m_telemetry.setEntryCount(m_sourceEntries.size() * (1 + m_extraLanguages.size()));
+    m_taskRunner->appendEntries(entries);
+}
+
+void SubtitleTranslation::finishStreamingSource(bool success)
+{
+    if (!m_streamingSource) {
+        return;
+    }
+
+    m_streamingSource = false;
+    if (!m_taskRunner->isRunning()) {
+        return;
+    }
+    if (!success) {
+        appendOutputMessage(tr("识别未完成，流式翻译随之中止"));
+        m_taskRunner->cancelTask();
+        return;
+    }
+    appendOutputMessage(tr("识别完成：共 %1 条，等待剩余分块翻译").arg(m_sourceEntries.size()));
+    m_taskRunner->closeInput();
 }
 
 void SubtitleTranslation::initializePresetStorage()
@@ -493,6 +628,7 @@ LlmServiceConfig SubtitleTranslation::collectServiceConfig()
     config.model = ui->modelComboBox->currentText().trimmed();
     config.stream = ui->streamingCheckBox->isChecked();
     config.timeoutMs = 0;
+    config.hedgeBudgetPercent = ui->hedgeBudgetSpinBox->value();
 
     updateSecretInputState();
     return config;
@@ -604,9 +740,18 @@ void SubtitleTranslation::loadUiPreferences()
     ui->temperatureSpinBox->setValue(settings.value(uiSettingKey(QStringLiteral("temperature")), ui->temperatureSpinBox->value()).toDouble());
     ui->maxTokensSpinBox->setValue(settings.value(uiSettingKey(QStringLiteral("max_tokens")), ui->maxTokensSpinBox->value()).toInt());
     ui->segmentSizeSpinBox->setValue(settings.value(uiSettingKey(QStringLiteral("segment_size")), ui->segmentSizeSpinBox->value()).toInt());
+    ui->hedgeBudgetSpinBox->setValue(settings.value(uiSettingKey(QStringLiteral("hedge_budget_percent")), ui->hedgeBudgetSpinBox->value()).toInt());
     ui->keepTimelineCheckBox->setChecked(settings.value(uiSettingKey(QStringLiteral("keep_timeline")), ui->keepTimelineCheckBox->isChecked()).toBool());
     ui->reviewCheckBox->setChecked(settings.value(uiSettingKey(QStringLiteral("review_polish")), ui->reviewCheckBox->isChecked()).toBool());
     ui->streamingCheckBox->setChecked(settings.value(uiSettingKey(QStringLiteral("streaming")), ui->streamingCheckBox->isChecked()).toBool());
+    ui->structuredOutputCheckBox->setChecked(settings.value(uiSettingKey(QStringLiteral("structured_output")), ui->structuredOutputCheckBox->isChecked()).toBool());
+    ui->sentenceRegroupCheckBox->setChecked(settings.value(uiSettingKey(QStringLiteral("sentence_regroup")), ui->sentenceRegroupCheckBox->isChecked()).toBool());
+    ui->concurrentPipelineCheckBox->setChecked(settings.value(uiSettingKey(QStringLiteral("concurrent_pipeline")), ui->concurrentPipelineCheckBox->isChecked()).toBool());
+    ui->batchApiCheckBox->setChecked(settings.value(uiSettingKey(QStringLiteral("batch_api")), ui->batchApiCheckBox->isChecked()).toBool());
+    ui->polishModelLineEdit->setText(settings.value(uiSettingKey(QStringLiteral("polish_model"))).toString().trimmed());
+    ui->polishHostLineEdit->setText(settings.value(uiSettingKey(QStringLiteral("polish_host"))).toString().trimmed());
+    ui->extraTargetLangLineEdit->setText(settings.value(uiSettingKey(QStringLiteral("extra_target_languages"))).toString().trimmed());
+    ui->fastModelLineEdit->setText(settings.value(uiSettingKey(QStringLiteral("fast_model"))).toString().trimmed());
 
     const QString srtPath = settings.value(uiSettingKey(QStringLiteral("srt_path"))).toString().trimmed();
     if (!srtPath.isEmpty()) {
@@ -637,20 +782,30 @@ void SubtitleTranslation::persistUiPreferences()
     settings.setValue(uiSettingKey(QStringLiteral("temperature")), ui->temperatureSpinBox->value());
     settings.setValue(uiSettingKey(QStringLiteral("max_tokens")), ui->maxTokensSpinBox->value());
     settings.setValue(uiSettingKey(QStringLiteral("segment_size")), ui->segmentSizeSpinBox->value());
+    settings.setValue(uiSettingKey(QStringLiteral("hedge_budget_percent")), ui->hedgeBudgetSpinBox->value());
     settings.setValue(uiSettingKey(QStringLiteral("keep_timeline")), ui->keepTimelineCheckBox->isChecked());
     settings.setValue(uiSettingKey(QStringLiteral("review_polish")), ui->reviewCheckBox->isChecked());
     settings.setValue(uiSettingKey(QStringLiteral("streaming")), ui->streamingCheckBox->isChecked());
+    settings.setValue(uiSettingKey(QStringLiteral("structured_output")), ui->structuredOutputCheckBox->isChecked());
+    settings.setValue(uiSettingKey(QStringLiteral("sentence_regroup")), ui->sentenceRegroupCheckBox->isChecked());
+    settings.setValue(uiSettingKey(QStringLiteral("concurrent_pipeline")), ui->concurrentPipelineCheckBox->isChecked());
+    settings.setValue(uiSettingKey(QStringLiteral("batch_api")), ui->batchApiCheckBox->isChecked());
+    settings.setValue(uiSettingKey(QStringLiteral("polish_model")), ui->polishModelLineEdit->text().trimmed());
+    settings.setValue(uiSettingKey(QStringLiteral("polish_host")), ui->polishHostLineEdit->text().trimmed());
+    settings.setValue(uiSettingKey(QStringLiteral("extra_target_languages")), ui->extraTargetLangLineEdit->text().trimmed());
+    settings.setValue(uiSettingKey(QStringLiteral("fast_model")), ui->fastModelLineEdit->text().trimmed());
     settings.setValue(uiSettingKey(QStringLiteral("srt_path")), ui->srtPathLineEdit->text().trimmed());
     settings.setValue(uiSettingKey(QStringLiteral("preset_path")), selectedPresetPath());
     settings.sync();
 }
 
-QString SubtitleTranslation::buildAutoInstructionText() const
+QString SubtitleTranslation::buildAutoInstructionText(const QString &targetLanguage) const
 {
     QString instruction = ui->instructionTextEdit->toPlainText().trimmed();
     if (instruction.isEmpty()) {
         instruction = tr("这是一个影视字幕任务，请翻译成%1，注意术语统一、语气自然，并遵循预设规则。")
-                          .arg(ui->targetLangComboBox->currentText().trimmed());
+                          .arg(targetLanguage.isEmpty() ? ui->targetLangComboBox->currentText().trimmed()
+                                                        : targetLanguage);
     }
     return instruction;
 }
@@ -705,39 +860,46 @@ QString SubtitleTranslation::resolveSecretForRequest(const QString &storageKey,
 
 void SubtitleTranslation::appendOutputMessage(const QString &message)
 {
-    const QString timestamp = QDateTime::currentDateTime().toString("HH:mm:ss");
-    m_outputLogLines.append(QStringLiteral("[%1] %2").arg(timestamp, message));
-    if (m_outputLogLines.size() > 500) {
-        m_outputLogLines.removeFirst();
-    }
-    renderOutputPanel();
+    m_outputModel->appendLogLine(message);
+    followOutputIfNeeded();
 }
 
 void SubtitleTranslation::renderOutputPanel()
 {
-    QScrollBar *scrollBar = ui->outputTextEdit->verticalScrollBar();
-    const int oldValue = scrollBar ? scrollBar->value() : 0;
-    const bool followToBottom = m_outputAutoFollow;
+    m_outputModel->setPreviewText(m_outputPreviewText);
+    followOutputIfNeeded();
+}
 
-    QStringList blocks;
-    blocks << QStringLiteral("【输出预览】");
-    blocks << (m_outputPreviewText.trimmed().isEmpty() ? tr("(暂无预览内容)") : m_outputPreviewText.trimmed());
-    blocks << QString();
-    blocks << QStringLiteral("【日志】");
-    if (m_outputLogLines.isEmpty()) {
-        blocks << tr("(暂无日志)");
-    } else {
-        blocks << m_outputLogLines;
+void SubtitleTranslation::appendOutputPreview(const QString &text)
+{
+    if (text.trimmed().isEmpty()) {
+        return;
+    }
+    if (!m_outputPreviewText.isEmpty()) {
+        m_outputPreviewText += QStringLiteral("\n\n");
     }
+    m_outputPreviewText += text;
+    m_outputModel->appendPreviewText(text);
+    followOutputIfNeeded();
+}
 
-    m_restoringOutputScroll = true;
-    ui->outputTextEdit->setPlainText(blocks.join('\n'));
+void SubtitleTranslation::followOutputIfNeeded()
+{
+    // 未跟随时视图停在原处：未变化的行不重排，滚动位置无需保存与恢复。
+    if (m_outputAutoFollow) {
+        ui->outputListView->scrollToBottom();
+    }
+}
 
-    if (scrollBar) {
-        const int target = followToBottom ? scrollBar->maximum() : qMin(oldValue, scrollBar->maximum());
-        scrollBar->setValue(qBound(0, target, scrollBar->maximum()));
+void SubtitleTranslation::copySelectedOutputRows()
+{
+    const QModelIndexList selected = ui->outputListView->selectionModel()->selectedIndexes();
+    if (selected.isEmpty()) {
+        return;
+    }
+    if (QClipboard *clipboard = QGuiApplication::clipboard()) {
+        clipboard->setText(m_outputModel->textForRows(selected));
     }
-    m_restoringOutputScroll = false;
 }
 
 void SubtitleTranslation::importSrtFile()
@@ -751,6 +913,7 @@ void SubtitleTranslation::importSrtFile()
     }
     ui->srtPathLineEdit->setText(path);
     persistUiPreferences();
+    announceRecoverableSession(path);
 }
 
 void SubtitleTranslation::refreshRemoteModels()
@@ -774,67 +937,22 @@ void SubtitleTranslation::sendCommunicationProbe()
 
 QString SubtitleTranslation::normalizeTimelineToken(const QString &timelineToken) const
 {
-    QString value = timelineToken.trimmed();
-    value.replace('.', ',');
-    return value;
+    return SubtitleTimeline::normalizeToken(timelineToken);
 }
 
 qint64 SubtitleTranslation::timelineToMs(const QString &timelineToken) const
 {
-    const QString normalized = normalizeTimelineToken(timelineToken);
-    const QRegularExpression tokenRegex(QStringLiteral(R"((\d{2}):(\d{2}):(\d{2}),(\d{3}))"));
-    const QRegularExpressionMatch match = tokenRegex.match(normalized);
-    if (!match.hasMatch()) {
-        return -1;
-    }
-
-    const int hours = match.captured(1).toInt();
-    const int minutes = match.captured(2).toInt();
-    const int seconds = match.captured(3).toInt();
-    const int millis = match.captured(4).toInt();
-    return (((hours * 60LL + minutes) * 60LL) + seconds) * 1000LL + millis;
+    return SubtitleTimeline::toMs(timelineToken);
 }
 
 QString SubtitleTranslation::msToTimeline(qint64 ms) const
 {
-    if (ms < 0) {
-        ms = 0;
-    }
-
-    const qint64 hours = ms / 3600000;
-    ms %= 3600000;
-    const qint64 minutes = ms / 60000;
-    ms %= 60000;
-    const qint64 seconds = ms / 1000;
-    ms %= 1000;
-
-    return QStringLiteral("%1:%2:%3,%4")
-        .arg(hours, 2, 10, QChar('0'))
-        .arg(minutes, 2, 10, QChar('0'))
-        .arg(seconds, 2, 10, QChar('0'))
-        .arg(ms, 3, 10, QChar('0'));
+    return SubtitleTimeline::fromMs(ms);
 }
 
 QVector<SubtitleTranslation::SubtitleEntry> SubtitleTranslation::parseSrtEntries(const QString &srtText) const
 {
-    QVector<SubtitleEntry> entries;
-    QRegularExpressionMatchIterator iterator = srtBlockRegex().globalMatch(srtText);
-    while (iterator.hasNext()) {
-        const QRegularExpressionMatch match = iterator.next();
-        SubtitleEntry entry;
-        entry.index = match.captured(1).trimmed().toInt();
-        entry.startText = normalizeTimelineToken(match.captured(2));
-        entry.endText = normalizeTimelineToken(match.captured(3));
-        entry.startMs = timelineToMs(entry.startText);
-        entry.endMs = timelineToMs(entry.endText);
-        entry.text = match.captured(4).trimmed();
-
-        if (entry.startMs < 0 || entry.endMs < 0 || entry.text.isEmpty()) {
-            continue;
-        }
-        entries.append(entry);
-    }
-    return entries;
+    return SubtitleSrt::parse(srtText);
 }
 
 QString SubtitleTranslation::serializeSrtEntries(const QVector<SubtitleEntry> &entries, bool reindex) const
@@ -870,7 +988,7 @@ QString SubtitleTranslation::cleanSrtPreviewText(const QString &rawText) const
     }
 
     QStringList blocks;
-    QRegularExpressionMatchIterator strictIterator = srtBlockRegex().globalMatch(candidate);
+    QRegularExpressionMatchIterator strictIterator = SubtitleSrt::blockRegex().globalMatch(candidate);
     while (strictIterator.hasNext()) {
         blocks.append(strictIterator.next().captured(0).trimmed());
     }
@@ -895,17 +1013,30 @@ void SubtitleTranslation::resetTranslationSessionState()
 {
     m_sourceEntries.clear();
     m_runtimeEntries.clear();
-    m_translatedByStartMs.clear();
+    m_runtimePositions.clear();
+    m_runtimeReferenceLines.clear();
+    m_translatedDocument.reset(0);
+    m_originalCues.clear();
+    m_sentenceUnits.clear();
+    m_extraLanguages.clear();
+    m_extraDocuments.clear();
+    m_concurrentChunkSize = 0;
+    m_streamingSource = false;
+    m_sessionJournal.close();
     m_flowState.reset();
     m_currentSegmentRawResponse.clear();
     m_currentSegmentCleanPreview.clear();
-    m_lastFinalMergedSrt.clear();
     m_exportTargetPath.clear();
     m_retryMode = RetryMode::None;
     if (ui && ui->retryActionButton) {
         setRetryButtonState(RetryMode::None, false);
     }
-    m_pendingStreamRawContent.clear();
+    m_streamCueParser.reset();
+    m_streamPreviewDirty = false;
+    m_streamPreviewShownLength = 0;
+    m_segmentTranslationsById.clear();
+    m_segmentRepairAttempts = 0;
+    m_segmentRepairInFlight = false;
     if (m_streamPreviewTimer) {
         m_streamPreviewTimer->stop();
     }
@@ -939,6 +1070,8 @@ bool SubtitleTranslation::refreshActiveRequestContextFromUi()
     m_activeConfig = config;
     m_activeOptions = options;
     m_activeComposeInput = composeInput;
+    m_activeStructuredOutput = ui->structuredOutputCheckBox->isChecked();
+    refreshActivePromptPrefix();
     return true;
 }
 
@@ -991,7 +1124,8 @@ void SubtitleTranslation::startSegmentedTranslation()
         return;
     }
 
-    const QString srtContent = QString::fromUtf8(srtFile.readAll());
+    const QByteArray srtBytes = srtFile.readAll();
+    const QString srtContent = QString::fromUtf8(srtBytes);
     const QFileInfo subtitleInfo(srtPath);
     const QString suffix = subtitleInfo.suffix().toLower();
 
@@ -1097,7 +1231,8 @@ void SubtitleTranslation::startSegmentedTranslation()
     composeInput.sourceLanguage = ui->sourceLangComboBox->currentText().trimmed();
     composeInput.targetLanguage = ui->targetLangComboBox->currentText().trimmed();
     composeInput.keepTimeline = ui->keepTimelineCheckBox->isChecked();
-    composeInput.reviewPolish = ui->reviewCheckBox->isChecked();
+    // 并发模式下润色作为独立的第二阶段执行，翻译阶段的指令不再要求校对润色。
+    composeInput.reviewPolish = ui->reviewCheckBox->isChecked() && !usesTaskRunner();
     composeInput.srtPath = srtPath;
     if (!presetObject.isEmpty()) {
         composeInput.presetJson = QString::fromUtf8(QJsonDocument(presetObject).toJson(QJsonDocument::Indented));
@@ -1109,24 +1244,142 @@ void SubtitleTranslation::startSegmentedTranslation()
 
     resetTranslationSessionState();
     m_sourceEntries = sourceEntries;
-    m_runtimeEntries = sourceEntries;
+    if (ui->sentenceRegroupCheckBox->isChecked()) {
+        m_originalCues = sourceEntries;
+        m_sourceEntries = SentenceRegrouper::group(sourceEntries, SentenceRegrouper::Options(), &m_sentenceUnits);
+        if (m_sourceEntries.size() == m_originalCues.size()) {
+            m_originalCues.clear();
+            m_sentenceUnits.clear();
+        }
+    }
+    m_runtimeEntries = m_sourceEntries;
+    m_runtimePositions.reserve(m_runtimeEntries.size());
+    for (int i = 0; i < m_runtimeEntries.size(); ++i) {
+        m_runtimePositions.append(i);
+    }
+    m_translatedDocument.reset(m_sourceEntries.size());
     m_activeConfig = config;
     m_activeOptions = options;
     m_activeComposeInput = composeInput;
-    m_flowState.begin(m_runtimeEntries.size());
-    m_outputLogLines.clear();
+    m_activeStructuredOutput = ui->structuredOutputCheckBox->isChecked();
+    refreshActivePromptPrefix();
+    m_llmClient->prewarmConnections(m_activeConfig);
+    m_telemetry.reset();
+    m_telemetry.setEntryCount(originalCueCount());
+    m_outputModel->clear();
     m_outputPreviewText.clear();
     m_outputAutoFollow = true;
     appendOutputMessage(tr("已解析字幕 %1 条，准备按每次 %2 条进行动态分段翻译")
                         .arg(m_sourceEntries.size())
                         .arg(qMax(1, ui->segmentSizeSpinBox->value())));
+    if (!m_sentenceUnits.isEmpty()) {
+        appendOutputMessage(tr("已按标点与停顿将 %1 条字幕合并为 %2 个句子单元翻译，导出时按原时间轴切回")
+                            .arg(m_originalCues.size())
+                            .arg(m_sourceEntries.size()));
+    }
     if (syntheticTimelineUsed) {
         appendOutputMessage(tr("当前文件为纯文本，已按行自动生成时间轴用于翻译流程。"));
     }
 
+    const bool concurrent = usesTaskRunner();
+    m_extraLanguages = concurrent ? extraTargetLanguages() : QStringList();
+    m_extraDocuments = QVector<TranslationDocumentStore>(m_extraLanguages.size());
+    for (TranslationDocumentStore &document : m_extraDocuments) {
+        document.reset(m_sourceEntries.size());
+    }
+
+    openSessionJournal(TranslationSessionJournal::hashSource(srtBytes), srtPath);
+    if (m_runtimeEntries.isEmpty()) {
+        appendOutputMessage(tr("会话日志中的译文已覆盖全部条目，直接导出"));
+        exportFinalMergedSrt();
+        exportExtraLanguageFiles();
+        return;
+    }
+
+    if (concurrent) {
+        startConcurrentTranslation();
+        return;
+    }
+
+    m_flowState.begin(m_runtimeEntries.size());
     sendCurrentSegmentRequest();
 }
 
+void SubtitleTranslation::startConcurrentTranslation()
+{
+    TranslationTaskRequest request;
+    request.entries = m_runtimeEntries;
+    request.referenceLines = m_runtimeReferenceLines;
+    request.config = m_activeConfig;
+    request.options = m_activeOptions;
+    request.systemPrompt = m_activeSystemPrompt;
+    m_telemetry.setEntryCount(originalCueCount() * (1 + m_extraLanguages.size()));
+    request.responseSchema = m_activeResponseSchema;
+    request.responseFormat = activeResponseFormat();
+    request.chunkSize = qMax(1, ui->segmentSizeSpinBox->value());
+    m_concurrentChunkSize = request.chunkSize;
+    request.maxInFlight = m_activeConfig.suggestedConcurrency();
+    request.fastModel = ui->fastModelLineEdit->text().trimmed();
+    request.batchApi = ui->batchApiCheckBox->isChecked();
+    request.openInput = m_streamingSource;
+
+    if (ui->reviewCheckBox->isChecked()) {
+        LlmServiceConfig polishConfig = m_activeConfig;
+        const QString polishModel = ui->polishModelLineEdit->text().trimmed();
+        const QString polishHost = ui->polishHostLineEdit->text().trimmed();
+        if (!polishModel.isEmpty()) {
+            polishConfig.model = polishModel;
+        }
+        if (!polishHost.isEmpty()) {
+            polishConfig.baseUrl = polishHost;
+        }
+
+        request.polishEnabled = true;
+        request.polishConfig = polishConfig;
+        request.polishOptions = m_activeOptions;
+        request.polishFormat = activeResponseFormat() == StreamingCueParser::InputFormat::JsonItems
+                                   ? StreamingCueParser::InputFormat::JsonItems
+                                   : StreamingCueParser::InputFormat::CompactLines;
+        request.polishSystemPrompt = PromptRequestComposer::buildPolishInstruction(m_activeComposeInput)
+                                     + QStringLiteral("\n\n")
+                                     + responseFormatInstruction(request.polishFormat, &request.polishResponseSchema);
+        request.polishMaxInFlight = polishConfig.suggestedConcurrency();
+        m_polishLlmClient->prewarmConnections(polishConfig);
+    }
+
+    if (!m_extraLanguages.isEmpty()) {
+        // 各语言共用解析结果与分块划分，只按目标语言重建静态前缀。
+        QStringList languages;
+        languages << m_activeComposeInput.targetLanguage << m_extraLanguages;
+        for (const QString &language : languages) {
+            PromptComposeInput composeInput = m_activeComposeInput;
+            composeInput.targetLanguage = language;
+            composeInput.naturalInstruction = buildAutoInstructionText(language);
+            TranslationTargetLanguage target;
+            target.language = language;
+            if (language == m_activeComposeInput.targetLanguage) {
+                target.systemPrompt = m_activeSystemPrompt;
+            } else {
+                target.systemPrompt = PromptRequestComposer::buildFinalInstruction(composeInput)
+                                      + QStringLiteral("\n\n")
+                                      + responseFormatInstruction(request.responseFormat, nullptr);
+            }
+            if (request.polishEnabled) {
+                target.polishSystemPrompt = PromptRequestComposer::buildPolishInstruction(composeInput)
+                                            + QStringLiteral("\n\n")
+                                            + responseFormatInstruction(request.polishFormat, nullptr);
+            }
+            request.languages.append(target);
+        }
+    }
+
+    ui->translateProgressBar->setRange(0, 100);
+    ui->translateProgressBar->setValue(0);
+    ui->progressStatusLabel->setText(request.batchApi ? tr("批任务处理中...") : tr("并发翻译中..."));
+    m_taskRunner->startTask(request);
+    onBusyChanged(m_taskRunner->isRunning());
+}
+
 QVector<SubtitleTranslation::SubtitleEntry> SubtitleTranslation::currentSegmentSourceEntries() const
 {
     const int startIndex = m_flowState.lastRequestStartIndex();
@@ -1145,9 +1398,73 @@ QVector<SubtitleTranslation::SubtitleEntry> SubtitleTranslation::currentSegmentS
     return result;
 }
 
-QString SubtitleTranslation::buildSegmentPromptSrt(const QVector<SubtitleEntry> &entries) const
+StreamingCueParser::InputFormat SubtitleTranslation::activeResponseFormat() const
 {
-    return serializeSrtEntries(entries, false);
+    if (!m_activeComposeInput.keepTimeline) {
+        return StreamingCueParser::InputFormat::SrtBlocks;
+    }
+    return m_activeStructuredOutput ? StreamingCueParser::InputFormat::JsonItems
+                                    : StreamingCueParser::InputFormat::CompactLines;
+}
+
+QString SubtitleTranslation::buildSegmentPromptText(int startIndex, const QVector<SubtitleEntry> &entries) const
+{
+    if (activeResponseFormat() == StreamingCueParser::InputFormat::SrtBlocks) {
+        return serializeSrtEntries(entries, false);
+    }
+
+    QStringList lines;
+    lines.reserve(entries.size());
+    for (int i = 0; i < entries.size(); ++i) {
+        lines.append(SegmentWireCodec::encodeLine(startIndex + i + 1, entries.at(i).text));
+    }
+    return lines.join('\n');
+}
+
+QString SubtitleTranslation::responseFormatInstruction(StreamingCueParser::InputFormat format,
+                                                       QJsonObject *responseSchema) const
+{
+    switch (format) {
+    case StreamingCueParser::InputFormat::JsonItems:
+        if (responseSchema) {
+            *responseSchema = SegmentWireCodec::responseSchema();
+        }
+        return SegmentWireCodec::structuredOutputInstruction();
+    case StreamingCueParser::InputFormat::CompactLines:
+        return SegmentWireCodec::outputInstruction();
+    default:
+        break;
+    }
+    return QStringLiteral("请严格输出 SRT 格式，仅返回字幕条目，不要额外解释。"
+                          "\n若某条是噪声可省略，但保留其余条目的原时间戳。");
+}
+
+void SubtitleTranslation::refreshActivePromptPrefix()
+{
+    // 任务期间只构造一次，保证每段请求的前缀逐字节一致，便于服务端前缀缓存与本地 KV 复用。
+    m_activeResponseSchema = QJsonObject();
+    m_activeSystemPrompt = PromptRequestComposer::buildFinalInstruction(m_activeComposeInput)
+                           + QStringLiteral("\n\n")
+                           + responseFormatInstruction(activeResponseFormat(), &m_activeResponseSchema);
+    m_firstTokenTotalMs = 0;
+    m_firstTokenSamples = 0;
+}
+
+QHash<int, StreamingCueParser::CueTiming> SubtitleTranslation::buildKeyedTimeline(const QVector<int> &ids) const
+{
+    QHash<int, StreamingCueParser::CueTiming> timelineById;
+    timelineById.reserve(ids.size());
+    for (int id : ids) {
+        if (id <= 0 || id > m_runtimeEntries.size()) {
+            continue;
+        }
+        const SubtitleEntry &entry = m_runtimeEntries.at(id - 1);
+        StreamingCueParser::CueTiming timing;
+        timing.startText = entry.startText.isEmpty() ? msToTimeline(entry.startMs) : entry.startText;
+        timing.endText = entry.endText.isEmpty() ? msToTimeline(entry.endMs) : entry.endText;
+        timelineById.insert(id, timing);
+    }
+    return timelineById;
 }
 
 void SubtitleTranslation::sendCurrentSegmentRequest()
@@ -1162,37 +1479,41 @@ void SubtitleTranslation::sendCurrentSegmentRequest()
     if (segmentEntries.isEmpty()) {
         return;
     }
-    const QString segmentSrt = buildSegmentPromptSrt(segmentEntries);
-
-    QJsonArray messages;
-    QJsonObject instructionMessage;
-    instructionMessage.insert("role", "user");
-    instructionMessage.insert("content",
-                              PromptRequestComposer::buildFinalInstruction(m_activeComposeInput)
-                                  + "\n\n请严格输出 SRT 格式，仅返回字幕条目，不要额外解释。"
-                                  + "\n若某条是噪声可省略，但保留其余条目的原时间戳。");
-    messages.append(instructionMessage);
+    const QString segmentPayload = buildSegmentPromptText(requestInfo.startIndex, segmentEntries);
+    const StreamingCueParser::InputFormat responseFormat = activeResponseFormat();
 
+    // 上一段上下文随请求变化，与本段条目一起放在静态前缀之后。
+    QString variableContent;
     if (!m_flowState.previousSegmentContext().trimmed().isEmpty()) {
-        QJsonObject contextMessage;
-        contextMessage.insert("role", "user");
-        contextMessage.insert("content",
-                              tr("【上一段译文（仅用于保持文风一致，不要重复输出）】\n%1")
-                                  .arg(m_flowState.previousSegmentContext()));
-        messages.append(contextMessage);
-    }
-
-    QJsonObject segmentMessage;
-    segmentMessage.insert("role", "user");
-    segmentMessage.insert("content",
-                          tr("【待翻译分段 %1/%2】\n%3")
-                              .arg(requestInfo.segmentIndex + 1)
-                              .arg(requestInfo.estimatedTotalSegments)
-                              .arg(segmentSrt));
-    messages.append(segmentMessage);
+        variableContent = tr("【上一段译文（仅用于保持文风一致，不要重复输出）】\n%1\n\n")
+                              .arg(m_flowState.previousSegmentContext());
+    }
+    variableContent += PromptRequestComposer::buildReferenceContextBlock(
+        referenceLinesForRange(requestInfo.startIndex, segmentEntries.size()));
+    variableContent += tr("【待翻译分段 %1/%2】\n%3")
+                           .arg(requestInfo.segmentIndex + 1)
+                           .arg(requestInfo.estimatedTotalSegments)
+                           .arg(segmentPayload);
+    const QJsonArray messages = PromptRequestComposer::buildPrefixCachedMessages(m_activeSystemPrompt,
+                                                                                 variableContent);
 
     m_currentSegmentRawResponse.clear();
     m_currentSegmentCleanPreview.clear();
+    m_streamCueParser.reset();
+    m_streamPreviewDirty = false;
+    m_streamPreviewShownLength = 0;
+    m_segmentTranslationsById.clear();
+    m_segmentRepairAttempts = 0;
+    m_segmentRepairInFlight = false;
+    if (responseFormat != StreamingCueParser::InputFormat::SrtBlocks) {
+        // 紧凑/结构化格式下时间轴不经过模型，按编号从本地源条目回填。
+        QVector<int> segmentIds;
+        segmentIds.reserve(segmentEntries.size());
+        for (int i = 0; i < segmentEntries.size(); ++i) {
+            segmentIds.append(requestInfo.startIndex + i + 1);
+        }
+        m_streamCueParser.setKeyedFormat(responseFormat, buildKeyedTimeline(segmentIds));
+    }
 
     ui->progressStatusLabel->setText(tr("正在翻译第 %1/%2 段...").arg(requestInfo.segmentIndex + 1).arg(requestInfo.estimatedTotalSegments));
     const int startProgress = qRound((requestInfo.startIndex * 100.0) / qMax(1, m_runtimeEntries.size()));
@@ -1201,7 +1522,10 @@ void SubtitleTranslation::sendCurrentSegmentRequest()
     appendOutputMessage(tr("开始发送第 %1 段翻译请求（%2 条）")
                         .arg(requestInfo.segmentIndex + 1)
                         .arg(segmentEntries.size()));
-    m_llmClient->requestChatCompletion(m_activeConfig, messages, m_activeOptions);
+    m_activeChatRequestId = m_llmClient->requestChatCompletion(m_activeConfig,
+                                                               messages,
+                                                               m_activeOptions,
+                                                               m_activeResponseSchema);
 }
 
 void SubtitleTranslation::updateLivePreview(const QString &rawResponse)
@@ -1219,38 +1543,513 @@ void SubtitleTranslation::updateLivePreview(const QString &rawResponse)
 
 void SubtitleTranslation::flushPendingStreamPreview()
 {
-    if (m_pendingStreamRawContent.isEmpty()) {
+    if (!m_streamPreviewDirty) {
         return;
     }
+    m_streamPreviewDirty = false;
 
-    updateLivePreview(m_pendingStreamRawContent);
-    m_pendingStreamRawContent.clear();
+    // 已提交文本由解析器增量追加，不再对全文做正则清洗。只经常量引用读取，不与解析器共享缓冲：
+    // 否则解析器下次追加条目时会整段分离复制，每提交一条都要复制全文。
+    // 本段首次刷新整体替换预览（清掉上一段的内容），之后只把新提交的条目追加到面板末尾。
+    // 本段结束时再由 applySegmentTranslationResult() 设置 m_currentSegmentCleanPreview。
+    const QString &committed = m_streamCueParser.committedText();
+    if (m_streamPreviewShownLength <= 0 || m_streamPreviewShownLength > committed.size()) {
+        m_outputPreviewText = QString(committed.constData(), committed.size());
+        renderOutputPanel();
+    } else {
+        appendOutputPreview(committed.mid(m_streamPreviewShownLength).trimmed());
+    }
+    m_streamPreviewShownLength = committed.size();
+}
+
+QVector<SubtitleTranslation::SubtitleEntry> SubtitleTranslation::entriesFromCommittedCues() const
+{
+    QVector<SubtitleEntry> entries;
+    const QVector<StreamingCueParser::Cue> &cues = m_streamCueParser.committedCues();
+    entries.reserve(cues.size());
+    for (const StreamingCueParser::Cue &cue : cues) {
+        SubtitleEntry entry;
+        entry.index = cue.index;
+        entry.startText = cue.startText;
+        entry.endText = cue.endText;
+        entry.startMs = timelineToMs(entry.startText);
+        entry.endMs = timelineToMs(entry.endText);
+        entry.text = cue.text.trimmed();
+        if (entry.startMs < 0 || entry.endMs < 0 || entry.text.isEmpty()) {
+            continue;
+        }
+        entries.append(entry);
+    }
+    return entries;
 }
 
 void SubtitleTranslation::applySegmentTranslationResult(const QString &rawResponse)
 {
-    updateLivePreview(rawResponse);
+    // 非流式响应一次性喂给解析器；流式响应此前已按增量喂入，这里只收尾。
+    if (!m_streamCueParser.hasInput()) {
+        m_streamCueParser.feed(rawResponse);
+    }
+    m_streamCueParser.finish();
+    m_streamPreviewDirty = false;
+    m_streamPreviewShownLength = 0;
+    m_currentSegmentRawResponse = rawResponse;
 
-    const QVector<SubtitleEntry> translated = parseSrtEntries(m_currentSegmentCleanPreview);
-    const QVector<SubtitleEntry> segmentSource = currentSegmentSourceEntries();
+    const StreamingCueParser::InputFormat responseFormat = activeResponseFormat();
+    if (responseFormat != StreamingCueParser::InputFormat::SrtBlocks) {
+        for (const StreamingCueParser::Cue &cue : m_streamCueParser.committedCues()) {
+            m_segmentTranslationsById.insert(cue.index, cue.text);
+        }
 
+        if (!m_segmentTranslationsById.isEmpty()) {
+            const QVector<int> missingIds = missingSegmentIds();
+            if (!missingIds.isEmpty() && m_segmentRepairAttempts < kMaxSegmentRepairAttempts) {
+                sendSegmentRepairRequest(missingIds);
+                return;
+            }
+            completeKeyedSegment();
+            return;
+        }
+    }
+
+    // SRT 格式，或模型未按编号格式作答时，回退为按时间戳合并。
+    QVector<SubtitleEntry> translated;
+    if (responseFormat == StreamingCueParser::InputFormat::SrtBlocks) {
+        translated = entriesFromCommittedCues();
+    }
     if (!translated.isEmpty()) {
-        for (const SubtitleEntry &translatedEntry : translated) {
-            SubtitleEntry mergedEntry = translatedEntry;
-            if (mergedEntry.startText.isEmpty()) {
-                mergedEntry.startText = msToTimeline(mergedEntry.startMs);
+        m_currentSegmentCleanPreview = m_streamCueParser.committedText();
+        m_outputPreviewText = m_currentSegmentCleanPreview;
+        renderOutputPanel();
+    } else {
+        updateLivePreview(rawResponse);
+        translated = parseSrtEntries(m_currentSegmentCleanPreview);
+    }
+    if (translated.isEmpty()) {
+        translated = parseSrtEntries(rawResponse);
+    }
+    if (translated.isEmpty() && responseFormat != StreamingCueParser::InputFormat::SrtBlocks) {
+        completeKeyedSegment();
+        return;
+    }
+
+    completeCurrentSegment(translated, m_currentSegmentCleanPreview);
+}
+
+QVector<int> SubtitleTranslation::missingSegmentIds() const
+{
+    QVector<int> missingIds;
+    const int startIndex = m_flowState.lastRequestStartIndex();
+    const int count = m_flowState.lastRequestCount();
+    if (startIndex < 0 || count <= 0) {
+        return missingIds;
+    }
+
+    for (int i = 0; i < count && startIndex + i < m_runtimeEntries.size(); ++i) {
+        const int id = startIndex + i + 1;
+        if (m_segmentTranslationsById.value(id).trimmed().isEmpty()) {
+            missingIds.append(id);
+        }
+    }
+    return missingIds;
+}
+
+void SubtitleTranslation::sendSegmentRepairRequest(const QVector<int> &missingIds)
+{
+    ++m_segmentRepairAttempts;
+    m_segmentRepairInFlight = true;
+
+    QStringList lines;
+    lines.reserve(missingIds.size());
+    for (int id : missingIds) {
+        lines.append(SegmentWireCodec::encodeLine(id, m_runtimeEntries.at(id - 1).text));
+    }
+
+    const StreamingCueParser::InputFormat responseFormat = activeResponseFormat();
+    const QJsonArray messages = PromptRequestComposer::buildPrefixCachedMessages(
+        m_activeSystemPrompt,
+        tr("【补译条目】以下编号在上次返回中缺失或无效，请仅输出这些编号的译文：\n%1").arg(lines.join('\n')));
+
+    m_streamCueParser.reset();
+    m_streamCueParser.setKeyedFormat(responseFormat, buildKeyedTimeline(missingIds));
+    m_streamPreviewDirty = false;
+    m_streamPreviewShownLength = 0;
+
+    appendOutputMessage(tr("第 %1 段有 %2 条缺失或无效，仅对这些条目发起补译（第 %3 次）")
+                        .arg(m_flowState.currentSegment() + 1)
+                        .arg(missingIds.size())
+                        .arg(m_segmentRepairAttempts));
+    m_activeChatRequestId = m_llmClient->requestChatCompletion(m_activeConfig,
+                                                               messages,
+                                                               m_activeOptions,
+                                                               m_activeResponseSchema);
+}
+
+void SubtitleTranslation::applySegmentRepairResult(const QString &rawResponse)
+{
+    m_segmentRepairInFlight = false;
+    if (!m_streamCueParser.hasInput()) {
+        m_streamCueParser.feed(rawResponse);
+    }
+    m_streamCueParser.finish();
+
+    // 解析器只接受本次补译请求中的编号，已有译文不会被覆盖为其它条目。
+    int repairedCount = 0;
+    for (const StreamingCueParser::Cue &cue : m_streamCueParser.committedCues()) {
+        m_segmentTranslationsById.insert(cue.index, cue.text);
+        ++repairedCount;
+    }
+
+    const QVector<int> missingIds = missingSegmentIds();
+    appendOutputMessage(tr("补译返回 %1 条，仍缺失 %2 条").arg(repairedCount).arg(missingIds.size()));
+    if (!missingIds.isEmpty() && repairedCount > 0 && m_segmentRepairAttempts < kMaxSegmentRepairAttempts) {
+        sendSegmentRepairRequest(missingIds);
+        return;
+    }
+    completeKeyedSegment();
+}
+
+void SubtitleTranslation::completeKeyedSegment()
+{
+    const QVector<SubtitleEntry> segmentSource = currentSegmentSourceEntries();
+    const int startIndex = m_flowState.lastRequestStartIndex();
+
+    QVector<SubtitleEntry> translated;
+    translated.reserve(segmentSource.size());
+    QStringList contextLines;
+    QStringList missingIds;
+    for (int i = 0; i < segmentSource.size(); ++i) {
+        const int id = startIndex + i + 1;
+        const QString text = m_segmentTranslationsById.value(id).trimmed();
+        if (text.isEmpty()) {
+            missingIds.append(QString::number(id));
+            continue;
+        }
+
+        SubtitleEntry entry = segmentSource.at(i);
+        entry.index = id;
+        entry.text = text;
+        translated.append(entry);
+        contextLines.append(SegmentWireCodec::encodeLine(id, text));
+    }
+
+    if (!missingIds.isEmpty()) {
+        const int shownCount = qMin(20, missingIds.size());
+        appendOutputMessage(tr("第 %1 段有 %2 条未返回有效译文（编号：%3%4），对应条目未写入合并结果。")
+                            .arg(m_flowState.currentSegment() + 1)
+                            .arg(missingIds.size())
+                            .arg(missingIds.mid(0, shownCount).join(QStringLiteral(", ")))
+                            .arg(missingIds.size() > shownCount ? QStringLiteral(" ...") : QString()));
+    }
+
+    // 上下文同样使用紧凑格式，避免把时间轴再次发给模型。
+    m_currentSegmentCleanPreview = serializeSrtEntries(translated, false);
+    m_outputPreviewText = m_currentSegmentCleanPreview;
+    renderOutputPanel();
+    completeCurrentSegment(translated, contextLines.join('\n'));
+}
+
+void SubtitleTranslation::storeTranslatedEntries(int languageIndex,
+                                                 const QVector<SubtitleEntry> &entries,
+                                                 int runtimeBegin,
+                                                 int runtimeCount)
+{
+    TranslationDocumentStore *document = documentForLanguage(languageIndex);
+    if (!document) {
+        return;
+    }
+
+    QVector<QPair<int, SubtitleEntry>> journalEntries;
+    journalEntries.reserve(entries.size());
+    const int runtimeEnd = qMin(m_runtimeEntries.size(), runtimeBegin + runtimeCount);
+    int cursor = qMax(0, runtimeBegin);
+    int droppedCount = 0;
+    for (const SubtitleEntry &translatedEntry : entries) {
+        SubtitleEntry entry = translatedEntry;
+        if (entry.startText.isEmpty()) {
+            entry.startText = msToTimeline(entry.startMs);
+        }
+        if (entry.endText.isEmpty()) {
+            entry.endText = msToTimeline(entry.endMs);
+        }
+
+        int runtimeIndex = entry.index - 1;
+        if (runtimeIndex < runtimeBegin || runtimeIndex >= runtimeEnd
+            || m_runtimeEntries.at(runtimeIndex).startMs != entry.startMs) {
+            // SRT 响应的编号不可信：在本段剩余条目中按开始时间匹配，匹配不上则顺延占用下一条。
+            runtimeIndex = -1;
+            for (int i = cursor; i < runtimeEnd; ++i) {
+                if (m_runtimeEntries.at(i).startMs == entry.startMs) {
+                    runtimeIndex = i;
+                    break;
+                }
             }
-            if (mergedEntry.endText.isEmpty()) {
-                mergedEntry.endText = msToTimeline(mergedEntry.endMs);
+            if (runtimeIndex < 0 && cursor < runtimeEnd) {
+                runtimeIndex = cursor;
             }
-            m_translatedByStartMs.insert(mergedEntry.startMs, mergedEntry);
         }
-    } else {
-        const QVector<SubtitleEntry> fallback = parseSrtEntries(rawResponse);
-        for (const SubtitleEntry &entry : fallback) {
-            m_translatedByStartMs.insert(entry.startMs, entry);
+        if (runtimeIndex < 0) {
+            ++droppedCount;
+            continue;
+        }
+
+        cursor = qMax(cursor, runtimeIndex + 1);
+        const int position = m_runtimePositions.at(runtimeIndex);
+        document->setEntry(position, entry);
+        journalEntries.append(qMakePair(position, entry));
+    }
+    m_sessionJournal.recordCommit(documentLanguage(languageIndex), journalEntries);
+
+    if (droppedCount > 0) {
+        appendOutputMessage(tr("返回条目多于请求条目，%1 条无法对应到源字幕，已忽略").arg(droppedCount));
+    }
+}
+
+TranslationDocumentStore *SubtitleTranslation::documentForLanguage(int languageIndex)
+{
+    if (languageIndex == 0) {
+        return &m_translatedDocument;
+    }
+    if (languageIndex > 0 && languageIndex - 1 < m_extraDocuments.size()) {
+        return &m_extraDocuments[languageIndex - 1];
+    }
+    return nullptr;
+}
+
+QString SubtitleTranslation::documentLanguage(int languageIndex) const
+{
+    return languageIndex == 0 ? m_activeComposeInput.targetLanguage : m_extraLanguages.value(languageIndex - 1);
+}
+
+void SubtitleTranslation::clearTranslatedPositions(const QVector<int> &positions)
+{
+    for (int position : positions) {
+        m_translatedDocument.clearEntry(position);
+    }
+    m_sessionJournal.recordClear(documentLanguage(0), positions);
+}
+
+void SubtitleTranslation::openSessionJournal(const QString &sourceHash, const QString &sourcePath)
+{
+    TranslationSessionJournal::SessionHeader header;
+    header.sourceHash = sourceHash;
+    header.sourcePath = QFileInfo(sourcePath).absoluteFilePath();
+    header.entryCount = m_sourceEntries.size();
+    header.chunkSize = qMax(1, ui->segmentSizeSpinBox->value());
+    header.model = m_activeConfig.model;
+    header.targetLanguage = m_activeComposeInput.targetLanguage;
+    header.extraLanguages = m_extraLanguages;
+    header.sentenceRegroup = !m_sentenceUnits.isEmpty();
+    header.concurrent = usesTaskRunner();
+
+    // 条目数、目标语言与是否合并碎句一致时，日志中的位置才与本次划分对应。
+    const TranslationSessionJournal::RecoveredSession recovered = TranslationSessionJournal::load(sourceHash);
+    const int committedCount = recovered.committedCount(header.targetLanguage);
+    bool resumed = false;
+    if (recovered.valid && !recovered.completed && committedCount > 0
+        && recovered.header.entryCount == header.entryCount
+        && recovered.header.targetLanguage == header.targetLanguage
+        && recovered.header.sentenceRegroup == header.sentenceRegroup) {
+        const QMessageBox::StandardButton choice = QMessageBox::question(
+            this,
+            tr("继续未完成的翻译"),
+            tr("该字幕文件有未完成的翻译会话（%1，已提交 %2/%3 条）。\n是否跳过已完成部分继续翻译？选择“否”将重新开始。")
+                .arg(header.targetLanguage)
+                .arg(committedCount)
+                .arg(header.entryCount),
+            QMessageBox::Yes | QMessageBox::No,
+            QMessageBox::Yes);
+        if (choice == QMessageBox::Yes) {
+            restoreJournalSession(recovered);
+            resumed = true;
+        }
+    }
+
+    // 同一路径的源文件内容变了（例如修正错别字）：与上次会话的源条目指纹比对，只重译改动部分。
+    const QVector<SourceFingerprint> fingerprints = SourceEditDiff::fingerprints(m_sourceEntries);
+    bool reusedEditedSource = false;
+    if (!resumed && !recovered.valid) {
+        const QString previousHash = TranslationSessionJournal::findLatestForSource(header.sourcePath, sourceHash);
+        const TranslationSessionJournal::RecoveredSession previous = previousHash.isEmpty()
+                                                                         ? TranslationSessionJournal::RecoveredSession()
+                                                                         : TranslationSessionJournal::load(previousHash);
+        if (previous.valid && !previous.source.isEmpty()
+            && previous.committedCount(header.targetLanguage) > 0
+            && previous.header.targetLanguage == header.targetLanguage
+            && previous.header.sentenceRegroup == header.sentenceRegroup) {
+            const QVector<int> matches = SourceEditDiff::matchPositions(previous.source, fingerprints);
+            const int unchangedCount = matches.size() - matches.count(-1);
+            if (unchangedCount > 0) {
+                const QMessageBox::StandardButton choice = QMessageBox::question(
+                    this,
+                    tr("源文件已修改"),
+                    tr("与上次翻译相比，源文件有 %1 条新增或修改（共 %2 条）。\n是否保留未改动条目的译文，仅重译改动部分？选择“否”将全部重译。")
+                        .arg(matches.size() - unchangedCount)
+                        .arg(matches.size()),
+                    QMessageBox::Yes | QMessageBox::No,
+                    QMessageBox::Yes);
+                if (choice == QMessageBox::Yes) {
+                    const int reusedCount = reuseTranslationsFromEditedSource(previous, matches);
+                    narrowRuntimeToUntranslated(true);
+                    reusedEditedSource = true;
+                    appendOutputMessage(tr("已沿用 %1 条未改动条目的译文，仅重译 %2 条（附带相邻条目作参考上下文）")
+                                        .arg(reusedCount)
+                                        .arg(m_runtimeEntries.size()));
+                }
+            }
+        }
+    }
+
+    QString errorMessage;
+    const bool opened = resumed ? m_sessionJournal.resume(header, &errorMessage)
+                                : m_sessionJournal.begin(header, fingerprints, &errorMessage);
+    if (!opened) {
+        appendOutputMessage(tr("会话日志不可用，本次任务中断后将无法续译：%1").arg(errorMessage));
+        return;
+    }
+
+    // 沿用的译文写入新会话，使新日志自身完整。
+    if (reusedEditedSource) {
+        for (int languageIndex = 0; languageIndex <= m_extraDocuments.size(); ++languageIndex) {
+            const TranslationDocumentStore *document = documentForLanguage(languageIndex);
+            QVector<QPair<int, SubtitleEntry>> entries;
+            for (int position = 0; position < document->size(); ++position) {
+                if (document->hasEntry(position)) {
+                    entries.append(qMakePair(position, document->entryAt(position)));
+                }
+            }
+            m_sessionJournal.recordCommit(documentLanguage(languageIndex), entries);
+        }
+    }
+}
+
+QStringList SubtitleTranslation::referenceLinesForRange(int runtimeBegin, int runtimeCount) const
+{
+    QStringList lines;
+    for (int i = qMax(0, runtimeBegin); i < runtimeBegin + runtimeCount && i < m_runtimeReferenceLines.size(); ++i) {
+        lines += m_runtimeReferenceLines.at(i);
+    }
+    lines.removeDuplicates();
+    return lines;
+}
+
+void SubtitleTranslation::narrowRuntimeToUntranslated(bool withReferenceContext)
+{
+    // 任一语言缺译的条目都重新请求（已有译文的语言会被新结果覆盖）。
+    QVector<SubtitleEntry> pendingEntries;
+    QVector<int> pendingPositions;
+    for (int position = 0; position < m_sourceEntries.size(); ++position) {
+        bool done = m_translatedDocument.hasEntry(position);
+        for (int i = 0; done && i < m_extraDocuments.size(); ++i) {
+            done = m_extraDocuments.at(i).hasEntry(position);
+        }
+        if (!done) {
+            pendingEntries.append(m_sourceEntries.at(position));
+            pendingPositions.append(position);
         }
     }
+    m_runtimeEntries = pendingEntries;
+    m_runtimePositions = pendingPositions;
+    m_runtimeReferenceLines.clear();
+    if (!withReferenceContext) {
+        return;
+    }
+
+    // 前后各取 2 条已有主语言译文的条目作为参考，不重新翻译。
+    const int contextRadius = 2;
+    m_runtimeReferenceLines.reserve(pendingPositions.size());
+    for (int position : pendingPositions) {
+        QStringList lines;
+        const int first = qMax(0, position - contextRadius);
+        const int last = qMin(m_sourceEntries.size() - 1, position + contextRadius);
+        for (int neighbor = first; neighbor <= last; ++neighbor) {
+            if (neighbor != position && m_translatedDocument.hasEntry(neighbor)) {
+                lines.append(tr("%1 → %2").arg(m_sourceEntries.at(neighbor).text.simplified(),
+                                                m_translatedDocument.entryAt(neighbor).text.simplified()));
+            }
+        }
+        m_runtimeReferenceLines.append(lines);
+    }
+}
+
+int SubtitleTranslation::reuseTranslationsFromEditedSource(const TranslationSessionJournal::RecoveredSession &previous,
+                                                           const QVector<int> &matches)
+{
+    int reusedCount = 0;
+    for (int languageIndex = 0; languageIndex <= m_extraDocuments.size(); ++languageIndex) {
+        TranslationDocumentStore *document = documentForLanguage(languageIndex);
+        const QMap<int, SubtitleEntry> entries = previous.entriesByLanguage.value(documentLanguage(languageIndex));
+        for (int position = 0; position < matches.size() && position < document->size(); ++position) {
+            const auto it = entries.constFind(matches.at(position));
+            if (matches.at(position) < 0 || it == entries.constEnd()) {
+                continue;
+            }
+
+            const SubtitleEntry &source = m_sourceEntries.at(position);
+            SubtitleEntry entry = it.value();
+            entry.index = position + 1;
+            entry.startMs = source.startMs;
+            entry.endMs = source.endMs;
+            entry.startText = source.startText.isEmpty() ? msToTimeline(source.startMs) : source.startText;
+            entry.endText = source.endText.isEmpty() ? msToTimeline(source.endMs) : source.endText;
+            document->setEntry(position, entry);
+            if (languageIndex == 0) {
+                ++reusedCount;
+            }
+        }
+    }
+    return reusedCount;
+}
+
+void SubtitleTranslation::restoreJournalSession(const TranslationSessionJournal::RecoveredSession &session)
+{
+    int restoredCount = 0;
+    for (int languageIndex = 0; languageIndex <= m_extraDocuments.size(); ++languageIndex) {
+        TranslationDocumentStore *document = documentForLanguage(languageIndex);
+        const QMap<int, SubtitleEntry> entries = session.entriesByLanguage.value(documentLanguage(languageIndex));
+        for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+            if (it.key() < document->size()) {
+                document->setEntry(it.key(), it.value());
+                ++restoredCount;
+            }
+        }
+    }
+
+    narrowRuntimeToUntranslated(false);
+
+    if (!session.exportPath.isEmpty() && QFileInfo(session.exportPath).absoluteDir().exists()) {
+        m_exportTargetPath = session.exportPath;
+    }
+    appendOutputMessage(tr("已从会话日志恢复 %1 条译文，剩余 %2 条继续翻译")
+                        .arg(restoredCount)
+                        .arg(m_runtimeEntries.size()));
+}
+
+void SubtitleTranslation::announceRecoverableSession(const QString &subtitlePath)
+{
+    QFile file(subtitlePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return;
+    }
+
+    const TranslationSessionJournal::RecoveredSession session =
+        TranslationSessionJournal::load(TranslationSessionJournal::hashSource(file.readAll()));
+    const int committedCount = session.committedCount(session.header.targetLanguage);
+    if (!session.valid || session.completed || committedCount <= 0) {
+        return;
+    }
+    appendOutputMessage(tr("检测到该文件未完成的翻译会话（%1，已提交 %2/%3 条），开始翻译时可选择继续")
+                        .arg(session.header.targetLanguage)
+                        .arg(committedCount)
+                        .arg(session.header.entryCount));
+}
+
+void SubtitleTranslation::completeCurrentSegment(const QVector<SubtitleEntry> &translated, const QString &segmentContext)
+{
+    const QVector<SubtitleEntry> segmentSource = currentSegmentSourceEntries();
+    storeTranslatedEntries(0,
+                           translated,
+                           m_flowState.lastRequestStartIndex(),
+                           m_flowState.lastRequestCount());
 
     const int finishedCount = qMin(m_runtimeEntries.size(),
                                    m_flowState.lastRequestStartIndex() + m_flowState.lastRequestCount());
@@ -1258,7 +2057,7 @@ void SubtitleTranslation::applySegmentTranslationResult(const QString &rawRespon
     ui->translateProgressBar->setRange(0, 100);
     ui->translateProgressBar->setValue(progress);
     ui->progressStatusLabel->setText(tr("第 %1 段翻译完成，等待导出继续").arg(m_flowState.currentSegment() + 1));
-    m_flowState.markSegmentCompleted(m_currentSegmentCleanPreview);
+    m_flowState.markSegmentCompleted(segmentContext);
 
     appendOutputMessage(tr("第 %1 段返回完成：输入 %2 条。已在预览区完整显示清洗后的 API 返回内容；点击“导出 SRT”将生成中间文件并继续下一段。")
                         .arg(m_flowState.currentSegment() + 1)
@@ -1286,6 +2085,7 @@ bool SubtitleTranslation::prepareExportTargetPath()
     const QString timestamp = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
     m_exportTargetPath = QDir(dirPath).filePath(
         QStringLiteral("%1_translated_%2.srt").arg(sourceBaseName, timestamp));
+    m_sessionJournal.recordExportPath(m_exportTargetPath);
     return true;
 }
 
@@ -1320,22 +2120,49 @@ void SubtitleTranslation::writeCurrentSegmentIntermediateFile()
     appendOutputMessage(tr("已生成中间文件：%1").arg(filePath));
 }
 
-QVector<SubtitleTranslation::SubtitleEntry> SubtitleTranslation::mergedTranslatedEntriesByTimestamp() const
+TranslationDocumentStore::Expander SubtitleTranslation::documentExpander() const
 {
-    QVector<SubtitleEntry> merged;
-    merged.reserve(m_translatedByStartMs.size());
+    if (m_sentenceUnits.isEmpty()) {
+        return TranslationDocumentStore::Expander();
+    }
+    return [this](int position, const SubtitleEntry &entry) {
+        return SentenceRegrouper::redistributeUnit(entry, m_originalCues, m_sentenceUnits.value(position));
+    };
+}
 
-    for (auto it = m_translatedByStartMs.constBegin(); it != m_translatedByStartMs.constEnd(); ++it) {
-        merged.append(it.value());
+bool SubtitleTranslation::flushTranslatedDocument(TranslationDocumentStore *document, const QString &filePath)
+{
+    QString errorMessage;
+    if (!document->flushToFile(filePath, documentExpander(), nullptr, &errorMessage)) {
+        appendOutputMessage(tr("无法写入文件：%1（%2）").arg(filePath, errorMessage));
+        return false;
     }
+    return true;
+}
 
-    std::sort(merged.begin(), merged.end(), [](const SubtitleEntry &a, const SubtitleEntry &b) {
-        if (a.startMs == b.startMs) {
-            return a.endMs < b.endMs;
+void SubtitleTranslation::flushTranslatedDocuments()
+{
+    if (!prepareExportTargetPath()) {
+        return;
+    }
+    if (m_translatedDocument.hasPendingChanges()) {
+        flushTranslatedDocument(&m_translatedDocument, m_exportTargetPath);
+    }
+    for (int i = 0; i < m_extraDocuments.size(); ++i) {
+        if (m_extraDocuments.at(i).hasPendingChanges()) {
+            flushTranslatedDocument(&m_extraDocuments[i], extraLanguageFilePath(i));
         }
-        return a.startMs < b.startMs;
-    });
-    return merged;
+    }
+}
+
+bool SubtitleTranslation::usesTaskRunner() const
+{
+    return ui->concurrentPipelineCheckBox->isChecked() || ui->batchApiCheckBox->isChecked();
+}
+
+int SubtitleTranslation::originalCueCount() const
+{
+    return m_originalCues.isEmpty() ? m_sourceEntries.size() : m_originalCues.size();
 }
 
 void SubtitleTranslation::exportFinalMergedSrt()
@@ -1344,40 +2171,81 @@ void SubtitleTranslation::exportFinalMergedSrt()
         return;
     }
 
-    const QVector<SubtitleEntry> mergedEntries = mergedTranslatedEntriesByTimestamp();
-    if (mergedEntries.isEmpty()) {
+    if (m_translatedDocument.isEmpty()) {
         appendOutputMessage(tr("尚无可导出的翻译内容"));
         return;
     }
 
-    const QString mergedSrt = serializeSrtEntries(mergedEntries, true);
-    QFile outFile(m_exportTargetPath);
-    if (!outFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+    // 各段提交时已增量落盘，这里只写出剩余变化（目标文件被删除或改动时全量重写）。
+    if (!flushTranslatedDocument(&m_translatedDocument, m_exportTargetPath)) {
         QMessageBox::warning(this, tr("导出失败"), tr("无法写入文件：%1").arg(m_exportTargetPath));
         return;
     }
 
-    outFile.write(mergedSrt.toUtf8());
-    outFile.close();
-
-    m_lastFinalMergedSrt = mergedSrt;
-    m_outputPreviewText = mergedSrt;
+    m_outputPreviewText = serializeSrtEntries(m_translatedDocument.translatedEntries(documentExpander()), true);
     renderOutputPanel();
 
     ui->progressStatusLabel->setText(tr("全部分段完成，已按时间戳合并导出"));
     ui->translateProgressBar->setRange(0, 100);
     ui->translateProgressBar->setValue(100);
     m_flowState.markTaskCompleted();
+    m_sessionJournal.recordCompleted();
     setRetryButtonState(RetryMode::RetryPartialRange, true);
-    appendOutputMessage(tr("导出完成：%1（共 %2 条，按时间戳顺序合并）")
+    appendOutputMessage(tr("导出完成：%1（共 %2 条，按源字幕顺序合并）")
                         .arg(m_exportTargetPath)
-                        .arg(mergedEntries.size()));
+                        .arg(m_translatedDocument.exportedBlockCount()));
+}
+
+QStringList SubtitleTranslation::extraTargetLanguages() const
+{
+    const QString primary = ui->targetLangComboBox->currentText().trimmed();
+    QStringList languages;
+    const QStringList parts = ui->extraTargetLangLineEdit->text().split(QRegularExpression(QStringLiteral("[,，;；]")));
+    for (const QString &part : parts) {
+        const QString language = part.trimmed();
+        if (!language.isEmpty() && language != primary && !languages.contains(language)) {
+            languages.append(language);
+        }
+    }
+    return languages;
+}
+
+void SubtitleTranslation::exportExtraLanguageFiles()
+{
+    if (m_extraLanguages.isEmpty() || m_exportTargetPath.isEmpty()) {
+        return;
+    }
+
+    for (int i = 0; i < m_extraLanguages.size() && i < m_extraDocuments.size(); ++i) {
+        TranslationDocumentStore &document = m_extraDocuments[i];
+        if (document.isEmpty()) {
+            appendOutputMessage(tr("%1 没有可导出的译文").arg(m_extraLanguages.at(i)));
+            continue;
+        }
+
+        const QString filePath = extraLanguageFilePath(i);
+        if (!flushTranslatedDocument(&document, filePath)) {
+            continue;
+        }
+        appendOutputMessage(tr("导出完成（%1）：%2（共 %3 条）")
+                            .arg(m_extraLanguages.at(i), filePath)
+                            .arg(document.exportedBlockCount()));
+    }
+}
+
+QString SubtitleTranslation::extraLanguageFilePath(int languageIndex) const
+{
+    const QFileInfo primaryInfo(m_exportTargetPath);
+    QString languageTag = m_extraLanguages.value(languageIndex);
+    languageTag.replace(QRegularExpression(QStringLiteral("[\\\\/:*?\"<>|\\s]")), QStringLiteral("_"));
+    return primaryInfo.dir().filePath(
+        QStringLiteral("%1_%2.srt").arg(primaryInfo.completeBaseName(), languageTag));
 }
 
 void SubtitleTranslation::onExportSrtClicked()
 {
     if (m_flowState.currentSegment() < 0) {
-        if (!m_lastFinalMergedSrt.trimmed().isEmpty()) {
+        if (!m_translatedDocument.isEmpty()) {
             exportFinalMergedSrt();
         } else {
             appendOutputMessage(tr("当前没有进行中的翻译任务"));
@@ -1395,6 +2263,7 @@ void SubtitleTranslation::onExportSrtClicked()
     }
 
     writeCurrentSegmentIntermediateFile();
+    flushTranslatedDocuments();
     if (m_flowState.advanceAfterExport()) {
         appendOutputMessage(tr("继续发送第 %1 段翻译请求").arg(m_flowState.currentSegment() + 1));
         sendCurrentSegmentRequest();
@@ -1402,14 +2271,25 @@ void SubtitleTranslation::onExportSrtClicked()
     }
 
     exportFinalMergedSrt();
+    appendTelemetrySummary();
 }
 
 void SubtitleTranslation::onStopTaskClicked()
 {
+    if (m_taskRunner->isRunning()) {
+        m_taskRunner->cancelTask();
+        ui->translateProgressBar->setRange(0, 100);
+        ui->translateProgressBar->setValue(0);
+        appendOutputMessage(tr("已手动停止并发翻译任务。"));
+        return;
+    }
+
     if (m_streamPreviewTimer) {
         m_streamPreviewTimer->stop();
     }
-    m_pendingStreamRawContent.clear();
+    m_streamPreviewDirty = false;
+    m_streamPreviewShownLength = 0;
+    m_segmentRepairInFlight = false;
 
     if (!m_flowState.hasRunningOrPendingTask() && !ui->startTranslateButton->isEnabled()) {
         m_flowState.markStopRequested();
@@ -1454,10 +2334,7 @@ void SubtitleTranslation::onRetryActionClicked()
         }
 
         const int chunk = qMax(1, ui->segmentSizeSpinBox->value());
-        for (int i = stoppedEntryIndex; i < m_runtimeEntries.size(); ++i) {
-            const SubtitleEntry &entry = m_runtimeEntries.at(i);
-            m_translatedByStartMs.remove(entry.startMs);
-        }
+        clearTranslatedPositions(m_runtimePositions.mid(stoppedEntryIndex));
 
         m_flowState.restartFromStopped(chunk);
         setRetryButtonState(RetryMode::None, false);
@@ -1469,7 +2346,7 @@ void SubtitleTranslation::onRetryActionClicked()
     }
 
     if (m_retryMode == RetryMode::RetryPartialRange) {
-        if (m_sourceEntries.isEmpty() || m_translatedByStartMs.isEmpty()) {
+        if (m_sourceEntries.isEmpty() || m_translatedDocument.isEmpty()) {
             appendOutputMessage(tr("当前没有可用于部分重译的数据，请先完成一次完整翻译。"));
             return;
         }
@@ -1511,13 +2388,15 @@ void SubtitleTranslation::onRetryActionClicked()
         }
 
         QVector<SubtitleEntry> selected;
-        for (const SubtitleEntry &entry : m_sourceEntries) {
+        QVector<int> selectedPositions;
+        for (int i = 0; i < m_sourceEntries.size(); ++i) {
+            const SubtitleEntry &entry = m_sourceEntries.at(i);
             const bool overlap = !(entry.endMs < startMs || entry.startMs > endMs);
             if (!overlap) {
                 continue;
             }
             selected.append(entry);
-            m_translatedByStartMs.remove(entry.startMs);
+            selectedPositions.append(i);
         }
 
         if (selected.isEmpty()) {
@@ -1525,7 +2404,11 @@ void SubtitleTranslation::onRetryActionClicked()
             return;
         }
 
+        clearTranslatedPositions(selectedPositions);
+
         m_runtimeEntries = selected;
+        m_runtimePositions = selectedPositions;
+        m_runtimeReferenceLines.clear();
 
         m_exportTargetPath.clear();
         m_flowState.restartWithPartialEntries(m_runtimeEntries.size());
@@ -1556,12 +2439,54 @@ void SubtitleTranslation::onCopyResultClicked()
     }
 }
 
+void SubtitleTranslation::appendTelemetrySummary()
+{
+    const QStringList lines = m_telemetry.summaryLines();
+    if (lines.isEmpty()) {
+        return;
+    }
+
+    appendOutputMessage(tr("请求性能统计（可通过“导出统计”保存为 CSV / JSON）："));
+    for (const QString &line : lines) {
+        appendOutputMessage(line);
+    }
+}
+
+void SubtitleTranslation::onExportTelemetryClicked()
+{
+    if (m_telemetry.isEmpty()) {
+        appendOutputMessage(tr("当前任务尚无请求统计"));
+        return;
+    }
+
+    const QString defaultDir = m_exportTargetPath.isEmpty() ? QDir::homePath()
+                                                             : QFileInfo(m_exportTargetPath).absolutePath();
+    QString selectedFilter;
+    const QString path = QFileDialog::getSaveFileName(this,
+                                                      tr("导出请求性能统计"),
+                                                      QDir(defaultDir).filePath(QStringLiteral("translation_metrics.csv")),
+                                                      tr("CSV 文件 (*.csv);;JSON 文件 (*.json)"),
+                                                      &selectedFilter);
+    if (path.isEmpty()) {
+        return;
+    }
+
+    const bool asJson = path.endsWith(QStringLiteral(".json"), Qt::CaseInsensitive)
+                        || (!path.endsWith(QStringLiteral(".csv"), Qt::CaseInsensitive) && selectedFilter.contains(QStringLiteral("json")));
+    QString errorMessage;
+    const bool ok = asJson ? m_telemetry.exportJson(path, &errorMessage) : m_telemetry.exportCsv(path, &errorMessage);
+    if (!ok) {
+        QMessageBox::warning(this, tr("导出失败"), tr("无法写入文件：%1\n%2").arg(path, errorMessage));
+        return;
+    }
+    appendOutputMessage(tr("请求性能统计已导出：%1").arg(path));
+}
+
 void SubtitleTranslation::onClearOutputClicked()
 {
     m_outputPreviewText.clear();
-    m_outputLogLines.clear();
+    m_outputModel->clear();
     m_outputAutoFollow = true;
-    renderOutputPanel();
 }
 
 void SubtitleTranslation::onPresetSelectionChanged()
@@ -1578,7 +2503,7 @@ void SubtitleTranslation::onNaturalInstructionChanged()
 void SubtitleTranslation::onModelsReady(const QStringList &models)
 {
     if (models.isEmpty()) {
-        onRequestFailed(tr("模型列表"), tr("响应为空"));
+        onRequestFailed(0, tr("模型列表"), tr("响应为空"));
         return;
     }
 
@@ -1598,18 +2523,22 @@ void SubtitleTranslation::onModelsReady(const QStringList &models)
     appendOutputMessage(tr("模型刷新成功，共 %1 个").arg(models.size()));
 }
 
-void SubtitleTranslation::onChatCompleted(const QString &content, const QJsonObject &)
+void SubtitleTranslation::onChatCompleted(quint64 requestId, const QString &content, const QJsonObject &)
 {
+    if (requestId != m_activeChatRequestId) {
+        return;
+    }
+
     if (m_streamPreviewTimer) {
         m_streamPreviewTimer->stop();
     }
-    if (!m_pendingStreamRawContent.isEmpty()) {
-        updateLivePreview(m_pendingStreamRawContent);
-        m_pendingStreamRawContent.clear();
-    }
 
     if (m_flowState.hasRunningOrPendingTask()) {
-        applySegmentTranslationResult(content);
+        if (m_segmentRepairInFlight) {
+            applySegmentRepairResult(content);
+        } else {
+            applySegmentTranslationResult(content);
+        }
         return;
     }
 
@@ -1621,24 +2550,117 @@ void SubtitleTranslation::onChatCompleted(const QString &content, const QJsonObj
     appendOutputMessage(tr("服务响应完成"));
 }
 
-void SubtitleTranslation::onStreamChunkReceived(const QString &, const QString &aggregatedContent)
+void SubtitleTranslation::onChatMetricsMeasured(quint64 requestId, const LlmRequestMetrics &metrics)
 {
-    if (m_flowState.currentSegment() < 0) {
+    m_telemetry.recordCompletion(metrics);
+    if (requestId != m_activeChatRequestId || metrics.firstTokenMs < 0) {
         return;
     }
 
-    m_pendingStreamRawContent = aggregatedContent;
-    if (m_streamPreviewTimer && !m_streamPreviewTimer->isActive()) {
-        m_streamPreviewTimer->start();
+    m_firstTokenTotalMs += metrics.firstTokenMs;
+    ++m_firstTokenSamples;
+    const QString setupText = metrics.tlsReadyMs >= 0
+                              ? tr("TLS 就绪 %1 ms，").arg(metrics.tlsReadyMs)
+                              : QString();
+    appendOutputMessage(tr("首字延迟 %1 ms（本任务平均 %2 ms），总耗时 %3 ms；排队 %4 ms，%5响应头 %6 ms，"
+                           "发送 %7 B / 接收 %8 B，%9")
+                        .arg(metrics.firstTokenMs)
+                        .arg(m_firstTokenTotalMs / m_firstTokenSamples)
+                        .arg(metrics.totalMs)
+                        .arg(metrics.queueWaitMs)
+                        .arg(setupText)
+                        .arg(metrics.headersMs)
+                        .arg(metrics.bytesSent)
+                        .arg(metrics.bytesReceived)
+                        .arg(metrics.http2 ? QStringLiteral("HTTP/2") : QStringLiteral("HTTP/1.1")));
+}
+
+void SubtitleTranslation::onStreamChunkReceived(quint64 requestId, const QString &delta)
+{
+    if (requestId != m_activeChatRequestId || m_flowState.currentSegment() < 0) {
+        return;
     }
-    const int chunk = qMax(1, ui->segmentSizeSpinBox->value());
+
+    // 仅消费本次增量；只有完整条目（遇到空行终止）提交后才需要刷新预览。
+    // 补译请求只含少量条目，结束后统一刷新，避免覆盖已显示的本段结果。
+    if (m_streamCueParser.feed(delta) > 0 && !m_segmentRepairInFlight) {
+        m_streamPreviewDirty = true;
+        if (m_streamPreviewTimer && !m_streamPreviewTimer->isActive()) {
+            m_streamPreviewTimer->start();
+        }
+    }
+    const int segmentSize = qMax(1, ui->segmentSizeSpinBox->value());
     const int estimatedTotalSegments = qMax(m_flowState.currentSegment() + 1,
-                                            (m_runtimeEntries.size() + chunk - 1) / chunk);
-    ui->progressStatusLabel->setText(tr("第 %1/%2 段流式返回中...").arg(m_flowState.currentSegment() + 1).arg(estimatedTotalSegments));
+                                            (m_runtimeEntries.size() + segmentSize - 1) / segmentSize);
+    ui->progressStatusLabel->setText(tr("第 %1/%2 段流式返回中（已提交 %3 条）...")
+                                         .arg(m_flowState.currentSegment() + 1)
+                                         .arg(estimatedTotalSegments)
+                                         .arg(m_streamCueParser.committedCues().size()));
+}
+
+void SubtitleTranslation::onRequestRestarted(quint64 requestId, const QString &reason)
+{
+    if (requestId != m_activeChatRequestId) {
+        return;
+    }
+
+    // 换端点重发：已流式显示的内容作废，按同一格式与时间轴重新解析。
+    m_streamCueParser.restart();
+    m_streamPreviewDirty = false;
+    m_streamPreviewShownLength = 0;
+    appendOutputMessage(reason);
+}
+
+void SubtitleTranslation::onConcurrentChunkCommitted(int languageIndex,
+                                                     int chunkIndex,
+                                                     const QVector<SubtitleEntry> &translatedEntries)
+{
+    const int chunkBegin = chunkIndex * m_concurrentChunkSize;
+    storeTranslatedEntries(languageIndex, translatedEntries, chunkBegin, m_concurrentChunkSize);
+    flushTranslatedDocuments();
+    if (languageIndex > 0) {
+        return;
+    }
+
+    if (!translatedEntries.isEmpty()) {
+        appendOutputPreview(serializeSrtEntries(translatedEntries, false));
+    }
 }
 
-void SubtitleTranslation::onRequestFailed(const QString &stage, const QString &message)
+void SubtitleTranslation::onConcurrentProgressChanged(int committedEntries, int totalEntries)
 {
+    ui->translateProgressBar->setRange(0, 100);
+    ui->translateProgressBar->setValue(qRound((committedEntries * 100.0) / qMax(1, totalEntries)));
+    ui->progressStatusLabel->setText(tr("并发翻译中：已按序提交 %1/%2 条").arg(committedEntries).arg(totalEntries));
+}
+
+void SubtitleTranslation::onConcurrentTaskFinished(bool success, const QString &message)
+{
+    appendOutputMessage(message);
+    if (success && !m_translatedDocument.isEmpty()) {
+        exportFinalMergedSrt();
+        exportExtraLanguageFiles();
+    } else {
+        ui->progressStatusLabel->setText(success ? tr("没有可导出的译文") : tr("并发翻译已中止"));
+    }
+    appendTelemetrySummary();
+    onBusyChanged(false);
+}
+
+void SubtitleTranslation::onChatFailureMeasured(quint64 requestId, const LlmRequestMetrics &metrics)
+{
+    Q_UNUSED(requestId);
+    // 按失败请求实际使用的模型计数（含快速模型路由与润色模型）。
+    m_telemetry.recordFailure(metrics.model);
+}
+
+void SubtitleTranslation::onRequestFailed(quint64 requestId, const QString &stage, const QString &message)
+{
+    // 并发执行器的请求由其自行处理。
+    if (requestId != 0 && requestId != m_activeChatRequestId) {
+        return;
+    }
+
     if (m_flowState.consumeStopRequested()) {
         ui->translateProgressBar->setRange(0, 100);
         ui->translateProgressBar->setValue(0);
@@ -1646,6 +2668,14 @@ void SubtitleTranslation::onRequestFailed(const QString &stage, const QString &m
         return;
     }
 
+    if (m_segmentRepairInFlight && m_flowState.hasRunningOrPendingTask()) {
+        // 补译失败不影响已得到的译文，缺失条目按原逻辑记录后完成本段。
+        m_segmentRepairInFlight = false;
+        appendOutputMessage(tr("补译%1失败：%2，保留已得到的译文").arg(stage, message));
+        completeKeyedSegment();
+        return;
+    }
+
     ui->translateProgressBar->setRange(0, 100);
     ui->translateProgressBar->setValue(0);
     ui->progressStatusLabel->setText(tr("%1失败").arg(stage));
@@ -1654,6 +2684,7 @@ void SubtitleTranslation::onRequestFailed(const QString &stage, const QString &m
 
 void SubtitleTranslation::onBusyChanged(bool busy)
 {
+    busy = busy || (m_taskRunner && m_taskRunner->isRunning());
     ui->refreshModelButton->setEnabled(!busy);
     ui->startTranslateButton->setEnabled(!busy);
     ui->exportSrtButton->setEnabled(!busy || m_flowState.isWaitingExport());
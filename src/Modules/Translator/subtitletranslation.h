@@ -3,7 +3,14 @@
 
 #include "llmserviceclient.h"
 #include "promptrequestcomposer.h"
+#include "sentenceregrouper.h"
+#include "streamingcueparser.h"
+#include "subtitleentry.h"
+#include "translationdocumentstore.h"
 #include "translationflowstate.h"
+#include "translationsessionjournal.h"
+#include "translationtaskrunner.h"
+#include "translationtelemetry.h"
 
 #include <QJsonObject>
 #include <QMap>
@@ -11,6 +18,8 @@
 #include <QVector>
 #include <QWidget>
 
+class OutputPanelModel;
+class LlmBatchClient;
 class QTimer;
 
 class LlmServiceClient;
@@ -23,20 +32,17 @@ class SubtitleTranslation : public QWidget
 {
     Q_OBJECT
 
-    struct SubtitleEntry
-    {
-        int index = 0;
-        qint64 startMs = 0;
-        qint64 endMs = 0;
-        QString startText;
-        QString endText;
-        QString text;
-    };
+    using SubtitleEntry = ::SubtitleEntry;
 
 public:
     explicit SubtitleTranslation(QWidget *parent = nullptr);
     ~SubtitleTranslation();
     void setPendingSubtitleFile(const QString &subtitlePath);
+    // 边识别边翻译：识别开始时以最终字幕路径开始流式任务（服务未配置或已有任务时返回 false），
+    // 识别出的条目按时间顺序逐段追加（SRT 片段），识别结束后补齐末块并照常导出。
+    bool beginStreamingSource(const QString &subtitlePath);
+    void appendStreamingSource(const QString &srtFragment);
+    void finishStreamingSource(bool success);
 
 private:
     enum class RetryMode {
@@ -66,14 +72,20 @@ private:
     void persistNaturalInstruction();
     void loadUiPreferences();
     void persistUiPreferences();
-    QString buildAutoInstructionText() const;
+    // targetLanguage 为空时取界面上的目标语言（指令框留空时用于生成默认指令）。
+    QString buildAutoInstructionText(const QString &targetLanguage = QString()) const;
     void updateSecretInputState();
     void persistSecret(const QString &storageKey, const QString &plainSecret);
     QString resolveSecretForRequest(const QString &storageKey,
                                     const QString &inputText,
                                     QString *cachedSecret);
     void appendOutputMessage(const QString &message);
+    // 用 m_outputPreviewText 更新预览区（只重排变化的行）。
     void renderOutputPanel();
+    // 预览区末尾追加一段，不重建已有行。
+    void appendOutputPreview(const QString &text);
+    void followOutputIfNeeded();
+    void copySelectedOutputRows();
 
     // 解析 SRT 文本为结构化条目。
     QVector<SubtitleEntry> parseSrtEntries(const QString &srtText) const;
@@ -85,27 +97,86 @@ private:
 
     // 启动一次新的分段翻译任务。
     void startSegmentedTranslation();
+    // 并发模式：整份字幕交给 TranslationTaskRunner，按序提交后自动导出。
+    void startConcurrentTranslation();
+    // 并发流水线与批量接口都由 TranslationTaskRunner 执行。
+    bool usesTaskRunner() const;
     // 发送当前段请求（按当前“每次翻译条数”动态切分）。
     void sendCurrentSegmentRequest();
     // 获取当前请求对应的源字幕条目区间。
     QVector<SubtitleEntry> currentSegmentSourceEntries() const;
-    // 构造单段的 SRT 提示文本。
-    QString buildSegmentPromptSrt(const QVector<SubtitleEntry> &entries) const;
+    // 当前任务的响应格式：保留时间轴时为 "id|text" 紧凑行或 JSON 结构化条目（时间戳本地回填），否则为 SRT。
+    StreamingCueParser::InputFormat activeResponseFormat() const;
+    // 构造单段的请求文本：紧凑格式为 "id|text" 行，否则为完整 SRT。
+    QString buildSegmentPromptText(int startIndex, const QVector<SubtitleEntry> &entries) const;
+    // 追加在指令末尾的输出格式约束；结构化输出时同时填充 JSON Schema。
+    QString responseFormatInstruction(StreamingCueParser::InputFormat format, QJsonObject *responseSchema) const;
+    // 按当前活动上下文构造静态前缀（指令 + 预设 + 输出格式）与结构化输出 Schema。
+    void refreshActivePromptPrefix();
+    // 按全局编号（从 1 开始）取源条目时间轴，供按编号格式本地回填。
+    QHash<int, StreamingCueParser::CueTiming> buildKeyedTimeline(const QVector<int> &ids) const;
     // 对原始响应做正则裁剪，用于预览展示。
     QString cleanSrtPreviewText(const QString &rawText) const;
     // 处理单段返回结果并写入全局合并映射。
     void applySegmentTranslationResult(const QString &rawResponse);
     void updateLivePreview(const QString &rawResponse);
     void flushPendingStreamPreview();
+    // 将增量解析器已提交的条目转换为结构化条目（无需再次正则扫描全文）。
+    QVector<SubtitleEntry> entriesFromCommittedCues() const;
+    // 当前段中尚未得到有效译文的编号。
+    QVector<int> missingSegmentIds() const;
+    // 仅针对缺失/无效编号补发请求，已得到的译文保留不动。
+    void sendSegmentRepairRequest(const QVector<int> &missingIds);
+    void applySegmentRepairResult(const QString &rawResponse);
+    // 按编号汇总当前段译文并完成本段。
+    void completeKeyedSegment();
+    // 按源条目位置写入译文（0 为主语言，其后为附加语言）并记入会话日志：
+    // 编号与开始时间都吻合时按编号定位，否则在本段内按开始时间顺序匹配。
+    void storeTranslatedEntries(int languageIndex,
+                                const QVector<SubtitleEntry> &entries,
+                                int runtimeBegin,
+                                int runtimeCount);
+    TranslationDocumentStore *documentForLanguage(int languageIndex);
+    QString documentLanguage(int languageIndex) const;
+    // 清除主语言若干位置的译文（重译前），同时记入会话日志。
+    void clearTranslatedPositions(const QVector<int> &positions);
+    // 打开本次任务的会话日志；同一源文件有未完成会话时询问是否续译。
+    void openSessionJournal(const QString &sourceHash, const QString &sourcePath);
+    // 从会话日志恢复已提交译文，待译条目缩减为尚未完成的部分。
+    void restoreJournalSession(const TranslationSessionJournal::RecoveredSession &session);
+    // 源文件修改后：按比对结果沿用未改动条目的旧译文（时间轴取新源文件），返回沿用条数。
+    int reuseTranslationsFromEditedSource(const TranslationSessionJournal::RecoveredSession &previous,
+                                          const QVector<int> &matches);
+    // 待译条目缩减为任一语言缺译的条目；withReferenceContext 时为其附带相邻已译条目作参考上下文。
+    void narrowRuntimeToUntranslated(bool withReferenceContext);
+    // 运行态区间内各条参考上下文行（去重）。
+    QStringList referenceLinesForRange(int runtimeBegin, int runtimeCount) const;
+    // 载入字幕文件时提示是否存在可续译的会话。
+    void announceRecoverableSession(const QString &subtitlePath);
+    // 写入译文文档、推进进度并标记本段完成。
+    void completeCurrentSegment(const QVector<SubtitleEntry> &translated, const QString &segmentContext);
 
     // 计算并准备最终导出文件路径。
     bool prepareExportTargetPath();
     // 写出当前段中间文件（segment_xxx.srt）。
     void writeCurrentSegmentIntermediateFile();
-    // 导出按时间戳合并后的最终 SRT。
+    // 导出最终 SRT（写出尚未落盘的变化）。
     void exportFinalMergedSrt();
-    // 按时间顺序合并条目，同时间戳仅保留一条。
-    QVector<SubtitleEntry> mergedTranslatedEntriesByTimestamp() const;
+    // 多语言任务：按主文件名追加语言名，逐个导出附加语言的 SRT。
+    void exportExtraLanguageFiles();
+    QString extraLanguageFilePath(int languageIndex) const;
+    // 将译文文档的变化增量写入目标文件；失败时在输出面板提示。
+    bool flushTranslatedDocument(TranslationDocumentStore *document, const QString &filePath);
+    // 分段 / 分块提交后即时落盘主语言与附加语言文件。
+    void flushTranslatedDocuments();
+    // 合并碎句翻译时将单元译文切回原条目时间轴；否则为空（原样写出）。
+    TranslationDocumentStore::Expander documentExpander() const;
+    // 附加目标语言（逗号 / 分号分隔，去重且排除主目标语言）。
+    QStringList extraTargetLanguages() const;
+    // 任务结束时在输出面板追加按模型汇总的请求性能统计。
+    void appendTelemetrySummary();
+    // 原始字幕条数（合并碎句前）。
+    int originalCueCount() const;
 
     // 重置当前翻译会话的运行态。
     void resetTranslationSessionState();
@@ -123,14 +194,21 @@ private:
 
 private slots:
     void onModelsReady(const QStringList &models);
-    void onChatCompleted(const QString &content, const QJsonObject &rawResponse);
-    void onStreamChunkReceived(const QString &chunk, const QString &aggregatedContent);
-    void onRequestFailed(const QString &stage, const QString &message);
+    void onChatCompleted(quint64 requestId, const QString &content, const QJsonObject &rawResponse);
+    void onChatMetricsMeasured(quint64 requestId, const LlmRequestMetrics &metrics);
+    void onChatFailureMeasured(quint64 requestId, const LlmRequestMetrics &metrics);
+    void onStreamChunkReceived(quint64 requestId, const QString &delta);
+    void onRequestFailed(quint64 requestId, const QString &stage, const QString &message);
+    void onRequestRestarted(quint64 requestId, const QString &reason);
+    void onConcurrentChunkCommitted(int languageIndex, int chunkIndex, const QVector<SubtitleEntry> &translatedEntries);
+    void onConcurrentProgressChanged(int committedEntries, int totalEntries);
+    void onConcurrentTaskFinished(bool success, const QString &message);
     void onBusyChanged(bool busy);
     void onExportSrtClicked();
     void onStopTaskClicked();
     void onRetryActionClicked();
     void onCopyResultClicked();
+    void onExportTelemetryClicked();
     void onClearOutputClicked();
 
 private:
@@ -138,31 +216,65 @@ private:
     Ui::SubtitleTranslation *ui;
     QString m_presetDirectory;
     LlmServiceClient *m_llmClient = nullptr;
+    // 润色阶段独立的客户端：端点池与翻译阶段互不影响，可指向不同模型或服务地址。
+    LlmServiceClient *m_polishLlmClient = nullptr;
+    TranslationTaskRunner *m_taskRunner = nullptr;
+    LlmBatchClient *m_batchClient = nullptr;
     QString m_savedApiKey;
     QString m_savedServerPassword;
     bool m_syncingSharedParameters = false;
     bool m_loadingUiPreferences = false;
 
-    QStringList m_outputLogLines;
+    // 输出面板（预览 + 日志）的行模型，视图只绘制可见行。
+    OutputPanelModel *m_outputModel = nullptr;
     QString m_outputPreviewText;
     bool m_outputAutoFollow = true;
-    bool m_restoringOutputScroll = false;
 
     QVector<SubtitleEntry> m_sourceEntries;
     QVector<SubtitleEntry> m_runtimeEntries;
-    QMap<qint64, SubtitleEntry> m_translatedByStartMs;
+    // m_runtimeEntries 各条在 m_sourceEntries 中的位置（部分重译时为所选条目）。
+    QVector<int> m_runtimePositions;
+    // 与 m_runtimeEntries 等长或为空：只重译改动条目时各条的参考上下文行。
+    QVector<QStringList> m_runtimeReferenceLines;
+    // 主目标语言译文，按 m_sourceEntries 位置存放。
+    TranslationDocumentStore m_translatedDocument;
+    // 合并碎句时的原始条目与句子单元；为空表示按原条目翻译。导出时按单元切回原条目。
+    QVector<SubtitleEntry> m_originalCues;
+    QVector<SentenceUnit> m_sentenceUnits;
+    // 多语言任务的附加语言及其译文文档。
+    QStringList m_extraLanguages;
+    QVector<TranslationDocumentStore> m_extraDocuments;
+    int m_concurrentChunkSize = 0;
+    // 源条目由识别页逐段送入，任务以流式输入方式运行。
+    bool m_streamingSource = false;
 
     TranslationFlowState m_flowState;
     RetryMode m_retryMode = RetryMode::None;
     QString m_currentSegmentRawResponse;
     QString m_currentSegmentCleanPreview;
-    QString m_lastFinalMergedSrt;
     QString m_exportTargetPath;
     LlmServiceConfig m_activeConfig;
     QJsonObject m_activeOptions;
     PromptComposeInput m_activeComposeInput;
+    bool m_activeStructuredOutput = false;
+    QString m_activeSystemPrompt;
+    QJsonObject m_activeResponseSchema;
+    qint64 m_firstTokenTotalMs = 0;
+    int m_firstTokenSamples = 0;
+    // 当前任务的会话日志（崩溃或关闭后可据此续译）。
+    TranslationSessionJournal m_sessionJournal;
+    // 本任务的请求性能统计（含并发执行器发出的请求）。
+    TranslationTelemetry m_telemetry;
+    quint64 m_activeChatRequestId = 0;
     QTimer *m_streamPreviewTimer = nullptr;
-    QString m_pendingStreamRawContent;
+    StreamingCueParser m_streamCueParser;
+    bool m_streamPreviewDirty = false;
+    // 本段已显示到预览面板的已提交文本长度，0 表示下次刷新整体替换预览。
+    int m_streamPreviewShownLength = 0;
+    // 当前段按编号累积的译文（含补译结果）。
+    QMap<int, QString> m_segmentTranslationsById;
+    int m_segmentRepairAttempts = 0;
+    bool m_segmentRepairInFlight = false;
 };
 
 #endif // SUBTITLETRANSLATION_H
@@ -0,0 +1,50 @@
+#ifndef TRANSLATIONBACKEND_H
+#define TRANSLATIONBACKEND_H
+
+#include "llmserviceclient.h"
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+// 一次按行翻译请求：译文与 lines 逐行对应。
+struct TranslationLineBatch
+{
+    QStringList lines;
+    // 为空表示自动检测。
+    QString sourceLanguage;
+    QString targetLanguage;
+    // 聊天类后端的静态前缀（指令 + 预设 + 输出格式）；专用机器翻译服务忽略。
+    QString systemPrompt;
+};
+
+// 按行批量翻译的后端：输入若干行原文，返回等长的译文行。分块调度、翻译记忆、补译与按序提交
+// 由 TranslationTaskRunner 负责，后端只需完成单次请求；聊天模型与专用机器翻译服务各有实现。
+class TranslationBackend : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TranslationBackend(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+    }
+
+    // 日志与统计中显示的名称。
+    virtual QString name() const = 0;
+    // 发出请求并返回请求 ID；参数无效或未能发出时返回 0（不发出信号）。
+    virtual quint64 translateLines(const TranslationLineBatch &batch) = 0;
+    // 取消在途请求；之后不再为该 ID 发出任何信号。
+    virtual void cancel(quint64 requestId) = 0;
+    // 建议的同时在途请求数。
+    virtual int suggestedConcurrency() const = 0;
+
+signals:
+    // translations 与请求的 lines 等长；未返回有效译文的行为空串，由调用方决定是否补译。
+    void linesTranslated(quint64 requestId, const QStringList &translations);
+    void linesFailed(quint64 requestId, const QString &message);
+    // 在 linesTranslated 之前发出。
+    void requestMeasured(quint64 requestId, const LlmRequestMetrics &metrics);
+};
+
+#endif // TRANSLATIONBACKEND_H
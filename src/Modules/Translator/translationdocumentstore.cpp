@@ -0,0 +1,277 @@
+#include "translationdocumentstore.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QPair>
+
+void TranslationDocumentStore::reset(int entryCount)
+{
+    const int count = qMax(0, entryCount);
+    m_entries = QVector<SubtitleEntry>(count);
+    m_present = QBitArray(count);
+    m_dirty = QBitArray(count);
+    m_firstDirty = -1;
+    m_lastDirty = -1;
+    m_lastPresent = -1;
+    m_translatedCount = 0;
+    m_blockOffsets = QVector<qint64>(count, 0);
+    m_blockNumbers = QVector<int>(count, 1);
+    invalidateExport();
+}
+
+void TranslationDocumentStore::grow(int entryCount)
+{
+    if (entryCount <= m_entries.size()) {
+        return;
+    }
+    m_entries.resize(entryCount);
+    m_present.resize(entryCount);
+    m_dirty.resize(entryCount);
+    m_blockOffsets.resize(entryCount);
+    m_blockNumbers.resize(entryCount);
+}
+
+int TranslationDocumentStore::size() const
+{
+    return m_entries.size();
+}
+
+int TranslationDocumentStore::translatedCount() const
+{
+    return m_translatedCount;
+}
+
+bool TranslationDocumentStore::isEmpty() const
+{
+    return m_translatedCount == 0;
+}
+
+bool TranslationDocumentStore::hasEntry(int position) const
+{
+    return position >= 0 && position < m_entries.size() && m_present.testBit(position);
+}
+
+const SubtitleEntry &TranslationDocumentStore::entryAt(int position) const
+{
+    return m_entries.at(position);
+}
+
+void TranslationDocumentStore::setEntry(int position, const SubtitleEntry &entry)
+{
+    if (position < 0 || position >= m_entries.size()) {
+        return;
+    }
+
+    if (!m_present.testBit(position)) {
+        m_present.setBit(position);
+        ++m_translatedCount;
+    }
+    m_entries[position] = entry;
+    m_lastPresent = qMax(m_lastPresent, position);
+    markDirty(position);
+}
+
+void TranslationDocumentStore::clearEntry(int position)
+{
+    if (!hasEntry(position)) {
+        return;
+    }
+
+    m_present.clearBit(position);
+    m_entries[position] = SubtitleEntry();
+    --m_translatedCount;
+    markDirty(position);
+    if (position == m_lastPresent) {
+        while (m_lastPresent >= 0 && !m_present.testBit(m_lastPresent)) {
+            --m_lastPresent;
+        }
+    }
+}
+
+QVector<SubtitleEntry> TranslationDocumentStore::translatedEntries(const Expander &expander) const
+{
+    QVector<SubtitleEntry> entries;
+    entries.reserve(m_translatedCount);
+    for (int i = 0; i <= m_lastPresent; ++i) {
+        if (!m_present.testBit(i)) {
+            continue;
+        }
+        if (expander) {
+            entries += expander(i, m_entries.at(i));
+        } else {
+            entries.append(m_entries.at(i));
+        }
+    }
+    return entries;
+}
+
+bool TranslationDocumentStore::hasPendingChanges() const
+{
+    return m_firstDirty >= 0;
+}
+
+bool TranslationDocumentStore::flushToFile(const QString &filePath,
+                                           const Expander &expander,
+                                           int *rewrittenBlocks,
+                                           QString *errorMessage)
+{
+    if (rewrittenBlocks) {
+        *rewrittenBlocks = 0;
+    }
+
+    // 目标变了或文件被外部改动过（大小与记录不符）时无法按偏移修补，退回全量写出。
+    const bool fullRewrite = filePath != m_exportPath
+                             || QFileInfo(filePath).size() != m_exportedBytes;
+    if (!fullRewrite && m_firstDirty < 0) {
+        return true;
+    }
+
+    // 布局内的脏位置：字节长度与块数都不变时就地覆盖，否则从该位置起重写尾部。
+    // 布局末尾之后的位置上次均无译文，从布局末尾接着写即可。
+    QVector<QPair<qint64, QByteArray>> patches;
+    int written = 0;
+    int start = 0;
+    if (!fullRewrite) {
+        start = m_layoutEnd;
+        const int lastDirty = qMin(m_lastDirty, m_layoutEnd - 1);
+        for (int i = m_firstDirty; i <= lastDirty; ++i) {
+            if (!m_dirty.testBit(i)) {
+                continue;
+            }
+            const bool lastInLayout = i + 1 >= m_layoutEnd;
+            const qint64 oldLength = (lastInLayout ? m_exportedBytes : m_blockOffsets.at(i + 1)) - m_blockOffsets.at(i);
+            const int oldBlocks = (lastInLayout ? m_exportedBlocks + 1 : m_blockNumbers.at(i + 1)) - m_blockNumbers.at(i);
+            int blocks = 0;
+            const QByteArray bytes = serializePosition(i, m_blockNumbers.at(i), expander, &blocks);
+            if (bytes.size() != oldLength || blocks != oldBlocks) {
+                start = i;
+                break;
+            }
+            if (!bytes.isEmpty()) {
+                patches.append(qMakePair(m_blockOffsets.at(i), bytes));
+                written += blocks;
+            }
+        }
+    }
+
+    qint64 offset = 0;
+    int number = 1;
+    if (!fullRewrite) {
+        if (start < m_layoutEnd) {
+            offset = m_blockOffsets.at(start);
+            number = m_blockNumbers.at(start);
+        } else {
+            offset = m_exportedBytes;
+            number = m_exportedBlocks + 1;
+        }
+    }
+
+    QByteArray payload;
+    for (int i = start; i <= m_lastPresent; ++i) {
+        m_blockOffsets[i] = offset + payload.size();
+        m_blockNumbers[i] = number;
+        int blocks = 0;
+        payload.append(serializePosition(i, number, expander, &blocks));
+        number += blocks;
+        written += blocks;
+    }
+
+    QFile file(filePath);
+    const QIODevice::OpenMode mode = fullRewrite ? (QIODevice::WriteOnly | QIODevice::Truncate)
+                                                 : QIODevice::ReadWrite;
+    bool ok = file.open(mode);
+    for (int i = 0; ok && i < patches.size(); ++i) {
+        ok = file.seek(patches.at(i).first) && file.write(patches.at(i).second) == patches.at(i).second.size();
+    }
+    const bool tailChanged = fullRewrite || !payload.isEmpty() || offset != m_exportedBytes;
+    if (ok && tailChanged) {
+        ok = (fullRewrite || (file.resize(offset) && file.seek(offset))) && file.write(payload) == payload.size();
+    }
+    if (!ok) {
+        if (errorMessage) {
+            *errorMessage = file.errorString();
+        }
+        invalidateExport();
+        return false;
+    }
+    file.close();
+
+    m_exportPath = filePath;
+    if (tailChanged) {
+        m_layoutEnd = qMax(start, m_lastPresent + 1);
+        m_exportedBytes = offset + payload.size();
+        m_exportedBlocks = number - 1;
+    }
+    if (m_firstDirty >= 0) {
+        m_dirty.fill(false, m_firstDirty, m_lastDirty + 1);
+        m_firstDirty = -1;
+        m_lastDirty = -1;
+    }
+    if (rewrittenBlocks) {
+        *rewrittenBlocks = written;
+    }
+    return true;
+}
+
+int TranslationDocumentStore::exportedBlockCount() const
+{
+    return m_exportedBlocks;
+}
+
+void TranslationDocumentStore::invalidateExport()
+{
+    m_exportPath.clear();
+    m_layoutEnd = 0;
+    m_exportedBytes = 0;
+    m_exportedBlocks = 0;
+}
+
+void TranslationDocumentStore::markDirty(int position)
+{
+    m_dirty.setBit(position);
+    if (m_firstDirty < 0 || position < m_firstDirty) {
+        m_firstDirty = position;
+    }
+    m_lastDirty = qMax(m_lastDirty, position);
+}
+
+QByteArray TranslationDocumentStore::serializePosition(int position,
+                                                       int firstNumber,
+                                                       const Expander &expander,
+                                                       int *blockCount) const
+{
+    *blockCount = 0;
+    if (!m_present.testBit(position)) {
+        return QByteArray();
+    }
+
+    QVector<SubtitleEntry> blocks;
+    if (expander) {
+        blocks = expander(position, m_entries.at(position));
+    } else {
+        blocks.append(m_entries.at(position));
+    }
+    QByteArray bytes;
+    int number = firstNumber;
+    for (const SubtitleEntry &block : blocks) {
+        if (number > 1) {
+            bytes.append("\n\n");
+        }
+        bytes.append(serializeBlock(number, block));
+        ++number;
+    }
+    *blockCount = blocks.size();
+    return bytes;
+}
+
+QByteArray TranslationDocumentStore::serializeBlock(int number, const SubtitleEntry &entry)
+{
+    const QString startToken = entry.startText.isEmpty() ? SubtitleTimeline::fromMs(entry.startMs)
+                                                         : SubtitleTimeline::normalizeToken(entry.startText);
+    const QString endToken = entry.endText.isEmpty() ? SubtitleTimeline::fromMs(entry.endMs)
+                                                     : SubtitleTimeline::normalizeToken(entry.endText);
+    return QStringLiteral("%1\n%2 --> %3\n%4")
+        .arg(number)
+        .arg(startToken, endToken, entry.text.trimmed())
+        .toUtf8();
+}
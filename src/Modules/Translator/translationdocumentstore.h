@@ -0,0 +1,71 @@
+#ifndef TRANSLATIONDOCUMENTSTORE_H
+#define TRANSLATIONDOCUMENTSTORE_H
+
+#include "subtitleentry.h"
+
+#include <QBitArray>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+// 译文文档：按源条目下标存放译文（与源条目等长的扁平数组），开始时间相同的条目互不覆盖。
+// 写入 / 清除的位置记入脏位图；导出时按位图只重写脏位置：字节长度与块数不变的就地覆盖，
+// 首个长度变化的脏位置起截断并重写其后部分。按序提交时即为追加，导出代价与变化量成正比。
+class TranslationDocumentStore
+{
+public:
+    // 将一个位置的译文展开为写出的条目（合并碎句时切回多条原条目）；未设置时原样写出一条。
+    using Expander = std::function<QVector<SubtitleEntry>(int position, const SubtitleEntry &entry)>;
+
+    // 清空译文与导出布局，按源条目数重新分配。
+    void reset(int entryCount);
+    // 扩充到 entryCount 条（源条目逐段到达时）；已有译文与导出布局保留，新位置之后接着追加写出。
+    void grow(int entryCount);
+    int size() const;
+    int translatedCount() const;
+    bool isEmpty() const;
+    bool hasEntry(int position) const;
+    const SubtitleEntry &entryAt(int position) const;
+    void setEntry(int position, const SubtitleEntry &entry);
+    void clearEntry(int position);
+    // 按源顺序返回全部已有译文（展开后）。
+    QVector<SubtitleEntry> translatedEntries(const Expander &expander = Expander()) const;
+
+    bool hasPendingChanges() const;
+    // 将变化写入 filePath：目标路径与上次不同时全量写出；否则就地覆盖长度不变的脏位置，
+    // 从首个长度变化的脏位置起截断后重写（无变化时不动文件）。
+    // rewrittenBlocks 为本次实际序列化的字幕块数。
+    bool flushToFile(const QString &filePath,
+                     const Expander &expander,
+                     int *rewrittenBlocks,
+                     QString *errorMessage);
+    // 目标文件中的字幕块数（展开后）。
+    int exportedBlockCount() const;
+    // 放弃导出布局，下次写出时全量重写。
+    void invalidateExport();
+
+private:
+    void markDirty(int position);
+    // 位置 position 写出的字节（首块之前的空行分隔在内）与块数，首块序号为 firstNumber。
+    QByteArray serializePosition(int position, int firstNumber, const Expander &expander, int *blockCount) const;
+    static QByteArray serializeBlock(int number, const SubtitleEntry &entry);
+
+    QVector<SubtitleEntry> m_entries;
+    QBitArray m_present;
+    QBitArray m_dirty;
+    int m_firstDirty = -1;
+    int m_lastDirty = -1;
+    int m_lastPresent = -1;
+    int m_translatedCount = 0;
+
+    // 已写出文件的布局：位置 i 的首个字节偏移与首块序号，对 [0, m_layoutEnd) 有效。
+    QString m_exportPath;
+    QVector<qint64> m_blockOffsets;
+    QVector<int> m_blockNumbers;
+    int m_layoutEnd = 0;
+    qint64 m_exportedBytes = 0;
+    int m_exportedBlocks = 0;
+};
+
+#endif // TRANSLATIONDOCUMENTSTORE_H
@@ -0,0 +1,52 @@
+#include "translationmemory.h"
+
+void TranslationMemory::clear()
+{
+    m_translationsByLanguage.clear();
+}
+
+void TranslationMemory::insert(const QString &language, const QString &sourceText, const QString &translation)
+{
+    const QString key = normalizeSource(sourceText);
+    const QString value = translation.trimmed();
+    if (key.isEmpty() || value.isEmpty()) {
+        return;
+    }
+    m_translationsByLanguage[language].insert(key, value);
+}
+
+bool TranslationMemory::lookup(const QString &language, const QString &sourceText, QString *translation) const
+{
+    const auto languageIt = m_translationsByLanguage.constFind(language);
+    if (languageIt == m_translationsByLanguage.constEnd()) {
+        return false;
+    }
+
+    const QString key = normalizeSource(sourceText);
+    if (key.isEmpty()) {
+        return false;
+    }
+
+    const auto it = languageIt->constFind(key);
+    if (it == languageIt->constEnd()) {
+        return false;
+    }
+    if (translation) {
+        *translation = it.value();
+    }
+    return true;
+}
+
+int TranslationMemory::size() const
+{
+    int total = 0;
+    for (auto it = m_translationsByLanguage.constBegin(); it != m_translationsByLanguage.constEnd(); ++it) {
+        total += it->size();
+    }
+    return total;
+}
+
+QString TranslationMemory::normalizeSource(const QString &text)
+{
+    return text.simplified();
+}
@@ -0,0 +1,25 @@
+#ifndef TRANSLATIONMEMORY_H
+#define TRANSLATIONMEMORY_H
+
+#include <QHash>
+#include <QString>
+
+// 翻译记忆：按（目标语言，规范化原文）精确匹配，复用已完成的译文。
+// 字幕中重复台词（应答、口头禅、片头片尾）较多，命中的条目不再发送给模型。
+class TranslationMemory
+{
+public:
+    void clear();
+    void insert(const QString &language, const QString &sourceText, const QString &translation);
+    bool lookup(const QString &language, const QString &sourceText, QString *translation) const;
+    // 全部语言的记忆条数。
+    int size() const;
+
+    // 去首尾空白并合并连续空白；结果为空的原文不参与匹配。
+    static QString normalizeSource(const QString &text);
+
+private:
+    QHash<QString, QHash<QString, QString>> m_translationsByLanguage;
+};
+
+#endif // TRANSLATIONMEMORY_H
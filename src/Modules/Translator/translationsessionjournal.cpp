@@ -0,0 +1,326 @@
+#include "translationsessionjournal.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+namespace {
+const int kJournalVersion = 1;
+
+QJsonArray toJsonArray(const QStringList &values)
+{
+    QJsonArray array;
+    for (const QString &value : values) {
+        array.append(value);
+    }
+    return array;
+}
+}
+
+QJsonObject TranslationSessionJournal::SessionHeader::toJson() const
+{
+    QJsonObject object;
+    object.insert(QStringLiteral("version"), kJournalVersion);
+    object.insert(QStringLiteral("sourceHash"), sourceHash);
+    object.insert(QStringLiteral("sourcePath"), sourcePath);
+    object.insert(QStringLiteral("entryCount"), entryCount);
+    object.insert(QStringLiteral("chunkSize"), chunkSize);
+    object.insert(QStringLiteral("model"), model);
+    object.insert(QStringLiteral("targetLanguage"), targetLanguage);
+    object.insert(QStringLiteral("extraLanguages"), toJsonArray(extraLanguages));
+    object.insert(QStringLiteral("sentenceRegroup"), sentenceRegroup);
+    object.insert(QStringLiteral("concurrent"), concurrent);
+    return object;
+}
+
+TranslationSessionJournal::SessionHeader TranslationSessionJournal::SessionHeader::fromJson(const QJsonObject &object)
+{
+    SessionHeader header;
+    header.sourceHash = object.value(QStringLiteral("sourceHash")).toString();
+    header.sourcePath = object.value(QStringLiteral("sourcePath")).toString();
+    header.entryCount = object.value(QStringLiteral("entryCount")).toInt();
+    header.chunkSize = object.value(QStringLiteral("chunkSize")).toInt();
+    header.model = object.value(QStringLiteral("model")).toString();
+    header.targetLanguage = object.value(QStringLiteral("targetLanguage")).toString();
+    const QJsonArray extraLanguages = object.value(QStringLiteral("extraLanguages")).toArray();
+    for (const QJsonValue &value : extraLanguages) {
+        header.extraLanguages.append(value.toString());
+    }
+    header.sentenceRegroup = object.value(QStringLiteral("sentenceRegroup")).toBool();
+    header.concurrent = object.value(QStringLiteral("concurrent")).toBool();
+    return header;
+}
+
+int TranslationSessionJournal::RecoveredSession::committedCount(const QString &language) const
+{
+    return entriesByLanguage.value(language).size();
+}
+
+QString TranslationSessionJournal::journalDirectory()
+{
+    return QDir::currentPath() + "/temp/translator_sessions";
+}
+
+QString TranslationSessionJournal::journalPathForHash(const QString &sourceHash)
+{
+    return QDir(journalDirectory()).filePath(sourceHash + QStringLiteral(".jsonl"));
+}
+
+QString TranslationSessionJournal::hashSource(const QByteArray &content)
+{
+    return QString::fromLatin1(QCryptographicHash::hash(content, QCryptographicHash::Sha1).toHex());
+}
+
+TranslationSessionJournal::RecoveredSession TranslationSessionJournal::load(const QString &sourceHash)
+{
+    RecoveredSession session;
+    QFile file(journalPathForHash(sourceHash));
+    if (sourceHash.isEmpty() || !file.open(QIODevice::ReadOnly)) {
+        return session;
+    }
+
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        QJsonParseError parseError;
+        const QJsonDocument document = QJsonDocument::fromJson(line, &parseError);
+        if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+            continue;
+        }
+
+        const QJsonObject record = document.object();
+        const QString type = record.value(QStringLiteral("type")).toString();
+        if (type == QStringLiteral("session")) {
+            session = RecoveredSession();
+            session.header = SessionHeader::fromJson(record);
+            session.valid = session.header.sourceHash == sourceHash;
+            continue;
+        }
+        if (!session.valid) {
+            continue;
+        }
+
+        if (type == QStringLiteral("resume")) {
+            session.header = SessionHeader::fromJson(record);
+        } else if (type == QStringLiteral("commit")) {
+            QMap<int, SubtitleEntry> &entries = session.entriesByLanguage[record.value(QStringLiteral("language")).toString()];
+            const QJsonArray items = record.value(QStringLiteral("entries")).toArray();
+            for (const QJsonValue &value : items) {
+                const QJsonObject item = value.toObject();
+                SubtitleEntry entry;
+                entry.startMs = static_cast<qint64>(item.value(QStringLiteral("start")).toDouble());
+                entry.endMs = static_cast<qint64>(item.value(QStringLiteral("end")).toDouble());
+                entry.startText = SubtitleTimeline::fromMs(entry.startMs);
+                entry.endText = SubtitleTimeline::fromMs(entry.endMs);
+                entry.text = item.value(QStringLiteral("text")).toString();
+                const int position = item.value(QStringLiteral("position")).toInt(-1);
+                if (position >= 0) {
+                    entry.index = position + 1;
+                    entries.insert(position, entry);
+                }
+            }
+            session.completed = false;
+        } else if (type == QStringLiteral("clear")) {
+            QMap<int, SubtitleEntry> &entries = session.entriesByLanguage[record.value(QStringLiteral("language")).toString()];
+            const QJsonArray positions = record.value(QStringLiteral("positions")).toArray();
+            for (const QJsonValue &value : positions) {
+                entries.remove(value.toInt(-1));
+            }
+            session.completed = false;
+        } else if (type == QStringLiteral("source")) {
+            session.source.clear();
+            const QJsonArray cues = record.value(QStringLiteral("cues")).toArray();
+            session.source.reserve(cues.size());
+            for (const QJsonValue &value : cues) {
+                const QJsonArray cue = value.toArray();
+                SourceFingerprint fingerprint;
+                fingerprint.startMs = static_cast<qint64>(cue.at(0).toDouble());
+                fingerprint.endMs = static_cast<qint64>(cue.at(1).toDouble());
+                fingerprint.textHash = cue.at(2).toString();
+                session.source.append(fingerprint);
+            }
+        } else if (type == QStringLiteral("export")) {
+            session.exportPath = record.value(QStringLiteral("path")).toString();
+        } else if (type == QStringLiteral("completed")) {
+            session.completed = true;
+        }
+    }
+    return session;
+}
+
+QString TranslationSessionJournal::findLatestForSource(const QString &sourcePath, const QString &excludeHash)
+{
+    const QFileInfoList journals = QDir(journalDirectory()).entryInfoList(QStringList() << QStringLiteral("*.jsonl"),
+                                                                          QDir::Files,
+                                                                          QDir::Time);
+    for (const QFileInfo &info : journals) {
+        if (info.completeBaseName() == excludeHash) {
+            continue;
+        }
+
+        QFile file(info.absoluteFilePath());
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        const QJsonObject record = QJsonDocument::fromJson(file.readLine().trimmed()).object();
+        if (record.value(QStringLiteral("type")).toString() == QStringLiteral("session")
+            && record.value(QStringLiteral("sourcePath")).toString() == sourcePath) {
+            return record.value(QStringLiteral("sourceHash")).toString();
+        }
+    }
+    return QString();
+}
+
+bool TranslationSessionJournal::begin(const SessionHeader &header,
+                                      const QVector<SourceFingerprint> &source,
+                                      QString *errorMessage)
+{
+    if (!open(QIODevice::WriteOnly | QIODevice::Truncate, header.sourceHash, errorMessage)) {
+        return false;
+    }
+    QJsonObject record = header.toJson();
+    record.insert(QStringLiteral("type"), QStringLiteral("session"));
+    record.insert(QStringLiteral("createdAt"), QDateTime::currentDateTime().toString(Qt::ISODate));
+    appendRecord(record);
+
+    QJsonArray cues;
+    for (const SourceFingerprint &fingerprint : source) {
+        QJsonArray cue;
+        cue.append(static_cast<double>(fingerprint.startMs));
+        cue.append(static_cast<double>(fingerprint.endMs));
+        cue.append(fingerprint.textHash);
+        cues.append(cue);
+    }
+    QJsonObject sourceRecord;
+    sourceRecord.insert(QStringLiteral("type"), QStringLiteral("source"));
+    sourceRecord.insert(QStringLiteral("cues"), cues);
+    appendRecord(sourceRecord);
+    return true;
+}
+
+bool TranslationSessionJournal::resume(const SessionHeader &header, QString *errorMessage)
+{
+    // 上次异常退出时末行可能写了一半，先补换行，避免与新记录粘成一行。
+    bool needsLineBreak = false;
+    QFile existing(journalPathForHash(header.sourceHash));
+    if (existing.open(QIODevice::ReadOnly) && existing.size() > 0 && existing.seek(existing.size() - 1)) {
+        needsLineBreak = existing.read(1) != QByteArray("\n");
+    }
+    existing.close();
+
+    if (!open(QIODevice::WriteOnly | QIODevice::Append, header.sourceHash, errorMessage)) {
+        return false;
+    }
+    if (needsLineBreak) {
+        m_file.write("\n");
+    }
+    QJsonObject record = header.toJson();
+    record.insert(QStringLiteral("type"), QStringLiteral("resume"));
+    record.insert(QStringLiteral("resumedAt"), QDateTime::currentDateTime().toString(Qt::ISODate));
+    appendRecord(record);
+    return true;
+}
+
+void TranslationSessionJournal::recordCommit(const QString &language, const QVector<QPair<int, SubtitleEntry>> &entries)
+{
+    if (entries.isEmpty()) {
+        return;
+    }
+
+    QJsonArray items;
+    for (const QPair<int, SubtitleEntry> &pair : entries) {
+        QJsonObject item;
+        item.insert(QStringLiteral("position"), pair.first);
+        item.insert(QStringLiteral("start"), static_cast<double>(pair.second.startMs));
+        item.insert(QStringLiteral("end"), static_cast<double>(pair.second.endMs));
+        item.insert(QStringLiteral("text"), pair.second.text);
+        items.append(item);
+    }
+
+    QJsonObject record;
+    record.insert(QStringLiteral("type"), QStringLiteral("commit"));
+    record.insert(QStringLiteral("language"), language);
+    record.insert(QStringLiteral("entries"), items);
+    appendRecord(record);
+}
+
+void TranslationSessionJournal::recordClear(const QString &language, const QVector<int> &positions)
+{
+    if (positions.isEmpty()) {
+        return;
+    }
+
+    QJsonArray items;
+    for (int position : positions) {
+        items.append(position);
+    }
+
+    QJsonObject record;
+    record.insert(QStringLiteral("type"), QStringLiteral("clear"));
+    record.insert(QStringLiteral("language"), language);
+    record.insert(QStringLiteral("positions"), items);
+    appendRecord(record);
+}
+
+void TranslationSessionJournal::recordExportPath(const QString &exportPath)
+{
+    QJsonObject record;
+    record.insert(QStringLiteral("type"), QStringLiteral("export"));
+    record.insert(QStringLiteral("path"), exportPath);
+    appendRecord(record);
+}
+
+void TranslationSessionJournal::recordCompleted()
+{
+    QJsonObject record;
+    record.insert(QStringLiteral("type"), QStringLiteral("completed"));
+    appendRecord(record);
+}
+
+bool TranslationSessionJournal::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+void TranslationSessionJournal::close()
+{
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+}
+
+bool TranslationSessionJournal::open(QIODevice::OpenMode mode, const QString &sourceHash, QString *errorMessage)
+{
+    close();
+    if (sourceHash.isEmpty() || !QDir().mkpath(journalDirectory())) {
+        if (errorMessage) {
+            *errorMessage = tr("会话日志目录无法创建：%1").arg(journalDirectory());
+        }
+        return false;
+    }
+
+    m_file.setFileName(journalPathForHash(sourceHash));
+    if (!m_file.open(mode)) {
+        if (errorMessage) {
+            *errorMessage = m_file.errorString();
+        }
+        return false;
+    }
+    return true;
+}
+
+void TranslationSessionJournal::appendRecord(const QJsonObject &record)
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+    m_file.write(QJsonDocument(record).toJson(QJsonDocument::Compact));
+    m_file.write("\n");
+    m_file.flush();
+}
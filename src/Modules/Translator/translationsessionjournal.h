@@ -0,0 +1,80 @@
+#ifndef TRANSLATIONSESSIONJOURNAL_H
+#define TRANSLATIONSESSIONJOURNAL_H
+
+#include "sourceeditdiff.h"
+#include "subtitleentry.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonObject>
+#include <QMap>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// 翻译会话日志：每个源文件（按内容哈希）一份只追加的 JSONL，记录任务配置、分块方案与每次提交的译文。
+// 每行写入后立即 flush；崩溃时最后一行可能不完整，读取时跳过无法解析的行。
+class TranslationSessionJournal
+{
+    Q_DECLARE_TR_FUNCTIONS(TranslationSessionJournal)
+
+public:
+    struct SessionHeader
+    {
+        QString sourceHash;
+        QString sourcePath;
+        // 翻译单位条数（合并碎句时为句子单元数）与分块大小。
+        int entryCount = 0;
+        int chunkSize = 0;
+        QString model;
+        QString targetLanguage;
+        QStringList extraLanguages;
+        bool sentenceRegroup = false;
+        bool concurrent = false;
+
+        QJsonObject toJson() const;
+        static SessionHeader fromJson(const QJsonObject &object);
+    };
+
+    struct RecoveredSession
+    {
+        bool valid = false;
+        SessionHeader header;
+        QString exportPath;
+        bool completed = false;
+        // 按目标语言名分组，键为源条目位置。
+        QMap<QString, QMap<int, SubtitleEntry>> entriesByLanguage;
+        // 会话开始时各源条目的指纹（源文件修改后据此比对）。
+        QVector<SourceFingerprint> source;
+
+        int committedCount(const QString &language) const;
+    };
+
+    static QString journalDirectory();
+    static QString journalPathForHash(const QString &sourceHash);
+    static QString hashSource(const QByteArray &content);
+    // 读取某个源文件最近一次会话；没有日志或首行无效时 valid 为 false。
+    static RecoveredSession load(const QString &sourceHash);
+    // 同一路径的源文件最近一次会话的内容哈希（排除 excludeHash）；仅读取各日志首行。
+    static QString findLatestForSource(const QString &sourcePath, const QString &excludeHash);
+
+    // 新会话：截断旧日志，写入会话头与源条目指纹。
+    bool begin(const SessionHeader &header, const QVector<SourceFingerprint> &source, QString *errorMessage);
+    // 续接已有日志：追加一条 resume 记录（更新会话头，不清除已提交译文）。
+    bool resume(const SessionHeader &header, QString *errorMessage);
+    void recordCommit(const QString &language, const QVector<QPair<int, SubtitleEntry>> &entries);
+    void recordClear(const QString &language, const QVector<int> &positions);
+    void recordExportPath(const QString &exportPath);
+    void recordCompleted();
+    bool isOpen() const;
+    void close();
+
+private:
+    bool open(QIODevice::OpenMode mode, const QString &sourceHash, QString *errorMessage);
+    void appendRecord(const QJsonObject &record);
+
+    QFile m_file;
+};
+
+#endif // TRANSLATIONSESSIONJOURNAL_H
@@ -0,0 +1,1183 @@
+#include "translationtaskrunner.h"
+
+#include "apiformatmanager.h"
+#include "llmbatchclient.h"
+#include "modelroutingpolicy.h"
+#include "promptrequestcomposer.h"
+#include "segmentwirecodec.h"
+#include "translationbackend.h"
+
+#include <QStringList>
+
+#include <algorithm>
+
+namespace {
+// 单块缺失条目的最大补译次数，与交互流程一致。
+const int kMaxChunkRepairAttempts = 2;
+// 单块请求失败（端点池已无可切换端点）后的整块重发次数。
+const int kMaxChunkFailedAttempts = 2;
+// 已发出但未提交的分块窗口（按并发数倍数），避免首块过慢时无限堆积后续结果。
+const int kCommitWindowFactor = 4;
+}
+
+TranslationTaskRunner::TranslationTaskRunner(LlmServiceClient *client, QObject *parent)
+    : QObject(parent)
+    , m_client(client)
+{
+    connect(m_client, &LlmServiceClient::chatCompleted, this, &TranslationTaskRunner::onChatCompleted);
+    connect(m_client, &LlmServiceClient::streamChunkReceived, this, &TranslationTaskRunner::onStreamChunkReceived);
+    connect(m_client, &LlmServiceClient::requestFailed, this, &TranslationTaskRunner::onRequestFailed);
+    connect(m_client, &LlmServiceClient::requestRestarted, this, &TranslationTaskRunner::onRequestRestarted);
+    connect(m_client, &LlmServiceClient::chatMetricsMeasured, this, &TranslationTaskRunner::onChatMetricsMeasured);
+
+    m_polishClient = m_client;
+    connectPolishClient(true);
+}
+
+void TranslationTaskRunner::setPolishClient(LlmServiceClient *client)
+{
+    LlmServiceClient *target = client ? client : m_client;
+    if (m_running || target == m_polishClient) {
+        return;
+    }
+
+    connectPolishClient(false);
+    m_polishClient = target;
+    connectPolishClient(true);
+}
+
+void TranslationTaskRunner::connectPolishClient(bool connectSignals)
+{
+    if (!connectSignals) {
+        disconnect(m_polishClient, &LlmServiceClient::chatCompleted, this, &TranslationTaskRunner::onPolishChatCompleted);
+        disconnect(m_polishClient, &LlmServiceClient::streamChunkReceived, this, &TranslationTaskRunner::onPolishStreamChunkReceived);
+        disconnect(m_polishClient, &LlmServiceClient::requestFailed, this, &TranslationTaskRunner::onPolishRequestFailed);
+        disconnect(m_polishClient, &LlmServiceClient::requestRestarted, this, &TranslationTaskRunner::onPolishRequestRestarted);
+        return;
+    }
+
+    // 与翻译共用客户端时请求编号不会重复，两组槽各自只认领自己的编号。
+    connect(m_polishClient, &LlmServiceClient::chatCompleted, this, &TranslationTaskRunner::onPolishChatCompleted);
+    connect(m_polishClient, &LlmServiceClient::streamChunkReceived, this, &TranslationTaskRunner::onPolishStreamChunkReceived);
+    connect(m_polishClient, &LlmServiceClient::requestFailed, this, &TranslationTaskRunner::onPolishRequestFailed);
+    connect(m_polishClient, &LlmServiceClient::requestRestarted, this, &TranslationTaskRunner::onPolishRequestRestarted);
+}
+
+void TranslationTaskRunner::setBatchClient(LlmBatchClient *client)
+{
+    if (m_running || client == m_batchClient) {
+        return;
+    }
+
+    if (m_batchClient) {
+        disconnect(m_batchClient, nullptr, this, nullptr);
+    }
+    m_batchClient = client;
+    if (!m_batchClient) {
+        return;
+    }
+    connect(m_batchClient, &LlmBatchClient::batchCreated, this, &TranslationTaskRunner::onBatchCreated);
+    connect(m_batchClient, &LlmBatchClient::statusChanged, this, &TranslationTaskRunner::onBatchStatusChanged);
+    connect(m_batchClient, &LlmBatchClient::resultReady, this, &TranslationTaskRunner::onBatchResultReady);
+    connect(m_batchClient, &LlmBatchClient::resultFailed, this, &TranslationTaskRunner::onBatchResultFailed);
+    connect(m_batchClient, &LlmBatchClient::batchFinished, this, &TranslationTaskRunner::onBatchFinished);
+}
+
+void TranslationTaskRunner::setSharedMemory(TranslationMemory *memory)
+{
+    if (m_running) {
+        return;
+    }
+    m_sharedMemory = memory;
+}
+
+void TranslationTaskRunner::setBackend(TranslationBackend *backend)
+{
+    if (m_running || backend == m_backend) {
+        return;
+    }
+
+    if (m_backend) {
+        disconnect(m_backend, nullptr, this, nullptr);
+    }
+    m_backend = backend;
+    if (!m_backend) {
+        return;
+    }
+    connect(m_backend, &TranslationBackend::linesTranslated, this, &TranslationTaskRunner::onBackendLinesTranslated);
+    connect(m_backend, &TranslationBackend::linesFailed, this, &TranslationTaskRunner::onBackendLinesFailed);
+    connect(m_backend, &TranslationBackend::requestMeasured, this, &TranslationTaskRunner::onBackendRequestMeasured);
+}
+
+bool TranslationTaskRunner::isRunning() const
+{
+    return m_running;
+}
+
+void TranslationTaskRunner::startTask(const TranslationTaskRequest &request)
+{
+    if (m_running) {
+        return;
+    }
+
+    m_request = request;
+    m_request.chunkSize = qMax(1, m_request.chunkSize);
+    m_request.maxInFlight = qMax(1, m_request.maxInFlight);
+    m_request.polishMaxInFlight = qMax(1, m_request.polishMaxInFlight);
+    if (m_request.polishFormat == StreamingCueParser::InputFormat::SrtBlocks) {
+        m_request.polishFormat = StreamingCueParser::InputFormat::CompactLines;
+    }
+    if (m_request.languages.isEmpty()) {
+        TranslationTargetLanguage language;
+        language.systemPrompt = m_request.systemPrompt;
+        language.polishSystemPrompt = m_request.polishSystemPrompt;
+        m_request.languages.append(language);
+    }
+    m_chunks.clear();
+    m_chunkCount = 0;
+    m_plannedEntries = 0;
+    m_inputClosed = !m_request.openInput;
+    m_nextCommitByLanguage = QVector<int>(m_request.languages.size(), 0);
+    m_committedChunks = 0;
+    m_memory.clear();
+    m_memoryHits = 0;
+    m_fastRouteStats = RouteStats();
+    m_strongRouteStats = RouteStats();
+    m_request.fastModel = m_request.fastModel.trimmed();
+    if (m_request.fastModel == m_request.config.model || m_backend) {
+        m_request.fastModel.clear();
+    }
+    if (m_backend) {
+        // 后端按行返回译文，统一按紧凑行解析（保留条目编号，缺失条目可单独补译）。
+        m_request.responseFormat = StreamingCueParser::InputFormat::CompactLines;
+    }
+    m_chunkByRequestId.clear();
+    m_polishChunkByRequestId.clear();
+    m_chunkByBackendRequestId.clear();
+    m_batchMode = false;
+    m_chunkByBatchId.clear();
+    m_lastBatchStatus.clear();
+    m_fallbackChunks.clear();
+    m_pendingPolishChunks.clear();
+    m_polishInFlight = 0;
+    m_translatedChunks = 0;
+    m_translateStageMs = -1;
+    m_nextChunkToDispatch = 0;
+    m_inFlight = 0;
+    m_committedEntries = 0;
+    m_missingEntries = 0;
+
+    if ((m_request.entries.isEmpty() && m_inputClosed) || (!m_backend && !m_request.config.isValid())) {
+        emit taskFinished(false, tr("没有可翻译的条目或服务配置无效"));
+        return;
+    }
+
+    const int languageCount = m_request.languages.size();
+    planChunks();
+
+    if (m_request.batchApi && m_backend) {
+        emit taskLog(tr("已指定翻译后端 %1，批量接口不适用，改为逐块请求").arg(m_backend->name()));
+    } else if (m_request.batchApi && !m_inputClosed) {
+        emit taskLog(tr("源条目逐段到达，批量接口不适用，改为逐块在线请求"));
+    } else if (m_request.batchApi) {
+        const QString provider = ApiFormatManager::providerId(m_request.config.provider, m_request.config.normalizedBaseUrl());
+        if (!m_batchClient || m_batchClient->isActive() || !ApiFormatManager::supportsBatch(provider)) {
+            emit taskLog(tr("当前服务不支持批量接口（或已有批任务进行中），改为逐块在线请求"));
+        } else {
+            m_batchMode = true;
+            if (!m_request.fastModel.isEmpty()) {
+                emit taskLog(tr("批量接口同一批只使用主模型，本次不按难度分流"));
+                m_request.fastModel.clear();
+            }
+        }
+    }
+
+    m_running = true;
+    m_taskTimer.start();
+    emit taskStarted(m_chunkCount, languageCount);
+    if (!m_inputClosed) {
+        emit taskLog(tr("流式翻译开始：源条目逐段到达，每凑满 %1 条发出一个分块，最多 %2 个请求同时在途")
+                     .arg(m_request.chunkSize)
+                     .arg(m_request.maxInFlight));
+    } else if (languageCount > 1) {
+        QStringList languageNames;
+        for (const TranslationTargetLanguage &language : m_request.languages) {
+            languageNames.append(language.language);
+        }
+        emit taskLog(tr("多语言并发翻译开始：共 %1 条，%2 个分块 × %3 种语言（%4），最多 %5 个请求同时在途")
+                     .arg(m_request.entries.size())
+                     .arg(m_chunkCount)
+                     .arg(languageCount)
+                     .arg(languageNames.join(QStringLiteral("、")))
+                     .arg(m_request.maxInFlight));
+    } else {
+        emit taskLog(tr("并发翻译开始：共 %1 条，%2 个分块，最多 %3 个分块同时在途")
+                     .arg(m_request.entries.size())
+                     .arg(m_chunkCount)
+                     .arg(m_request.maxInFlight));
+    }
+    if (m_backend) {
+        emit taskLog(tr("分块请求经翻译后端 %1 发出").arg(m_backend->name()));
+    }
+    if (!m_request.fastModel.isEmpty()) {
+        emit taskLog(tr("按难度分流：简单分块使用 %1，其余使用 %2").arg(m_request.fastModel, m_request.config.model));
+    }
+    if (m_request.polishEnabled && !m_request.polishConfig.isValid()) {
+        m_request.polishEnabled = false;
+        emit taskLog(tr("润色服务配置无效，本次仅执行翻译阶段"));
+    } else if (m_request.polishEnabled) {
+        emit taskLog(tr("润色阶段与翻译并行：模型 %1，最多 %2 个分块同时润色")
+                     .arg(m_request.polishConfig.model)
+                     .arg(m_request.polishMaxInFlight));
+    }
+    if (m_batchMode) {
+        submitBatch();
+        return;
+    }
+    dispatchChunks();
+}
+
+void TranslationTaskRunner::cancelTask()
+{
+    if (!m_running) {
+        return;
+    }
+
+    finishTask(false, tr("任务已取消，已提交 %1/%2 条")
+                          .arg(m_committedEntries)
+                          .arg(m_request.entries.size() * m_request.languages.size()));
+}
+
+void TranslationTaskRunner::appendEntries(const QVector<SubtitleEntry> &entries)
+{
+    if (!m_running || m_inputClosed || entries.isEmpty()) {
+        return;
+    }
+
+    m_request.entries += entries;
+    planChunks();
+    dispatchChunks();
+}
+
+void TranslationTaskRunner::closeInput()
+{
+    if (!m_running || m_inputClosed) {
+        return;
+    }
+
+    m_inputClosed = true;
+    planChunks();
+    emit taskLog(tr("源条目已全部到达：共 %1 条，%2 个分块").arg(m_request.entries.size()).arg(m_chunkCount));
+    if (m_translatedChunks == m_chunks.size()) {
+        m_translateStageMs = m_taskTimer.elapsed();
+    }
+    // 末块为空（条目数恰为分块整数倍）时，此时可能已全部提交。
+    commitCompletedChunks();
+    dispatchChunks();
+}
+
+void TranslationTaskRunner::planChunks()
+{
+    // 各语言共用同一份分块划分；同一分块的各语言请求相邻发出，各语言进度同步推进。
+    const int languageCount = m_request.languages.size();
+    while (m_plannedEntries < m_request.entries.size()) {
+        const int count = qMin(m_request.chunkSize, m_request.entries.size() - m_plannedEntries);
+        if (count < m_request.chunkSize && !m_inputClosed) {
+            break;
+        }
+        for (int languageIndex = 0; languageIndex < languageCount; ++languageIndex) {
+            ChunkState chunk;
+            chunk.languageIndex = languageIndex;
+            chunk.startIndex = m_plannedEntries;
+            chunk.count = count;
+            m_chunks.append(chunk);
+        }
+        m_plannedEntries += count;
+        ++m_chunkCount;
+    }
+}
+
+int TranslationTaskRunner::chunkOrdinal(int chunkIndex) const
+{
+    return chunkIndex / qMax(1, m_request.languages.size());
+}
+
+QString TranslationTaskRunner::chunkLabel(int chunkIndex) const
+{
+    const ChunkState &chunk = m_chunks.at(chunkIndex);
+    if (m_request.languages.size() <= 1) {
+        return tr("第 %1 块").arg(chunkOrdinal(chunkIndex) + 1);
+    }
+    return tr("第 %1 块（%2）").arg(chunkOrdinal(chunkIndex) + 1).arg(languageOf(chunk).language);
+}
+
+const TranslationTargetLanguage &TranslationTaskRunner::languageOf(const ChunkState &chunk) const
+{
+    return m_request.languages.at(chunk.languageIndex);
+}
+
+bool TranslationTaskRunner::isChunkReady(const ChunkState &chunk) const
+{
+    return chunk.completed && chunk.polished;
+}
+
+TranslationMemory &TranslationTaskRunner::memory()
+{
+    return m_sharedMemory ? *m_sharedMemory : m_memory;
+}
+
+QVector<int> TranslationTaskRunner::applyTranslationMemory(int chunkIndex)
+{
+    ChunkState &chunk = m_chunks[chunkIndex];
+    QVector<int> ids;
+    ids.reserve(chunk.count);
+    const bool keyed = m_request.responseFormat != StreamingCueParser::InputFormat::SrtBlocks;
+    for (int i = 0; i < chunk.count; ++i) {
+        const int id = chunk.startIndex + i + 1;
+        QString translation;
+        if (keyed && memory().lookup(languageOf(chunk).language, m_request.entries.at(id - 1).text, &translation)) {
+            chunk.translationsById.insert(id, translation);
+            ++m_memoryHits;
+            continue;
+        }
+        ids.append(id);
+    }
+    return ids;
+}
+
+void TranslationTaskRunner::rememberChunk(const ChunkState &chunk)
+{
+    if (m_request.responseFormat == StreamingCueParser::InputFormat::SrtBlocks) {
+        return;
+    }
+
+    for (const SubtitleEntry &entry : chunk.translated) {
+        if (entry.index >= 1 && entry.index <= m_request.entries.size()) {
+            memory().insert(languageOf(chunk).language, m_request.entries.at(entry.index - 1).text, entry.text);
+        }
+    }
+}
+
+void TranslationTaskRunner::dispatchChunks()
+{
+    // 批内失败的分块先于新分块发出：它们序号靠前，阻塞着按序提交。
+    while (m_running && m_inFlight < m_request.maxInFlight && !m_fallbackChunks.isEmpty()) {
+        const int chunkIndex = m_fallbackChunks.takeFirst();
+        ++m_inFlight;
+        if (!sendChunkRequest(chunkIndex, m_chunks.at(chunkIndex).requestedIds, false)) {
+            finishTask(false, tr("%1请求未能发出，任务中止").arg(chunkLabel(chunkIndex)));
+            return;
+        }
+    }
+
+    const int commitWindow = m_request.maxInFlight * kCommitWindowFactor;
+    while (m_running && m_inFlight < m_request.maxInFlight && m_nextChunkToDispatch < m_chunks.size()) {
+        // 提交窗口以进度最慢的语言为准。
+        int oldestUncommitted = m_chunks.size();
+        for (int languageIndex = 0; languageIndex < m_nextCommitByLanguage.size(); ++languageIndex) {
+            oldestUncommitted = qMin(oldestUncommitted,
+                                     m_nextCommitByLanguage.at(languageIndex) * m_request.languages.size() + languageIndex);
+        }
+        if (m_nextChunkToDispatch - oldestUncommitted >= commitWindow) {
+            break;
+        }
+
+        const int chunkIndex = m_nextChunkToDispatch++;
+        const QVector<int> ids = applyTranslationMemory(chunkIndex);
+        ++m_inFlight;
+        if (ids.isEmpty()) {
+            // 整块命中翻译记忆，无需请求。
+            buildKeyedTranslatedEntries(m_chunks[chunkIndex]);
+            completeChunk(chunkIndex);
+            continue;
+        }
+        routeChunk(chunkIndex, ids);
+        if (!sendChunkRequest(chunkIndex, ids, false)) {
+            finishTask(false, tr("%1请求未能发出，任务中止").arg(chunkLabel(chunkIndex)));
+            return;
+        }
+    }
+}
+
+void TranslationTaskRunner::routeChunk(int chunkIndex, const QVector<int> &ids)
+{
+    ChunkState &chunk = m_chunks[chunkIndex];
+    if (m_request.fastModel.isEmpty()) {
+        chunk.fastRoute = false;
+        return;
+    }
+
+    QStringList texts;
+    texts.reserve(ids.size());
+    for (int id : ids) {
+        texts.append(m_request.entries.at(id - 1).text);
+    }
+    const ChunkDifficulty difficulty = ModelRoutingPolicy::assess(texts, chunk.count - ids.size(), m_request.routingThreshold);
+    chunk.fastRoute = !difficulty.hard;
+}
+
+QString TranslationTaskRunner::routingReport() const
+{
+    const auto perEntry = [](const RouteStats &stats) {
+        return stats.entries > 0 ? static_cast<double>(stats.requestMs) / stats.entries : -1.0;
+    };
+    const double fastPerEntry = perEntry(m_fastRouteStats);
+    const double strongPerEntry = perEntry(m_strongRouteStats);
+    const auto formatPerEntry = [](double value) {
+        return value < 0 ? QStringLiteral("-") : QString::number(value, 'f', 0);
+    };
+
+    QString report = tr("模型分流：%1 处理 %2 块 / %3 条（平均 %4 ms/条），%5 处理 %6 块 / %7 条（平均 %8 ms/条）")
+                         .arg(m_request.fastModel)
+                         .arg(m_fastRouteStats.chunks)
+                         .arg(m_fastRouteStats.entries)
+                         .arg(formatPerEntry(fastPerEntry))
+                         .arg(m_request.config.model)
+                         .arg(m_strongRouteStats.chunks)
+                         .arg(m_strongRouteStats.entries)
+                         .arg(formatPerEntry(strongPerEntry));
+    if (fastPerEntry >= 0 && strongPerEntry >= 0) {
+        // 简单分块若交给主模型，按主模型每条平均耗时估算；难度不同，只作量级参考。
+        const double savedMs = m_fastRouteStats.entries * (strongPerEntry - fastPerEntry);
+        report += tr("；估计节省请求耗时 %1 s").arg(QString::number(savedMs / 1000.0, 'f', 1));
+    }
+    return report;
+}
+
+QJsonArray TranslationTaskRunner::prepareChunkRequest(int chunkIndex, const QVector<int> &ids, bool repairRequest)
+{
+    ChunkState &chunk = m_chunks[chunkIndex];
+    chunk.requestedIds = ids;
+    chunk.repairRequest = repairRequest;
+    chunk.parser.reset();
+    if (m_request.responseFormat != StreamingCueParser::InputFormat::SrtBlocks) {
+        chunk.parser.setKeyedFormat(m_request.responseFormat, timelineFor(ids));
+    }
+
+    return PromptRequestComposer::buildPrefixCachedMessages(languageOf(chunk).systemPrompt,
+                                                            buildChunkContent(chunkIndex, ids, repairRequest));
+}
+
+bool TranslationTaskRunner::sendChunkRequest(int chunkIndex, const QVector<int> &ids, bool repairRequest)
+{
+    if (m_backend) {
+        return sendBackendRequest(chunkIndex, ids, repairRequest);
+    }
+
+    const QJsonArray messages = prepareChunkRequest(chunkIndex, ids, repairRequest);
+    ChunkState &chunk = m_chunks[chunkIndex];
+    LlmServiceConfig config = m_request.config;
+    if (chunk.fastRoute && !repairRequest) {
+        config.model = m_request.fastModel;
+    }
+    const quint64 requestId = m_client->requestChatCompletion(config,
+                                                              messages,
+                                                              m_request.options,
+                                                              m_request.responseSchema);
+    if (requestId == 0) {
+        chunk.requestId = 0;
+        return false;
+    }
+
+    chunk.requestId = requestId;
+    m_chunkByRequestId.insert(requestId, chunkIndex);
+    return true;
+}
+
+bool TranslationTaskRunner::sendBackendRequest(int chunkIndex, const QVector<int> &ids, bool repairRequest)
+{
+    prepareChunkRequest(chunkIndex, ids, repairRequest);
+    ChunkState &chunk = m_chunks[chunkIndex];
+    TranslationLineBatch batch;
+    batch.lines.reserve(ids.size());
+    for (int id : ids) {
+        batch.lines.append(m_request.entries.at(id - 1).text);
+    }
+    batch.sourceLanguage = m_request.sourceLanguage;
+    batch.targetLanguage = languageOf(chunk).language;
+    batch.systemPrompt = languageOf(chunk).systemPrompt;
+
+    const quint64 requestId = m_backend->translateLines(batch);
+    chunk.requestId = requestId;
+    if (requestId == 0) {
+        return false;
+    }
+    m_chunkByBackendRequestId.insert(requestId, chunkIndex);
+    return true;
+}
+
+void TranslationTaskRunner::submitBatch()
+{
+    QVector<LlmBatchRequest> requests;
+    requests.reserve(m_chunks.size());
+    for (int chunkIndex = 0; m_running && chunkIndex < m_chunks.size(); ++chunkIndex) {
+        const QVector<int> ids = applyTranslationMemory(chunkIndex);
+        if (ids.isEmpty()) {
+            ++m_inFlight;
+            buildKeyedTranslatedEntries(m_chunks[chunkIndex]);
+            completeChunk(chunkIndex);
+            continue;
+        }
+
+        LlmBatchRequest request;
+        request.customId = QStringLiteral("chunk-%1").arg(chunkIndex);
+        request.messages = prepareChunkRequest(chunkIndex, ids, false);
+        request.options = m_request.options;
+        request.responseSchema = m_request.responseSchema;
+        requests.append(request);
+        m_chunkByBatchId.insert(request.customId, chunkIndex);
+    }
+    m_nextChunkToDispatch = m_chunks.size();
+    if (!m_running || requests.isEmpty()) {
+        return;
+    }
+
+    if (!m_batchClient->submit(m_request.config, requests)) {
+        emit taskLog(tr("批任务未能提交，改为逐块在线请求"));
+        fallBackFromBatch();
+        return;
+    }
+    emit taskLog(tr("正在上传批量请求文件：%1 个请求").arg(requests.size()));
+}
+
+void TranslationTaskRunner::fallBackFromBatch()
+{
+    m_fallbackChunks += m_chunkByBatchId.values();
+    m_chunkByBatchId.clear();
+    std::sort(m_fallbackChunks.begin(), m_fallbackChunks.end());
+    dispatchChunks();
+}
+
+void TranslationTaskRunner::onBatchCreated(const QString &batchId, int requestCount)
+{
+    if (!m_running || !m_batchMode) {
+        return;
+    }
+    emit taskLog(tr("批任务 %1 已创建（%2 个请求），等待服务端处理；结果返回前不占用在线并发").arg(batchId).arg(requestCount));
+}
+
+void TranslationTaskRunner::onBatchStatusChanged(const QString &status, int completedCount, int failedCount, int totalCount)
+{
+    if (!m_running || !m_batchMode || status == m_lastBatchStatus) {
+        return;
+    }
+
+    m_lastBatchStatus = status;
+    emit taskLog(tr("批任务状态：%1（完成 %2，失败 %3，共 %4）")
+                 .arg(status)
+                 .arg(completedCount)
+                 .arg(failedCount)
+                 .arg(totalCount));
+}
+
+void TranslationTaskRunner::onBatchResultReady(const QString &customId, const QString &content)
+{
+    if (!m_running) {
+        return;
+    }
+    const auto it = m_chunkByBatchId.constFind(customId);
+    if (it == m_chunkByBatchId.constEnd()) {
+        return;
+    }
+
+    const int chunkIndex = it.value();
+    m_chunkByBatchId.erase(it);
+    // 与在线结果同样处理：缺失条目补译、润色与按序提交均不变。
+    ++m_inFlight;
+    handleChunkResponse(chunkIndex, content);
+}
+
+void TranslationTaskRunner::onBatchResultFailed(const QString &customId, const QString &message)
+{
+    if (!m_running) {
+        return;
+    }
+    const auto it = m_chunkByBatchId.constFind(customId);
+    if (it == m_chunkByBatchId.constEnd()) {
+        return;
+    }
+
+    const int chunkIndex = it.value();
+    m_chunkByBatchId.erase(it);
+    emit taskLog(tr("%1在批任务中失败：%2，改为在线请求").arg(chunkLabel(chunkIndex), message));
+    m_fallbackChunks.insert(std::lower_bound(m_fallbackChunks.begin(), m_fallbackChunks.end(), chunkIndex), chunkIndex);
+    dispatchChunks();
+}
+
+void TranslationTaskRunner::onBatchFinished(bool success, const QString &message)
+{
+    if (!m_running || !m_batchMode) {
+        return;
+    }
+
+    emit taskLog(message);
+    if (!m_chunkByBatchId.isEmpty()) {
+        emit taskLog(tr("%1 个分块未从批任务返回%2，改为在线请求")
+                     .arg(m_chunkByBatchId.size())
+                     .arg(success ? QString() : tr("（批任务未正常完成）")));
+        fallBackFromBatch();
+    }
+}
+
+QString TranslationTaskRunner::buildChunkContent(int chunkIndex, const QVector<int> &ids, bool repairRequest) const
+{
+    QString reference;
+    if (!repairRequest && !m_request.referenceLines.isEmpty()) {
+        QStringList referenceLines;
+        for (int id : ids) {
+            referenceLines += m_request.referenceLines.value(id - 1);
+        }
+        referenceLines.removeDuplicates();
+        reference = PromptRequestComposer::buildReferenceContextBlock(referenceLines);
+    }
+
+    QStringList lines;
+    lines.reserve(ids.size());
+    if (m_request.responseFormat == StreamingCueParser::InputFormat::SrtBlocks) {
+        for (int id : ids) {
+            const SubtitleEntry &entry = m_request.entries.at(id - 1);
+            const QString startText = entry.startText.isEmpty() ? SubtitleTimeline::fromMs(entry.startMs)
+                                                                : SubtitleTimeline::normalizeToken(entry.startText);
+            const QString endText = entry.endText.isEmpty() ? SubtitleTimeline::fromMs(entry.endMs)
+                                                            : SubtitleTimeline::normalizeToken(entry.endText);
+            lines.append(QStringLiteral("%1\n%2 --> %3\n%4").arg(id).arg(startText, endText, entry.text.trimmed()));
+        }
+        return reference
+               + tr("【待翻译分段 %1/%2】\n%3")
+                     .arg(chunkOrdinal(chunkIndex) + 1)
+                     .arg(m_chunkCount)
+                     .arg(lines.join(QStringLiteral("\n\n")));
+    }
+
+    for (int id : ids) {
+        lines.append(SegmentWireCodec::encodeLine(id, m_request.entries.at(id - 1).text));
+    }
+    if (repairRequest) {
+        return tr("【补译条目】以下编号在上次返回中缺失或无效，请仅输出这些编号的译文：\n%1").arg(lines.join('\n'));
+    }
+    return reference
+           + tr("【待翻译分段 %1/%2】\n%3").arg(chunkOrdinal(chunkIndex) + 1).arg(m_chunkCount).arg(lines.join('\n'));
+}
+
+QHash<int, StreamingCueParser::CueTiming> TranslationTaskRunner::timelineFor(const QVector<int> &ids) const
+{
+    QHash<int, StreamingCueParser::CueTiming> timelineById;
+    timelineById.reserve(ids.size());
+    for (int id : ids) {
+        const SubtitleEntry &entry = m_request.entries.at(id - 1);
+        StreamingCueParser::CueTiming timing;
+        timing.startText = entry.startText.isEmpty() ? SubtitleTimeline::fromMs(entry.startMs) : entry.startText;
+        timing.endText = entry.endText.isEmpty() ? SubtitleTimeline::fromMs(entry.endMs) : entry.endText;
+        timelineById.insert(id, timing);
+    }
+    return timelineById;
+}
+
+QVector<int> TranslationTaskRunner::missingIds(const ChunkState &chunk) const
+{
+    QVector<int> ids;
+    for (int i = 0; i < chunk.count; ++i) {
+        const int id = chunk.startIndex + i + 1;
+        if (chunk.translationsById.value(id).trimmed().isEmpty()) {
+            ids.append(id);
+        }
+    }
+    return ids;
+}
+
+void TranslationTaskRunner::onChatCompleted(quint64 requestId, const QString &content, const QJsonObject &)
+{
+    const auto it = m_chunkByRequestId.constFind(requestId);
+    if (it == m_chunkByRequestId.constEnd()) {
+        return;
+    }
+
+    const int chunkIndex = it.value();
+    m_chunkByRequestId.erase(it);
+    handleChunkResponse(chunkIndex, content);
+}
+
+void TranslationTaskRunner::onStreamChunkReceived(quint64 requestId, const QString &delta)
+{
+    const auto it = m_chunkByRequestId.constFind(requestId);
+    if (it == m_chunkByRequestId.constEnd()) {
+        return;
+    }
+    m_chunks[it.value()].parser.feed(delta);
+}
+
+void TranslationTaskRunner::onRequestRestarted(quint64 requestId, const QString &reason)
+{
+    const auto it = m_chunkByRequestId.constFind(requestId);
+    if (it == m_chunkByRequestId.constEnd()) {
+        return;
+    }
+
+    m_chunks[it.value()].parser.restart();
+    emit taskLog(tr("%1：%2").arg(chunkLabel(it.value()), reason));
+}
+
+void TranslationTaskRunner::onChatMetricsMeasured(quint64 requestId, const LlmRequestMetrics &metrics)
+{
+    const auto it = m_chunkByRequestId.constFind(requestId);
+    if (it == m_chunkByRequestId.constEnd()) {
+        return;
+    }
+
+    ChunkState &chunk = m_chunks[it.value()];
+    if (!chunk.repairRequest) {
+        chunk.requestMs += metrics.totalMs;
+    }
+}
+
+void TranslationTaskRunner::onRequestFailed(quint64 requestId, const QString &stage, const QString &message)
+{
+    const auto it = m_chunkByRequestId.constFind(requestId);
+    if (it == m_chunkByRequestId.constEnd()) {
+        return;
+    }
+
+    const int chunkIndex = it.value();
+    m_chunkByRequestId.erase(it);
+    handleChunkFailure(chunkIndex, stage, message);
+}
+
+void TranslationTaskRunner::handleChunkFailure(int chunkIndex, const QString &stage, const QString &message)
+{
+    ChunkState &chunk = m_chunks[chunkIndex];
+    ++chunk.failedAttempts;
+    emit taskLog(tr("%1%2失败：%3").arg(chunkLabel(chunkIndex), stage, message));
+
+    if (chunk.failedAttempts <= kMaxChunkFailedAttempts) {
+        emit taskLog(tr("%1重新发送（第 %2 次）").arg(chunkLabel(chunkIndex)).arg(chunk.failedAttempts));
+        if (!sendChunkRequest(chunkIndex, chunk.requestedIds, chunk.repairRequest)) {
+            finishTask(false, tr("%1请求未能发出，任务中止").arg(chunkLabel(chunkIndex)));
+        }
+        return;
+    }
+
+    // 多次失败后按已有译文收尾，保证后续分块仍可按序提交。
+    if (m_request.responseFormat != StreamingCueParser::InputFormat::SrtBlocks) {
+        buildKeyedTranslatedEntries(chunk);
+    }
+    completeChunk(chunkIndex);
+}
+
+void TranslationTaskRunner::onBackendLinesTranslated(quint64 requestId, const QStringList &translations)
+{
+    const auto it = m_chunkByBackendRequestId.constFind(requestId);
+    if (it == m_chunkByBackendRequestId.constEnd()) {
+        return;
+    }
+
+    const int chunkIndex = it.value();
+    m_chunkByBackendRequestId.erase(it);
+    // 按下标对应回条目编号，转为紧凑行后与聊天响应走同一解析、补译与提交流程。
+    const QVector<int> ids = m_chunks.at(chunkIndex).requestedIds;
+    QStringList lines;
+    lines.reserve(ids.size());
+    for (int i = 0; i < ids.size() && i < translations.size(); ++i) {
+        if (!translations.at(i).trimmed().isEmpty()) {
+            lines.append(SegmentWireCodec::encodeLine(ids.at(i), translations.at(i)));
+        }
+    }
+    handleChunkResponse(chunkIndex, lines.join('\n'));
+}
+
+void TranslationTaskRunner::onBackendLinesFailed(quint64 requestId, const QString &message)
+{
+    const auto it = m_chunkByBackendRequestId.constFind(requestId);
+    if (it == m_chunkByBackendRequestId.constEnd()) {
+        return;
+    }
+
+    const int chunkIndex = it.value();
+    m_chunkByBackendRequestId.erase(it);
+    handleChunkFailure(chunkIndex, m_backend->name(), message);
+}
+
+void TranslationTaskRunner::onBackendRequestMeasured(quint64 requestId, const LlmRequestMetrics &metrics)
+{
+    const auto it = m_chunkByBackendRequestId.constFind(requestId);
+    if (it == m_chunkByBackendRequestId.constEnd()) {
+        return;
+    }
+
+    ChunkState &chunk = m_chunks[it.value()];
+    if (!chunk.repairRequest) {
+        chunk.requestMs += metrics.totalMs;
+    }
+}
+
+void TranslationTaskRunner::handleChunkResponse(int chunkIndex, const QString &rawResponse)
+{
+    ChunkState &chunk = m_chunks[chunkIndex];
+    if (!chunk.parser.hasInput()) {
+        chunk.parser.feed(rawResponse);
+    }
+    chunk.parser.finish();
+
+    if (m_request.responseFormat == StreamingCueParser::InputFormat::SrtBlocks) {
+        const int chunkEnd = qMin(m_request.entries.size(), chunk.startIndex + chunk.count);
+        int cursor = chunk.startIndex;
+        int droppedCount = 0;
+        for (const StreamingCueParser::Cue &cue : chunk.parser.committedCues()) {
+            SubtitleEntry entry;
+            entry.startText = SubtitleTimeline::normalizeToken(cue.startText);
+            entry.endText = SubtitleTimeline::normalizeToken(cue.endText);
+            entry.startMs = SubtitleTimeline::toMs(entry.startText);
+            entry.endMs = SubtitleTimeline::toMs(entry.endText);
+            entry.text = cue.text.trimmed();
+            if (entry.startMs < 0 || entry.endMs < 0 || entry.text.isEmpty()) {
+                continue;
+            }
+
+            // 模型写的编号不可信（常从 1 重新编号）：编号落在本块内且开始时间一致时才采用，
+            // 否则在本块剩余条目中按开始时间匹配，匹配不上则顺延占用下一条。
+            int sourceIndex = cue.index - 1;
+            if (sourceIndex < cursor || sourceIndex >= chunkEnd
+                || m_request.entries.at(sourceIndex).startMs != entry.startMs) {
+                sourceIndex = -1;
+                for (int i = cursor; i < chunkEnd; ++i) {
+                    if (m_request.entries.at(i).startMs == entry.startMs) {
+                        sourceIndex = i;
+                        break;
+                    }
+                }
+                if (sourceIndex < 0 && cursor < chunkEnd) {
+                    sourceIndex = cursor;
+                }
+            }
+            if (sourceIndex < 0) {
+                ++droppedCount;
+                continue;
+            }
+
+            cursor = sourceIndex + 1;
+            entry.index = sourceIndex + 1;
+            chunk.translated.append(entry);
+        }
+        if (droppedCount > 0) {
+            emit taskLog(tr("%1返回条目多于请求条目，%2 条无法对应到源字幕，已忽略")
+                         .arg(chunkLabel(chunkIndex))
+                         .arg(droppedCount));
+        }
+        completeChunk(chunkIndex);
+        return;
+    }
+
+    int returnedCount = 0;
+    for (const StreamingCueParser::Cue &cue : chunk.parser.committedCues()) {
+        chunk.translationsById.insert(cue.index, cue.text);
+        ++returnedCount;
+    }
+
+    const QVector<int> missing = missingIds(chunk);
+    const bool repairProductive = !chunk.repairRequest || returnedCount > 0;
+    if (!missing.isEmpty() && repairProductive && chunk.repairAttempts < kMaxChunkRepairAttempts) {
+        ++chunk.repairAttempts;
+        emit taskLog(tr("%1有 %2 条缺失或无效，仅对这些条目补译（第 %3 次）")
+                     .arg(chunkLabel(chunkIndex))
+                     .arg(missing.size())
+                     .arg(chunk.repairAttempts));
+        if (!sendChunkRequest(chunkIndex, missing, true)) {
+            finishTask(false, tr("%1补译请求未能发出，任务中止").arg(chunkLabel(chunkIndex)));
+        }
+        return;
+    }
+
+    buildKeyedTranslatedEntries(chunk);
+    completeChunk(chunkIndex);
+}
+
+void TranslationTaskRunner::buildKeyedTranslatedEntries(ChunkState &chunk)
+{
+    chunk.translated.clear();
+    for (int i = 0; i < chunk.count; ++i) {
+        const int id = chunk.startIndex + i + 1;
+        const QString text = chunk.translationsById.value(id).trimmed();
+        if (text.isEmpty()) {
+            continue;
+        }
+
+        SubtitleEntry entry = m_request.entries.at(id - 1);
+        entry.index = id;
+        entry.text = text;
+        if (entry.startText.isEmpty()) {
+            entry.startText = SubtitleTimeline::fromMs(entry.startMs);
+        }
+        if (entry.endText.isEmpty()) {
+            entry.endText = SubtitleTimeline::fromMs(entry.endMs);
+        }
+        chunk.translated.append(entry);
+    }
+}
+
+void TranslationTaskRunner::completeChunk(int chunkIndex)
+{
+    ChunkState &chunk = m_chunks[chunkIndex];
+    if (chunk.completed) {
+        return;
+    }
+
+    chunk.completed = true;
+    chunk.requestId = 0;
+    --m_inFlight;
+
+    const int missingCount = chunk.count - chunk.translated.size();
+    if (missingCount > 0 && m_request.responseFormat != StreamingCueParser::InputFormat::SrtBlocks) {
+        m_missingEntries += missingCount;
+        emit taskLog(tr("%1有 %2 条未返回有效译文，对应条目未写入合并结果").arg(chunkLabel(chunkIndex)).arg(missingCount));
+    }
+
+    if (!m_request.fastModel.isEmpty() && chunk.requestMs > 0) {
+        RouteStats &stats = chunk.fastRoute ? m_fastRouteStats : m_strongRouteStats;
+        ++stats.chunks;
+        stats.entries += chunk.count;
+        stats.requestMs += chunk.requestMs;
+    }
+
+    if (++m_translatedChunks == m_chunks.size() && m_inputClosed) {
+        m_translateStageMs = m_taskTimer.elapsed();
+    }
+
+    if (m_request.polishEnabled && !chunk.translated.isEmpty()) {
+        enqueuePolish(chunkIndex);
+    } else {
+        chunk.polished = true;
+    }
+
+    commitCompletedChunks();
+    dispatchChunks();
+}
+
+void TranslationTaskRunner::enqueuePolish(int chunkIndex)
+{
+    // 序号靠前的分块优先润色，尽早解除按序提交的阻塞。
+    m_pendingPolishChunks.insert(std::lower_bound(m_pendingPolishChunks.begin(), m_pendingPolishChunks.end(), chunkIndex),
+                                 chunkIndex);
+    dispatchPolish();
+}
+
+void TranslationTaskRunner::dispatchPolish()
+{
+    while (m_running && m_polishInFlight < m_request.polishMaxInFlight && !m_pendingPolishChunks.isEmpty()) {
+        const int chunkIndex = m_pendingPolishChunks.takeFirst();
+        ++m_polishInFlight;
+        if (!sendPolishRequest(chunkIndex)) {
+            emit taskLog(tr("%1润色请求未能发出，保留初译").arg(chunkLabel(chunkIndex)));
+            finishPolish(chunkIndex);
+        }
+    }
+}
+
+bool TranslationTaskRunner::sendPolishRequest(int chunkIndex)
+{
+    ChunkState &chunk = m_chunks[chunkIndex];
+    QHash<int, StreamingCueParser::CueTiming> timelineById;
+    QStringList sourceLines;
+    QStringList draftLines;
+    timelineById.reserve(chunk.translated.size());
+    for (const SubtitleEntry &entry : chunk.translated) {
+        StreamingCueParser::CueTiming timing;
+        timing.startText = entry.startText;
+        timing.endText = entry.endText;
+        timelineById.insert(entry.index, timing);
+        if (entry.index >= 1 && entry.index <= m_request.entries.size()) {
+            sourceLines.append(SegmentWireCodec::encodeLine(entry.index, m_request.entries.at(entry.index - 1).text));
+        }
+        draftLines.append(SegmentWireCodec::encodeLine(entry.index, entry.text));
+    }
+
+    chunk.polishParser.reset();
+    chunk.polishParser.setKeyedFormat(m_request.polishFormat, timelineById);
+
+    const QString content = tr("【待润色分段 %1/%2】\n【原文】\n%3\n\n【初译】\n%4")
+                                .arg(chunkOrdinal(chunkIndex) + 1)
+                                .arg(m_chunkCount)
+                                .arg(sourceLines.join('\n'), draftLines.join('\n'));
+    const QJsonArray messages = PromptRequestComposer::buildPrefixCachedMessages(languageOf(chunk).polishSystemPrompt,
+                                                                                 content);
+    const quint64 requestId = m_polishClient->requestChatCompletion(m_request.polishConfig,
+                                                                    messages,
+                                                                    m_request.polishOptions,
+                                                                    m_request.polishResponseSchema);
+    chunk.polishRequestId = requestId;
+    if (requestId == 0) {
+        return false;
+    }
+    m_polishChunkByRequestId.insert(requestId, chunkIndex);
+    return true;
+}
+
+void TranslationTaskRunner::onPolishChatCompleted(quint64 requestId, const QString &content, const QJsonObject &)
+{
+    const auto it = m_polishChunkByRequestId.constFind(requestId);
+    if (it == m_polishChunkByRequestId.constEnd()) {
+        return;
+    }
+
+    const int chunkIndex = it.value();
+    m_polishChunkByRequestId.erase(it);
+    handlePolishResponse(chunkIndex, content);
+}
+
+void TranslationTaskRunner::onPolishStreamChunkReceived(quint64 requestId, const QString &delta)
+{
+    const auto it = m_polishChunkByRequestId.constFind(requestId);
+    if (it == m_polishChunkByRequestId.constEnd()) {
+        return;
+    }
+    m_chunks[it.value()].polishParser.feed(delta);
+}
+
+void TranslationTaskRunner::onPolishRequestRestarted(quint64 requestId, const QString &reason)
+{
+    const auto it = m_polishChunkByRequestId.constFind(requestId);
+    if (it == m_polishChunkByRequestId.constEnd()) {
+        return;
+    }
+
+    m_chunks[it.value()].polishParser.restart();
+    emit taskLog(tr("%1润色：%2").arg(chunkLabel(it.value()), reason));
+}
+
+void TranslationTaskRunner::onPolishRequestFailed(quint64 requestId, const QString &stage, const QString &message)
+{
+    const auto it = m_polishChunkByRequestId.constFind(requestId);
+    if (it == m_polishChunkByRequestId.constEnd()) {
+        return;
+    }
+
+    const int chunkIndex = it.value();
+    m_polishChunkByRequestId.erase(it);
+    ChunkState &chunk = m_chunks[chunkIndex];
+    ++chunk.polishFailedAttempts;
+    emit taskLog(tr("%1润色%2失败：%3").arg(chunkLabel(chunkIndex), stage, message));
+
+    if (chunk.polishFailedAttempts <= kMaxChunkFailedAttempts && sendPolishRequest(chunkIndex)) {
+        emit taskLog(tr("%1润色重新发送（第 %2 次）").arg(chunkLabel(chunkIndex)).arg(chunk.polishFailedAttempts));
+        return;
+    }
+
+    // 润色失败不影响结果完整性：保留初译继续提交。
+    emit taskLog(tr("%1润色未完成，保留初译").arg(chunkLabel(chunkIndex)));
+    finishPolish(chunkIndex);
+}
+
+void TranslationTaskRunner::handlePolishResponse(int chunkIndex, const QString &rawResponse)
+{
+    ChunkState &chunk = m_chunks[chunkIndex];
+    if (!chunk.polishParser.hasInput()) {
+        chunk.polishParser.feed(rawResponse);
+    }
+    chunk.polishParser.finish();
+
+    QHash<int, QString> polishedById;
+    for (const StreamingCueParser::Cue &cue : chunk.polishParser.committedCues()) {
+        polishedById.insert(cue.index, cue.text.trimmed());
+    }
+
+    int keptCount = 0;
+    for (SubtitleEntry &entry : chunk.translated) {
+        const QString text = polishedById.value(entry.index);
+        if (text.isEmpty()) {
+            ++keptCount;
+            continue;
+        }
+        entry.text = text;
+    }
+    if (keptCount > 0) {
+        emit taskLog(tr("%1润色结果缺少 %2 条，对应条目保留初译").arg(chunkLabel(chunkIndex)).arg(keptCount));
+    }
+    finishPolish(chunkIndex);
+}
+
+void TranslationTaskRunner::finishPolish(int chunkIndex)
+{
+    ChunkState &chunk = m_chunks[chunkIndex];
+    if (chunk.polished) {
+        return;
+    }
+
+    chunk.polished = true;
+    chunk.polishRequestId = 0;
+    chunk.polishParser.reset();
+    --m_polishInFlight;
+
+    commitCompletedChunks();
+    dispatchPolish();
+    dispatchChunks();
+}
+
+void TranslationTaskRunner::commitCompletedChunks()
+{
+    const int languageCount = m_request.languages.size();
+    for (int languageIndex = 0; m_running && languageIndex < languageCount; ++languageIndex) {
+        int &nextChunk = m_nextCommitByLanguage[languageIndex];
+        while (m_running && nextChunk < m_chunkCount && isChunkReady(m_chunks.at(nextChunk * languageCount + languageIndex))) {
+            ChunkState &chunk = m_chunks[nextChunk * languageCount + languageIndex];
+            rememberChunk(chunk);
+            emit chunkCommitted(languageIndex, nextChunk, chunk.translated);
+            m_committedEntries += chunk.count;
+            ++m_committedChunks;
+
+            // 已提交分块不再需要解析状态与中间结果。
+            chunk.parser.reset();
+            chunk.translationsById.clear();
+            chunk.translated.clear();
+            ++nextChunk;
+            emit progressChanged(m_committedEntries, m_request.entries.size() * languageCount);
+        }
+    }
+
+    if (m_running && m_inputClosed && m_committedChunks >= m_chunks.size()) {
+        if (m_request.polishEnabled && m_translateStageMs >= 0) {
+            // 两阶段重叠执行：总用时应接近较慢一阶段，而不是两者之和。
+            emit taskLog(tr("翻译阶段用时 %1 s，润色随后于 %2 s 全部完成")
+                         .arg(QString::number(m_translateStageMs / 1000.0, 'f', 1))
+                         .arg(QString::number(m_taskTimer.elapsed() / 1000.0, 'f', 1)));
+        }
+        if (!m_request.fastModel.isEmpty()) {
+            emit taskLog(routingReport());
+        }
+        if (m_memoryHits > 0) {
+            emit taskLog(tr("翻译记忆命中 %1 条（重复台词未重复请求）").arg(m_memoryHits));
+        }
+        const int totalEntries = m_request.entries.size() * languageCount;
+        finishTask(true, m_missingEntries > 0
+                             ? tr("并发翻译完成：%1 条中 %2 条缺失").arg(totalEntries).arg(m_missingEntries)
+                             : tr("并发翻译完成：共 %1 条").arg(totalEntries));
+    }
+}
+
+void TranslationTaskRunner::finishTask(bool success, const QString &message)
+{
+    if (!m_running) {
+        return;
+    }
+
+    m_running = false;
+    if (m_batchMode && m_batchClient && m_batchClient->isActive()) {
+        m_batchClient->cancel();
+    }
+    m_chunkByBatchId.clear();
+    m_fallbackChunks.clear();
+    const QList<quint64> requestIds = m_chunkByRequestId.keys();
+    m_chunkByRequestId.clear();
+    for (quint64 requestId : requestIds) {
+        m_client->cancelRequest(requestId);
+    }
+    const QList<quint64> backendRequestIds = m_chunkByBackendRequestId.keys();
+    m_chunkByBackendRequestId.clear();
+    for (quint64 requestId : backendRequestIds) {
+        m_backend->cancel(requestId);
+    }
+    const QList<quint64> polishRequestIds = m_polishChunkByRequestId.keys();
+    m_polishChunkByRequestId.clear();
+    m_pendingPolishChunks.clear();
+    for (quint64 requestId : polishRequestIds) {
+        m_polishClient->cancelRequest(requestId);
+    }
+    emit taskFinished(success, message);
+}
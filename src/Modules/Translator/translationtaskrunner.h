@@ -0,0 +1,243 @@
+#ifndef TRANSLATIONTASKRUNNER_H
+#define TRANSLATIONTASKRUNNER_H
+
+#include "llmserviceclient.h"
+#include "streamingcueparser.h"
+#include "subtitleentry.h"
+#include "translationmemory.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QVector>
+
+class LlmBatchClient;
+class TranslationBackend;
+
+// 一个目标语言的静态提示；同一语言的各分块请求前缀逐字节一致。
+struct TranslationTargetLanguage
+{
+    QString language;
+    QString systemPrompt;
+    QString polishSystemPrompt;
+};
+
+struct TranslationTaskRequest
+{
+    // 源条目，全局编号为下标 + 1。
+    QVector<SubtitleEntry> entries;
+    // 可选，与 entries 等长：各条目的参考上下文行（只重译改动条目时附带相邻未改动条目的原文与译文）。
+    QVector<QStringList> referenceLines;
+    LlmServiceConfig config;
+    QJsonObject options;
+    // 静态前缀（指令 + 预设 + 输出格式），各分块请求逐字节一致。
+    QString systemPrompt;
+    // 多语言扇出：非空时忽略 systemPrompt / polishSystemPrompt，每个（分块，语言）组合各发一个请求，
+    // 共用源条目、分块划分、翻译记忆与同一个在途上限。
+    QVector<TranslationTargetLanguage> languages;
+    QJsonObject responseSchema;
+    // 源语言（为空表示自动检测）；仅按行翻译后端使用，聊天请求的源语言写在 systemPrompt 中。
+    QString sourceLanguage;
+    StreamingCueParser::InputFormat responseFormat = StreamingCueParser::InputFormat::CompactLines;
+    int chunkSize = 20;
+    // 同时在途的分块请求数上限（通常取端点池的建议并发数）。
+    int maxInFlight = 1;
+    // 快慢模型分流：非空时按 ModelRoutingPolicy 评估，简单分块改用该模型（端点不变），补译仍用主模型。
+    QString fastModel;
+    double routingThreshold = 0.45;
+    // 批量接口：全部分块的首发请求合并为一个批任务离线执行（同批只用主模型，不做快慢分流）；
+    // 结果逐块走与在线请求相同的解析、补译与润色流程，批内失败或未返回的分块改为在线请求。
+    bool batchApi = false;
+    // 流式输入：entries 可为空，源条目随后经 appendEntries() 逐段追加（如边识别边翻译）；
+    // 凑满 chunkSize 条即划出分块发出，closeInput() 后剩余条目组成末块。不使用批量接口。
+    bool openInput = false;
+
+    // 第二阶段润色：每块译完即发出润色请求，与后续分块的翻译并行；提交的是润色后的结果。
+    bool polishEnabled = false;
+    // 润色可使用不同的模型或端点，请求经 setPolishClient() 指定的客户端发出。
+    LlmServiceConfig polishConfig;
+    QJsonObject polishOptions;
+    QString polishSystemPrompt;
+    QJsonObject polishResponseSchema;
+    // 润色响应格式，仅支持紧凑行与 JSON 条目；SRT 块按紧凑行处理。
+    StreamingCueParser::InputFormat polishFormat = StreamingCueParser::InputFormat::CompactLines;
+    int polishMaxInFlight = 1;
+};
+
+// 无 UI 的分块翻译执行器：多个分块并发发出（由 LlmServiceClient 的端点池分摊到各端点），
+// 结果按源顺序提交；紧凑 / 结构化格式下缺失条目单独补译。启用润色时每块译完即进入润色阶段，
+// 两阶段流水并行，提交的是润色后的分块。多语言任务按分块交替发出各语言请求，各语言分别按序提交。
+class TranslationTaskRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TranslationTaskRunner(LlmServiceClient *client, QObject *parent = nullptr);
+
+    // 润色请求使用的客户端（独立的端点池）；传 nullptr 时与翻译共用。任务运行期间忽略。
+    void setPolishClient(LlmServiceClient *client);
+    // 批量接口客户端；未设置时 batchApi 任务退回在线请求。任务运行期间忽略。
+    void setBatchClient(LlmBatchClient *client);
+    // 多个执行器共用的翻译记忆（如批量处理多个文件）；传 nullptr 时使用自身的记忆（每次任务开始清空）。
+    // 共用的记忆不随任务清空。任务运行期间忽略。
+    void setSharedMemory(TranslationMemory *memory);
+    // 按行翻译后端（如专用机器翻译服务）；设置后分块请求改经后端发出，分块调度、翻译记忆、补译与按序提交不变。
+    // 此时按紧凑行处理结果，不使用批量接口与快慢分流，config 可为空；润色仍经聊天客户端。
+    // 传 nullptr 时恢复直接发送聊天请求。任务运行期间忽略。
+    void setBackend(TranslationBackend *backend);
+
+    bool isRunning() const;
+    // 启动任务；已有任务运行时忽略。
+    void startTask(const TranslationTaskRequest &request);
+    // 取消全部在途分块请求并结束任务。
+    void cancelTask();
+    // 流式输入任务追加源条目（全局编号顺延）；非流式任务或输入已结束时忽略。
+    void appendEntries(const QVector<SubtitleEntry> &entries);
+    // 流式输入结束：剩余条目组成末块，全部提交后任务完成。
+    void closeInput();
+
+signals:
+    void taskStarted(int chunkCount, int languageCount);
+    void taskLog(const QString &line);
+    // 每个语言各自按源顺序提交：前序分块未完成时，先完成的分块暂存等待。
+    // 单语言任务的 languageIndex 恒为 0。
+    void chunkCommitted(int languageIndex, int chunkIndex, const QVector<SubtitleEntry> &translatedEntries);
+    // 条目数按（条目，语言）计。
+    void progressChanged(int committedEntries, int totalEntries);
+    void taskFinished(bool success, const QString &message);
+
+private slots:
+    void onChatCompleted(quint64 requestId, const QString &content, const QJsonObject &rawResponse);
+    void onStreamChunkReceived(quint64 requestId, const QString &delta);
+    void onRequestFailed(quint64 requestId, const QString &stage, const QString &message);
+    void onRequestRestarted(quint64 requestId, const QString &reason);
+    void onChatMetricsMeasured(quint64 requestId, const LlmRequestMetrics &metrics);
+    void onPolishChatCompleted(quint64 requestId, const QString &content, const QJsonObject &rawResponse);
+    void onPolishStreamChunkReceived(quint64 requestId, const QString &delta);
+    void onPolishRequestFailed(quint64 requestId, const QString &stage, const QString &message);
+    void onPolishRequestRestarted(quint64 requestId, const QString &reason);
+    void onBatchCreated(const QString &batchId, int requestCount);
+    void onBatchStatusChanged(const QString &status, int completedCount, int failedCount, int totalCount);
+    void onBatchResultReady(const QString &customId, const QString &content);
+    void onBatchResultFailed(const QString &customId, const QString &message);
+    void onBatchFinished(bool success, const QString &message);
+    void onBackendLinesTranslated(quint64 requestId, const QStringList &translations);
+    void onBackendLinesFailed(quint64 requestId, const QString &message);
+    void onBackendRequestMeasured(quint64 requestId, const LlmRequestMetrics &metrics);
+
+private:
+    // m_chunks 按发出顺序排列：下标 = 分块序号 × 语言数 + 语言序号。
+    struct ChunkState
+    {
+        int languageIndex = 0;
+        int startIndex = 0;
+        int count = 0;
+        quint64 requestId = 0;
+        // 当前请求包含的编号：首发为整块，补译时仅为缺失部分。
+        QVector<int> requestedIds;
+        bool repairRequest = false;
+        StreamingCueParser parser;
+        QMap<int, QString> translationsById;
+        QVector<SubtitleEntry> translated;
+        int repairAttempts = 0;
+        int failedAttempts = 0;
+        bool completed = false;
+        // 首发请求是否分流到快速模型，及其请求耗时（不含补译）。
+        bool fastRoute = false;
+        qint64 requestMs = 0;
+        // 润色阶段
+        quint64 polishRequestId = 0;
+        StreamingCueParser polishParser;
+        int polishFailedAttempts = 0;
+        bool polished = false;
+    };
+
+    int chunkOrdinal(int chunkIndex) const;
+    QString chunkLabel(int chunkIndex) const;
+    const TranslationTargetLanguage &languageOf(const ChunkState &chunk) const;
+    bool isChunkReady(const ChunkState &chunk) const;
+    TranslationMemory &memory();
+    // 翻译记忆命中的条目直接填入，返回仍需请求的编号。
+    QVector<int> applyTranslationMemory(int chunkIndex);
+    void rememberChunk(const ChunkState &chunk);
+    // 按已有源条目划分分块：输入未结束时只划分满块。
+    void planChunks();
+    void dispatchChunks();
+    // 记录本次请求的编号并重置解析器，返回请求消息（在线与批量共用）。
+    QJsonArray prepareChunkRequest(int chunkIndex, const QVector<int> &ids, bool repairRequest);
+    bool sendChunkRequest(int chunkIndex, const QVector<int> &ids, bool repairRequest);
+    bool sendBackendRequest(int chunkIndex, const QVector<int> &ids, bool repairRequest);
+    // 请求失败（端点池或后端已放弃）：未超次数时整块重发，否则按已有译文收尾。
+    void handleChunkFailure(int chunkIndex, const QString &stage, const QString &message);
+    void submitBatch();
+    // 把仍在批任务中的分块转入在线请求队列。
+    void fallBackFromBatch();
+    void buildKeyedTranslatedEntries(ChunkState &chunk);
+    QString buildChunkContent(int chunkIndex, const QVector<int> &ids, bool repairRequest) const;
+    QHash<int, StreamingCueParser::CueTiming> timelineFor(const QVector<int> &ids) const;
+    QVector<int> missingIds(const ChunkState &chunk) const;
+    void handleChunkResponse(int chunkIndex, const QString &rawResponse);
+    void completeChunk(int chunkIndex);
+    void enqueuePolish(int chunkIndex);
+    void dispatchPolish();
+    bool sendPolishRequest(int chunkIndex);
+    void handlePolishResponse(int chunkIndex, const QString &rawResponse);
+    void finishPolish(int chunkIndex);
+    void connectPolishClient(bool connectSignals);
+    void routeChunk(int chunkIndex, const QVector<int> &ids);
+    QString routingReport() const;
+    void commitCompletedChunks();
+    void finishTask(bool success, const QString &message);
+
+    LlmServiceClient *m_client = nullptr;
+    LlmServiceClient *m_polishClient = nullptr;
+    LlmBatchClient *m_batchClient = nullptr;
+    TranslationBackend *m_backend = nullptr;
+    TranslationTaskRequest m_request;
+    QVector<ChunkState> m_chunks;
+    // 每个语言的分块数（各语言相同）；流式输入时随条目到达增加。
+    int m_chunkCount = 0;
+    // 已划入分块的源条目数，及源条目是否已全部到达。
+    int m_plannedEntries = 0;
+    bool m_inputClosed = true;
+    // 各语言下一个待提交的分块序号。
+    QVector<int> m_nextCommitByLanguage;
+    int m_committedChunks = 0;
+    TranslationMemory m_memory;
+    TranslationMemory *m_sharedMemory = nullptr;
+    int m_memoryHits = 0;
+    struct RouteStats
+    {
+        int chunks = 0;
+        int entries = 0;
+        qint64 requestMs = 0;
+    };
+    RouteStats m_fastRouteStats;
+    RouteStats m_strongRouteStats;
+    QHash<quint64, int> m_chunkByRequestId;
+    QHash<quint64, int> m_polishChunkByRequestId;
+    // 经后端发出的分块请求（编号由后端分配，与聊天客户端的编号分开记录）。
+    QHash<quint64, int> m_chunkByBackendRequestId;
+    // 批量模式：仍在批任务中的分块（custom_id -> 分块下标），不计入在途数。
+    bool m_batchMode = false;
+    QHash<QString, int> m_chunkByBatchId;
+    QString m_lastBatchStatus;
+    // 批内失败或未返回、等待在线重发的分块，按分块序号升序。
+    QList<int> m_fallbackChunks;
+    // 待润色分块，按分块序号升序。
+    QList<int> m_pendingPolishChunks;
+    int m_polishInFlight = 0;
+    int m_translatedChunks = 0;
+    qint64 m_translateStageMs = -1;
+    QElapsedTimer m_taskTimer;
+    int m_nextChunkToDispatch = 0;
+    int m_inFlight = 0;
+    int m_committedEntries = 0;
+    int m_missingEntries = 0;
+    bool m_running = false;
+};
+
+#endif // TRANSLATIONTASKRUNNER_H
@@ -0,0 +1,305 @@
+#include "translationtelemetry.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+
+#include <algorithm>
+
+namespace {
+QString csvField(const QString &value)
+{
+    if (!value.contains(QLatin1Char(',')) && !value.contains(QLatin1Char('"')) && !value.contains(QLatin1Char('\n'))) {
+        return value;
+    }
+    QString quoted = value;
+    quoted.replace(QStringLiteral("\""), QStringLiteral("\"\""));
+    return QLatin1Char('"') + quoted + QLatin1Char('"');
+}
+
+QString modelLabel(const QString &model)
+{
+    return model.trimmed().isEmpty() ? QCoreApplication::translate("TranslationTelemetry", "（未指定模型）") : model;
+}
+
+QString formatRate(double tokensPerSecond)
+{
+    return tokensPerSecond < 0 ? QStringLiteral("-") : QString::number(tokensPerSecond, 'f', 1);
+}
+
+QString formatMs(qint64 value)
+{
+    return value < 0 ? QStringLiteral("-") : QString::number(value);
+}
+}
+
+void TranslationTelemetry::reset()
+{
+    m_completions.clear();
+    m_failuresByModel.clear();
+    m_entryCount = 0;
+    m_jobTimer.start();
+}
+
+void TranslationTelemetry::setEntryCount(int entryCount)
+{
+    m_entryCount = qMax(0, entryCount);
+}
+
+void TranslationTelemetry::recordCompletion(const LlmRequestMetrics &metrics)
+{
+    if (!m_jobTimer.isValid()) {
+        m_jobTimer.start();
+    }
+    m_completions.append(metrics);
+}
+
+void TranslationTelemetry::recordFailure(const QString &model)
+{
+    if (!m_jobTimer.isValid()) {
+        m_jobTimer.start();
+    }
+    ++m_failuresByModel[model];
+}
+
+bool TranslationTelemetry::isEmpty() const
+{
+    return m_completions.isEmpty() && m_failuresByModel.isEmpty();
+}
+
+double TranslationTelemetry::tokensPerSecond(const LlmRequestMetrics &metrics)
+{
+    const qint64 generationMs = metrics.totalMs - qMax<qint64>(0, metrics.firstTokenMs);
+    if (metrics.completionTokens <= 0 || generationMs <= 0) {
+        return -1.0;
+    }
+    return metrics.completionTokens * 1000.0 / generationMs;
+}
+
+TranslationTelemetry::ModelSummary TranslationTelemetry::summarize(const QString &model, bool allModels) const
+{
+    ModelSummary summary;
+    summary.model = allModels ? QString() : model;
+
+    QVector<qint64> firstTokenSamples;
+    qint64 firstTokenTotal = 0;
+    qint64 totalMsSum = 0;
+    qint64 rateTokens = 0;
+    qint64 rateMs = 0;
+    for (const LlmRequestMetrics &metrics : m_completions) {
+        if (!allModels && metrics.model != model) {
+            continue;
+        }
+
+        ++summary.requests;
+        summary.retries += qMax(0, metrics.attempts - 1);
+        summary.hedged += metrics.hedged ? 1 : 0;
+        summary.promptTokens += qMax<qint64>(0, metrics.promptTokens);
+        summary.completionTokens += qMax<qint64>(0, metrics.completionTokens);
+        totalMsSum += metrics.totalMs;
+        if (metrics.firstTokenMs >= 0) {
+            firstTokenSamples.append(metrics.firstTokenMs);
+            firstTokenTotal += metrics.firstTokenMs;
+        }
+
+        const qint64 generationMs = metrics.totalMs - qMax<qint64>(0, metrics.firstTokenMs);
+        if (metrics.completionTokens > 0 && generationMs > 0) {
+            rateTokens += metrics.completionTokens;
+            rateMs += generationMs;
+        }
+    }
+
+    if (allModels) {
+        for (auto it = m_failuresByModel.constBegin(); it != m_failuresByModel.constEnd(); ++it) {
+            summary.failures += it.value();
+        }
+    } else {
+        summary.failures = m_failuresByModel.value(model, 0);
+    }
+
+    if (summary.requests > 0) {
+        summary.averageTotalMs = totalMsSum / summary.requests;
+    }
+    if (!firstTokenSamples.isEmpty()) {
+        summary.averageFirstTokenMs = firstTokenTotal / firstTokenSamples.size();
+        const int rank = qBound(0, static_cast<int>(0.9 * firstTokenSamples.size()), firstTokenSamples.size() - 1);
+        std::nth_element(firstTokenSamples.begin(), firstTokenSamples.begin() + rank, firstTokenSamples.end());
+        summary.p90FirstTokenMs = firstTokenSamples.at(rank);
+    }
+    if (rateMs > 0) {
+        summary.tokensPerSecond = rateTokens * 1000.0 / rateMs;
+    }
+    return summary;
+}
+
+QVector<TranslationTelemetry::ModelSummary> TranslationTelemetry::summaries() const
+{
+    QStringList models;
+    QSet<QString> seen;
+    for (const LlmRequestMetrics &metrics : m_completions) {
+        if (!seen.contains(metrics.model)) {
+            seen.insert(metrics.model);
+            models.append(metrics.model);
+        }
+    }
+    for (auto it = m_failuresByModel.constBegin(); it != m_failuresByModel.constEnd(); ++it) {
+        if (!seen.contains(it.key())) {
+            seen.insert(it.key());
+            models.append(it.key());
+        }
+    }
+
+    QVector<ModelSummary> result;
+    result.reserve(models.size() + 1);
+    for (const QString &model : models) {
+        result.append(summarize(model, false));
+    }
+    result.append(summarize(QString(), true));
+    return result;
+}
+
+QStringList TranslationTelemetry::summaryLines() const
+{
+    QStringList lines;
+    if (isEmpty()) {
+        return lines;
+    }
+
+    const QVector<ModelSummary> modelSummaries = summaries();
+    const qint64 wallMs = m_jobTimer.isValid() ? m_jobTimer.elapsed() : 0;
+    for (const ModelSummary &summary : modelSummaries) {
+        const bool isTotal = &summary == &modelSummaries.constLast();
+        QString line = QCoreApplication::translate("TranslationTelemetry",
+                                                   "%1：请求 %2（失败 %3，重发 %4，对冲 %5），首字平均 %6 ms / p90 %7 ms，"
+                                                   "平均耗时 %8 ms，输入 %9 / 输出 %10 token，生成速率 %11 token/s")
+                           .arg(isTotal ? QCoreApplication::translate("TranslationTelemetry", "全任务合计")
+                                        : modelLabel(summary.model))
+                           .arg(summary.requests)
+                           .arg(summary.failures)
+                           .arg(summary.retries)
+                           .arg(summary.hedged)
+                           .arg(formatMs(summary.averageFirstTokenMs))
+                           .arg(formatMs(summary.p90FirstTokenMs))
+                           .arg(formatMs(summary.averageTotalMs))
+                           .arg(summary.promptTokens)
+                           .arg(summary.completionTokens)
+                           .arg(formatRate(summary.tokensPerSecond));
+        if (isTotal && wallMs > 0) {
+            // 任务吞吐按墙钟时间计，反映并发与排队后的实际产出速度。
+            line += QCoreApplication::translate("TranslationTelemetry", "，任务用时 %1 s，整体吞吐 %2 token/s")
+                        .arg(QString::number(wallMs / 1000.0, 'f', 1))
+                        .arg(QString::number(summary.completionTokens * 1000.0 / wallMs, 'f', 1));
+            if (m_entryCount > 0) {
+                line += QCoreApplication::translate("TranslationTelemetry", "，字幕 %1 条（%2 条/s）")
+                            .arg(m_entryCount)
+                            .arg(QString::number(m_entryCount * 1000.0 / wallMs, 'f', 2));
+            }
+        }
+        lines.append(line);
+    }
+    return lines;
+}
+
+bool TranslationTelemetry::exportCsv(const QString &filePath, QString *errorMessage) const
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        if (errorMessage) {
+            *errorMessage = file.errorString();
+        }
+        return false;
+    }
+
+    QStringList rows;
+    rows.reserve(m_completions.size() + 1);
+    rows.append(QStringLiteral("endpoint,model,queue_wait_ms,tls_ready_ms,headers_ms,first_token_ms,total_ms,"
+                               "prompt_tokens,completion_tokens,tokens_per_second,stream_chunks,attempts,hedged,"
+                               "http2,bytes_sent,bytes_received"));
+    for (const LlmRequestMetrics &metrics : m_completions) {
+        const double rate = tokensPerSecond(metrics);
+        rows.append(QStringList{csvField(metrics.endpointUrl),
+                                csvField(metrics.model),
+                                QString::number(metrics.queueWaitMs),
+                                QString::number(metrics.tlsReadyMs),
+                                QString::number(metrics.headersMs),
+                                QString::number(metrics.firstTokenMs),
+                                QString::number(metrics.totalMs),
+                                QString::number(metrics.promptTokens),
+                                QString::number(metrics.completionTokens),
+                                rate < 0 ? QString() : QString::number(rate, 'f', 2),
+                                QString::number(metrics.streamChunks),
+                                QString::number(metrics.attempts),
+                                metrics.hedged ? QStringLiteral("1") : QStringLiteral("0"),
+                                metrics.http2 ? QStringLiteral("1") : QStringLiteral("0"),
+                                QString::number(metrics.bytesSent),
+                                QString::number(metrics.bytesReceived)}
+                        .join(QLatin1Char(',')));
+    }
+
+    file.write(rows.join(QLatin1Char('\n')).toUtf8());
+    file.write("\n");
+    return true;
+}
+
+bool TranslationTelemetry::exportJson(const QString &filePath, QString *errorMessage) const
+{
+    QJsonArray requests;
+    for (const LlmRequestMetrics &metrics : m_completions) {
+        QJsonObject item;
+        item.insert(QStringLiteral("endpoint"), metrics.endpointUrl);
+        item.insert(QStringLiteral("model"), metrics.model);
+        item.insert(QStringLiteral("queueWaitMs"), static_cast<double>(metrics.queueWaitMs));
+        item.insert(QStringLiteral("tlsReadyMs"), static_cast<double>(metrics.tlsReadyMs));
+        item.insert(QStringLiteral("headersMs"), static_cast<double>(metrics.headersMs));
+        item.insert(QStringLiteral("firstTokenMs"), static_cast<double>(metrics.firstTokenMs));
+        item.insert(QStringLiteral("totalMs"), static_cast<double>(metrics.totalMs));
+        item.insert(QStringLiteral("promptTokens"), static_cast<double>(metrics.promptTokens));
+        item.insert(QStringLiteral("completionTokens"), static_cast<double>(metrics.completionTokens));
+        item.insert(QStringLiteral("tokensPerSecond"), tokensPerSecond(metrics));
+        item.insert(QStringLiteral("streamChunks"), metrics.streamChunks);
+        item.insert(QStringLiteral("attempts"), metrics.attempts);
+        item.insert(QStringLiteral("hedged"), metrics.hedged);
+        item.insert(QStringLiteral("http2"), metrics.http2);
+        item.insert(QStringLiteral("bytesSent"), static_cast<double>(metrics.bytesSent));
+        item.insert(QStringLiteral("bytesReceived"), static_cast<double>(metrics.bytesReceived));
+        requests.append(item);
+    }
+
+    QJsonArray models;
+    for (const ModelSummary &summary : summaries()) {
+        QJsonObject item;
+        item.insert(QStringLiteral("model"), summary.model.isEmpty() ? QJsonValue() : QJsonValue(summary.model));
+        item.insert(QStringLiteral("requests"), summary.requests);
+        item.insert(QStringLiteral("failures"), summary.failures);
+        item.insert(QStringLiteral("retries"), summary.retries);
+        item.insert(QStringLiteral("hedged"), summary.hedged);
+        item.insert(QStringLiteral("promptTokens"), static_cast<double>(summary.promptTokens));
+        item.insert(QStringLiteral("completionTokens"), static_cast<double>(summary.completionTokens));
+        item.insert(QStringLiteral("averageFirstTokenMs"), static_cast<double>(summary.averageFirstTokenMs));
+        item.insert(QStringLiteral("p90FirstTokenMs"), static_cast<double>(summary.p90FirstTokenMs));
+        item.insert(QStringLiteral("averageTotalMs"), static_cast<double>(summary.averageTotalMs));
+        item.insert(QStringLiteral("tokensPerSecond"), summary.tokensPerSecond);
+        models.append(item);
+    }
+
+    const qint64 wallMs = m_jobTimer.isValid() ? m_jobTimer.elapsed() : 0;
+    QJsonObject root;
+    root.insert(QStringLiteral("wallMs"), static_cast<double>(wallMs));
+    root.insert(QStringLiteral("entries"), m_entryCount);
+    root.insert(QStringLiteral("entriesPerSecond"), wallMs > 0 ? m_entryCount * 1000.0 / wallMs : 0.0);
+    root.insert(QStringLiteral("models"), models);
+    root.insert(QStringLiteral("requests"), requests);
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (errorMessage) {
+            *errorMessage = file.errorString();
+        }
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    return true;
+}
@@ -0,0 +1,61 @@
+#ifndef TRANSLATIONTELEMETRY_H
+#define TRANSLATIONTELEMETRY_H
+
+#include "llmserviceclient.h"
+
+#include <QElapsedTimer>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// 单个翻译任务的请求性能统计：逐请求记录，按模型汇总，可导出 CSV / JSON。
+class TranslationTelemetry
+{
+public:
+    struct ModelSummary
+    {
+        // 为空表示全任务合计。
+        QString model;
+        int requests = 0;
+        int failures = 0;
+        int retries = 0;
+        int hedged = 0;
+        qint64 promptTokens = 0;
+        qint64 completionTokens = 0;
+        qint64 averageFirstTokenMs = -1;
+        qint64 p90FirstTokenMs = -1;
+        qint64 averageTotalMs = -1;
+        // 生成阶段速率：输出 token 数 / (总耗时 - 首字延迟)；无 usage 时为 -1。
+        double tokensPerSecond = -1.0;
+    };
+
+    // 开始新任务：清空记录并重新计时。
+    void reset();
+    // 本任务的字幕条目数，用于计算条目吞吐（条/秒）。
+    void setEntryCount(int entryCount);
+    void recordCompletion(const LlmRequestMetrics &metrics);
+    void recordFailure(const QString &model);
+
+    bool isEmpty() const;
+    // 按模型汇总，末项为全任务合计。
+    QVector<ModelSummary> summaries() const;
+    // 供输出面板显示的汇总行。
+    QStringList summaryLines() const;
+
+    bool exportCsv(const QString &filePath, QString *errorMessage) const;
+    bool exportJson(const QString &filePath, QString *errorMessage) const;
+
+    // 单个请求的生成速率（token/s），无法计算时返回 -1。
+    static double tokensPerSecond(const LlmRequestMetrics &metrics);
+
+private:
+    ModelSummary summarize(const QString &model, bool allModels) const;
+
+    QVector<LlmRequestMetrics> m_completions;
+    QMap<QString, int> m_failuresByModel;
+    QElapsedTimer m_jobTimer;
+    int m_entryCount = 0;
+};
+
+#endif // TRANSLATIONTELEMETRY_H
@@ -5,6 +5,8 @@
 #include "whisperruntimeselector.h"
 #include "../../Core/executablecapabilities.h"
 
+#include <QAction>
+#include <QClipboard>
 #include <QDesktopServices>
 #include <QDateTime>
 #include <QCoreApplication>
@@ -14,11 +16,12 @@
 #include <QFileDialog>
 #include <QFileInfo>
 #include <QFileInfoList>
+#include <QGuiApplication>
+#include <QKeySequence>
 #include <QMessageBox>
 #include <QProcess>
 #include <QRegularExpression>
 #include <QShowEvent>
-#include <QScrollBar>
 #include <QTimer>
 #include <QTextStream>
 #include <QToolButton>
@@ -33,6 +36,7 @@
 #include <QRunnable>
 
 #include "../../Core/dependencymanager.h"
+#include "../../Core/pipelinelogmodel.h"
 
 // 内部转录 Worker 类（用于线程池）
 class TranscribeWorker : public QRunnable
@@ -97,6 +101,10 @@ SubtitleExtraction::SubtitleExtraction(QWidget *parent) :
     m_toolsSpinTimer->setInterval(60);
     connect(m_toolsSpinTimer, &QTimer::timeout, this, &SubtitleExtraction::updateToolsSpinner);
 
+    m_progressTimer = new QTimer(this);
+    m_progressTimer->setInterval(100);
+    connect(m_progressTimer, &QTimer::timeout, this, &SubtitleExtraction::publishSegmentProgress);
+
     connect(ui->toolsCheckButton, &QToolButton::clicked, this, []() {
         DependencyManager::instance().checkForUpdates();
     });
@@ -474,18 +482,22 @@ void SubtitleExtraction::startTranscriptionWorkflow()
     const QString outputExtension = WhisperCommandBuilder::outputFileExtensionFromUiText(outputFormatText);
     const QString outputFilePath = QDir(finalRoot).filePath(inputInfo.completeBaseName() + "_whisper." + outputExtension);
 
-    m_workflowLogHistory.clear();
-    m_activeSegmentLogLines.clear();
-    if (ui->logTextEdit) {
-        ui->logTextEdit->clear();
-    }
+    m_logModel->beginSession();
     appendWorkflowLog(tr("任务开始：%1").arg(inputInfo.fileName()));
+    if (!m_logModel->spillFilePath().isEmpty()) {
+        appendWorkflowLog(tr("完整日志：%1").arg(QDir::toNativeSeparators(m_logModel->spillFilePath())));
+    }
     appendWorkflowLog(tr("识别模型：%1").arg(QFileInfo(modelPath).fileName()));
     appendWorkflowLog(tr("输出格式：%1").arg(outputFormatText));
     appendWorkflowLog(tr("GPU 加速：%1").arg(ui->gpuCheckBox && ui->gpuCheckBox->isChecked() ? tr("已开启") : tr("未开启")));
     appendWorkflowLog(tr("Whisper 后端：%1（%2）")
                       .arg(whisperRuntime.usingCudaBuild ? tr("CUDA 优先版本") : tr("CPU 版本"))
                       .arg(QFileInfo(whisperPath).fileName()));
+    const bool streamToTranslator = ui->streamTranslateCheckBox && ui->streamTranslateCheckBox->isChecked();
+    if (streamToTranslator) {
+        appendWorkflowLog(tr("边识别边翻译：已识别的分段按时间顺序送入翻译页"));
+        emit transcriptStreamStarted(outputFilePath);
+    }
     emit progressChanged(0);
 
     double durationSeconds = 0.0;
@@ -522,13 +534,7 @@ void SubtitleExtraction::startTranscriptionWorkflow()
     }
 
     // 初始化分段进度跟踪
-    {
-        QMutexLocker lock(&m_progressLock);
-        m_segmentProgress.clear();
-        for (int i = 0; i < segmentCount; ++i) {
-            m_segmentProgress[i] = -1;
-        }
-    }
+    resetSegmentProgress(segmentCount);
 
     const QString languageCode = WhisperCommandBuilder::languageCodeFromUiText(ui->languageComboBox ? ui->languageComboBox->currentText() : QString());
     
@@ -557,7 +563,7 @@ void SubtitleExtraction::startTranscriptionWorkflow()
             allSuccess = false;
             if (!m_cancelRequested.load()) {
                 failureMessage = tr("音频分段失败，请检查输入文件或 FFmpeg 是否可用。");
-                appendWorkflowLog(tr("第 %1/%2 段分段失败（%3）").arg(index + 1).arg(segmentCount).arg(rangeText));
+                appendWorkflowLog(tr("第 %1/%2 段分段失败（%3）").arg(index + 1).arg(segmentCount).arg(rangeText), LogSeverity::Error);
             }
             break;
         }
@@ -585,6 +591,29 @@ void SubtitleExtraction::startTranscriptionWorkflow()
         QVector<bool> segmentResults(segments.size(), false);
         QMutex resultLock;
 
+        // 边识别边翻译：前序分段全部完成后才提交，保证片段按时间顺序、序号全局连续。
+        int nextStreamedSegment = 0;
+        int streamedCueCount = 0;
+        const auto streamCompletedSegments = [&]() {
+            while (streamToTranslator && !m_cancelRequested.load() && nextStreamedSegment < segments.size()) {
+                {
+                    QMutexLocker lock(&resultLock);
+                    if (!segmentResults[nextStreamedSegment]) {
+                        return;
+                    }
+                }
+
+                const SegmentInfo &seg = segments[nextStreamedSegment];
+                const QStringList blocks = WhisperSegmentMerger::shiftedSegmentBlocks(
+                    seg.srtPath, static_cast<qint64>(seg.index) * segmentSeconds * 1000);
+                if (!blocks.isEmpty()) {
+                    emit transcriptCuesCommitted(WhisperSegmentMerger::numberedSrtContent(blocks, streamedCueCount + 1));
+                    streamedCueCount += blocks.size();
+                }
+                ++nextStreamedSegment;
+            }
+        };
+
         for (int i = 0; i < segments.size(); ++i) {
             if (m_cancelRequested.load()) {
                 allSuccess = false;
@@ -601,13 +630,19 @@ void SubtitleExtraction::startTranscriptionWorkflow()
             pool->start(worker);
         }
 
+        // worker 只写进度槽位，汇总与刷新由定时器在下方的事件处理中完成。
+        m_progressTimer->start();
         while (pool->activeThreadCount() > 0) {
             if (m_cancelRequested.load()) {
                 pool->clear();
             }
+            streamCompletedSegments();
             QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
             QThread::msleep(15);
         }
+        m_progressTimer->stop();
+        publishSegmentProgress();
+        streamCompletedSegments();
 
         for (int i = 0; i < segments.size(); ++i) {
             if (m_cancelRequested.load()) {
@@ -620,7 +655,7 @@ void SubtitleExtraction::startTranscriptionWorkflow()
                 allSuccess = false;
                 if (!m_cancelRequested.load()) {
                     failureMessage = tr("Whisper 识别失败，请检查模型文件和 whisper 版本。");
-                    appendWorkflowLog(tr("第 %1 段识别失败").arg(segments[i].index + 1));
+                    appendWorkflowLog(tr("第 %1 段识别失败").arg(segments[i].index + 1), LogSeverity::Error);
                 }
                 break;
             }
@@ -628,7 +663,7 @@ void SubtitleExtraction::startTranscriptionWorkflow()
             if (!QFileInfo::exists(segments[i].srtPath)) {
                 allSuccess = false;
                 failureMessage = tr("Whisper 未产出分段 SRT 文件。");
-                appendWorkflowLog(tr("第 %1 段未产出字幕文件").arg(segments[i].index + 1));
+                appendWorkflowLog(tr("第 %1 段未产出字幕文件").arg(segments[i].index + 1), LogSeverity::Error);
                 break;
             }
 
@@ -657,13 +692,13 @@ void SubtitleExtraction::startTranscriptionWorkflow()
         if (finalOutputContent.isEmpty()) {
             allSuccess = false;
             failureMessage = tr("合并字幕失败。");
-            appendWorkflowLog(tr("合并失败：无法生成合并内容"));
+            appendWorkflowLog(tr("合并失败：无法生成合并内容"), LogSeverity::Error);
         } else {
             QFile outputFile(outputFilePath);
             if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
                 allSuccess = false;
                 failureMessage = tr("无法写入最终输出文件。请检查输出目录权限。");
-                appendWorkflowLog(tr("输出失败：无法写入最终文件"));
+                appendWorkflowLog(tr("输出失败：无法写入最终文件"), LogSeverity::Error);
             } else {
                 QTextStream out(&outputFile);
                 out.setCodec("UTF-8");
@@ -680,14 +715,17 @@ void SubtitleExtraction::startTranscriptionWorkflow()
         appendWorkflowLog(tr("已清理中间文件"));
     }
 
-    m_activeSegmentLogLines.clear();
-    renderWorkflowLogConsole();
+    m_logModel->clearActiveLines();
 
     updateRunningStateUi(false);
+    if (streamToTranslator) {
+        emit transcriptStreamFinished(allSuccess, outputFilePath);
+    }
 
     if (!allSuccess) {
         appendWorkflowLog(tr("本次转写总耗时：%1").arg(formatElapsedDuration(workflowTimer.elapsed())));
-        appendWorkflowLog(tr("任务结束：%1").arg(failureMessage.isEmpty() ? tr("任务已停止或执行失败。") : failureMessage));
+        appendWorkflowLog(tr("任务结束：%1").arg(failureMessage.isEmpty() ? tr("任务已停止或执行失败。") : failureMessage),
+                          LogSeverity::Warning);
         QMessageBox::warning(this, tr("识别未完成"), failureMessage.isEmpty() ? tr("任务已停止或执行失败。") : failureMessage);
         return;
     }
@@ -800,7 +838,7 @@ bool SubtitleExtraction::extractSegmentAudio(const QString &ffmpegPath,
 
     const bool ok = runProcessCancelable(ffmpegPath, args, &stdErr);
     if (!ok && !stdErr.trimmed().isEmpty()) {
-        appendWorkflowLog(tr("FFmpeg 错误：%1").arg(stdErr.trimmed()));
+        appendWorkflowLog(tr("FFmpeg 错误：%1").arg(stdErr.trimmed()), LogSeverity::Error);
     }
     return ok;
 }
@@ -842,12 +880,14 @@ bool SubtitleExtraction::transcribeSegment(const QString &whisperPath,
     int lastReportedSegmentProgress = -1;
     qint64 lastTailRefreshMs = -1;
     qint64 lastActivityMs = 0;
+    // 槽位在识别开始前已按段数分配，此处只写不重分配。
+    std::atomic_int *progressSlot = segmentIndex >= 0 && segmentIndex < qMin(segmentCount, m_segmentProgressCount)
+                                        ? &m_segmentProgress[segmentIndex]
+                                        : nullptr;
 
-    {
-        QMutexLocker lock(&m_progressLock);
-        m_segmentProgress[segmentIndex] = 0;
+    if (progressSlot) {
+        progressSlot->store(0, std::memory_order_relaxed);
     }
-    updateSegmentProgressLog(segmentIndex, 0, false);
 
     while (process.state() != QProcess::NotRunning) {
         if (m_cancelRequested.load()) {
@@ -883,26 +923,9 @@ bool SubtitleExtraction::transcribeSegment(const QString &whisperPath,
         if (segmentProgress != lastReportedSegmentProgress) {
             lastReportedSegmentProgress = segmentProgress;
             lastActivityMs = timer.elapsed();
-            int overallPercent = 0;
-            QString parallelSummary;
-            {
-                QMutexLocker lock(&m_progressLock);
-                m_segmentProgress[segmentIndex] = segmentProgress;
-
-                int progressSum = 0;
-                for (int i = 0; i < segmentCount; ++i) {
-                    progressSum += qMax(0, m_segmentProgress.value(i, -1));
-                }
-                overallPercent = progressSum / qMax(1, segmentCount);
-                if (overallPercent != m_lastProgressPercent) {
-                    m_lastProgressPercent = overallPercent;
-                    emit progressChanged(overallPercent);
-                }
-
-                parallelSummary = buildParallelStatusSummaryLocked(segmentCount, overallPercent);
+            if (progressSlot) {
+                progressSlot->store(segmentProgress, std::memory_order_relaxed);
             }
-            updateSegmentProgressLog(segmentIndex, segmentProgress, false);
-            emit statusMessage(parallelSummary);
         }
 
         if (segmentProgress == 99) {
@@ -932,28 +955,13 @@ bool SubtitleExtraction::transcribeSegment(const QString &whisperPath,
         stdErrTail = stdErrTail.right(32768);
     }
     stdErr = stdErrTail;
-    int finalOverallPercent = 100;
-    QString finalParallelSummary;
-    {
-        QMutexLocker lock(&m_progressLock);
-        m_segmentProgress[segmentIndex] = 100;
-
-        int progressSum = 0;
-        for (int i = 0; i < segmentCount; ++i) {
-            progressSum += qMax(0, m_segmentProgress.value(i, -1));
-        }
-        finalOverallPercent = progressSum / qMax(1, segmentCount);
-        finalParallelSummary = buildParallelStatusSummaryLocked(segmentCount, finalOverallPercent);
-        if (finalOverallPercent != m_lastProgressPercent) {
-            m_lastProgressPercent = finalOverallPercent;
-            emit progressChanged(finalOverallPercent);
-        }
+    if (progressSlot) {
+        progressSlot->store(100, std::memory_order_relaxed);
     }
     updateSegmentProgressLog(segmentIndex, 100, true);
-    emit statusMessage(finalParallelSummary);
     const bool ok = process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0;
     if (!ok && !stdErr.trimmed().isEmpty()) {
-        appendWorkflowLog(tr("Whisper 错误：%1").arg(stdErr.trimmed()));
+        appendWorkflowLog(tr("Whisper 错误：%1").arg(stdErr.trimmed()), LogSeverity::Error);
     }
     return ok;
 }
@@ -1015,11 +1023,58 @@ QString SubtitleExtraction::segmentRangeLabel(double startSeconds, double durati
         .arg(endSec, 2, 10, QLatin1Char('0'));
 }
 
-QString SubtitleExtraction::buildParallelStatusSummaryLocked(int segmentCount, int overallPercent) const
+void SubtitleExtraction::resetSegmentProgress(int segmentCount)
+{
+    m_segmentProgressCount = qMax(0, segmentCount);
+    m_segmentProgress.reset(m_segmentProgressCount > 0 ? new std::atomic_int[m_segmentProgressCount] : nullptr);
+    for (int i = 0; i < m_segmentProgressCount; ++i) {
+        m_segmentProgress[i].store(-1, std::memory_order_relaxed);
+    }
+    m_renderedSegmentProgress = QVector<int>(m_segmentProgressCount, -1);
+    m_lastParallelSummary.clear();
+}
+
+void SubtitleExtraction::publishSegmentProgress()
+{
+    if (m_segmentProgressCount <= 0) {
+        return;
+    }
+
+    // 进度只增不减，各槽位单独读取即可，不需要整体快照。
+    int progressSum = 0;
+    const QString timestamp = QDateTime::currentDateTime().toString("hh:mm:ss");
+    for (int i = 0; i < m_segmentProgressCount; ++i) {
+        const int progress = m_segmentProgress[i].load(std::memory_order_relaxed);
+        progressSum += qMax(0, progress);
+        if (progress == m_renderedSegmentProgress.at(i)) {
+            continue;
+        }
+        m_renderedSegmentProgress[i] = progress;
+        // 完成行由 worker 结束时的 updateSegmentProgressLog() 写入历史。
+        if (progress >= 0 && progress < 100) {
+            m_logModel->setActiveLine(QString::number(i),
+                                      QString("[%1] %2").arg(timestamp,
+                                                             tr("第 %1 段识别进度=%2%").arg(i + 1).arg(progress)));
+        }
+    }
+
+    const int overallPercent = progressSum / m_segmentProgressCount;
+    if (overallPercent != m_lastProgressPercent) {
+        m_lastProgressPercent = overallPercent;
+        emit progressChanged(overallPercent);
+    }
+    const QString summary = buildParallelStatusSummary(overallPercent);
+    if (summary != m_lastParallelSummary) {
+        m_lastParallelSummary = summary;
+        emit statusMessage(summary);
+    }
+}
+
+QString SubtitleExtraction::buildParallelStatusSummary(int overallPercent) const
 {
     QStringList activeSegments;
-    for (int i = 0; i < segmentCount; ++i) {
-        const int progress = m_segmentProgress.value(i, -1);
+    for (int i = 0; i < m_segmentProgressCount; ++i) {
+        const int progress = m_segmentProgress[i].load(std::memory_order_relaxed);
         if (progress >= 0 && progress < 100) {
             activeSegments << tr("第%1段 %2%").arg(i + 1).arg(progress);
         }
@@ -1034,20 +1089,21 @@ QString SubtitleExtraction::buildParallelStatusSummaryLocked(int segmentCount, i
         .arg(overallPercent);
 }
 
-void SubtitleExtraction::renderWorkflowLogConsole()
+void SubtitleExtraction::followWorkflowLog()
 {
-    if (!ui || !ui->logTextEdit) {
-        return;
+    if (ui && ui->logListView) {
+        ui->logListView->scrollToBottom();
     }
+}
 
-    QStringList lines = m_workflowLogHistory;
-    for (auto it = m_activeSegmentLogLines.constBegin(); it != m_activeSegmentLogLines.constEnd(); ++it) {
-        lines << it.value();
+void SubtitleExtraction::copySelectedLogRows()
+{
+    const QModelIndexList selected = ui->logListView->selectionModel()->selectedIndexes();
+    if (selected.isEmpty()) {
+        return;
     }
-
-    ui->logTextEdit->setPlainText(lines.join("\n"));
-    if (ui->logTextEdit->verticalScrollBar()) {
-        ui->logTextEdit->verticalScrollBar()->setValue(ui->logTextEdit->verticalScrollBar()->maximum());
+    if (QClipboard *clipboard = QGuiApplication::clipboard()) {
+        clipboard->setText(m_logModel->textForRows(selected));
     }
 }
 
@@ -1060,46 +1116,51 @@ void SubtitleExtraction::updateSegmentProgressLog(int segmentIndex, int progress
         return;
     }
 
-    const QString timestamp = QDateTime::currentDateTime().toString("hh:mm:ss");
+    const QString key = QString::number(segmentIndex);
     if (finished) {
-        m_activeSegmentLogLines.remove(segmentIndex);
-        m_workflowLogHistory << QString("[%1] %2")
-                                .arg(timestamp,
-                                     tr("第 %1 段识别完成：100%").arg(segmentIndex + 1));
+        m_logModel->removeActiveLine(key);
+        m_logModel->append(tr("第 %1 段识别完成：100%").arg(segmentIndex + 1));
     } else {
-        m_activeSegmentLogLines[segmentIndex] = QString("[%1] %2")
-                                                    .arg(timestamp,
-                                                         tr("第 %1 段识别进度=%2%").arg(segmentIndex + 1).arg(progressPercent));
+        const QString timestamp = QDateTime::currentDateTime().toString("hh:mm:ss");
+        m_logModel->setActiveLine(key,
+                                  QString("[%1] %2").arg(timestamp,
+                                                         tr("第 %1 段识别进度=%2%").arg(segmentIndex + 1).arg(progressPercent)));
     }
-
-    renderWorkflowLogConsole();
+    followWorkflowLog();
 }
 
-void SubtitleExtraction::appendWorkflowLog(const QString &message)
+void SubtitleExtraction::appendWorkflowLog(const QString &message, LogSeverity severity)
 {
     if (QThread::currentThread() != thread()) {
-        QMetaObject::invokeMethod(this, [this, message]() {
-            appendWorkflowLog(message);
+        QMetaObject::invokeMethod(this, [this, message, severity]() {
+            appendWorkflowLog(message, severity);
         }, Qt::QueuedConnection);
         return;
     }
 
-    if (!ui || !ui->logTextEdit) {
+    if (!m_logModel) {
         return;
     }
 
-    const QString timestamp = QDateTime::currentDateTime().toString("hh:mm:ss");
-    m_workflowLogHistory << QString("[%1] %2").arg(timestamp, message);
-    renderWorkflowLogConsole();
+    m_logModel->append(message, severity);
+    followWorkflowLog();
     emit statusMessage(message);
 }
 
 void SubtitleExtraction::initializeLogConsole()
 {
-    if (!ui || !ui->logTextEdit) {
+    if (!ui || !ui->logListView) {
         return;
     }
 
-    ui->logTextEdit->setReadOnly(true);
-    ui->logTextEdit->setPlaceholderText(tr("转写进度将在此按阶段实时显示..."));
+    m_logModel = new PipelineLogModel(QStringLiteral("whisper"), this);
+    m_logModel->setPlaceholderText(tr("转写进度将在此按阶段实时显示..."));
+    ui->logListView->setModel(m_logModel);
+
+    QAction *copyRowsAction = new QAction(tr("复制选中行"), ui->logListView);
+    copyRowsAction->setShortcut(QKeySequence::Copy);
+    copyRowsAction->setShortcutContext(Qt::WidgetShortcut);
+    connect(copyRowsAction, &QAction::triggered, this, &SubtitleExtraction::copySelectedLogRows);
+    ui->logListView->addAction(copyRowsAction);
+    ui->logListView->setContextMenuPolicy(Qt::ActionsContextMenu);
 }
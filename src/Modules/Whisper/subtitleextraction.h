@@ -3,12 +3,14 @@
 
 #include <QWidget>
 #include <QIcon>
-#include <QMutex>
-#include <QMap>
+#include <QVector>
 #include <atomic>
+#include "../../Core/logringbuffer.h"
+#include <memory>
 
 class QTimer;
 class QShowEvent;
+class PipelineLogModel;
 class TranscribeWorker;
 class WhisperSegmentMerger;
 class WhisperCommandBuilder;
@@ -35,6 +37,12 @@ signals:
     void statusMessage(const QString &message);
     void progressChanged(int percent);
     void requestNextStep(const QString &subtitlePath);
+    /// @brief 边识别边翻译：开始识别时给出最终输出路径
+    void transcriptStreamStarted(const QString &subtitlePath);
+    /// @brief 按时间顺序提交已识别完成的分段（SRT 片段，序号全局连续）
+    void transcriptCuesCommitted(const QString &srtFragment);
+    /// @brief 识别结束（含失败与停止），此后不再提交片段
+    void transcriptStreamFinished(bool success, const QString &subtitlePath);
 
 private:
     Ui::SubtitleExtraction *ui;
@@ -45,10 +53,17 @@ private:
     bool m_isRunning = false;
     std::atomic_bool m_cancelRequested{false};
     int m_lastProgressPercent = -1;
-    QMutex m_progressLock;
-    QMap<int, int> m_segmentProgress;
-    QStringList m_workflowLogHistory;
-    QMap<int, QString> m_activeSegmentLogLines;
+    /// @brief 各分段进度（-1 未开始，0~99 进行中，100 完成），识别开始前按段数预分配；
+    /// worker 只写自己的槽位（无锁），汇总与显示由界面线程的定时器完成
+    std::unique_ptr<std::atomic_int[]> m_segmentProgress;
+    int m_segmentProgressCount = 0;
+    /// @brief 约 10 Hz 合并刷新总进度、状态栏汇总与日志区的活跃分段行
+    QTimer *m_progressTimer = nullptr;
+    /// @brief 界面线程上次显示的各分段进度与状态栏汇总，未变化时不重绘
+    QVector<int> m_renderedSegmentProgress;
+    QString m_lastParallelSummary;
+    /// @brief 日志区模型：历史记录（固定容量，完整历史落盘）+ 进行中分段的活动行
+    PipelineLogModel *m_logModel = nullptr;
     QString m_lastCompletedOutputFilePath;
 
     void setToolsLoading(bool loading);
@@ -110,12 +125,17 @@ private:
         static QString srtToTimestampedText(const QString &srtContent);
         static QString srtToWebVtt(const QString &srtContent);
     static QString segmentRangeLabel(double startSeconds, double durationSeconds);
-        QString buildParallelStatusSummaryLocked(int segmentCount, int overallPercent) const;
-        void renderWorkflowLogConsole();
+        QString buildParallelStatusSummary(int overallPercent) const;
+        /// @brief 重置分段进度槽位（识别开始前在界面线程调用）
+        void resetSegmentProgress(int segmentCount);
+        /// @brief 读取各分段进度，刷新总进度、状态栏汇总与日志区（仅界面线程）
+        void publishSegmentProgress();
+        void followWorkflowLog();
+        void copySelectedLogRows();
         void updateSegmentProgressLog(int segmentIndex, int progressPercent, bool finished);
 
     /// @brief 追加一行日志到页面日志栏
-    void appendWorkflowLog(const QString &message);
+    void appendWorkflowLog(const QString &message, LogSeverity severity = LogSeverity::Info);
     /// @brief 设置日志栏初始状态
     void initializeLogConsole();
 
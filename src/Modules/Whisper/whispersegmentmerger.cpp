@@ -132,6 +132,49 @@ QString WhisperSegmentMerger::srtToWebVtt(const QString &srtContent)
     return out.join("\n");
 }
 
+QStringList WhisperSegmentMerger::shiftedSegmentBlocks(const QString &segmentSrtPath, qint64 offsetMs, bool *ok)
+{
+    QStringList result;
+    QFile srtFile(segmentSrtPath);
+    if (!srtFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (ok) {
+            *ok = false;
+        }
+        return result;
+    }
+
+    QTextStream in(&srtFile);
+    in.setCodec("UTF-8");
+    const QString shifted = shiftedSrtContent(in.readAll(), offsetMs);
+    srtFile.close();
+
+    const QStringList blocks = shifted.split(QRegularExpression("\\r?\\n\\r?\\n"), Qt::SkipEmptyParts);
+    for (const QString &block : blocks) {
+        const QStringList lines = block.split(QRegularExpression("\\r?\\n"), Qt::KeepEmptyParts);
+        if (lines.size() < 2) {
+            continue;
+        }
+        result << lines.mid(1).join("\n");
+    }
+
+    if (ok) {
+        *ok = true;
+    }
+    return result;
+}
+
+QString WhisperSegmentMerger::numberedSrtContent(const QStringList &blocks, int firstIndex)
+{
+    QString content;
+    QTextStream out(&content, QIODevice::WriteOnly);
+    int globalIndex = firstIndex;
+    for (const QString &block : blocks) {
+        out << globalIndex++ << "\n" << block << "\n\n";
+    }
+    out.flush();
+    return content;
+}
+
 QString WhisperSegmentMerger::mergeSegmentSrtFiles(const QStringList &segmentSrtFiles,
                                                     double segmentDurationSeconds,
                                                     OutputFormat format)
@@ -140,36 +183,17 @@ QString WhisperSegmentMerger::mergeSegmentSrtFiles(const QStringList &segmentSrt
         return QString();
     }
 
-    QString mergedSrtContent;
-    QTextStream mergedSrtOut(&mergedSrtContent, QIODevice::WriteOnly);
-    int globalIndex = 1;
+    QStringList mergedBlocks;
     const int segmentSeconds = static_cast<int>(segmentDurationSeconds);
 
     for (int index = 0; index < segmentSrtFiles.size(); ++index) {
-        QFile srtFile(segmentSrtFiles[index]);
-        if (!srtFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        bool ok = false;
+        mergedBlocks += shiftedSegmentBlocks(segmentSrtFiles[index], static_cast<qint64>(index) * segmentSeconds * 1000, &ok);
+        if (!ok) {
             return QString();
         }
-
-        QTextStream in(&srtFile);
-        in.setCodec("UTF-8");
-        const QString shifted = shiftedSrtContent(in.readAll(), static_cast<qint64>(index) * segmentSeconds * 1000);
-        srtFile.close();
-
-        const QStringList blocks = shifted.split(QRegularExpression("\\r?\\n\\r?\\n"), Qt::SkipEmptyParts);
-        for (const QString &block : blocks) {
-            const QStringList lines = block.split(QRegularExpression("\\r?\\n"), Qt::KeepEmptyParts);
-            if (lines.size() < 2) {
-                continue;
-            }
-
-            mergedSrtOut << globalIndex++ << "\n";
-            for (int i = 1; i < lines.size(); ++i) {
-                mergedSrtOut << lines[i] << "\n";
-            }
-            mergedSrtOut << "\n";
-        }
     }
+    const QString mergedSrtContent = numberedSrtContent(mergedBlocks, 1);
 
     // 格式转换
     QString finalContent = mergedSrtContent;
@@ -49,6 +49,19 @@ public:
     /// @return WebVTT 格式内容
     static QString srtToWebVtt(const QString &srtContent);
 
+    /// @brief 读取单个分段 SRT 并整体平移时间轴
+    /// @param segmentSrtPath 分段 SRT 文件路径
+    /// @param offsetMs 分段起点的毫秒偏移
+    /// @param ok 输出文件是否读取成功（可为 nullptr）
+    /// @return 字幕块列表（时间行 + 文本行，不含序号）
+    static QStringList shiftedSegmentBlocks(const QString &segmentSrtPath, qint64 offsetMs, bool *ok = nullptr);
+
+    /// @brief 按连续序号拼接字幕块
+    /// @param blocks shiftedSegmentBlocks() 返回的字幕块
+    /// @param firstIndex 首块序号
+    /// @return SRT 内容
+    static QString numberedSrtContent(const QStringList &blocks, int firstIndex);
+
     /// @brief 合并多个分段 SRT 文件
     /// @param segmentSrtFiles 分段 SRT 文件路径列表
     /// @param segmentDurationSeconds 每个分段的时长（秒）
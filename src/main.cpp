@@ -1,10 +1,62 @@
 #include "mainwindow.h"
+#include "Modules/Translator/headlesstranslationrunner.h"
+#include "Modules/Translator/llmmockserver.h"
 
 #include <QApplication>
+#include <QCoreApplication>
+#include <QtGlobal>
+
+namespace {
+void startMockServerFromEnvironment(QCoreApplication *application)
+{
+    LlmMockServerOptions mockOptions;
+    if (!LlmMockServerOptions::fromEnvironment(&mockOptions)) {
+        return;
+    }
+
+    LlmMockServer *mockServer = new LlmMockServer(mockOptions, application);
+    QString errorMessage;
+    if (mockServer->start(&errorMessage)) {
+        qInfo("Mock LLM server listening on http://127.0.0.1:%u (%d recorded exchanges)",
+              static_cast<unsigned>(mockServer->port()),
+              mockServer->recordedExchangeCount());
+    } else {
+        qWarning("Mock LLM server failed to start: %s", qPrintable(errorMessage));
+    }
+}
+
+// 无界面批量翻译：不创建窗口，可在没有显示环境的服务器上运行。
+int runHeadlessTranslation(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+    startMockServerFromEnvironment(&application);
+
+    HeadlessTranslationOptions options;
+    QString errorMessage;
+    if (!HeadlessTranslationOptions::fromArguments(application.arguments(), &options, &errorMessage)) {
+        qWarning("%s\n%s", qPrintable(errorMessage), qPrintable(HeadlessTranslationRunner::usage()));
+        return 2;
+    }
+
+    HeadlessTranslationRunner runner(options);
+    QObject::connect(&runner, &HeadlessTranslationRunner::finished, &application, &QCoreApplication::exit);
+    if (!runner.start(&errorMessage)) {
+        qWarning("%s", qPrintable(errorMessage));
+        return 2;
+    }
+    return application.exec();
+}
+}
 
 int main(int argc, char *argv[])
 {
+    if (HeadlessTranslationRunner::isRequested(argc, argv)) {
+        return runHeadlessTranslation(argc, argv);
+    }
+
     QApplication a(argc, argv);
+    startMockServerFromEnvironment(&a);
+
     MainWindow w;
     w.show();
     return a.exec();
@@ -160,6 +160,19 @@ MainWindow::MainWindow(QWidget *parent)
         setStatusHint(tr("已进入字幕翻译：%1").arg(subtitleInfo.fileName()));
     });
 
+    // 边识别边翻译：识别页逐段提交的条目直接送入翻译页的并发执行器，不经磁盘重新解析。
+    connect(whisperPage, &SubtitleExtraction::transcriptStreamStarted, this, [this, translatePage](const QString &subtitlePath) {
+        if (translatePage->beginStreamingSource(subtitlePath)) {
+            setStatusHint(tr("边识别边翻译已开始，译文在字幕翻译页按分块输出"));
+        } else {
+            setStatusHint(tr("翻译页未能开始流式翻译，识别结束后可手动进入下一步"));
+        }
+    });
+    connect(whisperPage, &SubtitleExtraction::transcriptCuesCommitted, translatePage, &SubtitleTranslation::appendStreamingSource);
+    connect(whisperPage, &SubtitleExtraction::transcriptStreamFinished, this, [translatePage](bool success, const QString &) {
+        translatePage->finishStreamingSource(success);
+    });
+
     connect(ui->navDownloadButton, &QToolButton::clicked, this, &MainWindow::triggerDependencyCheckOnce);
     connect(ui->navWhisperButton, &QToolButton::clicked, this, &MainWindow::triggerDependencyCheckOnce);
     connect(ui->navBurnButton, &QToolButton::clicked, this, &MainWindow::triggerDependencyCheckOnce);